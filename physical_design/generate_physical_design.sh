@@ -31,6 +31,7 @@ MODULE_NAME="ZeroNyteRV32ICore"
 CONFIG_BASE_FILE="config.base.json"
 CONFIG_MODULE_FILE=""
 OUTPUT_ROOT="_runs"
+INPUT_RTL=""
 OPENLANE2_PATH="${OPENLANE2_ROOT:-/opt/skywater-pdk/openlane2}"
 VERBOSE=true
 
@@ -53,6 +54,7 @@ while [[ $# -gt 0 ]]; do
         --config-base) CONFIG_BASE_FILE="$2"; shift 2 ;;
         --config-module) CONFIG_MODULE_FILE="$2"; shift 2 ;;
         --output-root) OUTPUT_ROOT="$2"; shift 2 ;;
+        --input-rtl) INPUT_RTL="$2"; shift 2 ;;
         --openlane2-path) OPENLANE2_PATH="$2"; shift 2 ;;
         --clock-period) CLOCK_PERIOD="$2"; export CLOCK_PERIOD; shift 2 ;;
         --utilization) CORE_UTILIZATION="$2"; export CORE_UTILIZATION; shift 2 ;;
@@ -67,6 +69,7 @@ Options:
   --config-base <file>    Base JSON config (default: config.base.json)
   --config-module <file>  Module-specific JSON config (optional)
   --output-root <path>    Output directory (default: _runs)
+  --input-rtl <file>      Verilog to implement (default: the generated timed RTL)
   --openlane2-path <path> OpenLane2 directory (default: /opt/skywater-pdk/openlane2)
   --clock-period <ns>     Clock period in nanoseconds (default: 10.0)
   --utilization <ratio>   Core utilization ratio (default: 0.7)
@@ -82,6 +85,10 @@ EOF
     esac
 done
 
+if [ -z "$INPUT_RTL" ]; then
+    INPUT_RTL="../rtl/generators/generated/verilog_hierarchical_timed/${MODULE_NAME}.v"
+fi
+
 # --- Configuration Loading and Processing ---
 load_and_process_config() {
     print_step "Loading and processing configurations..."
@@ -115,7 +122,7 @@ prepare_design_config() {
     mkdir -p "$src_dir"
 
     # Copy RTL file to design source directory
-    local input_rtl="../rtl/generators/generated/verilog_hierarchical_timed/${MODULE_NAME}.v"
+    local input_rtl="$INPUT_RTL"
     local target_rtl="$src_dir/${MODULE_NAME}.v"
     
     if [ -f "$input_rtl" ]; then
@@ -162,7 +169,7 @@ validate_configuration() {
     fi
     
     # Check RTL file exists
-    local input_rtl="../rtl/generators/generated/verilog_hierarchical_timed/${MODULE_NAME}.v"
+    local input_rtl="$INPUT_RTL"
     if [ ! -f "$input_rtl" ]; then
         print_error "RTL file not found: $input_rtl. Please generate RTL first using the RTL generation scripts."
     fi
@@ -7,16 +7,21 @@ case class CacheParams(
   capacityBytes: Int = 4096,
   blockBytes: Int = 64,
   dataWidth: Int = 32,
-  addrWidth: Int = 32
+  addrWidth: Int = 32,
+  threads: Int = 1,                  // requesters tagged in ICacheReq.thread
+  nextLinePrefetch: Boolean = false  // per-thread next-line prefetch on block crossings
 ) {
   def indexBits = log2Ceil(capacityBytes / blockBytes)
   def offsetBits = log2Ceil(blockBytes)
   def tagBits = addrWidth - indexBits - offsetBits
   def lines = capacityBytes / blockBytes
+  def blockAddrBits = addrWidth - offsetBits
+  def threadBits = log2Ceil(threads) max 1
 }
 
-class ICacheReq(val addrWidth: Int) extends Bundle {
+class ICacheReq(val addrWidth: Int, val threadBits: Int) extends Bundle {
   val addr = UInt(addrWidth.W)
+  val thread = UInt(threadBits.W)
 }
 
 class ICacheResp(val dataWidth: Int) extends Bundle {
@@ -32,9 +37,18 @@ class MemResp(val blockBytes: Int) extends Bundle {
   val data = UInt((blockBytes * 8).W)
 }
 
+// Free-running event counters. Prefetch accuracy is prefetchHits / prefetches and
+// coverage is prefetchHits / (prefetchHits + misses).
+class ICacheStats extends Bundle {
+  val accesses     = UInt(32.W) // demand requests accepted
+  val misses       = UInt(32.W) // demand refills sent to memory
+  val prefetches   = UInt(32.W) // prefetch refills sent to memory
+  val prefetchHits = UInt(32.W) // demand uses of a prefetched line, including late ones
+}
+
 class ICacheIO(val params: CacheParams) extends Bundle {
   val cpu = new Bundle {
-    val req = Flipped(Decoupled(new ICacheReq(params.addrWidth)))
+    val req = Flipped(Decoupled(new ICacheReq(params.addrWidth, params.threadBits)))
     val resp = Valid(new ICacheResp(params.dataWidth))
   }
   
@@ -42,6 +56,8 @@ class ICacheIO(val params: CacheParams) extends Bundle {
     val req = Decoupled(new MemReq(params.addrWidth))
     val resp = Flipped(Decoupled(new MemResp(params.blockBytes)))
   }
+
+  val stats = Output(new ICacheStats)
 }
 
 class ICache(val params: CacheParams) extends Module {
@@ -133,6 +149,31 @@ class ICache(val params: CacheParams) extends Module {
   io.mem.req.bits.burst := false.B
   io.mem.resp.ready := false.B
 
+  val demandBlock = Cat(tagReg, indexReg)
+
+  // Event counters
+  val accessCount = RegInit(0.U(32.W))
+  val missCount = RegInit(0.U(32.W))
+  val prefetchCount = RegInit(0.U(32.W))
+  val prefetchHitCount = RegInit(0.U(32.W))
+  io.stats.accesses := accessCount
+  io.stats.misses := missCount
+  io.stats.prefetches := prefetchCount
+  io.stats.prefetchHits := prefetchHitCount
+
+  when (canAcceptCpu && io.cpu.req.valid) {
+    accessCount := accessCount + 1.U
+  }
+
+  // Prefetcher handshake with the demand FSM; both stay idle without a prefetcher.
+  val prefetchBusy = WireDefault(false.B)   // a prefetch refill owns the memory port
+  val prefetchMerge = WireDefault(false.B)  // that refill brings in the demand miss's block
+
+  // Line fill, shared by demand and prefetch refills so the arrays keep one write port.
+  val fillEn = WireDefault(false.B)
+  val fillIndex = WireDefault(indexReg)
+  val fillTag = WireDefault(tagReg)
+
   switch(state) {
     is(sIdle) {
        when(!canAcceptCpu && !io.cpu.req.valid) {
@@ -153,21 +194,22 @@ class ICache(val params: CacheParams) extends Module {
        }
     }
     is(sRefill) {
-       val blockAddr = Cat(tagReg, indexReg, 0.U(params.offsetBits.W))
-       io.mem.req.valid := true.B
+       val blockAddr = Cat(demandBlock, 0.U(params.offsetBits.W))
+       io.mem.req.valid := !prefetchBusy
        io.mem.req.bits.addr := blockAddr
        io.mem.req.bits.burst := true.B
        
        when(io.mem.req.fire) {
+         missCount := missCount + 1.U
          state := sWaitResp
+       } .elsewhen(prefetchMerge) {
+         state := sReplay
        }
     }
     is(sWaitResp) {
        io.mem.resp.ready := true.B
        when(io.mem.resp.fire) {
-         tagArray.write(indexReg, tagReg)
-         dataArray.write(indexReg, io.mem.resp.bits.data)
-         validArray(indexReg) := true.B
+         fillEn := true.B
          state := sReplay
        }
     }
@@ -175,4 +217,114 @@ class ICache(val params: CacheParams) extends Module {
       // Transitions to sCompare via doRead block
     }
   }
+
+  // ***************************************************************************
+  // Next-line prefetcher
+  // ***************************************************************************
+  // Each thread's stream remembers the block it last fetched from. When a thread
+  // moves into a new block, the following block is queued for prefetch; the refill
+  // uses the memory port whenever no demand refill needs it (demand goes first,
+  // one request is outstanding at a time). A demand miss on the block a prefetch
+  // is already fetching waits for that refill instead of issuing its own.
+  if (params.nextLinePrefetch) {
+    val pfIdle :: pfReq :: pfWait :: Nil = Enum(3)
+    val pfState = RegInit(pfIdle)
+    val pfBlock = Reg(UInt(params.blockAddrBits.W))
+    val pfIndex = pfBlock(params.indexBits - 1, 0)
+
+    val streamBlock = RegInit(VecInit(Seq.fill(params.threads)(0.U(params.blockAddrBits.W))))
+    val streamPending = RegInit(VecInit(Seq.fill(params.threads)(false.B)))
+
+    // Register copy of the tags, so candidates are probed without a tagArray read port.
+    val tagShadow = Reg(Vec(params.lines, UInt(params.tagBits.W)))
+    // Lines brought in by a prefetch and not yet used by a demand request.
+    val prefetched = RegInit(VecInit(Seq.fill(params.lines)(false.B)))
+
+    def blockOf(addr: UInt) = addr(params.addrWidth - 1, params.offsetBits)
+    def isResident(block: UInt) = {
+      val index = block(params.indexBits - 1, 0)
+      validArray(index) && tagShadow(index) === block(params.blockAddrBits - 1, params.indexBits)
+    }
+
+    // Train on accepted requests
+    when (canAcceptCpu && io.cpu.req.valid) {
+      val thread = io.cpu.req.bits.thread
+      val block = blockOf(io.cpu.req.bits.addr)
+      when (block =/= streamBlock(thread)) {
+        streamBlock(thread) := block
+        streamPending(thread) := true.B
+      }
+    }
+
+    // Pick a stream to serve
+    val anyPending = streamPending.asUInt.orR
+    val pick = PriorityEncoder(streamPending.asUInt)
+    val candidate = streamBlock(pick) + 1.U
+    val demandOwnsPort = (state === sRefill) || (state === sWaitResp)
+
+    when (pfState === pfIdle && anyPending) {
+      when (isResident(candidate)) {
+        streamPending(pick) := false.B
+      } .elsewhen (!demandOwnsPort) {
+        streamPending(pick) := false.B
+        pfBlock := candidate
+        pfState := pfReq
+      }
+    }
+
+    when (pfState === pfReq) {
+      when (state === sRefill && io.mem.req.fire && demandBlock === pfBlock) {
+        // The demand refill is fetching this block already.
+        pfState := pfIdle
+      } .elsewhen (!demandOwnsPort) {
+        io.mem.req.valid := true.B
+        io.mem.req.bits.addr := Cat(pfBlock, 0.U(params.offsetBits.W))
+        io.mem.req.bits.burst := true.B
+        when (io.mem.req.fire) {
+          prefetchCount := prefetchCount + 1.U
+          pfState := pfWait
+        }
+      }
+    }
+
+    // Hold the fill while the demand side is reading or comparing the same line.
+    val fillBlocked = (doRead && memReadAddr === pfIndex) ||
+      (state === sCompare && indexReg === pfIndex)
+    prefetchBusy := pfState === pfWait
+
+    when (pfState === pfWait) {
+      io.mem.resp.ready := !fillBlocked
+      when (io.mem.resp.fire) {
+        fillEn := true.B
+        fillIndex := pfIndex
+        fillTag := pfBlock(params.blockAddrBits - 1, params.indexBits)
+        pfState := pfIdle
+
+        prefetchMerge := state === sRefill && demandBlock === pfBlock
+        prefetched(pfIndex) := !prefetchMerge
+        when (prefetchMerge) {
+          prefetchHitCount := prefetchHitCount + 1.U
+        }
+      }
+    }
+
+    when (fillEn) {
+      tagShadow(fillIndex) := fillTag
+    }
+    // Demand refills replace the line and its prefetched mark.
+    when (state === sWaitResp && io.mem.resp.fire) {
+      prefetched(indexReg) := false.B
+    }
+
+    when (io.cpu.resp.valid && prefetched(indexReg)) {
+      prefetched(indexReg) := false.B
+      prefetchHitCount := prefetchHitCount + 1.U
+    }
+  }
+
+  when (fillEn) {
+    tagArray.write(fillIndex, fillTag)
+    dataArray.write(fillIndex, io.mem.resp.bits.data)
+    validArray(fillIndex) := true.B
+  }
 }
@@ -6,9 +6,13 @@ import TileLink._
 
 /** Legacy memory interface bridged to a TileLink-UL master.
   * Keeps the passthrough SRAM-style signals usable while exposing TL for bus attach.
+  * Up to `outstanding` accesses may be in flight, one per source ID; with more than one,
+  * legacy.thread tags each access so a slow access from one barrel thread does not hold
+  * back the others. Accesses wait in a request queue of the same depth.
   */
-class OctoNyteMemPort(p: TLParams = TLParams()) extends Module {
+class OctoNyteMemPort(p: TLParams = TLParams(), outstanding: Int = 1) extends Module {
   require(p.beatBytes == 4, "OctoNyteMemPort assumes a 32-bit data path")
+  require(outstanding >= 1 && outstanding <= (1 << p.sourceBits), "outstanding must fit the TL source IDs")
   val io = IO(new Bundle {
     val legacy = new Bundle {
       val valid     = Input(Bool())
@@ -16,6 +20,8 @@ class OctoNyteMemPort(p: TLParams = TLParams()) extends Module {
       val writeData = Input(UInt(32.W))
       val writeMask = Input(UInt(4.W))
       val readData  = Output(UInt(32.W))
+      val ready     = Output(Bool()) // request queue has room; valid while low is dropped
+      val thread    = if (outstanding > 1) Some(Input(UInt(p.sourceBits.W))) else None
     }
 
     val passthroughMem = new Bundle {
@@ -25,6 +31,10 @@ class OctoNyteMemPort(p: TLParams = TLParams()) extends Module {
       val readData  = Input(UInt(32.W))
     }
 
+    // Every D beat, tagged with the source (thread) it answers.
+    val resp = Valid(new TLBundleD(p))
+    val inflight = Output(UInt(log2Ceil(outstanding + 1).W))
+
     val tl = new TLBundleUL(p)
   })
 
@@ -60,15 +70,39 @@ class OctoNyteMemPort(p: TLParams = TLParams()) extends Module {
     Mux(io.legacy.writeMask === Fill(p.beatBytes, 1.U(1.W)), TLOpcodesA.PutFullData, TLOpcodesA.PutPartialData),
     TLOpcodesA.Get)
 
-  io.tl.a.valid := io.legacy.valid
-  io.tl.a.bits.opcode := opcode
-  io.tl.a.bits.param := 0.U
-  io.tl.a.bits.size := size
-  io.tl.a.bits.source := 0.U
-  io.tl.a.bits.address := io.legacy.addr
-  io.tl.a.bits.mask := tlMask
-  io.tl.a.bits.data := io.legacy.writeData
-  io.tl.a.bits.corrupt := false.B
+  val reqQueue = Module(new Queue(new TLBundleA(p), outstanding, flow = true))
+  reqQueue.io.enq.valid := io.legacy.valid
+  reqQueue.io.enq.bits.opcode := opcode
+  reqQueue.io.enq.bits.param := 0.U
+  reqQueue.io.enq.bits.size := size
+  reqQueue.io.enq.bits.source := io.legacy.thread.getOrElse(0.U)
+  reqQueue.io.enq.bits.address := io.legacy.addr
+  reqQueue.io.enq.bits.mask := tlMask
+  reqQueue.io.enq.bits.data := io.legacy.writeData
+  reqQueue.io.enq.bits.corrupt := false.B
+  io.legacy.ready := reqQueue.io.enq.ready
+
+  // A source stays busy from its A beat to its D beat; TL allows one access per source.
+  val sourceBusy = RegInit(0.U((1 << p.sourceBits).W))
+  val inflight = RegInit(0.U(log2Ceil(outstanding + 1).W))
+  val head = reqQueue.io.deq.bits
+  val canIssue = inflight < outstanding.U && !sourceBusy(head.source)
 
+  io.tl.a.valid := reqQueue.io.deq.valid && canIssue
+  io.tl.a.bits := head
+  reqQueue.io.deq.ready := io.tl.a.ready && canIssue
   io.tl.d.ready := true.B
+
+  val issued = Mux(io.tl.a.fire, UIntToOH(head.source, 1 << p.sourceBits), 0.U)
+  val retired = Mux(io.tl.d.fire, UIntToOH(io.tl.d.bits.source, 1 << p.sourceBits), 0.U)
+  sourceBusy := (sourceBusy | issued) & ~retired
+  when(io.tl.a.fire && !io.tl.d.fire) {
+    inflight := inflight + 1.U
+  }.elsewhen(!io.tl.a.fire && io.tl.d.fire) {
+    inflight := inflight - 1.U
+  }
+  io.inflight := inflight
+
+  io.resp.valid := io.tl.d.fire
+  io.resp.bits := io.tl.d.bits
 }
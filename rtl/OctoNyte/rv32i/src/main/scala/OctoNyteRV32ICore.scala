@@ -5,11 +5,12 @@ import chisel3.util._
 import chisel3.dontTouch
 import ALUs.ALU32
 import Decoders.RV32IDecode
-import Pipeline.ThreadScheduler
+import Pipeline.{SchedulePolicy, ThreadScheduler}
 import BranchUnit.BranchUnit
 import LoadUnit.LoadUnit
 import StoreUnit.StoreUnit
 import RegFiles.RegFileMTMultiWVec
+import CSRs.PerfCounterCSRs
 
 
 // *********************************************************
@@ -19,7 +20,11 @@ class OctoNyteRV32ICoreIO(val numThreads: Int, val fetchWidth: Int) extends Bund
   private val threadBits = log2Ceil(numThreads)
 
   val threadEnable = Input(Vec(numThreads, Bool()))
-  val instrMem     = Input(UInt((fetchWidth * 32).W))
+  val fetchThread  = Output(UInt(threadBits.W)) // thread owning this cycle's fetch slot
+  val fetchValid   = Output(Bool())             // the slot has an owner (always, under fixed scheduling)
+  val instrMem     = Input(UInt((fetchWidth * 32).W))   // words at pc, pc+4, ... of the fetching thread
+  val fetchReq     = Output(Bool())   // instrMem is consumed this cycle
+  val fetchBufferHit = Output(Bool()) // the fetch was served from the thread's fetch buffer
   val dataMemResp  = Input(UInt(32.W))
   val memAddr      = Output(UInt(32.W))
   val memWrite     = Output(UInt(32.W))
@@ -106,11 +111,13 @@ class WritebackPipelineRegs(threadBits: Int) extends Bundle {
 // *********************************************************
 // OctoNyte RV32I Core Definition
 // *********************************************************
-class OctoNyteRV32ICore extends Module {
+class OctoNyteRV32ICore(val fetchWords: Int = 4, val schedule: SchedulePolicy = SchedulePolicy.Fixed) extends Module {
   val numThreads = 8
   // Keep this aligned with OctoNyte tests, which drive a 4-wide (128b) instruction packet.
-  // The core currently only consumes slot 0 (`instrMem(31,0)`), so the extra slots are ignored.
+  // A fetch that misses the thread's fetch buffer consumes `fetchWords` lanes of the packet:
+  // slot 0 issues and the rest are kept for the thread's next sequential fetches.
   val fetchWidth = 4
+  require(fetchWords >= 1 && fetchWords <= fetchWidth, s"fetchWords must be 1..$fetchWidth")
   val regFileReadPorts = 2 * fetchWidth
   val regFileWritePorts = fetchWidth
   val io = IO(new OctoNyteRV32ICoreIO(numThreads, fetchWidth))
@@ -160,15 +167,18 @@ class OctoNyteRV32ICore extends Module {
 
   // ================================================
 
-  
-  val threadCounter = RegInit(0.U(threadBits.W))
-
-  val curThread = threadCounter
-  val nextThread =
-    Mux(curThread === (numThreads - 1).U, 0.U, curThread + 1.U)
+  // Fixed scheduling gives every thread every eighth slot. Dynamic scheduling gives slots
+  // only to enabled threads, no closer than reissueCycles apart: a fetch in cycle c
+  // writes back in c+8, and the thread's next fetch must read registers after that
+  // (3 cycles after fetch) and see the pc its EX1 redirect sets in c+5.
+  private val reissueCycles = 6
+  val scheduler = Module(new ThreadScheduler(numThreads, 0, schedule, reissueCycles))
+  scheduler.io.ready := io.threadEnable
 
-  // ALWAYS advance
-  threadCounter := nextThread
+  val curThread = scheduler.io.currentThread
+  val fetchEnable = scheduler.io.currentValid && io.threadEnable(curThread)
+  io.fetchThread := curThread
+  io.fetchValid := scheduler.io.currentValid
 
   
   // Default IO outputs 
@@ -244,6 +254,10 @@ class OctoNyteRV32ICore extends Module {
   storeUnit.io.data := 0.U
   storeUnit.io.storeType := 0.U
 
+  // Counter CSRs (per-thread, accessed in EX1)
+  val csrs = Module(new PerfCounterCSRs(numThreads))
+  csrs.io.access := 0.U.asTypeOf(csrs.io.access)
+
 
 // =============================
 // Fetch stage
@@ -251,11 +265,37 @@ class OctoNyteRV32ICore extends Module {
 
 // Single fetch pipeline register
   val fetchReg = RegInit(0.U.asTypeOf(new FetchPipelineRegs(threadBits)))
-  when (io.threadEnable(curThread)) {
+
+  // Per-thread fetch buffer: the words after slot 0 of the thread's last packet, i.e. the
+  // instructions at bufBase + 4 onwards. A fetch whose pc falls inside it needs no packet.
+  private val bufDepth = (fetchWords - 1) max 1
+  val bufValid = RegInit(VecInit(Seq.fill(numThreads)(false.B)))
+  val bufBase  = Reg(Vec(numThreads, UInt(32.W)))
+  val bufWords = Reg(Vec(numThreads, Vec(bufDepth, UInt(32.W))))
+
+  val fetchPc   = pcRegs(curThread)
+  val bufOffset = (fetchPc - bufBase(curThread))(31, 2)
+  val bufHit = (fetchWords > 1).B && bufValid(curThread) && fetchPc(1, 0) === 0.U &&
+    bufOffset =/= 0.U && bufOffset < fetchWords.U
+  val bufInstr = bufWords(curThread)((bufOffset - 1.U)(log2Ceil(bufDepth + 1) - 1, 0))
+  val bufFill = fetchEnable && !bufHit && (fetchWords > 1).B
+
+  io.fetchReq := fetchEnable && !bufHit
+  io.fetchBufferHit := fetchEnable && bufHit
+
+  when (fetchEnable) {
     fetchReg.valid    := true.B
     fetchReg.threadId := curThread
-    fetchReg.pc       := pcRegs(curThread)
-    fetchReg.instr    := io.instrMem(31, 0)
+    fetchReg.pc       := fetchPc
+    fetchReg.instr    := Mux(bufHit, bufInstr, io.instrMem(31, 0))
+
+    when (bufFill) {
+      bufValid(curThread) := true.B
+      bufBase(curThread)  := fetchPc
+      for (w <- 1 until fetchWords) {
+        bufWords(curThread)(w - 1) := io.instrMem(32 * w + 31, 32 * w)
+      }
+    }
 
     pcRegs(curThread) := pcRegs(curThread) + 4.U
   } .otherwise {
@@ -424,6 +464,19 @@ when (dispatchReg.decodePipelineSignals.fetchSignals.valid) {
     io.memMisaligned := io.threadEnable(fetchSignals.threadId) && storeUnit.io.misaligned
   }
 
+  // ---- Zicsr (counter CSRs) ----
+  .elsewhen (PerfCounterCSRs.isCsrInstr(fetchSignals.instr)) {
+    csrs.io.access.valid := io.threadEnable(fetchSignals.threadId)
+    csrs.io.access.hart := fetchSignals.threadId
+    csrs.io.access.addr := fetchSignals.instr(31, 20)
+    csrs.io.access.cmd := fetchSignals.instr(13, 12)
+    csrs.io.access.wen := PerfCounterCSRs.writesCsr(fetchSignals.instr)
+    csrs.io.access.wdata := PerfCounterCSRs.operand(fetchSignals.instr, regReadReg.rs1Data)
+
+    exec1Reg.result := csrs.io.rdata
+    exec1Reg.doRegFileWrite := true.B
+  }
+
   } .otherwise {
     exec1Reg
       .regReadSignals
@@ -523,14 +576,20 @@ val ex1Fetch =
   exec1Reg.regReadSignals.dispatchSignals.decodePipelineSignals.fetchSignals
 val ex1Redirect = ex1Fetch.valid && exec1Reg.ctrlTaken
 
-// Resolve control flow in EX1 and squash younger work so taken redirects do not replay.
+// Resolve control flow in EX1 and squash the thread's younger work so taken redirects do
+// not replay. Other threads' instructions in those stages are unaffected.
 when (ex1Redirect) {
-  pcRegs(ex1Fetch.threadId) := exec1Reg.ctrlTarget
+  val tid = ex1Fetch.threadId
+  pcRegs(tid) := exec1Reg.ctrlTarget
 
-  fetchReg.valid := false.B
-  decodeReg.fetchSignals.valid := false.B
-  dispatchReg.decodePipelineSignals.fetchSignals.valid := false.B
-  regReadReg.dispatchSignals.decodePipelineSignals.fetchSignals.valid := false.B
+  when (curThread === tid) { fetchReg.valid := false.B }
+  when (fetchReg.threadId === tid) { decodeReg.fetchSignals.valid := false.B }
+  when (decodeReg.fetchSignals.threadId === tid) {
+    dispatchReg.decodePipelineSignals.fetchSignals.valid := false.B
+  }
+  when (dispatchReg.decodePipelineSignals.fetchSignals.threadId === tid) {
+    regReadReg.dispatchSignals.decodePipelineSignals.fetchSignals.valid := false.B
+  }
 }
 
 when (wbFetch.valid &&
@@ -548,6 +607,29 @@ when (wbFetch.valid && wbExec.doRegFileWrite && wbDecode.rd === 0.U) {
   regFile.io.wen(0) := false.B
 }
 
+// -----------------------------
+// Fetch buffer coherence
+// -----------------------------
+// A store into a buffered word drops that thread's buffer so the next fetch re-reads memory.
+// The packet filling a buffer this cycle was read before the store, so it is checked too.
+for (t <- 0 until numThreads) {
+  val base = Mux(bufFill && curThread === t.U, fetchPc, bufBase(t))
+  val storeOffset = (io.memAddr - base)(31, 2)
+  when (io.memMask =/= 0.U && storeOffset =/= 0.U && storeOffset < fetchWords.U) {
+    bufValid(t) := false.B
+  }
+}
+
+// -----------------
+// Counter events
+// -----------------
+for (t <- 0 until numThreads) {
+  csrs.io.retire(t) := wbFetch.valid && wbFetch.threadId === t.U
+  csrs.io.events(t)(0) := false.B
+  csrs.io.events(t)(1) := ex1Redirect && ex1Fetch.threadId === t.U
+  csrs.io.events(t)(2) := curThread === t.U && !fetchEnable
+}
+
 // -----------------
 // Debug control (single-lane)
 // -----------------
@@ -63,8 +63,9 @@ class OctoNyteRV32ICoreWithCacheIO(val numThreads: Int, val fetchWidth: Int) ext
 // *********************************************************
 // OctoNyte RV32I Core with Cache Definition
 // *********************************************************
-class OctoNyteRV32ICoreWithCache extends Module {
+class OctoNyteRV32ICoreWithCache(cacheParams: CacheParams = CacheParams(threads = 8)) extends Module {
   val numThreads = 8
+  require(cacheParams.threads == numThreads, "cacheParams.threads must match numThreads")
   // Keep this aligned with OctoNyte tests, which drive a 4-wide (128b) instruction packet.
   // The core currently only consumes slot 0 (`instrMem(31,0)`), so the extra slots are ignored.
   val fetchWidth = 4
@@ -144,12 +145,13 @@ class OctoNyteRV32ICoreWithCache extends Module {
   // ***********************************************************************************
   // Instruction Cache
   // ***********************************************************************************
-  val icache = Module(new ICache(CacheParams()))
+  val icache = Module(new ICache(cacheParams))
   io.mem <> icache.io.mem
   
   // Send Next Thread's PC to Cache (Pipelining Fetch)
   icache.io.cpu.req.valid := io.threadEnable(nextThread)
   icache.io.cpu.req.bits.addr := pcRegs(nextThread)
+  icache.io.cpu.req.bits.thread := nextThread
   
   // Stall/Pipeline Logic
   // If Cache is not ready (miss/busy), we must stall everything.
@@ -0,0 +1,70 @@
+package OctoNyte
+
+import chisel3._
+import chisel3.util._
+import TileLink._
+
+/** ICache refill port (MemReq/MemResp) bridged to a TileLink master.
+  * With burst = true a block is fetched by one multibeat Get (TL-UH style) and the
+  * downstream bridge turns it into an AXI4 or AHB burst; otherwise one single-beat
+  * Get is issued per word, each waiting for its AccessAckData.
+  */
+class OctoNyteRefillPort(blockBytes: Int = 64, p: TLParams = TLParams(), burst: Boolean = false) extends Module {
+  require(isPow2(blockBytes) && blockBytes >= p.beatBytes, "blockBytes must be a power of two of at least one beat")
+  private val beats = blockBytes / p.beatBytes
+  require(!burst || p.maxBurstBeats >= beats, "burst refills need TLParams.maxBurstBeats >= blockBytes / beatBytes")
+
+  val io = IO(new Bundle {
+    val mem = new Bundle {
+      val req = Flipped(Decoupled(new MemReq(p.addrBits)))
+      val resp = Decoupled(new MemResp(blockBytes))
+    }
+    val tl = new TLBundleUL(p)
+  })
+
+  val sIdle :: sGet :: sData :: sResp :: Nil = Enum(4)
+  val state = RegInit(sIdle)
+
+  val blockAddr = RegInit(0.U(p.addrBits.W))
+  val words = Reg(Vec(beats, UInt(p.dataBits.W)))
+  val beat = RegInit(0.U(log2Ceil(beats + 1).W))
+
+  io.mem.req.ready := state === sIdle
+  io.mem.resp.valid := state === sResp
+  io.mem.resp.bits.data := words.asUInt
+
+  io.tl.a.valid := state === sGet
+  io.tl.a.bits.opcode := TLOpcodesA.Get
+  io.tl.a.bits.param := 0.U
+  io.tl.a.bits.size := (if (burst) log2Ceil(blockBytes) else log2Ceil(p.beatBytes)).U
+  io.tl.a.bits.source := 0.U
+  io.tl.a.bits.address := (if (burst) blockAddr else blockAddr + (beat << log2Ceil(p.beatBytes)))
+  io.tl.a.bits.mask := Fill(p.beatBytes, 1.U(1.W))
+  io.tl.a.bits.data := 0.U
+  io.tl.a.bits.corrupt := false.B
+  io.tl.d.ready := state === sData
+
+  when(state === sIdle && io.mem.req.fire) {
+    blockAddr := io.mem.req.bits.addr
+    beat := 0.U
+    state := sGet
+  }
+
+  when(state === sGet && io.tl.a.fire) {
+    state := sData
+  }
+
+  when(state === sData && io.tl.d.fire) {
+    words(beat) := io.tl.d.bits.data
+    beat := beat + 1.U
+    when(beat === (beats - 1).U) {
+      state := sResp
+    }.elsewhen(!burst.B) {
+      state := sGet
+    }
+  }
+
+  when(state === sResp && io.mem.resp.fire) {
+    state := sIdle
+  }
+}
@@ -90,4 +90,90 @@ class ICacheTest extends AnyFlatSpec {
       assert(respData2 == 0x99AABBCCL)
     }
   }
+
+  // Two threads fetch interleaved sequential streams from a memory that answers each
+  // block request after `latency` cycles; every word holds its own address.
+  private def runStreams(params: CacheParams, latency: Int = 4, words: Int = 32): (Int, Map[String, BigInt]) = {
+    var result = (0, Map.empty[String, BigInt])
+    simulate(new ICache(params)) { dut =>
+      dut.io.cpu.req.valid.poke(false.B)
+      dut.io.mem.req.ready.poke(false.B)
+      dut.io.mem.resp.valid.poke(false.B)
+      dut.reset.poke(true.B)
+      dut.clock.step()
+      dut.reset.poke(false.B)
+
+      val pcs = Array(0x000, 0x080)
+      val issued = Array(0, 0)
+      var turn = 0
+      val expected = scala.collection.mutable.Queue[Int]()
+      var received = 0
+      var memAddr = 0
+      var memBusy = false
+      var memCountdown = 0
+      var cycles = 0
+
+      while (received < 2 * words && cycles < 2000) {
+        val cpuValid = issued(turn) < words
+        dut.io.cpu.req.valid.poke(cpuValid.B)
+        dut.io.cpu.req.bits.addr.poke(pcs(turn).U)
+        dut.io.cpu.req.bits.thread.poke(turn.U)
+
+        val respReady = memBusy && memCountdown == 0
+        dut.io.mem.req.ready.poke((!memBusy).B)
+        dut.io.mem.resp.valid.poke(respReady.B)
+        val block = (0 until params.blockBytes / 4).map(w => BigInt(memAddr + 4 * w) << (32 * w)).sum
+        dut.io.mem.resp.bits.data.poke(block.U)
+
+        if (dut.io.cpu.resp.valid.peek().litToBoolean) {
+          assert(expected.nonEmpty, "response without a request")
+          assert(dut.io.cpu.resp.bits.data.peek().litValue == expected.dequeue())
+          received += 1
+        }
+        if (cpuValid && dut.io.cpu.req.ready.peek().litToBoolean) {
+          expected.enqueue(pcs(turn))
+          pcs(turn) += 4
+          issued(turn) += 1
+          turn = 1 - turn
+        }
+        if (memBusy) {
+          if (respReady && dut.io.mem.resp.ready.peek().litToBoolean) memBusy = false
+          else memCountdown = (memCountdown - 1).max(0)
+        } else if (dut.io.mem.req.valid.peek().litToBoolean) {
+          memAddr = dut.io.mem.req.bits.addr.peek().litValue.toInt
+          memBusy = true
+          memCountdown = latency
+        }
+        dut.clock.step()
+        cycles += 1
+      }
+      assert(received == 2 * words, s"only $received of ${2 * words} fetches completed")
+
+      val stats = dut.io.stats
+      result = (cycles, Map(
+        "accesses" -> stats.accesses.peek().litValue,
+        "misses" -> stats.misses.peek().litValue,
+        "prefetches" -> stats.prefetches.peek().litValue,
+        "prefetchHits" -> stats.prefetchHits.peek().litValue))
+    }
+    result
+  }
+
+  it should "prefetch each thread's next line and cut demand misses" in {
+    val base = CacheParams(capacityBytes = 256, blockBytes = 16, threads = 2)
+    val (demandCycles, demand) = runStreams(base)
+    val (prefetchCycles, prefetch) = runStreams(base.copy(nextLinePrefetch = true))
+
+    // 2 x 32 words over 16-byte blocks: 16 blocks, each a demand miss without prefetch.
+    assert(demand("accesses") == 64 && prefetch("accesses") == 64)
+    assert(demand("misses") == 16)
+    assert(demand("prefetches") == 0 && demand("prefetchHits") == 0)
+
+    assert(prefetch("prefetches") > 0)
+    assert(prefetch("prefetchHits") > 0)
+    assert(prefetch("prefetchHits") <= prefetch("prefetches"))
+    assert(prefetch("misses") < demand("misses"),
+      s"misses with prefetch ${prefetch("misses")} vs ${demand("misses")} without")
+    assert(prefetchCycles < demandCycles, s"$prefetchCycles cycles with prefetch vs $demandCycles without")
+  }
 }
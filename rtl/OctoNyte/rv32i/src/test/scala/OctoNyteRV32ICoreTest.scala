@@ -4,6 +4,7 @@ import chisel3._
 import chisel3.simulator.EphemeralSimulator._
 import org.scalatest.flatspec.AnyFlatSpec
 import org.slf4j.LoggerFactory
+import Pipeline.SchedulePolicy
 
 class OctoNyteRV32ICoreTest extends AnyFlatSpec {
   behavior of "OctoNyteRV32ICore"
@@ -47,7 +48,7 @@ class OctoNyteRV32ICoreTest extends AnyFlatSpec {
       dut.clock.step(2)
       dut.reset.poke(false.B)
 
-      // Only slot 0 is consumed by the core; fill the rest with NOPs.
+      // Slot 0 holds the ADDI; the NOPs in the other slots fill each thread's fetch buffer.
       val singleAddiPacket = BigInt("00000013000000130000001300100093", 16).U(128.W)
       val debugCycles = 32
       val totalCycles = 80
@@ -98,4 +99,81 @@ class OctoNyteRV32ICoreTest extends AnyFlatSpec {
       assert(values.forall(_ >= 1), s"Each thread should increment x1 at least once: $values")
     }
   }
+
+  it should "issue the sequential packet slots from the per-thread fetch buffer" in {
+    logger.info("Test: Stream a packet of four different ADDIs. Each thread should execute all four, reading a new packet only on every fourth fetch.")
+    simulate(new OctoNyteRV32ICore) { dut =>
+      for (i <- 0 until 8) { dut.io.threadEnable(i).poke(true.B) }
+      dut.io.dataMemResp.poke(0.U)
+
+      dut.reset.poke(true.B)
+      dut.clock.step(2)
+      dut.reset.poke(false.B)
+
+      // Slots from low to high: ADDI x1,x0,1  ADDI x2,x0,2  ADDI x3,x0,3  ADDI x4,x0,4
+      val packet = BigInt("00400213003001930020011300100093", 16).U(128.W)
+      val totalCycles = 80
+      var reads = 0
+      var hits = 0
+      for (c <- 0 until totalCycles) {
+        dut.io.instrMem.poke(packet)
+        if (dut.io.fetchReq.peek().litToBoolean) reads += 1
+        if (dut.io.fetchBufferHit.peek().litToBoolean) hits += 1
+        dut.clock.step()
+      }
+
+      // Ten fetches per thread: packets at the 1st, 5th and 9th, the buffer serves the rest.
+      assert(reads == 8 * 3, s"Expected 24 packet reads, got $reads")
+      assert(hits == totalCycles - reads, s"Expected ${totalCycles - reads} buffer hits, got $hits")
+      for (t <- 0 until 8; r <- 1 to 4) {
+        val value = dut.io.debugRegs01234(t)(r).peek().litValue
+        assert(value == r, s"Thread $t x$r mismatch: got $value expected $r")
+      }
+    }
+  }
+
+  // Only thread 0 runs a stream of dependent ADDI x1,x1,1; returns its fetch count and final x1.
+  private def runSingleThread(schedule: SchedulePolicy, cycles: Int): (Int, BigInt) = {
+    var fetches = 0
+    var x1 = BigInt(0)
+    simulate(new OctoNyteRV32ICore(schedule = schedule)) { dut =>
+      for (i <- 0 until 8) { dut.io.threadEnable(i).poke((i == 0).B) }
+      dut.io.dataMemResp.poke(0.U)
+
+      dut.reset.poke(true.B)
+      dut.clock.step(2)
+      dut.reset.poke(false.B)
+
+      val accumPacket = BigInt("00108093001080930010809300108093", 16).U(128.W)
+      for (c <- 0 until cycles) {
+        dut.io.instrMem.poke(accumPacket)
+        val fetched = dut.io.fetchReq.peek().litToBoolean || dut.io.fetchBufferHit.peek().litToBoolean
+        if (fetched) {
+          dut.io.fetchThread.expect(0.U)
+          dut.io.fetchValid.expect(true.B)
+          fetches += 1
+        }
+        dut.clock.step()
+      }
+      // Stop fetching and drain the pipeline.
+      dut.io.threadEnable(0).poke(false.B)
+      dut.clock.step(10)
+      x1 = dut.io.debugRegs01234(0)(1).peek().litValue
+    }
+    (fetches, x1)
+  }
+
+  it should "give a lone thread only its own slots under dynamic scheduling" in {
+    val cycles = 96
+    val (fixedFetches, fixedX1) = runSingleThread(SchedulePolicy.Fixed, cycles)
+    val (dynamicFetches, dynamicX1) = runSingleThread(SchedulePolicy.Dynamic, cycles)
+    logger.info(s"Single thread over $cycles cycles: fixed $fixedFetches fetches, dynamic $dynamicFetches")
+
+    // Every fetched ADDI depends on the one before it, so each must see its predecessor's result.
+    assert(fixedX1 == fixedFetches, s"fixed: x1=$fixedX1 after $fixedFetches fetches")
+    assert(dynamicX1 == dynamicFetches, s"dynamic: x1=$dynamicX1 after $dynamicFetches fetches")
+    assert(fixedFetches == cycles / 8, s"fixed: expected ${cycles / 8} fetches, got $fixedFetches")
+    // One fetch every six cycles once the first slot is picked.
+    assert(dynamicFetches >= cycles / 6 - 1, s"dynamic: expected about ${cycles / 6} fetches, got $dynamicFetches")
+  }
 }
@@ -0,0 +1,120 @@
+package OctoNyte
+
+import chisel3._
+import chisel3.util._
+import chisel3.simulator.EphemeralSimulator._
+import org.scalatest.flatspec.AnyFlatSpec
+import org.slf4j.LoggerFactory
+import AHB.AHBLiteRAM
+import AXI4.AXI4RAM
+import Bridges.{TLToAHBLite, TLToAXI4}
+import TileLink._
+
+class OctoNyteRefillBurstTest extends AnyFlatSpec {
+  private val logger = LoggerFactory.getLogger(getClass)
+
+  private val blockBytes = 32
+  private val words = blockBytes / 4
+
+  // Refill port plus a preload port that writes words with PutFullData; acks for the
+  // preload writes are dropped, AccessAckData beats go to the refill port.
+  class Harness(bus: String, burst: Boolean) extends Module {
+    private val p = TLParams(maxBurstBeats = if (burst) words else 1)
+    val io = IO(new Bundle {
+      val preload = Flipped(Decoupled(new Bundle {
+        val addr = UInt(32.W)
+        val data = UInt(32.W)
+      }))
+      val req = Flipped(Decoupled(new MemReq(32)))
+      val resp = Decoupled(new MemResp(blockBytes))
+    })
+
+    val refill = Module(new OctoNyteRefillPort(blockBytes, p, burst))
+    refill.io.mem.req <> io.req
+    io.resp <> refill.io.mem.resp
+
+    val tl = Wire(new TLBundleUL(p))
+    if (bus == "ahb") {
+      val bridge = Module(new TLToAHBLite(tlParams = p, burst = burst))
+      val ram = Module(new AHBLiteRAM())
+      bridge.io.tl <> tl
+      ram.io.ahb <> bridge.io.ahb
+    } else {
+      val bridge = Module(new TLToAXI4(p))
+      val ram = Module(new AXI4RAM())
+      bridge.io.tl <> tl
+      ram.io.axi <> bridge.io.axi
+    }
+
+    tl.a.valid := io.preload.valid || refill.io.tl.a.valid
+    tl.a.bits := refill.io.tl.a.bits
+    when(io.preload.valid) {
+      tl.a.bits.opcode := TLOpcodesA.PutFullData
+      tl.a.bits.size := 2.U
+      tl.a.bits.address := io.preload.bits.addr
+      tl.a.bits.mask := "b1111".U
+      tl.a.bits.data := io.preload.bits.data
+    }
+    io.preload.ready := tl.a.ready
+    refill.io.tl.a.ready := tl.a.ready && !io.preload.valid
+
+    val isData = tl.d.bits.opcode === TLOpcodesD.AccessAckData
+    refill.io.tl.d.valid := tl.d.valid && isData
+    refill.io.tl.d.bits := tl.d.bits
+    tl.d.ready := !isData || refill.io.tl.d.ready
+  }
+
+  // Returns the cycles from refill request to block response.
+  private def refill(bus: String, burst: Boolean): Int = {
+    var cycles = 0
+    simulate(new Harness(bus, burst)) { dut =>
+      dut.io.req.valid.poke(false.B)
+      dut.io.resp.ready.poke(false.B)
+      dut.io.preload.valid.poke(false.B)
+      dut.reset.poke(true.B)
+      dut.clock.step()
+      dut.reset.poke(false.B)
+
+      val base = 0x40
+      for (w <- 0 until words) {
+        dut.io.preload.valid.poke(true.B)
+        dut.io.preload.bits.addr.poke((base + 4 * w).U)
+        dut.io.preload.bits.data.poke((0x1000 + w).U)
+        while (!dut.io.preload.ready.peek().litToBoolean) dut.clock.step()
+        dut.clock.step()
+      }
+      dut.io.preload.valid.poke(false.B)
+      dut.clock.step(8)
+
+      dut.io.req.valid.poke(true.B)
+      dut.io.req.bits.addr.poke(base.U)
+      dut.io.req.bits.burst.poke(true.B)
+      dut.io.resp.ready.poke(true.B)
+      while (!dut.io.req.ready.peek().litToBoolean) dut.clock.step()
+      dut.clock.step()
+      dut.io.req.valid.poke(false.B)
+      cycles = 1
+      while (!dut.io.resp.valid.peek().litToBoolean && cycles < 200) {
+        dut.clock.step()
+        cycles += 1
+      }
+      assert(dut.io.resp.valid.peek().litToBoolean, s"$bus refill did not complete")
+      val block = dut.io.resp.bits.data.peek().litValue
+      for (w <- 0 until words) {
+        val word = (block >> (32 * w)) & 0xffffffffL
+        assert(word == 0x1000 + w, f"$bus word $w: got 0x$word%x")
+      }
+    }
+    cycles
+  }
+
+  for (bus <- Seq("ahb", "axi")) {
+    "OctoNyteRefillPort over " + bus should "refill a block with one burst in fewer cycles than per-word Gets" in {
+      val single = refill(bus, burst = false)
+      val burst = refill(bus, burst = true)
+      logger.info(s"$bus refill of $words words: $single cycles single-beat, $burst cycles burst")
+      assert(burst < single, s"burst refill took $burst cycles vs $single single-beat")
+      assert(burst <= words + 6, s"burst refill took $burst cycles for $words beats")
+    }
+  }
+}
@@ -5,6 +5,7 @@ import chisel3.util._
 import chisel3.dontTouch
 import ALUs._
 import BranchUnit._
+import CSRs.PerfCounterCSRs
 import Decoders._
 import LoadUnit._
 import StoreUnit._
@@ -63,7 +64,7 @@ class TetraNyteRV32ICoreIO(val numThreads: Int) extends Bundle {
   val ctrlIsBranch = Output(Bool())
 }
 
-class TetraNyteRV32ICore extends Module {
+class TetraNyteRV32ICore(mulDiv: MulDivConfig = new MulDivConfig) extends Module {
   val numThreads = 4
   val io = IO(new TetraNyteRV32ICoreIO(numThreads))
 
@@ -74,7 +75,7 @@ class TetraNyteRV32ICore extends Module {
   val flushThread = RegInit(VecInit(Seq.fill(numThreads)(false.B)))
 
   // Long-latency division bookkeeping (global stall while active to keep hazards simple)
-  val divider = Module(new Div32Radix4)
+  val divider = Module(mulDiv.divider())
   val divActive = RegInit(false.B)
   val divThread = Reg(UInt(log2Ceil(numThreads).W))
   val divRd = Reg(UInt(5.W))
@@ -234,6 +235,9 @@ class TetraNyteRV32ICore extends Module {
   val isMulInstr = isMExt && (funct3 <= "b011".U)
   val isDivInstr = isMExt && (funct3 >= "b100".U)
 
+  // The product is written back from EX/MEM a cycle after EX, with no slot
+  // to hold it longer, so only the divider is configurable here.
+  require(mulDiv.mulStages == 1, "TetraNyteRV32ICore needs a single-cycle multiplier")
   val mulUnit = Module(new Mul32OneCycle)
   val mulSignedA = WireDefault(true.B)
   val mulSignedB = WireDefault(true.B)
@@ -282,11 +286,21 @@ class TetraNyteRV32ICore extends Module {
       divider.io.remainder)
   }
 
-  ex_mem.aluResult := Mux(isMulInstr, mulResult, alu.io.result)
+  // ---------- Counter CSRs (per-thread, read/modified in EX) ----------
+  val isCsrInstr = id_ex.valid && PerfCounterCSRs.isCsrInstr(instr)
+  val csrs = Module(new PerfCounterCSRs(numThreads))
+  csrs.io.access.valid := isCsrInstr && io.threadEnable(id_ex.threadId)
+  csrs.io.access.hart := id_ex.threadId
+  csrs.io.access.addr := instr(31, 20)
+  csrs.io.access.cmd := funct3(1, 0)
+  csrs.io.access.wen := PerfCounterCSRs.writesCsr(instr)
+  csrs.io.access.wdata := PerfCounterCSRs.operand(instr, id_ex.rs1Data)
+
+  ex_mem.aluResult := Mux(isCsrInstr, csrs.io.rdata, Mux(isMulInstr, mulResult, alu.io.result))
   ex_mem.instr := id_ex.instr
   ex_mem.threadId := id_ex.threadId
   ex_mem.rd := id_ex.rd
-  ex_mem.isALU := id_ex.isALU || isMulInstr
+  ex_mem.isALU := id_ex.isALU || isMulInstr || isCsrInstr
   ex_mem.isLoad := id_ex.isLoad
   ex_mem.isStore := id_ex.isStore
   ex_mem.isBranch := id_ex.isBranch
@@ -447,6 +461,17 @@ class TetraNyteRV32ICore extends Module {
     flushThread := flushResetVec
   }
 
+  // ===================== Counter Events =====================
+  for (t <- 0 until numThreads) {
+    val exRetire = ex_mem.valid && ex_mem.threadId === t.U && io.threadEnable(t)
+    csrs.io.retire(t) := exRetire || (divWrite && divThread === t.U)
+    csrs.io.events(t)(0) := false.B
+    csrs.io.events(t)(1) := (branchTakenEx || jalTakenEx || jalrTakenEx) &&
+      id_ex.threadId === t.U && io.threadEnable(t)
+    // The fetch slot went to thread t but no instruction entered the pipeline.
+    csrs.io.events(t)(2) := currentThread === t.U && !(threadEnabled && !flushThisThread)
+  }
+
   // ===================== Expose Pipeline State =====================
   io.if_pc := pcRegs
   io.if_instr := debugIfInstr
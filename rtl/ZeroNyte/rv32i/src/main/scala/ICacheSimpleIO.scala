@@ -2,10 +2,30 @@ package ZeroNyte
 
 import chisel3._
 import chisel3.util._
+import chisel3.util.random.LFSR
 import Decoders.RV32IDecode
 import ALUs.ALU32
 
-class ICacheSimpleConfig(val cacheBytes: Int, val blockBytes: Int, val ways: Int)
+// Victim choice once every way of the set is valid (invalid ways always fill first).
+sealed trait ICacheReplacement
+object ICacheReplacement {
+  case object LRU extends ICacheReplacement        // oldest access time, a 32-bit stamp per way
+  case object Random extends ICacheReplacement     // 16-bit LFSR, advanced on each fill
+  case object RoundRobin extends ICacheReplacement // per-set pointer, advanced on each fill
+  case object TreePLRU extends ICacheReplacement   // ways-1 tree bits per set
+
+  def apply(name: String): ICacheReplacement = name match {
+    case "lru"         => LRU
+    case "random"      => Random
+    case "round-robin" => RoundRobin
+    case "plru"        => TreePLRU
+    case other => throw new IllegalArgumentException(
+      s"unknown I-cache replacement $other (expected lru, random, round-robin or plru)")
+  }
+}
+
+class ICacheSimpleConfig(val cacheBytes: Int, val blockBytes: Int, val ways: Int,
+                         val replacement: ICacheReplacement = ICacheReplacement.LRU)
 
 class ICacheSimpleIO extends Bundle {
   // CPU side
@@ -14,6 +34,8 @@ class ICacheSimpleIO extends Bundle {
   val instr     = Output(UInt(32.W))
   val instr_valid = Output(Bool())
   val stall     = Output(Bool())
+  val hit       = Output(Bool())  // request from idle hit the tags this cycle
+  val miss      = Output(Bool())  // request from idle missed the tags this cycle
 
   // Memory side (same as your imem)
   val mem_addr  = Output(UInt(32.W))
@@ -27,12 +49,15 @@ class ICacheSimple(cfg: ICacheSimpleConfig) extends Module {
   // Derived parameters
   require(cfg.blockBytes >= 4 && (cfg.blockBytes & (cfg.blockBytes - 1)) == 0, "blockBytes must be power of two")
   require(cfg.cacheBytes % (cfg.blockBytes * cfg.ways) == 0, "cacheBytes must be divisible by blockBytes*ways")
+  require(cfg.replacement == ICacheReplacement.LRU || cfg.replacement == ICacheReplacement.RoundRobin ||
+    isPow2(cfg.ways), "random and plru replacement need a power-of-two number of ways")
 
   val sets = cfg.cacheBytes / (cfg.blockBytes * cfg.ways)
   val offBits = log2Ceil(cfg.blockBytes)
   val idxBits = if (sets > 1) log2Ceil(sets) else 1   // avoid zero-width
   val tagBits = 32 - offBits - idxBits
   val wordsPerLine = cfg.blockBytes / 4
+  val wayBits = log2Ceil(cfg.ways)
 
   // storage
   val data = RegInit(VecInit(Seq.fill(sets)(VecInit(Seq.fill(cfg.ways)(
@@ -41,10 +66,6 @@ class ICacheSimple(cfg: ICacheSimpleConfig) extends Module {
 
   val tagArray = RegInit(VecInit(Seq.fill(sets)(VecInit(Seq.fill(cfg.ways)(0.U(tagBits.W))))))
   val valid    = RegInit(VecInit(Seq.fill(sets)(VecInit(Seq.fill(cfg.ways)(false.B)))))
-  val age      = RegInit(VecInit(Seq.fill(sets)(VecInit(Seq.fill(cfg.ways)(0.U(32.W))))))
-
-  val globalTime = RegInit(0.U(32.W))
-  globalTime := globalTime + 1.U
 
   // address decode for the incoming PC
   val blockAddr = io.pc >> offBits
@@ -57,14 +78,72 @@ class ICacheSimple(cfg: ICacheSimpleConfig) extends Module {
   val blockBase = Cat(io.pc(31, offBits), 0.U(offBits.W))
   val wordByteAddr = (blockBase + (wordOffset << 2))(31,0)
 
-  // hit detection
-  val hit = Wire(Bool()); hit := false.B
-  val hitWay = Wire(UInt(log2Ceil(cfg.ways).W)); hitWay := 0.U
-  for (w <- 0 until cfg.ways) {
-    when(valid(idx)(w) && tagArray(idx)(w) === tag) {
-      hit := true.B
-      hitWay := w.U
-    }
+  // hit detection: every way compares its tag in parallel and the one-hot
+  // result selects the word directly, so no priority chain grows with ways.
+  val hitOH = VecInit(Seq.tabulate(cfg.ways)(w => valid(idx)(w) && tagArray(idx)(w) === tag)).asUInt
+  val hit = hitOH.orR
+  val hitWay = OHToUInt(hitOH)
+  val hitWord = Mux1H(hitOH, Seq.tabulate(cfg.ways)(w => data(idx)(w)(wordOffset)))
+
+  // Replacement state is updated when a way is used (a hit or a completed
+  // fill) and stays put during a fill, so the victim is stable across it.
+  val touch = Wire(Valid(UInt(wayBits.W)))
+  touch.valid := false.B
+  touch.bits := hitWay
+  val filled = WireDefault(false.B)
+
+  val policyWay = Wire(UInt(wayBits.W))
+  cfg.replacement match {
+    case ICacheReplacement.LRU =>
+      val age = RegInit(VecInit(Seq.fill(sets)(VecInit(Seq.fill(cfg.ways)(0.U(32.W))))))
+      val globalTime = RegInit(0.U(32.W))
+      globalTime := globalTime + 1.U
+      when(touch.valid) { age(idx)(touch.bits) := globalTime }
+
+      val minIdxWire = Wire(UInt(wayBits.W))
+      val minAgeWire = Wire(UInt(32.W))
+      minIdxWire := 0.U
+      minAgeWire := age(idx)(0)
+      for (w <- 1 until cfg.ways) {
+        when(age(idx)(w) < minAgeWire) {
+          minAgeWire := age(idx)(w)
+          minIdxWire := w.U
+        }
+      }
+      policyWay := minIdxWire
+
+    case ICacheReplacement.Random =>
+      val lfsr = LFSR(16, filled)
+      policyWay := (if (cfg.ways > 1) lfsr(wayBits - 1, 0) else 0.U)
+
+    case ICacheReplacement.RoundRobin =>
+      val next = RegInit(VecInit(Seq.fill(sets)(0.U(wayBits.W))))
+      when(filled) { next(idx) := Mux(next(idx) === (cfg.ways - 1).U, 0.U, next(idx) + 1.U) }
+      policyWay := next(idx)
+
+    case ICacheReplacement.TreePLRU =>
+      // Node n has children 2n+1 and 2n+2; a bit points toward the side to evict.
+      val nodes = (cfg.ways - 1) max 1
+      val tree = RegInit(VecInit(Seq.fill(sets)(0.U(nodes.W))))
+      val path = Wire(Vec(wayBits max 1, Bool()))
+      path := DontCare
+      var node: UInt = 0.U
+      for (l <- 0 until wayBits) {
+        path(l) := tree(idx)(node)
+        node = (node << 1) + 1.U + path(l)
+      }
+      policyWay := (if (cfg.ways > 1) Cat(path) else 0.U)
+
+      when(touch.valid) {
+        val updated = VecInit(tree(idx).asBools)
+        var at: UInt = 0.U
+        for (l <- 0 until wayBits) {
+          val right = touch.bits(wayBits - 1 - l)
+          updated(at) := !right
+          at = (at << 1) + 1.U + right
+        }
+        tree(idx) := updated.asUInt
+      }
   }
 
   // victim selection
@@ -72,19 +151,7 @@ class ICacheSimple(cfg: ICacheSimpleConfig) extends Module {
   for (w <- 0 until cfg.ways) invalidMask(w) := !valid(idx)(w)
   val anyInvalid = invalidMask.asUInt.orR
   val firstInvalid = PriorityEncoder(invalidMask.asUInt)
-
-  val minIdxWire = Wire(UInt(log2Ceil(cfg.ways).W))
-  val minAgeWire = Wire(UInt(32.W))
-  minIdxWire := 0.U
-  // avoid reading age(idx)(0) if ways==0 - ways is >=1 by design
-  minAgeWire := age(idx)(0)
-  for (w <- 1 until cfg.ways) {
-    when(age(idx)(w) < minAgeWire) {
-      minAgeWire := age(idx)(w)
-      minIdxWire := w.U
-    }
-  }
-  val victim = Mux(anyInvalid, firstInvalid, minIdxWire)
+  val victim = Mux(anyInvalid, firstInvalid, policyWay)
 
   // FSM
   val sIdle :: sMiss :: sFill :: Nil = Enum(3)
@@ -95,6 +162,8 @@ class ICacheSimple(cfg: ICacheSimpleConfig) extends Module {
   io.instr := 0.U
   io.instr_valid := false.B
   io.stall := (state =/= sIdle)
+  io.hit := (state === sIdle) && io.pc_valid && hit
+  io.miss := (state === sIdle) && io.pc_valid && !hit
 
   // Default mem_addr: drive the wordByteAddr so combinational memory produces proper mem_rdata
   // sFill overrides mem_addr when filling block words.
@@ -104,9 +173,9 @@ class ICacheSimple(cfg: ICacheSimpleConfig) extends Module {
   when(state === sIdle && io.pc_valid) {
     when(hit) {
       // immediate hit: return from cache
-      io.instr := data(idx)(hitWay)(wordOffset)
+      io.instr := hitWord
       io.instr_valid := true.B
-      age(idx)(hitWay) := globalTime
+      touch.valid := true.B
       state := sIdle
     } .elsewhen(io.mem_rvalid) {
       // FAST PATH: memory is combinational and has the requested word now.
@@ -115,7 +184,7 @@ class ICacheSimple(cfg: ICacheSimpleConfig) extends Module {
       data(idx)(victim)(wordOffset) := io.mem_rdata
       // DO NOT: valid(idx)(victim) := true.B
       // DO NOT: tagArray(idx)(victim) := tag
-      // DO NOT: age(idx)(victim) := globalTime
+      // DO NOT: update the replacement state
 
       // Return the instruction immediately to the CPU
       io.instr := io.mem_rdata
@@ -142,10 +211,12 @@ class ICacheSimple(cfg: ICacheSimpleConfig) extends Module {
       data(idx)(victim)(fillCnt) := io.mem_rdata
       fillCnt := fillCnt + 1.U
       when(fillCnt === (wordsPerLine - 1).U) {
-        // Only mark valid/tag/age after the whole block is filled
+        // Only mark valid/tag and update replacement after the whole block is filled
         valid(idx)(victim) := true.B
         tagArray(idx)(victim) := tag
-        age(idx)(victim) := globalTime
+        touch.valid := true.B
+        touch.bits := victim
+        filled := true.B
 
         // respond to CPU using the filled data
         io.instr := data(idx)(victim)(wordOffset)
@@ -4,11 +4,12 @@ import chisel3._
 import chisel3.util._
 import chisel3.dontTouch
 import Decoders.RV32IDecode
-import ALUs.{ALU32, Div32Radix4, Mul32OneCycle}
+import ALUs.{ALU32, MulDivConfig}
+import CSRs.PerfCounterCSRs
 import TileLink._
 
 
-class ZeroNyteRV32ICore extends Module {
+class ZeroNyteRV32ICore(mulDiv: MulDivConfig = new MulDivConfig) extends Module {
   val io = IO(new Bundle {
     // Instruction Memory Interface
     val imem_addr = Output(UInt(32.W))
@@ -75,7 +76,7 @@ class ZeroNyteRV32ICore extends Module {
   val isMulInstr = isMExt && (funct3 <= "b011".U)
   val isDivInstr = isMExt && (funct3 >= "b100".U)
 
-  val mulUnit = Module(new Mul32OneCycle)
+  val mulUnit = Module(mulDiv.multiplier())
   val mulSignedA = WireDefault(true.B)
   val mulSignedB = WireDefault(true.B)
   when(funct3 === "b011".U) { // MULHU
@@ -98,7 +99,16 @@ class ZeroNyteRV32ICore extends Module {
     "b011".U -> mulUnit.io.hi  // MULHU
   ))
 
-  val divider = Module(new Div32Radix4)
+  // A pipelined multiplier holds the instruction, and so its operands,
+  // until the product comes out.
+  val mulStall = if (mulDiv.mulStages == 1) false.B else {
+    val mulWait = RegInit(0.U(2.W))
+    val waiting = isMulInstr && mulWait =/= (mulDiv.mulStages - 1).U
+    mulWait := Mux(waiting, mulWait + 1.U, 0.U)
+    waiting
+  }
+
+  val divider = Module(mulDiv.divider())
   val divActive = RegInit(false.B)
   val divRd = Reg(UInt(5.W))
   val divFunct3 = Reg(UInt(3.W))
@@ -135,6 +145,16 @@ class ZeroNyteRV32ICore extends Module {
   dontTouch(divDivideByZeroSink)
   val divDone = divActive && divider.io.done
 
+  // ---------- Counter CSRs ----------
+  val isCsrInstr = PerfCounterCSRs.isCsrInstr(instr)
+  val csrs = Module(new PerfCounterCSRs(1))
+  csrs.io.access.valid := isCsrInstr
+  csrs.io.access.hart := 0.U
+  csrs.io.access.addr := instr(31, 20)
+  csrs.io.access.cmd := funct3(1, 0)
+  csrs.io.access.wen := PerfCounterCSRs.writesCsr(instr)
+  csrs.io.access.wdata := PerfCounterCSRs.operand(instr, r1)
+
   // ---------- Data Memory Access ----------
   val effAddr    = alu.io.result
   val addrBase   = Cat(effAddr(31, 2), 0.U(2.W))
@@ -234,7 +254,7 @@ class ZeroNyteRV32ICore extends Module {
 
   when(isMulInstr) {
     write_data := mulResult
-    doWrite := true.B
+    doWrite := !mulStall
   }
 
   when(isDivInstr) {
@@ -261,6 +281,11 @@ class ZeroNyteRV32ICore extends Module {
     doWrite := true.B
   }
 
+  when(isCsrInstr) {
+    write_data := csrs.io.rdata
+    doWrite := true.B
+  }
+
   when(doWrite && targetRd =/= 0.U) {
     regFile(targetRd) := write_data
   }
@@ -298,7 +323,8 @@ class ZeroNyteRV32ICore extends Module {
 
   val nextPC = WireDefault(pcPlus4)
   val divStall = (divActive || divLaunch) && !divider.io.done
-  val interruptTaken = interruptController.io.hasInterrupt && !divStall
+  val stall = divStall || mulStall
+  val interruptTaken = interruptController.io.hasInterrupt && !stall
   io.interruptTaken := interruptTaken
 
   when(dec.isBranch && branchTaken) {
@@ -310,11 +336,19 @@ class ZeroNyteRV32ICore extends Module {
   when(dec.isJALR) {
     nextPC := jalrTarget
   }
-  when(divStall) {
+  when(stall) {
     nextPC := pc
   }
   when(interruptTaken) {
     nextPC := io.interruptVector
  }
   pc := nextPC
+
+  // ---------- Counter Events ----------
+  // An instruction retires every cycle except while a divide or a pipelined
+  // multiply is in flight.
+  csrs.io.retire(0) := !stall
+  csrs.io.events(0)(0) := false.B
+  csrs.io.events(0)(1) := (dec.isBranch && branchTaken) || dec.isJAL || dec.isJALR
+  csrs.io.events(0)(2) := stall
 }
@@ -4,8 +4,9 @@ import chisel3._
 import chisel3.util._
 import Decoders.RV32IDecode
 import ALUs.ALU32
+import CSRs.PerfCounterCSRs
 
-class ZeroNyteRV32ICoreWithCache extends Module {
+class ZeroNyteRV32ICoreWithCache(cacheConfig: ICacheSimpleConfig = new ICacheSimpleConfig(2*1024, 16, 1)) extends Module {
   val io = IO(new Bundle {
     // Instruction Memory Interface
     val imem_addr = Output(UInt(32.W))
@@ -21,6 +22,11 @@ class ZeroNyteRV32ICoreWithCache extends Module {
     val pc_out    = Output(UInt(32.W))
     val instr_out = Output(UInt(32.W))
     val result    = Output(UInt(32.W))
+
+    // I-cache activity for the simulation harness statistics
+    val icache_hit   = Output(Bool())
+    val icache_miss  = Output(Bool())
+    val icache_stall = Output(Bool())
   })
 
   // ---------- Program Counter ----------
@@ -28,7 +34,7 @@ class ZeroNyteRV32ICoreWithCache extends Module {
   io.pc_out := pc
 
   // ---------- Instruction Cache (Simple) ----------
-  val I$ = Module(new ICacheSimple(new ICacheSimpleConfig(2*1024, 16, 1)))
+  val I$ = Module(new ICacheSimple(cacheConfig))
 
   // Request fetch every cycle for current PC (cache will stall/fill as needed)
   I$.io.pc := pc
@@ -46,6 +52,9 @@ class ZeroNyteRV32ICoreWithCache extends Module {
   val cache_stall = Wire(Bool())
   cache_stall := I$.io.stall
   dontTouch(cache_stall)
+  io.icache_hit := I$.io.hit
+  io.icache_miss := I$.io.miss
+  io.icache_stall := cache_stall
 
   // Expose visible instruction for debug (0 when not valid)
   io.instr_out := Mux(instr_valid, fetched_instr, 0.U)
@@ -76,6 +85,16 @@ class ZeroNyteRV32ICoreWithCache extends Module {
   alu.io.b := operandB
   alu.io.opcode := dec.aluOp
 
+  // ---------- Counter CSRs ----------
+  val isCsrInstr = instr_valid && PerfCounterCSRs.isCsrInstr(instr)
+  val csrs = Module(new PerfCounterCSRs(1))
+  csrs.io.access.valid := isCsrInstr
+  csrs.io.access.hart := 0.U
+  csrs.io.access.addr := instr(31, 20)
+  csrs.io.access.cmd := instr(13, 12)
+  csrs.io.access.wen := PerfCounterCSRs.writesCsr(instr)
+  csrs.io.access.wdata := PerfCounterCSRs.operand(instr, r1)
+
   // ---------- Data Memory Access ----------
   // Only use ALU result when an instruction is valid; otherwise drive safe zeros
   val effAddr = Wire(UInt(32.W))
@@ -182,6 +201,11 @@ class ZeroNyteRV32ICoreWithCache extends Module {
     doWrite := true.B
   }
 
+  when(isCsrInstr) {
+    write_data := csrs.io.rdata
+    doWrite := true.B
+  }
+
   // Only commit register writes when instruction is valid and destination is not x0
   when(instr_valid && doWrite && rd =/= 0.U) {
     regFile(rd) := write_data
@@ -225,4 +249,10 @@ class ZeroNyteRV32ICoreWithCache extends Module {
   when(instr_valid) {
     pc := nextPC
   }
+
+  // ---------- Counter Events ----------
+  csrs.io.retire(0) := instr_valid
+  csrs.io.events(0)(0) := I$.io.miss
+  csrs.io.events(0)(1) := instr_valid && ((dec.isBranch && branchTaken) || dec.isJAL || dec.isJALR)
+  csrs.io.events(0)(2) := !instr_valid
 }
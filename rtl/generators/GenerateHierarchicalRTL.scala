@@ -12,17 +12,23 @@ import java.nio.file.{Files, Paths, StandardCopyOption, NoSuchFileException}
 import java.io.IOException
 import java.io.PrintStream
 import java.io.OutputStream
+import java.util.concurrent.Executors
+import scala.concurrent.{Await, ExecutionContext, Future}
+import scala.concurrent.duration.Duration
+import scala.io.Source
 import scala.util.{Try, Success, Failure}
 
 // Import KryptoNyte modules
-import ALUs.ALU32
+import ALUs.{ALU32, MulDivConfig}
 import BranchUnit.BranchUnit
+import CSRs.PerfCounterCSRs
 import Decoders.RV32IDecodeModule
 import LoadUnit.LoadUnit
+import Pipeline.SchedulePolicy
 import RegFiles.RegFileMT2R1WVec
 import StoreUnit.StoreUnit
 import TetraNyte.TetraNyteRV32ICore
-import ZeroNyte.{ZeroNyteRV32ICore, ZeroNyteRV32ICoreWithCache}
+import ZeroNyte.{ICacheReplacement, ICacheSimpleConfig, ZeroNyteRV32ICore, ZeroNyteRV32ICoreWithCache}
 import OctoNyte.OctoNyteRV32ICore
 
 // Note: RV32IDecode is an object (not a Module class), so it's not imported for RTL generation
@@ -59,7 +65,13 @@ case class RTLGeneratorConfig(
   
   // Cleanup options
   deleteIntermediateFiles: Boolean = false,
-  verbose: Boolean = true
+  verbose: Boolean = true,
+
+  // Design-space exploration
+  topModule: String = "",                        // generate only this module
+  designParams: Map[String, String] = Map.empty, // --param knobs, see DesignParams
+  variantsFile: String = "",                     // "<name> key=value ..." per line
+  jobs: Int = 1                                  // variants generated in parallel
 ) {
   
   // Computed paths
@@ -108,6 +120,68 @@ case class RTLGeneratorConfig(
   }
 }
 
+// Design knobs settable with --param key=value or per variant in a
+// --variants file. Unset knobs keep the defaults the cores are built with.
+object DesignParams {
+  val descriptions: Seq[(String, String)] = Seq(
+    "icache.bytes" -> "ZeroNyteRV32ICoreWithCache I-cache capacity in bytes (default 2048)",
+    "icache.block" -> "ZeroNyteRV32ICoreWithCache I-cache block size in bytes (default 16)",
+    "icache.ways"  -> "ZeroNyteRV32ICoreWithCache I-cache associativity (default 1)",
+    "icache.replacement" -> "ZeroNyteRV32ICoreWithCache I-cache replacement: lru, random, round-robin or plru (default lru)",
+    "muldiv.div-radix" -> "ZeroNyte/TetraNyte divider radix, 2 or 4 quotient bits a cycle: 4 or 16 (default 4)",
+    "muldiv.div-early-out" -> "ZeroNyte/TetraNyte divider skips leading zero dividend digits: 0 or 1 (default 0)",
+    "muldiv.mul-stages" -> "ZeroNyteRV32ICore multiplier stages: 1, 2 or 3 (default 1)",
+    "octonyte.schedule" -> "OctoNyteRV32ICore thread scheduling: fixed or dynamic (default fixed)"
+  )
+
+  // Knobs that take a name rather than an integer, checked by their parser.
+  private val named: Map[String, String => Any] = Map(
+    "icache.replacement" -> (ICacheReplacement(_)),
+    "octonyte.schedule" -> (SchedulePolicy(_))
+  )
+
+  def validate(params: Map[String, String]): Unit = {
+    val known = descriptions.map(_._1).toSet
+    params.foreach { case (key, value) =>
+      if (!known.contains(key)) {
+        throw new IllegalArgumentException(s"Unknown design parameter: $key")
+      }
+      named.get(key) match {
+        case Some(check) => check(value)
+        case None if Try(value.toInt).isFailure =>
+          throw new IllegalArgumentException(s"Design parameter $key must be an integer, got $value")
+        case None =>
+      }
+    }
+  }
+
+  def parse(assignments: Seq[String]): Map[String, String] = assignments.map { kv =>
+    kv.split("=", 2) match {
+      case Array(key, value) if key.nonEmpty => key -> value
+      case _ => throw new IllegalArgumentException(s"Expected key=value, got $kv")
+    }
+  }.toMap
+
+  private def int(params: Map[String, String], key: String, default: Int): Int =
+    params.get(key).map(_.toInt).getOrElse(default)
+
+  def zeroNyteICache(params: Map[String, String]): ICacheSimpleConfig = new ICacheSimpleConfig(
+    int(params, "icache.bytes", 2 * 1024),
+    int(params, "icache.block", 16),
+    int(params, "icache.ways", 1),
+    params.get("icache.replacement").map(ICacheReplacement(_)).getOrElse(ICacheReplacement.LRU)
+  )
+
+  def mulDiv(params: Map[String, String]): MulDivConfig = new MulDivConfig(
+    int(params, "muldiv.div-radix", 4),
+    int(params, "muldiv.div-early-out", 0) != 0,
+    int(params, "muldiv.mul-stages", 1)
+  )
+
+  def octoNyteSchedule(params: Map[String, String]): SchedulePolicy =
+    params.get("octonyte.schedule").map(SchedulePolicy(_)).getOrElse(SchedulePolicy.Fixed)
+}
+
 // Module specification for generation
 case class ModuleSpec(
   generator: () => chisel3.Module,
@@ -133,19 +207,10 @@ object GenerateHierarchicalRTL extends App {
     printConfiguration(finalConfig)
   }
   
-  // Modules to generate - easily configurable
-  val modulesToGenerate = getModulesToGenerate(finalConfig)
-  
-  // Generate RTL for each module
-  modulesToGenerate.foreach { moduleSpec =>
-    try {
-      generateModuleRTL(moduleSpec, finalConfig)
-    } catch {
-      case e: Exception =>
-        println(s"Error generating RTL for ${moduleSpec.name}: ${e.getMessage}")
-        if (finalConfig.verbose) e.printStackTrace()
-        throw e
-    }
+  if (finalConfig.variantsFile.nonEmpty) {
+    generateVariants(finalConfig)
+  } else {
+    generateModules(finalConfig)
   }
   
   println("\n" + "="*80)
@@ -153,6 +218,64 @@ object GenerateHierarchicalRTL extends App {
   println("="*80)
   
   // Helper functions
+
+  def generateModules(config: RTLGeneratorConfig): Unit = {
+    val modulesToGenerate = getModulesToGenerate(config)
+      .filter(spec => config.topModule.isEmpty || spec.name == config.topModule)
+    if (modulesToGenerate.isEmpty) {
+      throw new IllegalArgumentException(s"No module ${config.topModule} in ${config.coreFamily}/${config.coreVariant}")
+    }
+
+    // Generate RTL for each module
+    modulesToGenerate.foreach { moduleSpec =>
+      try {
+        generateModuleRTL(moduleSpec, config)
+      } catch {
+        case e: Exception =>
+          println(s"Error generating RTL for ${moduleSpec.name}: ${e.getMessage}")
+          if (config.verbose) e.printStackTrace()
+          throw e
+      }
+    }
+  }
+
+  // Each variant is generated into <output-root>/<name>/ with its own
+  // parameters layered over the --param ones.
+  def loadVariants(config: RTLGeneratorConfig): Seq[(String, RTLGeneratorConfig)] = {
+    val source = Source.fromFile(config.variantsFile)
+    val lines = try source.getLines().toList finally source.close()
+    lines.map(_.trim).filter(line => line.nonEmpty && !line.startsWith("#")).map { line =>
+      val fields = line.split("\\s+").toSeq
+      val name = fields.head
+      if (!name.matches("[A-Za-z0-9_.-]+")) {
+        throw new IllegalArgumentException(s"Bad variant name: $name")
+      }
+      val params = config.designParams ++ DesignParams.parse(fields.tail)
+      DesignParams.validate(params)
+      name -> config.copy(outputRoot = s"${config.fullOutputRoot}/$name", designParams = params)
+    }
+  }
+
+  def generateVariants(config: RTLGeneratorConfig): Unit = {
+    val variants = loadVariants(config)
+    val pool = Executors.newFixedThreadPool(math.max(1, config.jobs))
+    implicit val ec: ExecutionContext = ExecutionContext.fromExecutorService(pool)
+
+    val runs = variants.map { case (name, variantConfig) =>
+      Future {
+        variantConfig.createDirectories()
+        generateModules(variantConfig)
+        name -> Option.empty[String]
+      }.recover { case e: Exception => name -> Some(e.getMessage) }
+    }
+    val results = try Await.result(Future.sequence(runs), Duration.Inf) finally pool.shutdown()
+
+    val failed = results.collect { case (name, Some(error)) => s"$name: $error" }
+    println(s"Generated ${results.size - failed.size} of ${results.size} variants under ${config.fullOutputRoot}")
+    if (failed.nonEmpty) {
+      throw new RuntimeException(s"Variant generation failed:\n  ${failed.mkString("\n  ")}")
+    }
+  }
   
   def parseArgs(args: Array[String]): RTLGeneratorConfig = {
     var config = RTLGeneratorConfig()
@@ -187,6 +310,18 @@ object GenerateHierarchicalRTL extends App {
         case "--quiet" => 
           config = config.copy(verbose = false)
           i += 1
+        case "--top" =>
+          config = config.copy(topModule = args(i + 1))
+          i += 2
+        case "--param" =>
+          config = config.copy(designParams = config.designParams ++ DesignParams.parse(Seq(args(i + 1))))
+          i += 2
+        case "--variants" =>
+          config = config.copy(variantsFile = args(i + 1))
+          i += 2
+        case "--jobs" =>
+          config = config.copy(jobs = args(i + 1).toInt)
+          i += 2
         case "--help" | "-h" =>
           printHelp()
           System.exit(0)
@@ -196,11 +331,21 @@ object GenerateHierarchicalRTL extends App {
       }
     }
     
+    DesignParams.validate(config.designParams)
+    // The simulator builds read and regenerate the default output root with
+    // the default parameters, and their staleness stamp only covers the Scala
+    // sources, so a parameterised elaboration there would be taken as current.
+    if (config.designParams.nonEmpty && config.variantsFile.isEmpty &&
+        config.fullOutputRoot == RTLGeneratorConfig().fullOutputRoot) {
+      throw new IllegalArgumentException(
+        "--param needs an --output-root other than the default generated/ (build a simulator from it with --verilog)")
+    }
     config
   }
   
   def printHelp(): Unit = {
-    println("""
+    val paramHelp = DesignParams.descriptions.map { case (k, d) => f"  $k%-26s  $d" }.mkString("\n")
+    println(s"""
 KryptoNyte Hierarchical RTL Generator
 
 Usage: sbt 'runMain kryptonyte.generators.GenerateHierarchicalRTL [options]'
@@ -215,8 +360,17 @@ Options:
   --no-optimize              Disable ASIC optimization (default)
   --cleanup                   Delete intermediate files after generation
   --quiet                     Reduce output verbosity
+  --top <module>              Generate only this module of the family
+  --param <key>=<value>       Set a design parameter (repeatable, see below);
+                              needs an --output-root other than generated/
+  --variants <file>           Generate one variant per line ("<name> key=value ...")
+                              into <output-root>/<name>/
+  --jobs <n>                  Variants generated in parallel (default: 1)
   --help, -h                  Show this help message
 
+Design parameters:
+$paramHelp
+
 Examples:
   # Generate ZeroNyte RV32I with default settings
   sbt 'runMain kryptonyte.generators.GenerateHierarchicalRTL'
@@ -227,6 +381,16 @@ Examples:
   # Generate with ASIC optimization
   sbt 'runMain kryptonyte.generators.GenerateHierarchicalRTL --optimize-asic --pdk-root /opt/skywater-pdk/pdks/sky130A'
 
+  # Generate two I-cache variants of the cached ZeroNyte in parallel
+  sbt 'runMain kryptonyte.generators.GenerateHierarchicalRTL --core-family ZeroNyte --top ZeroNyteRV32ICoreWithCache --variants variants.txt --jobs 2'
+
+  # Generate OctoNyte with the dynamic thread scheduler, then simulate it
+  sbt 'runMain kryptonyte.generators.GenerateHierarchicalRTL --core-family OctoNyte --top OctoNyteRV32ICore --param octonyte.schedule=dynamic --output-root generated/octonyte-dynamic'
+  tests/sim/build_octonyte_sim.sh --verilog rtl/generators/generated/octonyte-dynamic/verilog_hierarchical_timed/OctoNyteRV32ICore.v --output tests/sim/build/octonyte_dynamic_sim
+
+  # Generate ZeroNyte with an early-out radix-16 divider and a 2-stage multiplier
+  sbt 'runMain kryptonyte.generators.GenerateHierarchicalRTL --top ZeroNyteRV32ICore --param muldiv.div-radix=16 --param muldiv.div-early-out=1 --param muldiv.mul-stages=2 --output-root generated/zeronyte-muldiv'
+
 Environment Variables:
   PDK_ROOT                    PDK root directory
   SKYWATER_PDK_ROOT          SkyWater PDK root directory
@@ -252,6 +416,9 @@ Environment Variables:
     println(s"ASIC Optimization:     ${config.optimizeForASIC}")
     println(s"Preserve Aggregates:   ${config.preserveAggregates}")
     println(s"Generate Annotations:  ${config.generateAnnotations}")
+    if (config.topModule.nonEmpty) println(s"Top Module:            ${config.topModule}")
+    if (config.designParams.nonEmpty) println(s"Design Parameters:     ${config.designParams.toSeq.sorted.map { case (k, v) => s"$k=$v" }.mkString(" ")}")
+    if (config.variantsFile.nonEmpty) println(s"Variants:              ${config.variantsFile} (jobs=${config.jobs})")
     println("="*80 + "\n")
   }
   
@@ -259,13 +426,13 @@ Environment Variables:
     // This would be expanded based on the core family and variant
     config.coreFamily match {
       case "Library" => getLibraryModules(config.coreVariant)
-      case "ZeroNyte" => getZeroNyteModules(config.coreVariant)
+      case "ZeroNyte" => getZeroNyteModules(config.coreVariant, config.designParams)
       case "PipeNyte" => getPipeNyteModules(config.coreVariant)
-      case "TetraNyte" => getTetraNyteModules(config.coreVariant)
-      case "OctoNyte" => getOctoNyteModules(config.coreVariant)
+      case "TetraNyte" => getTetraNyteModules(config.coreVariant, config.designParams)
+      case "OctoNyte" => getOctoNyteModules(config.coreVariant, config.designParams)
       case _ => 
         println(s"Warning: Unknown core family ${config.coreFamily}, using ZeroNyte")
-        getZeroNyteModules(config.coreVariant)
+        getZeroNyteModules(config.coreVariant, config.designParams)
     }
   }
 
@@ -274,6 +441,7 @@ Environment Variables:
     ModuleSpec(() => new BranchUnit, "BranchUnit", "Branch decision unit", family, "rv32i"),
     ModuleSpec(() => new LoadUnit, "LoadUnit", "Load unit for RV32I", family, "rv32i"),
     ModuleSpec(() => new StoreUnit, "StoreUnit", "Store unit with mask generation", family, "rv32i"),
+    ModuleSpec(() => new PerfCounterCSRs(1), "PerfCounterCSRs", "Zicntr/Zihpm counter CSRs", family, "rv32i"),
     ModuleSpec(() => new RegFileMT2R1WVec(), "RegFileMT2R1WVec", "Multithreaded 2R1W register file", family, "rv32i"),
     ModuleSpec(() => new RV32IDecodeModule, "RV32IDecodeModule", "RV32I instruction decoder", family, "rv32i")
   )
@@ -285,12 +453,12 @@ Environment Variables:
     }
   }
   
-  def getZeroNyteModules(variant: String): Seq[ModuleSpec] = {
+  def getZeroNyteModules(variant: String, params: Map[String, String] = Map.empty): Seq[ModuleSpec] = {
     variant match {
       case "rv32i" =>
         getRV32ILibraryModules("ZeroNyte") ++ Seq(
-          ModuleSpec(() => new ZeroNyteRV32ICore, "ZeroNyteRV32ICore", "Single-cycle RV32I core", "ZeroNyte", "rv32i"),
-          ModuleSpec(() => new ZeroNyteRV32ICoreWithCache, "ZeroNyteRV32ICoreWithCache", "Single-cycle RV32I core with I-cache", "ZeroNyte", "rv32i")
+          ModuleSpec(() => new ZeroNyteRV32ICore(DesignParams.mulDiv(params)), "ZeroNyteRV32ICore", "Single-cycle RV32I core", "ZeroNyte", "rv32i"),
+          ModuleSpec(() => new ZeroNyteRV32ICoreWithCache(DesignParams.zeroNyteICache(params)), "ZeroNyteRV32ICoreWithCache", "Single-cycle RV32I core with I-cache", "ZeroNyte", "rv32i")
         )
       case _ => Seq.empty
     }
@@ -301,23 +469,23 @@ Environment Variables:
     Seq.empty
   }
   
-  def getTetraNyteModules(variant: String): Seq[ModuleSpec] = {
+  def getTetraNyteModules(variant: String, params: Map[String, String] = Map.empty): Seq[ModuleSpec] = {
     variant match {
       case "rv32i" =>
         // Generate all building blocks plus the threaded core itself
         val libraryBlocks = getRV32ILibraryModules("TetraNyte")
         libraryBlocks :+
-          ModuleSpec(() => new TetraNyteRV32ICore, "TetraNyteRV32ICore", "Four-thread barrel-threaded RV32I core", "TetraNyte", "rv32i")
+          ModuleSpec(() => new TetraNyteRV32ICore(DesignParams.mulDiv(params)), "TetraNyteRV32ICore", "Four-thread barrel-threaded RV32I core", "TetraNyte", "rv32i")
       case _ => Seq.empty
     }
   }
   
-  def getOctoNyteModules(variant: String): Seq[ModuleSpec] = {
+  def getOctoNyteModules(variant: String, params: Map[String, String] = Map.empty): Seq[ModuleSpec] = {
     variant match {
       case "rv32i" =>
         val libraryBlocks = getRV32ILibraryModules("OctoNyte")
         libraryBlocks :+
-          ModuleSpec(() => new OctoNyteRV32ICore, "OctoNyteRV32ICore", "Eight-thread, 4-wide packet barrel-threaded RV32I core", "OctoNyte", "rv32i")
+          ModuleSpec(() => new OctoNyteRV32ICore(schedule = DesignParams.octoNyteSchedule(params)), "OctoNyteRV32ICore", "Eight-thread, 4-wide packet barrel-threaded RV32I core", "OctoNyte", "rv32i")
       case _ => Seq.empty
     }
   }
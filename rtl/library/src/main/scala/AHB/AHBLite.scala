@@ -6,6 +6,14 @@ case class AHBLiteParams(addrBits: Int = 32, dataBits: Int = 32) {
   require(dataBits % 8 == 0, "dataBits must be byte-addressable")
 }
 
+object AHBBurst {
+  val SINGLE = "b000".U(3.W)
+  val INCR   = "b001".U(3.W)
+  val INCR4  = "b011".U(3.W)
+  val INCR8  = "b101".U(3.W)
+  val INCR16 = "b111".U(3.W)
+}
+
 object AHBTrans {
   val IDLE   = "b00".U(2.W)
   val BUSY   = "b01".U(2.W)
@@ -18,6 +26,7 @@ class AHBLiteIO(p: AHBLiteParams) extends Bundle {
   val hwrite = Output(Bool())
   val htrans = Output(UInt(2.W))
   val hsize  = Output(UInt(3.W))
+  val hburst = Output(UInt(3.W))
   val hsel   = Output(Bool())
   val hwdata = Output(UInt(p.dataBits.W))
 
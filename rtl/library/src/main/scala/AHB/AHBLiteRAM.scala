@@ -12,7 +12,7 @@ class AHBLiteRAM(p: AHBLiteParams = AHBLiteParams(), depth: Int = 1024) extends
   val mem = Mem(depth, UInt(p.dataBits.W))
 
   val addrIdx = io.ahb.haddr(p.addrBits - 1, log2Ceil(p.dataBits / 8))
-  val isActive = io.ahb.hsel && (io.ahb.htrans === AHBTrans.NONSEQ)
+  val isActive = io.ahb.hsel && (io.ahb.htrans === AHBTrans.NONSEQ || io.ahb.htrans === AHBTrans.SEQ)
 
   val readData = mem.read(addrIdx)
   io.ahb.hrdata := readData
@@ -0,0 +1,102 @@
+package ALUs
+
+import chisel3._
+import chisel3.util._
+
+/**
+ * Restoring divider retiring log2(radix) quotient bits per cycle: radix 4
+ * takes 16 cycles like Div32Radix4, radix 16 takes 8 at the cost of four
+ * chained 33-bit subtractors. Signed operands are divided as magnitudes and
+ * the signs applied on the way out, which also yields the RV32M overflow
+ * result (-2^31 / -1 = -2^31, remainder 0) without a special case.
+ *
+ * With earlyOut the leading zero digits of the dividend magnitude are
+ * skipped at start, so small dividends finish early and a zero dividend
+ * finishes the next cycle like a divide by zero does.
+ */
+class Div32Iterative(val radix: Int, val earlyOut: Boolean) extends Div32Unit {
+  require(radix == 4 || radix == 16, s"divider radix must be 4 or 16, got $radix")
+
+  override def desiredName: String = s"Div32Radix$radix" + (if (earlyOut) "EarlyOut" else "")
+
+  private val bitsPerCycle = log2Ceil(radix)
+  private val digits = 32 / bitsPerCycle
+
+  val busyReg     = RegInit(false.B)
+  val doneReg     = RegInit(false.B)
+  val digitReg    = RegInit(0.U(log2Ceil(digits).W)) // digit being retired
+  val remReg      = RegInit(0.U(32.W))
+  val quotReg     = RegInit(0.U(32.W)) // dividend bits shift out as quotient bits shift in
+  val divisorReg  = RegInit(0.U(32.W))
+  val negQuotReg  = RegInit(false.B)
+  val negRemReg   = RegInit(false.B)
+  val divZeroReg  = RegInit(false.B)
+
+  doneReg := false.B
+
+  private def negate(x: UInt): UInt = (~x).asUInt + 1.U
+
+  // One restoring iteration: shift the next dividend bit into the partial
+  // remainder and subtract the divisor if it fits.
+  private def step(rem: UInt, quot: UInt): (UInt, UInt) = {
+    val shifted = Cat(rem, quot(31))
+    val fits = shifted >= divisorReg
+    (Mux(fits, shifted - divisorReg, shifted)(31, 0), Cat(quot(30, 0), fits))
+  }
+
+  when(io.start && !busyReg) {
+    val dividendNeg = io.signed && io.dividend(31)
+    val divisorNeg  = io.signed && io.divisor(31)
+    val dividendAbs = Mux(dividendNeg, negate(io.dividend), io.dividend)
+    val divisorAbs  = Mux(divisorNeg, negate(io.divisor), io.divisor)
+
+    // Leading zero digits of the dividend magnitude, all of them when it is zero.
+    val skip = if (earlyOut) {
+      val leadingZeros = Mux(dividendAbs === 0.U, 32.U(6.W), PriorityEncoder(Reverse(dividendAbs)))
+      leadingZeros >> log2Ceil(bitsPerCycle)
+    } else {
+      0.U(6.W)
+    }
+    val skipDigits = skip(log2Ceil(digits) - 1, 0)
+
+    divZeroReg := io.divisor === 0.U
+    remReg := 0.U
+    divisorReg := divisorAbs
+    digitReg := skipDigits
+    busyReg := true.B
+
+    when(io.divisor === 0.U) {
+      doneReg := true.B
+      busyReg := false.B
+      quotReg := Fill(32, 1.U) // per spec
+      remReg := io.dividend
+      negQuotReg := false.B
+      negRemReg := false.B
+    }.elsewhen(skip === digits.U) {
+      doneReg := true.B
+      busyReg := false.B
+      quotReg := 0.U
+      negQuotReg := false.B
+      negRemReg := false.B
+    }.otherwise {
+      quotReg := (dividendAbs << Cat(skipDigits, 0.U(log2Ceil(bitsPerCycle).W)))(31, 0)
+      negQuotReg := dividendNeg ^ divisorNeg
+      negRemReg := dividendNeg
+    }
+  }.elsewhen(busyReg) {
+    val (rem, quot) = (0 until bitsPerCycle).foldLeft((remReg, quotReg)) { case ((r, q), _) => step(r, q) }
+    remReg := rem
+    quotReg := quot
+    digitReg := digitReg + 1.U
+    when(digitReg === (digits - 1).U) {
+      busyReg := false.B
+      doneReg := true.B
+    }
+  }
+
+  io.busy := busyReg
+  io.done := doneReg
+  io.divideByZero := divZeroReg
+  io.quotient := Mux(negQuotReg, negate(quotReg), quotReg)
+  io.remainder := Mux(negRemReg, negate(remReg), remReg)
+}
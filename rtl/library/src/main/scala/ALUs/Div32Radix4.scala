@@ -3,25 +3,36 @@ package ALUs
 import chisel3._
 import chisel3.util._
 
+/** Start/busy/done handshake shared by the dividers. The operands are
+  * sampled on the cycle start is raised while the divider is idle; done
+  * pulses for one cycle with quotient and remainder valid, and they hold
+  * until the next start.
+  */
+class Div32IO extends Bundle {
+  val start    = Input(Bool())
+  val signed   = Input(Bool())
+  val dividend = Input(UInt(32.W))
+  val divisor  = Input(UInt(32.W))
+
+  val busy        = Output(Bool())
+  val done        = Output(Bool())
+  val quotient    = Output(UInt(32.W))
+  val remainder   = Output(UInt(32.W))
+  val divideByZero = Output(Bool())
+}
+
+/** A divider a core can instantiate through MulDivConfig. */
+abstract class Div32Unit extends Module {
+  val io = IO(new Div32IO)
+}
+
 /**
  * 32-bit divider that completes in 16 cycles by performing two restoring
  * division iterations per cycle (radix-4 style). Supports signed/unsigned
  * operation, signals divide-by-zero, and exposes a simple start/busy/done
  * handshake.
  */
-class Div32Radix4 extends Module {
-  val io = IO(new Bundle {
-    val start    = Input(Bool())
-    val signed   = Input(Bool())
-    val dividend = Input(UInt(32.W))
-    val divisor  = Input(UInt(32.W))
-
-    val busy        = Output(Bool())
-    val done        = Output(Bool())
-    val quotient    = Output(UInt(32.W))
-    val remainder   = Output(UInt(32.W))
-    val divideByZero = Output(Bool())
-  })
+class Div32Radix4 extends Div32Unit {
 
   val busyReg         = RegInit(false.B)
   val doneReg         = RegInit(false.B)
@@ -2,19 +2,27 @@ package ALUs
 
 import chisel3._
 
+class Mul32IO extends Bundle {
+  val a       = Input(UInt(32.W))
+  val b       = Input(UInt(32.W))
+  val signedA = Input(Bool())
+  val signedB = Input(Bool())
+  val product = Output(UInt(64.W))
+  val lo      = Output(UInt(32.W))
+  val hi      = Output(UInt(32.W))
+}
+
+/** A multiplier a core can instantiate through MulDivConfig. The product of
+  * the operands presented on one cycle appears stages - 1 cycles later.
+  */
+abstract class Mul32Unit(val stages: Int) extends Module {
+  val io = IO(new Mul32IO)
+}
+
 /** 32-bit multiplier that produces a full 64-bit product in one cycle.
   * Supports signed/unsigned operands independently (RV32M semantics).
   */
-class Mul32OneCycle extends Module {
-  val io = IO(new Bundle {
-    val a       = Input(UInt(32.W))
-    val b       = Input(UInt(32.W))
-    val signedA = Input(Bool())
-    val signedB = Input(Bool())
-    val product = Output(UInt(64.W))
-    val lo      = Output(UInt(32.W))
-    val hi      = Output(UInt(32.W))
-  })
+class Mul32OneCycle extends Mul32Unit(1) {
 
   // Sign-extend or zero-extend operands based on control bits.
   val opA = Mux(io.signedA, io.a.asSInt, io.a.zext.asSInt)
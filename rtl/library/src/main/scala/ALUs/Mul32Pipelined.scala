@@ -0,0 +1,44 @@
+package ALUs
+
+import chisel3._
+
+/** 32-bit multiplier split over two or three stages (RV32M semantics, like
+  * Mul32OneCycle). The 33-bit sign/zero-extended operands are cut into 17-bit
+  * halves whose four partial products are registered at the end of the first
+  * stage; with three stages the two cross products are summed and registered
+  * again before the final add. A new multiply can enter every cycle.
+  */
+class Mul32Pipelined(stages: Int) extends Mul32Unit(stages) {
+  require(stages == 2 || stages == 3, s"pipelined multiplier takes 2 or 3 stages, got $stages")
+
+  override def desiredName: String = s"Mul32Pipelined$stages"
+
+  val opA = Mux(io.signedA, io.a.asSInt, io.a.zext.asSInt)
+  val opB = Mux(io.signedB, io.b.asSInt, io.b.zext.asSInt)
+
+  // Low halves are unsigned, high halves carry the sign.
+  val aLo = opA(15, 0).zext
+  val bLo = opB(15, 0).zext
+  val aHi = opA >> 16
+  val bHi = opB >> 16
+
+  val lolo = RegNext(aLo * bLo)
+  val lohi = RegNext(aLo * bHi)
+  val hilo = RegNext(aHi * bLo)
+  val hihi = RegNext(aHi * bHi)
+
+  // hihi * 2^32 + lolo is a concatenation since 0 <= lolo < 2^32.
+  val outer = (hihi << 32) + lolo
+  val cross = lohi +& hilo
+
+  val prod = if (stages == 2) {
+    (outer + (cross << 16)).asUInt
+  } else {
+    (RegNext(outer) + (RegNext(cross) << 16)).asUInt
+  }
+  val prod64 = prod(63, 0)
+
+  io.product := prod64
+  io.lo := prod64(31, 0)
+  io.hi := prod64(63, 32)
+}
@@ -0,0 +1,19 @@
+package ALUs
+
+/** M-extension backends for a core. The defaults are Div32Radix4 and
+  * Mul32OneCycle, so a core built without a config elaborates as before.
+  *
+  * divRadix    4 or 16 quotient digits per cycle
+  * divEarlyOut skip the leading zero digits of the dividend
+  * mulStages   1 (combinational), 2 or 3 (Mul32Pipelined)
+  */
+class MulDivConfig(val divRadix: Int = 4, val divEarlyOut: Boolean = false, val mulStages: Int = 1) {
+  require(divRadix == 4 || divRadix == 16, s"divider radix must be 4 or 16, got $divRadix")
+  require(mulStages >= 1 && mulStages <= 3, s"multiplier stages must be 1 to 3, got $mulStages")
+
+  def divider(): Div32Unit =
+    if (divRadix == 4 && !divEarlyOut) new Div32Radix4 else new Div32Iterative(divRadix, divEarlyOut)
+
+  def multiplier(): Mul32Unit =
+    if (mulStages == 1) new Mul32OneCycle else new Mul32Pipelined(mulStages)
+}
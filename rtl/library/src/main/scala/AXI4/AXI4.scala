@@ -0,0 +1,53 @@
+package AXI4
+
+import chisel3._
+import chisel3.util._
+
+/** Full AXI4 parameters, for masters that need bursts. Responses use the AXI4LiteResp codes. */
+case class AXI4Params(addrBits: Int = 32, dataBits: Int = 32, idBits: Int = 4) {
+  require(dataBits % 8 == 0, "dataBits must be byte-addressable")
+  val strbBits: Int = dataBits / 8
+}
+
+object AXI4Burst {
+  val FIXED = "b00".U(2.W)
+  val INCR  = "b01".U(2.W)
+  val WRAP  = "b10".U(2.W)
+}
+
+/** AW and AR share one layout; len is beats - 1 and size is log2 of bytes per beat. */
+class AXI4Addr(p: AXI4Params) extends Bundle {
+  val id    = UInt(p.idBits.W)
+  val addr  = UInt(p.addrBits.W)
+  val len   = UInt(8.W)
+  val size  = UInt(3.W)
+  val burst = UInt(2.W)
+  val prot  = UInt(3.W)
+}
+
+class AXI4W(p: AXI4Params) extends Bundle {
+  val data = UInt(p.dataBits.W)
+  val strb = UInt(p.strbBits.W)
+  val last = Bool()
+}
+
+class AXI4B(p: AXI4Params) extends Bundle {
+  val id   = UInt(p.idBits.W)
+  val resp = UInt(2.W)
+}
+
+class AXI4R(p: AXI4Params) extends Bundle {
+  val id   = UInt(p.idBits.W)
+  val data = UInt(p.dataBits.W)
+  val resp = UInt(2.W)
+  val last = Bool()
+}
+
+/** AXI4 master interface. */
+class AXI4IO(p: AXI4Params) extends Bundle {
+  val aw = Decoupled(new AXI4Addr(p))
+  val w  = Decoupled(new AXI4W(p))
+  val b  = Flipped(Decoupled(new AXI4B(p)))
+  val ar = Decoupled(new AXI4Addr(p))
+  val r  = Flipped(Decoupled(new AXI4R(p)))
+}
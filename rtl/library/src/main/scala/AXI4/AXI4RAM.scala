@@ -0,0 +1,69 @@
+package AXI4
+
+import chisel3._
+import chisel3.util._
+
+/** Simple AXI4 RAM model for simulation: one transaction at a time, one beat per cycle,
+  * FIXED and INCR bursts (WRAP is treated as INCR).
+  */
+class AXI4RAM(p: AXI4Params = AXI4Params(), depth: Int = 1024) extends Module {
+  val io = IO(new Bundle {
+    val axi = Flipped(new AXI4IO(p))
+  })
+
+  val mem = Mem(depth, UInt(p.dataBits.W)) // combinational read for simple modeling
+
+  val sIdle :: sRead :: sWrite :: sWriteResp :: Nil = Enum(4)
+  val state = RegInit(sIdle)
+
+  val req = RegInit(0.U.asTypeOf(new AXI4Addr(p)))
+  val beatsLeft = RegInit(0.U(9.W))
+
+  def index(addr: UInt) = addr(p.addrBits - 1, log2Ceil(p.strbBits))
+  def nextAddr(a: AXI4Addr) = Mux(a.burst === AXI4Burst.FIXED, a.addr, a.addr + (1.U << a.size))
+
+  io.axi.ar.ready := state === sIdle
+  io.axi.aw.ready := state === sIdle && !io.axi.ar.valid
+  io.axi.w.ready := state === sWrite
+
+  io.axi.r.valid := state === sRead
+  io.axi.r.bits.id := req.id
+  io.axi.r.bits.data := mem.read(index(req.addr))
+  io.axi.r.bits.resp := AXI4LiteResp.OKAY
+  io.axi.r.bits.last := beatsLeft === 1.U
+
+  io.axi.b.valid := state === sWriteResp
+  io.axi.b.bits.id := req.id
+  io.axi.b.bits.resp := AXI4LiteResp.OKAY
+
+  when(state === sIdle) {
+    when(io.axi.ar.fire) {
+      req := io.axi.ar.bits
+      beatsLeft := io.axi.ar.bits.len +& 1.U
+      state := sRead
+    }.elsewhen(io.axi.aw.fire) {
+      req := io.axi.aw.bits
+      state := sWrite
+    }
+  }
+
+  when(state === sRead && io.axi.r.fire) {
+    req.addr := nextAddr(req)
+    beatsLeft := beatsLeft - 1.U
+    when(beatsLeft === 1.U) { state := sIdle }
+  }
+
+  when(state === sWrite && io.axi.w.fire) {
+    val curr = mem.read(index(req.addr))
+    val merged = VecInit(Seq.tabulate(p.strbBits) { i =>
+      Mux(io.axi.w.bits.strb(i), io.axi.w.bits.data(8 * i + 7, 8 * i), curr(8 * i + 7, 8 * i))
+    })
+    mem.write(index(req.addr), merged.asUInt)
+    req.addr := nextAddr(req)
+    when(io.axi.w.bits.last) { state := sWriteResp }
+  }
+
+  when(state === sWriteResp && io.axi.b.fire) {
+    state := sIdle
+  }
+}
@@ -39,6 +39,7 @@ class AXI4LiteToAHBLite(axiParams: AXI4LiteParams = AXI4LiteParams(),
   io.ahb.hwrite := false.B
   io.ahb.htrans := AHBTrans.IDLE
   io.ahb.hsize := 2.U
+  io.ahb.hburst := AHBBurst.SINGLE
   io.ahb.hsel := false.B
   io.ahb.hwdata := 0.U
 
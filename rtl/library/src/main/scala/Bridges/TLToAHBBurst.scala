@@ -0,0 +1,105 @@
+package Bridges
+
+import chisel3._
+import chisel3.util._
+import TileLink._
+import AHB._
+
+/** TileLink to AHB-Lite bridge with burst reads (single outstanding transaction).
+  * A multibeat Get becomes one incrementing burst (INCR4/INCR8/INCR16 when the beat
+  * count matches, INCR otherwise) with one SEQ beat per cycle; BUSY is inserted while
+  * the TL D channel is stalled. Puts are single NONSEQ writes. Address and data share
+  * a cycle, as in AXI4LiteToAHBLite and AHBLiteRAM.
+  */
+class TLToAHBBurst(tlParams: TLParams = TLParams(), ahbParams: AHBLiteParams = AHBLiteParams()) extends Module {
+  require(tlParams.dataBits == ahbParams.dataBits, "TL and AHB data widths must match")
+  val io = IO(new Bundle {
+    val tl  = Flipped(new TLBundleUL(tlParams))
+    val ahb = new AHBLiteIO(ahbParams)
+  })
+
+  private val beatSize = log2Ceil(tlParams.beatBytes)
+
+  val sIdle :: sWrite :: sRead :: Nil = Enum(3)
+  val state = RegInit(sIdle)
+
+  val aReg = RegInit(0.U.asTypeOf(new TLBundleA(tlParams)))
+  val dReg = RegInit(0.U.asTypeOf(new TLBundleD(tlParams)))
+  val dValid = RegInit(false.B)
+
+  val beats = RegInit(0.U(log2Ceil(tlParams.maxBurstBeats + 1).W))
+  val beat = RegInit(0.U(log2Ceil(tlParams.maxBurstBeats + 1).W))
+
+  val burstType = MuxLookup(beats, AHBBurst.INCR)(Seq(
+    1.U  -> AHBBurst.SINGLE,
+    4.U  -> AHBBurst.INCR4,
+    8.U  -> AHBBurst.INCR8,
+    16.U -> AHBBurst.INCR16))
+
+  // AHB defaults
+  io.ahb.haddr := 0.U
+  io.ahb.hwrite := false.B
+  io.ahb.htrans := AHBTrans.IDLE
+  io.ahb.hsize := beatSize.U
+  io.ahb.hburst := AHBBurst.SINGLE
+  io.ahb.hsel := false.B
+  io.ahb.hwdata := 0.U
+
+  // TL defaults
+  io.tl.a.ready := state === sIdle && !dValid
+  io.tl.d.valid := dValid
+  io.tl.d.bits := dReg
+
+  val dFree = !dValid || io.tl.d.ready
+  when(dValid && io.tl.d.ready) {
+    dValid := false.B
+  }
+
+  def startResponse(opcode: UInt, data: UInt, error: Bool): Unit = {
+    dReg.opcode := opcode
+    dReg.param := 0.U
+    dReg.size := aReg.size
+    dReg.source := aReg.source
+    dReg.denied := error
+    dReg.data := data
+    dReg.corrupt := false.B
+    dValid := true.B
+  }
+
+  when(state === sIdle) {
+    when(io.tl.a.fire) {
+      aReg := io.tl.a.bits
+      beats := TLBeats(io.tl.a.bits.size, tlParams)
+      beat := 0.U
+      state := Mux(io.tl.a.bits.opcode === TLOpcodesA.Get, sRead, sWrite)
+    }
+  }
+
+  when(state === sWrite) {
+    io.ahb.hsel := true.B
+    io.ahb.haddr := aReg.address
+    io.ahb.hwrite := true.B
+    io.ahb.htrans := AHBTrans.NONSEQ
+    io.ahb.hsize := aReg.size
+    io.ahb.hwdata := aReg.data
+    when(io.ahb.hready) {
+      startResponse(TLOpcodesD.AccessAck, 0.U, io.ahb.hresp)
+      state := sIdle
+    }
+  }
+
+  when(state === sRead) {
+    io.ahb.hsel := true.B
+    io.ahb.haddr := aReg.address + (beat << beatSize)
+    io.ahb.htrans := Mux(!dFree, AHBTrans.BUSY, Mux(beat === 0.U, AHBTrans.NONSEQ, AHBTrans.SEQ))
+    io.ahb.hsize := Mux(aReg.size > beatSize.U, beatSize.U, aReg.size)
+    io.ahb.hburst := burstType
+    when(dFree && io.ahb.hready) {
+      startResponse(TLOpcodesD.AccessAckData, io.ahb.hrdata, io.ahb.hresp)
+      beat := beat + 1.U
+      when(beat === beats - 1.U) {
+        state := sIdle
+      }
+    }
+  }
+}
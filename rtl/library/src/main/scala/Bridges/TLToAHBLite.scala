@@ -5,10 +5,13 @@ import TileLink._
 import AXI4._
 import AHB._
 
-/** TileLink-UL to AHB-Lite bridge via AXI4-Lite (single outstanding transaction). */
+/** TileLink-UL to AHB-Lite bridge via AXI4-Lite (single outstanding transaction).
+  * With burst = true, multibeat Gets go straight to AHB bursts through TLToAHBBurst instead.
+  */
 class TLToAHBLite(tlParams: TLParams = TLParams(),
                   axiParams: AXI4LiteParams = AXI4LiteParams(),
-                  ahbParams: AHBLiteParams = AHBLiteParams()) extends Module {
+                  ahbParams: AHBLiteParams = AHBLiteParams(),
+                  burst: Boolean = false) extends Module {
   require(tlParams.dataBits == axiParams.dataBits, "TL and AXI data widths must match")
   require(axiParams.dataBits == ahbParams.dataBits, "AXI and AHB data widths must match")
   val io = IO(new Bundle {
@@ -16,10 +19,16 @@ class TLToAHBLite(tlParams: TLParams = TLParams(),
     val ahb = new AHBLiteIO(ahbParams)
   })
 
-  private val tlToAxi = Module(new TLToAXI4Lite(tlParams, axiParams))
-  private val axiToAhb = Module(new AXI4LiteToAHBLite(axiParams, ahbParams))
+  if (burst) {
+    val tlToAhb = Module(new TLToAHBBurst(tlParams, ahbParams))
+    tlToAhb.io.tl <> io.tl
+    io.ahb <> tlToAhb.io.ahb
+  } else {
+    val tlToAxi = Module(new TLToAXI4Lite(tlParams, axiParams))
+    val axiToAhb = Module(new AXI4LiteToAHBLite(axiParams, ahbParams))
 
-  tlToAxi.io.tl <> io.tl
-  axiToAhb.io.axi <> tlToAxi.io.axi
-  io.ahb <> axiToAhb.io.ahb
+    tlToAxi.io.tl <> io.tl
+    axiToAhb.io.axi <> tlToAxi.io.axi
+    io.ahb <> axiToAhb.io.ahb
+  }
 }
@@ -0,0 +1,118 @@
+package Bridges
+
+import chisel3._
+import chisel3.util._
+import TileLink._
+import AXI4._
+
+/** TileLink to full AXI4 bridge (single outstanding transaction).
+  * A multibeat Get becomes one INCR read burst whose R beats are returned as
+  * AccessAckData beats; Puts are single-beat writes.
+  */
+class TLToAXI4(tlParams: TLParams = TLParams(), axiParams: AXI4Params = AXI4Params()) extends Module {
+  require(tlParams.dataBits == axiParams.dataBits, "TL and AXI data widths must match for this bridge")
+  require(tlParams.maxBurstBeats <= 256, "AXI4 INCR bursts are limited to 256 beats")
+  val io = IO(new Bundle {
+    val tl  = Flipped(new TLBundleUL(tlParams))
+    val axi = new AXI4IO(axiParams)
+  })
+
+  private val beatSize = log2Ceil(tlParams.beatBytes)
+
+  val sIdle :: sWrite :: sWriteResp :: sReadAddr :: sReadData :: Nil = Enum(5)
+  val state = RegInit(sIdle)
+
+  val aReg = RegInit(0.U.asTypeOf(new TLBundleA(tlParams)))
+  val dReg = RegInit(0.U.asTypeOf(new TLBundleD(tlParams)))
+  val dValid = RegInit(false.B)
+
+  val awSent = RegInit(false.B)
+  val wSent = RegInit(false.B)
+
+  // Default AXI signals
+  io.axi.aw.valid := false.B
+  io.axi.aw.bits.id := aReg.source
+  io.axi.aw.bits.addr := aReg.address
+  io.axi.aw.bits.len := 0.U
+  io.axi.aw.bits.size := beatSize.U
+  io.axi.aw.bits.burst := AXI4Burst.INCR
+  io.axi.aw.bits.prot := 0.U
+  io.axi.w.valid := false.B
+  io.axi.w.bits.data := aReg.data
+  io.axi.w.bits.strb := aReg.mask
+  io.axi.w.bits.last := true.B
+  io.axi.ar.valid := false.B
+  io.axi.ar.bits.id := aReg.source
+  io.axi.ar.bits.addr := aReg.address
+  io.axi.ar.bits.len := TLBeats(aReg.size, tlParams) - 1.U
+  io.axi.ar.bits.size := Mux(aReg.size > beatSize.U, beatSize.U, aReg.size)
+  io.axi.ar.bits.burst := AXI4Burst.INCR
+  io.axi.ar.bits.prot := 0.U
+  io.axi.b.ready := state === sWriteResp && !dValid
+  // Each R beat needs a free D slot.
+  io.axi.r.ready := state === sReadData && (!dValid || io.tl.d.ready)
+
+  // TL defaults
+  io.tl.a.ready := state === sIdle && !dValid
+  io.tl.d.valid := dValid
+  io.tl.d.bits := dReg
+
+  when(dValid && io.tl.d.ready) {
+    dValid := false.B
+  }
+
+  def startResponse(opcode: UInt, data: UInt, resp: UInt): Unit = {
+    dReg.opcode := opcode
+    dReg.param := 0.U
+    dReg.size := aReg.size
+    dReg.source := aReg.source
+    dReg.denied := resp =/= AXI4LiteResp.OKAY
+    dReg.data := data
+    dReg.corrupt := false.B
+    dValid := true.B
+  }
+
+  when(state === sIdle) {
+    awSent := false.B
+    wSent := false.B
+    when(io.tl.a.fire) {
+      aReg := io.tl.a.bits
+      when(io.tl.a.bits.opcode === TLOpcodesA.Get) {
+        state := sReadAddr
+      }.otherwise {
+        state := sWrite
+      }
+    }
+  }
+
+  when(state === sWrite) {
+    io.axi.aw.valid := !awSent
+    io.axi.w.valid := !wSent
+    when(io.axi.aw.fire) { awSent := true.B }
+    when(io.axi.w.fire) { wSent := true.B }
+    when(awSent && wSent) { state := sWriteResp }
+  }
+
+  when(state === sWriteResp) {
+    when(io.axi.b.fire) {
+      startResponse(TLOpcodesD.AccessAck, 0.U, io.axi.b.bits.resp)
+      state := sIdle
+    }
+  }
+
+  when(state === sReadAddr) {
+    io.axi.ar.valid := true.B
+    when(io.axi.ar.fire) {
+      state := sReadData
+    }
+  }
+
+  when(state === sReadData) {
+    when(io.axi.r.fire) {
+      startResponse(TLOpcodesD.AccessAckData, io.axi.r.bits.data, io.axi.r.bits.resp)
+      when(io.axi.r.bits.last) {
+        state := sIdle
+      }
+    }
+  }
+}
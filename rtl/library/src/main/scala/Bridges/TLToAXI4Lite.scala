@@ -8,6 +8,7 @@ import AXI4._
 /** TileLink-UL to AXI4-Lite bridge (single outstanding transaction). */
 class TLToAXI4Lite(tlParams: TLParams = TLParams(), axiParams: AXI4LiteParams = AXI4LiteParams()) extends Module {
   require(tlParams.dataBits == axiParams.dataBits, "TL and AXI data widths must match for this bridge")
+  require(tlParams.maxBurstBeats == 1, "AXI4-Lite is single-beat; use TLToAXI4 for multibeat Gets")
   val io = IO(new Bundle {
     val tl  = Flipped(new TLBundleUL(tlParams))
     val axi = new AXI4LiteIO(axiParams)
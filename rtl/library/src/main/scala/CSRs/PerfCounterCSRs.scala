@@ -0,0 +1,144 @@
+// Licensed under the BSD 3-Clause License.
+// See https://opensource.org/licenses/BSD-3-Clause for details.
+
+package CSRs
+
+import chisel3._
+import chisel3.util._
+
+object PerfCounterCSRs {
+  // CSR instruction commands: funct3(1,0) of CSRRW/CSRRS/CSRRC and their immediate forms.
+  val CMD_RW = 1.U(2.W)
+  val CMD_RS = 2.U(2.W)
+  val CMD_RC = 3.U(2.W)
+
+  // Machine counters (read/write) and their user-mode read-only shadows.
+  val MCYCLE        = 0xB00
+  val MINSTRET      = 0xB02
+  val MHPMCOUNTER3  = 0xB03
+  val MCYCLEH       = 0xB80
+  val MINSTRETH     = 0xB82
+  val MHPMCOUNTER3H = 0xB83
+  val CYCLE         = 0xC00
+  val TIME          = 0xC01
+  val INSTRET       = 0xC02
+  val HPMCOUNTER3   = 0xC03
+  val CYCLEH        = 0xC80
+  val TIMEH         = 0xC81
+  val INSTRETH      = 0xC82
+  val HPMCOUNTER3H  = 0xC83
+  val MCOUNTINHIBIT = 0x320
+  val MHPMEVENT3    = 0x323
+  val MHARTID       = 0xF14
+
+  // Hardwired events of mhpmcounter3.. (the value read back from mhpmevent3..).
+  val EVENT_ICACHE_MISS  = 1
+  val EVENT_BRANCH_TAKEN = 2
+  val EVENT_SLOT_BUBBLE  = 3
+  val numEvents = 3
+
+  /** True for Zicsr instructions (SYSTEM opcode with a non-zero funct3). */
+  def isCsrInstr(instr: UInt): Bool =
+    instr(6, 0) === "b1110011".U && instr(14, 12) =/= 0.U
+
+  /** Writes happen for CSRRW(I) always, for CSRRS(I)/CSRRC(I) only with a non-zero rs1/uimm. */
+  def writesCsr(instr: UInt): Bool =
+    instr(13, 12) === CMD_RW || instr(19, 15) =/= 0.U
+
+  /** Write operand: rs1 data, or the zero-extended 5-bit immediate for the *I forms. */
+  def operand(instr: UInt, rs1Data: UInt): UInt =
+    Mux(instr(14), Cat(0.U(27.W), instr(19, 15)), rs1Data)
+}
+
+/** One CSR access per cycle, issued by the hart executing a Zicsr instruction. */
+class CSRAccess(hartBits: Int) extends Bundle {
+  val valid = Bool()
+  val hart  = UInt(hartBits.W)
+  val addr  = UInt(12.W)
+  val cmd   = UInt(2.W)
+  val wen   = Bool()
+  val wdata = UInt(32.W)
+}
+
+/**
+  * Zicntr/Zihpm counters for a core with `numHarts` hardware threads.
+  *
+  * Every hart has its own mcycle, minstret, mhpmcounter3..5 and mcountinhibit;
+  * accesses are resolved against the hart in `io.access.hart`. The user-mode
+  * aliases read the same counters (time reads as cycle: there is no mtime),
+  * writes to them are ignored, and unimplemented CSRs read as zero because
+  * the cores do not take illegal-instruction traps.
+  *
+  * The event inputs are sampled every cycle:
+  *   events(h)(0)  I-cache miss started (mhpmcounter3)
+  *   events(h)(1)  taken branch or jump  (mhpmcounter4)
+  *   events(h)(2)  fetch slot of hart h that issued nothing (mhpmcounter5)
+  */
+class PerfCounterCSRs(numHarts: Int) extends Module {
+  import PerfCounterCSRs._
+
+  val hartBits = math.max(1, log2Ceil(numHarts))
+
+  val io = IO(new Bundle {
+    val access  = Input(new CSRAccess(hartBits))
+    val rdata   = Output(UInt(32.W))
+    val retire  = Input(Vec(numHarts, Bool()))
+    val events  = Input(Vec(numHarts, Vec(numEvents, Bool())))
+  })
+
+  val cycle   = RegInit(VecInit(Seq.fill(numHarts)(0.U(64.W))))
+  val instret = RegInit(VecInit(Seq.fill(numHarts)(0.U(64.W))))
+  val hpm     = RegInit(VecInit(Seq.fill(numHarts)(VecInit(Seq.fill(numEvents)(0.U(64.W))))))
+  // mcountinhibit bits: CY (0), IR (2) and HPM3.. (3..); TM (1) is read-only zero.
+  val inhibitMask = ((1 << (3 + numEvents)) - 1) & ~0x2
+  val inhibit = RegInit(VecInit(Seq.fill(numHarts)(0.U(32.W))))
+
+  // ---------- Read ----------
+  val h = if (numHarts == 1) 0.U else io.access.hart
+  val reads = Seq(
+    MCYCLE -> cycle(h)(31, 0),      MCYCLEH -> cycle(h)(63, 32),
+    CYCLE -> cycle(h)(31, 0),       CYCLEH -> cycle(h)(63, 32),
+    TIME -> cycle(h)(31, 0),        TIMEH -> cycle(h)(63, 32),
+    MINSTRET -> instret(h)(31, 0),  MINSTRETH -> instret(h)(63, 32),
+    INSTRET -> instret(h)(31, 0),   INSTRETH -> instret(h)(63, 32),
+    MCOUNTINHIBIT -> inhibit(h),
+    MHARTID -> h.pad(32)
+  ) ++ (0 until numEvents).flatMap { i =>
+    Seq(
+      (MHPMCOUNTER3 + i) -> hpm(h)(i)(31, 0), (MHPMCOUNTER3H + i) -> hpm(h)(i)(63, 32),
+      (HPMCOUNTER3 + i) -> hpm(h)(i)(31, 0),  (HPMCOUNTER3H + i) -> hpm(h)(i)(63, 32),
+      (MHPMEVENT3 + i) -> (EVENT_ICACHE_MISS + i).U(32.W)
+    )
+  }
+  val oldValue = MuxLookup(io.access.addr, 0.U(32.W))(reads.map { case (a, v) => a.U(12.W) -> v })
+  io.rdata := oldValue
+
+  // ---------- Write ----------
+  val newValue = MuxLookup(io.access.cmd, oldValue)(Seq(
+    CMD_RW -> io.access.wdata,
+    CMD_RS -> (oldValue | io.access.wdata),
+    CMD_RC -> (oldValue & ~io.access.wdata)
+  ))
+  val doWrite = io.access.valid && io.access.wen
+
+  for (t <- 0 until numHarts) {
+    val sel = doWrite && io.access.hart === t.U
+
+    // A software write to either half replaces that cycle's increment.
+    def update(counter: UInt, inc: Bool, inhibitBit: Int, lo: Int, hi: Int): Unit = {
+      val next = WireDefault(counter + (inc && !inhibit(t)(inhibitBit)).asUInt)
+      when(sel && io.access.addr === lo.U) { next := Cat(counter(63, 32), newValue) }
+      when(sel && io.access.addr === hi.U) { next := Cat(newValue, counter(31, 0)) }
+      counter := next
+    }
+
+    update(cycle(t), true.B, 0, MCYCLE, MCYCLEH)
+    update(instret(t), io.retire(t), 2, MINSTRET, MINSTRETH)
+    for (i <- 0 until numEvents) {
+      update(hpm(t)(i), io.events(t)(i), 3 + i, MHPMCOUNTER3 + i, MHPMCOUNTER3H + i)
+    }
+    when(sel && io.access.addr === MCOUNTINHIBIT.U) {
+      inhibit(t) := newValue & inhibitMask.U(32.W)
+    }
+  }
+}
@@ -8,8 +8,12 @@ import chisel3.util._
   *
   * @param numThreads Number of hardware threads supported.
   * @param stageCount Number of pipeline stages participating in the barrel (default 8).
+  * @param policy     Fixed rotates through every thread, disabled or not; Dynamic gives
+  *                   each advance to the next enabled thread, and the owners then move
+  *                   down the stages with it.
   */
-class PipelineScheduler(numThreads: Int, stageCount: Int = 8) extends Module {
+class PipelineScheduler(numThreads: Int, stageCount: Int = 8,
+                        policy: SchedulePolicy = SchedulePolicy.Fixed) extends Module {
   private val threadBits = log2Ceil(numThreads)
 
   val io = IO(new Bundle {
@@ -20,17 +24,40 @@ class PipelineScheduler(numThreads: Int, stageCount: Int = 8) extends Module {
     val threadSelect = Output(UInt(threadBits.W)) // fetch stage owner for convenience
   })
 
-  val offset = RegInit(0.U(threadBits.W))
-  when(io.advance) {
-    offset := Mux(offset === (numThreads - 1).U, 0.U, offset + 1.U)
-  }
+  policy match {
+    case SchedulePolicy.Fixed =>
+      val offset = RegInit(0.U(threadBits.W))
+      when(io.advance) {
+        offset := Mux(offset === (numThreads - 1).U, 0.U, offset + 1.U)
+      }
+
+      val extended = offset + numThreads.U((threadBits + 1).W)
+      for (stage <- 0 until stageCount) {
+        val owner = (extended - stage.U)((threadBits + 1) - 1, 0)
+        val threadId = owner(threadBits - 1, 0)
+        io.stageThreads(stage) := threadId
+        io.stageValids(stage) := io.threadEnable(threadId)
+      }
+
+    case SchedulePolicy.Dynamic =>
+      val owners = RegInit(VecInit(Seq.fill(stageCount)(0.U(threadBits.W))))
+      val issued = RegInit(VecInit(Seq.fill(stageCount)(false.B)))
+      when(io.advance) {
+        val current = owners(0)
+        val first = Mux(issued(0), Mux(current === (numThreads - 1).U, 0.U, current + 1.U), current)
+        val (found, next) = ThreadScheduler.nextEligible(first, io.threadEnable)
+        owners(0) := Mux(found, next, current)
+        issued(0) := found
+        for (stage <- 1 until stageCount) {
+          owners(stage) := owners(stage - 1)
+          issued(stage) := issued(stage - 1)
+        }
+      }
 
-  val extended = offset + numThreads.U((threadBits + 1).W)
-  for (stage <- 0 until stageCount) {
-    val owner = (extended - stage.U)((threadBits + 1) - 1, 0)
-    val threadId = owner(threadBits - 1, 0)
-    io.stageThreads(stage) := threadId
-    io.stageValids(stage) := io.threadEnable(threadId)
+      for (stage <- 0 until stageCount) {
+        io.stageThreads(stage) := owners(stage)
+        io.stageValids(stage) := issued(stage) && io.threadEnable(owners(stage))
+      }
   }
 
   io.threadSelect := io.stageThreads(0)
@@ -3,34 +3,107 @@ package Pipeline
 import chisel3._
 import chisel3.util._
 
+// How a barrel scheduler hands out slots.
+sealed trait SchedulePolicy
+object SchedulePolicy {
+  case object Fixed extends SchedulePolicy   // every thread in turn, enabled or not
+  case object Dynamic extends SchedulePolicy // round-robin over the threads that can take the slot
+
+  def apply(name: String): SchedulePolicy = name match {
+    case "fixed"   => Fixed
+    case "dynamic" => Dynamic
+    case other => throw new IllegalArgumentException(
+      s"unknown thread schedule $other (expected fixed or dynamic)")
+  }
+}
+
+object ThreadScheduler {
+  /** First eligible thread in round-robin order starting at `first`, and
+    * whether there is one. `first` must be below eligible.size.
+    */
+  def nextEligible(first: UInt, eligible: Seq[Bool]): (Bool, UInt) = {
+    val n = eligible.size
+    val eligibleVec = VecInit(eligible)
+    val order = Seq.tabulate(n) { k =>
+      val candidate = first +& k.U
+      Mux(candidate >= n.U, candidate - n.U, candidate)(log2Ceil(n) - 1, 0)
+    }
+    val hits = order.map(eligibleVec(_))
+    (hits.reduce(_ || _), PriorityMux(hits, order))
+  }
+}
 
 /**
-  * Simple round-robin thread scheduler for barrel-threaded pipelines.
+  * Round-robin thread scheduler for barrel-threaded pipelines.
   *
-  * - Advances every cycle to the next thread.
-  * - Wraps modulo `numThreads` and starts from `startingThread`.
+  * - Fixed: advances every cycle to the next thread, wrapping modulo
+  *   `numThreads` from `startingThread`; `ready` is ignored.
+  * - Dynamic: each slot goes to the next thread in round-robin order that is
+  *   `ready` and did not hold any of the last `reissueCycles - 1` slots, so a
+  *   pipeline without interlocks can set the spacing its hazards need. With
+  *   no such thread the slot is empty (`currentValid` low).
   */
-class ThreadScheduler(numThreads: Int, startingThread: Int = 0) extends Module {
+class ThreadScheduler(numThreads: Int, startingThread: Int = 0,
+                      policy: SchedulePolicy = SchedulePolicy.Fixed, reissueCycles: Int = 1) extends Module {
+  require(reissueCycles >= 1, s"reissueCycles must be at least 1, got $reissueCycles")
   private val threadBits = log2Ceil(numThreads)
   val io = IO(new Bundle {
+    val ready         = Input(Vec(numThreads, Bool()))  // Dynamic: thread may take the next slot
     val currentThread = Output(UInt(threadBits.W))
+    val currentValid  = Output(Bool())                   // always high when Fixed
     val stageThreads  = Output(Vec(numThreads, UInt(threadBits.W))) // stage 0=fetch, 1=decode, ..., stageCount-1=WB
   })
 
   val sel = RegInit(startingThread.U(threadBits.W))
   io.currentThread := sel
 
-  // Always advance in round-robin order: 0,1,2,...,N-1,0,...
-  val atLast = sel === (numThreads - 1).U
-  sel := Mux(atLast, 0.U, sel + 1.U)
-
-  // Derive per-stage thread IDs assuming a fully-pipelined barrel where each stage lags fetch by its index.
-  // stage 0 = fetch, stage 1 = decode (fetch from previous cycle), stage 2 = dispatch, etc.
-  // thread for stage i = (sel - i) mod numThreads
-  val base = sel + numThreads.U // ensure non-negative before subtracting
-  for (i <- 0 until numThreads) {
-    val off = i.U
-    val tmp = base - off
-    io.stageThreads(i) := tmp(threadBits - 1, 0)
+  policy match {
+    case SchedulePolicy.Fixed =>
+      io.currentValid := true.B
+
+      // Always advance in round-robin order: 0,1,2,...,N-1,0,...
+      val atLast = sel === (numThreads - 1).U
+      sel := Mux(atLast, 0.U, sel + 1.U)
+
+      // Derive per-stage thread IDs assuming a fully-pipelined barrel where each stage lags fetch by its index.
+      // stage 0 = fetch, stage 1 = decode (fetch from previous cycle), stage 2 = dispatch, etc.
+      // thread for stage i = (sel - i) mod numThreads
+      val base = sel + numThreads.U // ensure non-negative before subtracting
+      for (i <- 0 until numThreads) {
+        val off = i.U
+        val tmp = base - off
+        io.stageThreads(i) := tmp(threadBits - 1, 0)
+      }
+
+    case SchedulePolicy.Dynamic =>
+      // No slot is issued before the first pick, which starts at startingThread.
+      val selValid = RegInit(false.B)
+      io.currentValid := selValid
+
+      // Owners of the slots before the current one, most recent first.
+      val historyDepth = (numThreads - 1) max (reissueCycles - 2) max 1
+      val historyThread = Reg(Vec(historyDepth, UInt(threadBits.W)))
+      val historyValid = RegInit(VecInit(Seq.fill(historyDepth)(false.B)))
+      val slotThread = sel +: historyThread
+      val slotValid = selValid +: historyValid
+
+      val eligible = Seq.tabulate(numThreads) { t =>
+        val recent = (0 until reissueCycles - 1).map(i => slotValid(i) && slotThread(i) === t.U)
+        io.ready(t) && !recent.foldLeft(false.B)(_ || _)
+      }
+      val atLast = sel === (numThreads - 1).U
+      val first = Mux(selValid, Mux(atLast, 0.U, sel + 1.U), sel)
+      val (found, next) = ThreadScheduler.nextEligible(first, eligible)
+
+      when(found) { sel := next }
+      selValid := found
+      for (i <- 0 until historyDepth) {
+        historyThread(i) := slotThread(i)
+        historyValid(i) := slotValid(i)
+      }
+
+      for (i <- 0 until numThreads) {
+        io.stageThreads(i) := slotThread(i)
+      }
   }
 }
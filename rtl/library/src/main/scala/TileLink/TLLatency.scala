@@ -0,0 +1,42 @@
+package TileLink
+
+import chisel3._
+import chisel3.util._
+
+class TLLatencyEntry(p: TLParams) extends Bundle {
+  val d   = new TLBundleD(p)
+  val due = UInt(32.W)
+}
+
+/** Latency injector for simulation: passes the A channel straight through and holds
+  * every D beat for `latency` cycles. Up to `depth` responses can be in flight, so
+  * depth should cover the master's outstanding accesses.
+  */
+class TLLatency(p: TLParams = TLParams(), latency: Int = 0, depth: Int = 8) extends Module {
+  require(latency >= 0, "latency must be non-negative")
+  val io = IO(new Bundle {
+    val in  = Flipped(new TLBundleUL(p))
+    val out = new TLBundleUL(p)
+  })
+
+  io.out.a <> io.in.a
+
+  if (latency == 0) {
+    io.in.d <> io.out.d
+  } else {
+    val now = RegInit(0.U(32.W))
+    now := now + 1.U
+
+    val pending = Module(new Queue(new TLLatencyEntry(p), depth))
+    pending.io.enq.valid := io.out.d.valid
+    pending.io.enq.bits.d := io.out.d.bits
+    pending.io.enq.bits.due := now + latency.U
+    io.out.d.ready := pending.io.enq.ready
+
+    // Wrap-safe: due is at most `latency` cycles ahead of now.
+    val due = (now - pending.io.deq.bits.due).asSInt >= 0.S
+    io.in.d.valid := pending.io.deq.valid && due
+    io.in.d.bits := pending.io.deq.bits.d
+    pending.io.deq.ready := io.in.d.ready && due
+  }
+}
@@ -4,11 +4,22 @@ import chisel3._
 import chisel3.util._
 
 // Minimal TileLink-Uncached Lite parameters for a single master.
-case class TLParams(addrBits: Int = 32, dataBits: Int = 32, sourceBits: Int = 4) {
+// maxBurstBeats > 1 additionally allows TL-UH style multibeat Gets: one A beat with
+// size up to beatBytes * maxBurstBeats, answered by one AccessAckData beat per word.
+case class TLParams(addrBits: Int = 32, dataBits: Int = 32, sourceBits: Int = 4, maxBurstBeats: Int = 1) {
   require(dataBits % 8 == 0, "dataBits must be byte-addressable")
+  require(isPow2(maxBurstBeats), "maxBurstBeats must be a power of two")
   val beatBytes: Int = dataBits / 8
-  // Allow sizes up to the beat width; width+1 keeps room for a future burst size.
-  val sizeBits: Int = log2Ceil(beatBytes) + 1
+  // Allow sizes up to the largest burst; width+1 keeps room for a future larger size.
+  val sizeBits: Int = log2Ceil(beatBytes * maxBurstBeats) + 1
+}
+
+object TLBeats {
+  /** Number of D beats answering a Get of the given size (log2 of bytes). */
+  def apply(size: UInt, p: TLParams): UInt = {
+    val beatSize = log2Ceil(p.beatBytes)
+    Mux(size > beatSize.U, 1.U << (size - beatSize.U), 1.U)
+  }
 }
 
 object TLOpcodesA {
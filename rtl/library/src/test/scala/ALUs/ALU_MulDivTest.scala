@@ -86,4 +86,112 @@ class ALU_MulDivTest extends AnyFlatSpec with Matchers {
       runDiv(-0x80000000L, -1, signed = true, expectedQ = 0x80000000L, expectedR = 0)
     }
   }
+
+  for (stages <- Seq(2, 3)) {
+    s"Mul32Pipelined($stages)" should s"produce each product ${stages - 1} cycles after its operands" in {
+      simulate(new Mul32Pipelined(stages)) { dut =>
+        def toTwos(value: BigInt, bits: Int): BigInt = {
+          val base = BigInt(1) << bits
+          ((value % base) + base) % base
+        }
+
+        // (a, b, signedA, signedB) issued back to back, one per cycle.
+        val cases = Seq[(BigInt, BigInt, Boolean, Boolean)](
+          (3, 4, false, false),
+          (-7, 5, true, true),
+          (-7, 5, true, false),
+          (6, -3, false, true),
+          (-0x80000000L, -0x80000000L, true, true),
+          (0xffffffffL, 0xffffffffL, false, false),
+          (-1, 0xffffffffL, true, false),
+          (0x12345678L, -0x6789abcdL, true, true)
+        )
+
+        def product(c: (BigInt, BigInt, Boolean, Boolean)): BigInt = {
+          val (a, b, signedA, signedB) = c
+          val opA = if (signedA) a else toTwos(a, 32)
+          val opB = if (signedB) b else toTwos(b, 32)
+          toTwos(opA * opB, 64)
+        }
+
+        for (i <- 0 until cases.size + stages - 1) {
+          if (i < cases.size) {
+            val (a, b, signedA, signedB) = cases(i)
+            dut.io.a.poke(toTwos(a, 32).U)
+            dut.io.b.poke(toTwos(b, 32).U)
+            dut.io.signedA.poke(signedA.B)
+            dut.io.signedB.poke(signedB.B)
+          }
+          val issued = i - (stages - 1)
+          if (issued >= 0) {
+            val exp64 = product(cases(issued))
+            dut.io.product.expect(exp64.U)
+            dut.io.lo.expect((exp64 & 0xffffffffL).U)
+            dut.io.hi.expect((exp64 >> 32).U)
+          }
+          dut.clock.step()
+        }
+      }
+    }
+  }
+
+  for ((radix, earlyOut) <- Seq((4, false), (4, true), (16, false), (16, true))) {
+    val name = s"Div32Iterative(radix $radix${if (earlyOut) ", early-out" else ""})"
+    name should "match RV32M results and take the expected number of cycles" in {
+      simulate(new Div32Iterative(radix, earlyOut)) { dut =>
+        def toTwos(value: BigInt, bits: Int): BigInt = {
+          val base = BigInt(1) << bits
+          ((value % base) + base) % base
+        }
+
+        val bitsPerCycle = if (radix == 16) 4 else 2
+        val digits = 32 / bitsPerCycle
+
+        // Cycles from start to done, counting the start cycle.
+        def expectedCycles(dividend: BigInt, divisor: BigInt, signed: Boolean): Int = {
+          if (divisor == 0) return 1
+          val magnitude = if (signed && dividend < 0) -dividend else toTwos(dividend, 32)
+          val skip = if (earlyOut) (32 - magnitude.bitLength) / bitsPerCycle else 0
+          if (skip == digits) 1 else digits - skip + 1
+        }
+
+        def runDiv(dividend: BigInt, divisor: BigInt, signed: Boolean, expectedQ: BigInt, expectedR: BigInt): Unit = {
+          dut.io.dividend.poke(toTwos(dividend, 32).U)
+          dut.io.divisor.poke(toTwos(divisor, 32).U)
+          dut.io.signed.poke(signed.B)
+          dut.io.start.poke(true.B)
+          dut.clock.step()
+          dut.io.start.poke(false.B)
+
+          var cycles = 1
+          while (!dut.io.done.peek().litToBoolean && cycles < 40) {
+            dut.io.busy.expect(true.B)
+            dut.clock.step()
+            cycles += 1
+          }
+
+          cycles shouldBe expectedCycles(dividend, divisor, signed)
+          dut.io.busy.expect(false.B)
+          dut.io.divideByZero.expect((divisor == 0).B)
+          dut.io.quotient.expect(toTwos(expectedQ, 32).U)
+          dut.io.remainder.expect(toTwos(expectedR, 32).U)
+        }
+
+        runDiv(100, 5, signed = false, expectedQ = 20, expectedR = 0)
+        runDiv(7, 3, signed = false, expectedQ = 2, expectedR = 1)
+        runDiv(0, 3, signed = false, expectedQ = 0, expectedR = 0)
+        runDiv(-20, 3, signed = true, expectedQ = -6, expectedR = -2)
+        runDiv(20, -3, signed = true, expectedQ = -6, expectedR = 2)
+        runDiv(123, 0, signed = false, expectedQ = -1, expectedR = 123)
+        runDiv(-123, 0, signed = true, expectedQ = -1, expectedR = -123)
+        runDiv(0xb505L, -2, signed = true, expectedQ = -0x5a82L, expectedR = 1)
+        runDiv(-0xb503L, 0xb505L, signed = true, expectedQ = 0, expectedR = -0xb503L)
+        runDiv(0xffffffffL, 1, signed = false, expectedQ = 0xffffffffL, expectedR = 0)
+        runDiv(0xffffffffL, 0x10000L, signed = false, expectedQ = 0xffffL, expectedR = 0xffffL)
+        runDiv(0x12345678L, 0x1234L, signed = false, expectedQ = 0x10004L, expectedR = 0xda8L)
+        runDiv(-1, -1, signed = true, expectedQ = 1, expectedR = 0)
+        runDiv(-0x80000000L, -1, signed = true, expectedQ = -0x80000000L, expectedR = 0)
+      }
+    }
+  }
 }
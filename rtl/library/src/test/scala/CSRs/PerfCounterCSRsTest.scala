@@ -0,0 +1,103 @@
+// Licensed under the BSD 3-Clause License.
+// See https://opensource.org/licenses/BSD-3-Clause for details.
+
+// sbt "testOnly CSRs.PerfCounterCSRsTest"
+
+package CSRs
+
+import chisel3._
+import chisel3.simulator.EphemeralSimulator._
+import org.scalatest.flatspec.AnyFlatSpec
+
+class PerfCounterCSRsTest extends AnyFlatSpec {
+  import PerfCounterCSRs._
+
+  "PerfCounterCSRs" should "count cycles, retirements and events per hart and accept CSR writes" in {
+    simulate(new PerfCounterCSRs(2)) { dut =>
+      def idle(): Unit = {
+        dut.io.access.valid.poke(false.B)
+        dut.io.access.wen.poke(false.B)
+        dut.io.access.hart.poke(0.U)
+        dut.io.access.addr.poke(0.U)
+        dut.io.access.cmd.poke(0.U)
+        dut.io.access.wdata.poke(0.U)
+        for (h <- 0 until 2) {
+          dut.io.retire(h).poke(false.B)
+          for (e <- 0 until numEvents) dut.io.events(h)(e).poke(false.B)
+        }
+      }
+
+      def read(hart: Int, addr: Int): BigInt = {
+        dut.io.access.hart.poke(hart.U)
+        dut.io.access.addr.poke(addr.U)
+        dut.io.rdata.peek().litValue
+      }
+
+      def write(hart: Int, addr: Int, cmd: UInt, value: BigInt): Unit = {
+        dut.io.access.valid.poke(true.B)
+        dut.io.access.wen.poke(true.B)
+        dut.io.access.hart.poke(hart.U)
+        dut.io.access.addr.poke(addr.U)
+        dut.io.access.cmd.poke(cmd)
+        dut.io.access.wdata.poke(value.U(32.W))
+        dut.clock.step()
+        dut.io.access.valid.poke(false.B)
+        dut.io.access.wen.poke(false.B)
+      }
+
+      idle()
+      dut.reset.poke(true.B)
+      dut.clock.step()
+      dut.reset.poke(false.B)
+
+      // mcycle advances every cycle; the user alias and time read the same value.
+      dut.clock.step(5)
+      assert(read(0, MCYCLE) == 5)
+      assert(read(0, CYCLE) == 5)
+      assert(read(0, TIME) == 5)
+      assert(read(1, MCYCLE) == 5)
+
+      // minstret and the event counters follow their own hart's inputs only.
+      dut.io.retire(0).poke(true.B)
+      dut.io.events(1)(1).poke(true.B)
+      dut.clock.step(3)
+      dut.io.retire(0).poke(false.B)
+      dut.io.events(1)(1).poke(false.B)
+      assert(read(0, MINSTRET) == 3)
+      assert(read(1, MINSTRET) == 0)
+      assert(read(1, MHPMCOUNTER3 + 1) == 3)
+      assert(read(0, MHPMCOUNTER3 + 1) == 0)
+      assert(read(1, MHPMEVENT3 + 1) == EVENT_BRANCH_TAKEN)
+      assert(read(1, MHARTID) == 1)
+
+      // CSRRW replaces the low half; the carry reaches the high half.
+      write(0, MCYCLE, CMD_RW, BigInt("FFFFFFFF", 16))
+      assert(read(0, MCYCLE) == BigInt("FFFFFFFF", 16))
+      dut.clock.step()
+      assert(read(0, MCYCLE) == 0)
+      assert(read(0, MCYCLEH) == 1)
+
+      // CSRRS/CSRRC set and clear bits of the old value.
+      write(0, MINSTRET, CMD_RS, 0x10)
+      assert(read(0, MINSTRET) == 0x13)
+      write(0, MINSTRET, CMD_RC, 0x1)
+      assert(read(0, MINSTRET) == 0x12)
+
+      // mcountinhibit.IR freezes minstret; the other hart keeps counting.
+      write(0, MCOUNTINHIBIT, CMD_RW, 0x4)
+      dut.io.retire(0).poke(true.B)
+      dut.io.retire(1).poke(true.B)
+      dut.clock.step(4)
+      dut.io.retire(0).poke(false.B)
+      dut.io.retire(1).poke(false.B)
+      assert(read(0, MINSTRET) == 0x12)
+      assert(read(1, MINSTRET) == 4)
+      assert(read(0, MCOUNTINHIBIT) == 0x4)
+
+      // Writes to the user-mode aliases are ignored.
+      val before = read(1, MINSTRET)
+      write(1, INSTRET, CMD_RW, 0)
+      assert(read(1, MINSTRET) == before)
+    }
+  }
+}
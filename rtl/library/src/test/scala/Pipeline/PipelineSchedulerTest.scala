@@ -64,4 +64,34 @@ class PipelineSchedulerTest extends AnyFlatSpec {
       assert(seen == expectedSeq, s"Unexpected fetch sequence: $seen")
     }
   }
+
+  it should "skip disabled threads when scheduling dynamically" in {
+    val n = 8
+    val stages = 8
+    simulate(new PipelineScheduler(n, stages, SchedulePolicy.Dynamic)) { dut =>
+      val enabled = Set(2, 6, 7)
+      for (i <- 0 until n) dut.io.threadEnable(i).poke(enabled.contains(i).B)
+      dut.io.advance.poke(true.B)
+      dut.clock.step()
+
+      val seen = collection.mutable.ArrayBuffer[Int]()
+      for (cycle <- 0 until 12) {
+        assert(dut.io.stageValids(0).peek().litToBoolean, s"cycle $cycle: fetch slot empty")
+        seen += dut.io.threadSelect.peek().litValue.toInt
+        // Stage i holds the owner of the fetch slot i advances ago.
+        for (i <- 1 until stages if i <= cycle) {
+          assert(dut.io.stageThreads(i).peek().litValue.toInt == seen(cycle - i))
+          assert(dut.io.stageValids(i).peek().litToBoolean)
+        }
+        dut.clock.step()
+      }
+      assert(seen == Seq(2, 6, 7, 2, 6, 7, 2, 6, 7, 2, 6, 7), s"Unexpected fetch sequence: $seen")
+
+      // Holding advance freezes the stages.
+      dut.io.advance.poke(false.B)
+      val frozen = dut.io.stageThreads.map(_.peek().litValue.toInt)
+      dut.clock.step(3)
+      assert(dut.io.stageThreads.map(_.peek().litValue.toInt) == frozen)
+    }
+  }
 }
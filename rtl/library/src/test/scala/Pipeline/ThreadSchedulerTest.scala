@@ -39,4 +39,40 @@ class ThreadSchedulerTest extends AnyFlatSpec {
   it should "roll through 8 threads starting at 5" in {
     checkSequence(start = 5)
   }
+
+  // Owners of the first `cycles` slots of a dynamic scheduler, -1 for an empty slot.
+  private def dynamicSlots(ready: Set[Int], reissueCycles: Int, cycles: Int, start: Int = 0): Seq[Int] = {
+    var slots = Seq.empty[Int]
+    simulate(new ThreadScheduler(8, start, SchedulePolicy.Dynamic, reissueCycles)) { dut =>
+      for (t <- 0 until 8) dut.io.ready(t).poke(ready.contains(t).B)
+      dut.reset.poke(true.B)
+      dut.clock.step()
+      dut.reset.poke(false.B)
+      dut.io.currentValid.expect(false.B)
+      dut.clock.step()
+      slots = (0 until cycles).map { _ =>
+        val owner = if (dut.io.currentValid.peek().litToBoolean) dut.io.currentThread.peek().litValue.toInt else -1
+        if (owner >= 0) dut.io.stageThreads(0).expect(owner.U)
+        dut.clock.step()
+        owner
+      }
+    }
+    slots
+  }
+
+  it should "give every slot to the ready threads in turn when scheduling dynamically" in {
+    assert(dynamicSlots(Set(0, 1, 2, 3, 4, 5, 6, 7), 1, 10, start = 5) == Seq(5, 6, 7, 0, 1, 2, 3, 4, 5, 6))
+    assert(dynamicSlots(Set(2, 6), 1, 6) == Seq(2, 6, 2, 6, 2, 6))
+    assert(dynamicSlots(Set(3), 1, 4) == Seq(3, 3, 3, 3))
+  }
+
+  it should "keep a thread's slots reissueCycles apart" in {
+    assert(dynamicSlots(Set(3), 6, 13) == Seq(3, -1, -1, -1, -1, -1, 3, -1, -1, -1, -1, -1, 3))
+    assert(dynamicSlots(Set(1, 5), 6, 8) == Seq(1, 5, -1, -1, -1, -1, 1, 5))
+    assert(dynamicSlots((0 until 8).toSet, 6, 10) == Seq(0, 1, 2, 3, 4, 5, 6, 7, 0, 1))
+  }
+
+  it should "leave every slot empty when no thread is ready" in {
+    assert(dynamicSlots(Set.empty, 1, 4) == Seq(-1, -1, -1, -1))
+  }
 }
@@ -0,0 +1,35 @@
+#include "bench.h"
+
+extern volatile uint32_t tohost;
+
+static uint32_t roi_cycle_start;
+static uint32_t roi_instret_start[BENCH_MAX_HARTS];
+
+void bench_roi_begin(void) {
+  const uint32_t hart = bench_hartid();
+  if (hart == 0) {
+    roi_cycle_start = bench_mcycle();
+  }
+  roi_instret_start[hart] = bench_minstret();
+}
+
+void bench_roi_end(void) {
+  const uint32_t hart = bench_hartid();
+  begin_signature.roi_instret[hart] += bench_minstret() - roi_instret_start[hart];
+  if (hart == 0) {
+    begin_signature.roi_cycles += bench_mcycle() - roi_cycle_start;
+  }
+}
+
+__attribute__((weak)) void bench_worker(uint32_t hart) {
+  (void)hart;
+  for (;;) {
+  }
+}
+
+void bench_exit(int code) {
+  begin_signature.status = (uint32_t)code;
+  for (;;) {
+    tohost = ((uint32_t)code << 1) | 1u;
+  }
+}
@@ -0,0 +1,54 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+// Bare-metal runtime shared by the benchmarks in tests/bench.
+//
+// crt0.S starts every enabled hart at the reset vector, each on its own
+// stack below BENCH_STACK_TOP. Hart 0 runs main() and ends the run with
+// bench_exit(main's return value); every other hart calls bench_worker(),
+// which parks it unless the benchmark provides one. The harness memory
+// starts zeroed, so .bss is never cleared.
+//
+// bench_roi_begin()/bench_roi_end() bracket the measured region on the
+// calling hart. The signature is a struct bench_result that run_bench.py
+// turns into cycles and CPI.
+
+#include <stdint.h>
+
+#define BENCH_MAX_HARTS 8
+#define BENCH_STACK_TOP 0x81000000u
+#define BENCH_STACK_BYTES 0x10000u  // per hart
+
+struct bench_result {
+  uint32_t status;                        // bench_exit code
+  uint32_t roi_cycles;                    // mcycle inside hart 0's regions
+  uint32_t roi_instret[BENCH_MAX_HARTS];  // minstret inside each hart's regions
+};
+
+extern struct bench_result begin_signature;
+
+static inline uint32_t bench_hartid(void) {
+  uint32_t id;
+  __asm__ volatile("csrr %0, mhartid" : "=r"(id));
+  return id;
+}
+
+static inline uint32_t bench_mcycle(void) {
+  uint32_t value;
+  __asm__ volatile("csrr %0, mcycle" : "=r"(value));
+  return value;
+}
+
+static inline uint32_t bench_minstret(void) {
+  uint32_t value;
+  __asm__ volatile("csrr %0, minstret" : "=r"(value));
+  return value;
+}
+
+void bench_roi_begin(void);
+void bench_roi_end(void);
+void bench_worker(uint32_t hart);
+// Writes (code << 1) | 1 to tohost, so 0 passes.
+void bench_exit(int code) __attribute__((noreturn));
+
+#endif  // BENCH_H
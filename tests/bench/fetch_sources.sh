@@ -0,0 +1,31 @@
+#!/usr/bin/env bash
+# Clones the upstream benchmark sources at pinned revisions into
+# tests/bench/third_party, where run_bench.py compiles them. Override a pin
+# with COREMARK_REF, EMBENCH_REF or RISCV_TESTS_REF.
+set -euo pipefail
+
+SCRIPT_DIR=$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)
+THIRD_PARTY="$SCRIPT_DIR/third_party"
+
+COREMARK_REF=${COREMARK_REF:-v1.01}
+EMBENCH_REF=${EMBENCH_REF:-embench-1.0}
+RISCV_TESTS_REF=${RISCV_TESTS_REF:-master}
+
+fetch() {
+  local name=$1 url=$2 ref=$3
+  local dir="$THIRD_PARTY/$name"
+  if [[ ! -d "$dir/.git" ]]; then
+    git clone --quiet "$url" "$dir"
+  fi
+  git -C "$dir" fetch --quiet --tags origin
+  git -C "$dir" checkout --quiet "$ref"
+  echo "$name $(git -C "$dir" rev-parse HEAD)"
+}
+
+mkdir -p "$THIRD_PARTY"
+{
+  fetch coremark https://github.com/eembc/coremark.git "$COREMARK_REF"
+  fetch embench-iot https://github.com/embench/embench-iot.git "$EMBENCH_REF"
+  # Only benchmarks/dhrystone and benchmarks/common are used; no submodules.
+  fetch riscv-tests https://github.com/riscv-software-src/riscv-tests.git "$RISCV_TESTS_REF"
+} | tee "$THIRD_PARTY/REVISIONS"
@@ -0,0 +1,79 @@
+#ifndef CORE_PORTME_H
+#define CORE_PORTME_H
+
+// CoreMark port for the tests/bench runtime. Built with MULTITHREAD=N, the
+// N contexts run on harts 0..N-1 of a barrel core: hart 0 runs context 0
+// itself and the others pick theirs up in bench_worker().
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "bench.h"
+
+#define HAS_FLOAT 0
+#define HAS_TIME_H 0
+#define USE_CLOCK 0
+#define HAS_STDIO 0
+#define HAS_PRINTF 0
+#define MAIN_HAS_NOARGC 1
+#define MAIN_HAS_NORETURN 0
+#define SEED_METHOD SEED_VOLATILE
+
+#ifndef COMPILER_VERSION
+#define COMPILER_VERSION "GCC" __VERSION__
+#endif
+#ifndef COMPILER_FLAGS
+#define COMPILER_FLAGS FLAGS_STR
+#endif
+
+#ifndef ITERATIONS
+#define ITERATIONS 1
+#endif
+#if !defined(PROFILE_RUN) && !defined(PERFORMANCE_RUN) && !defined(VALIDATION_RUN)
+#define PERFORMANCE_RUN 1
+#endif
+
+#ifndef MULTITHREAD
+#define MULTITHREAD 1
+#endif
+// core_main refuses a static data area for more than one context; the
+// contexts then come from a bump allocator in core_portme.c.
+#if MULTITHREAD > 1
+#define PARALLEL_METHOD "Harts"
+#define MEM_METHOD MEM_MALLOC
+#define MEM_LOCATION "ARENA"
+#else
+#define MEM_METHOD MEM_STATIC
+#define MEM_LOCATION "STATIC"
+#endif
+#define USE_PTHREAD 0
+#define USE_FORK 0
+#define USE_SOCKET 0
+
+typedef int16_t ee_s16;
+typedef uint16_t ee_u16;
+typedef int32_t ee_s32;
+typedef uint8_t ee_u8;
+typedef uint32_t ee_u32;
+typedef uintptr_t ee_ptr_int;
+typedef size_t ee_size_t;
+
+// The harness reports real time; counting cycles as seconds keeps
+// CoreMark's ten-second minimum from flagging every short simulated run.
+typedef uint32_t CORE_TICKS;
+#define EE_TICKS_PER_SEC 1
+
+#define align_mem(x) (void *)(4 + (((ee_ptr_int)(x)-1) & ~3))
+
+typedef struct CORE_PORTABLE_S {
+  ee_u8 portable_id;
+  ee_u8 hart;  // hart running this context
+} core_portable;
+
+extern ee_u32 default_num_contexts;
+
+void portable_init(core_portable *p, int *argc, char *argv[]);
+void portable_fini(core_portable *p);
+int ee_printf(const char *fmt, ...);
+
+#endif  // CORE_PORTME_H
@@ -0,0 +1,9 @@
+// Output hooks for riscv-tests' dhrystone_main.c. The benchmark's report
+// is dropped; run_bench.py derives its numbers from the ROI signature.
+
+void debug_printf(const char *str, ...) { (void)str; }
+
+int printf(const char *fmt, ...) {
+  (void)fmt;
+  return 0;
+}
@@ -0,0 +1,30 @@
+#ifndef BENCH_DHRYSTONE_UTIL_H
+#define BENCH_DHRYSTONE_UTIL_H
+
+// Stands in for riscv-tests' benchmarks/common/util.h, which dhrystone.h
+// includes: setStats() brackets the measured loop with the bench ROI
+// instead of printing counter deltas through the riscv-tests syscalls.
+
+#include <stdint.h>
+
+#include "bench.h"
+
+#ifndef read_csr
+#define read_csr(reg)                                 \
+  ({                                                  \
+    unsigned long __tmp;                              \
+    __asm__ volatile("csrr %0, " #reg : "=r"(__tmp)); \
+    __tmp;                                            \
+  })
+#endif
+
+#define setStats(enable)   \
+  do {                     \
+    if (enable) {          \
+      bench_roi_begin();   \
+    } else {               \
+      bench_roi_end();     \
+    }                      \
+  } while (0)
+
+#endif  // BENCH_DHRYSTONE_UTIL_H
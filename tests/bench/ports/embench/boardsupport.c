@@ -0,0 +1,9 @@
+#include <support.h>
+
+#include "bench.h"
+
+void initialise_board(void) {}
+
+void __attribute__((noinline)) start_trigger(void) { bench_roi_begin(); }
+
+void __attribute__((noinline)) stop_trigger(void) { bench_roi_end(); }
@@ -0,0 +1,7 @@
+#ifndef BOARDSUPPORT_H
+#define BOARDSUPPORT_H
+
+// Embench board support for the tests/bench runtime. CPU_MHZ only scales
+// the iteration count of each kernel and is set by run_bench.py.
+
+#endif  // BOARDSUPPORT_H
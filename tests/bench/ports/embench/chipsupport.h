@@ -0,0 +1,4 @@
+#ifndef CHIPSUPPORT_H
+#define CHIPSUPPORT_H
+
+#endif  // CHIPSUPPORT_H
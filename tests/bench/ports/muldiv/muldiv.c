@@ -0,0 +1,89 @@
+// M-extension latency and throughput kernels for run_bench.py's muldiv-*
+// benchmarks. Each runs MULDIV_ITERATIONS blocks of MULDIV_BLOCK
+// instructions of one kind inside the ROI; the runner divides the ROI
+// cycles by the op count, so cycles per op include the two loop-control
+// instructions of each block.
+//
+// MULDIV_KERNEL selects the kernel:
+//   MULDIV_MUL_LAT    MUL, each on the previous product
+//   MULDIV_MUL_TPUT   independent MULs
+//   MULDIV_MULH_TPUT  independent MULHs
+//   MULDIV_DIV        DIVU of a full 32-bit dividend
+//   MULDIV_DIV_SMALL  DIVU of an 8-bit dividend, where an early-out divider
+//                     skips most digits
+//   MULDIV_REM        REM of negative operands
+
+#include "bench.h"
+
+#define MULDIV_MUL_LAT 1
+#define MULDIV_MUL_TPUT 2
+#define MULDIV_MULH_TPUT 3
+#define MULDIV_DIV 4
+#define MULDIV_DIV_SMALL 5
+#define MULDIV_REM 6
+
+#ifndef MULDIV_KERNEL
+#error "define MULDIV_KERNEL"
+#endif
+#ifndef MULDIV_ITERATIONS
+#define MULDIV_ITERATIONS 64
+#endif
+#define MULDIV_BLOCK 16  // run_bench.py counts ops with this
+
+#define REP4(s) s s s s
+#define REP16(s) REP4(REP4(s))
+
+// Volatile so the operands reach the kernels in registers at run time.
+static volatile uint32_t operand_a = 0x9e3779b9u;
+static volatile uint32_t operand_b = 0x7f4a7c15u;
+static volatile uint32_t operand_small = 0xc5u;
+static volatile uint32_t operand_divisor = 0x2bu;
+
+int main(void) {
+  const uint32_t a = operand_a;
+  const uint32_t b = operand_b;
+  const uint32_t small = operand_small;
+  const uint32_t d = operand_divisor;
+  uint32_t r = a;
+  (void)b;
+  (void)small;
+  (void)d;
+
+  bench_roi_begin();
+  for (int i = 0; i < MULDIV_ITERATIONS; ++i) {
+#if MULDIV_KERNEL == MULDIV_MUL_LAT
+    __asm__ volatile(REP16("mul %0, %0, %1\n") : "+r"(r) : "r"(b));
+#elif MULDIV_KERNEL == MULDIV_MUL_TPUT
+    __asm__ volatile(REP16("mul %0, %1, %2\n") : "=&r"(r) : "r"(a), "r"(b));
+#elif MULDIV_KERNEL == MULDIV_MULH_TPUT
+    __asm__ volatile(REP16("mulh %0, %1, %2\n") : "=&r"(r) : "r"(a), "r"(b));
+#elif MULDIV_KERNEL == MULDIV_DIV
+    __asm__ volatile(REP16("divu %0, %1, %2\n") : "=&r"(r) : "r"(a), "r"(d));
+#elif MULDIV_KERNEL == MULDIV_DIV_SMALL
+    __asm__ volatile(REP16("divu %0, %1, %2\n") : "=&r"(r) : "r"(small), "r"(d));
+#elif MULDIV_KERNEL == MULDIV_REM
+    __asm__ volatile(REP16("rem %0, %1, %2\n") : "=&r"(r) : "r"(a), "r"(-d));
+#else
+#error "unknown MULDIV_KERNEL"
+#endif
+  }
+  bench_roi_end();
+
+#if MULDIV_KERNEL == MULDIV_MUL_LAT
+  uint32_t expected = a;
+  for (int i = 0; i < MULDIV_ITERATIONS * MULDIV_BLOCK; ++i) {
+    expected *= b;
+  }
+#elif MULDIV_KERNEL == MULDIV_MUL_TPUT
+  const uint32_t expected = a * b;
+#elif MULDIV_KERNEL == MULDIV_MULH_TPUT
+  const uint32_t expected = (uint32_t)(((int64_t)(int32_t)a * (int32_t)b) >> 32);
+#elif MULDIV_KERNEL == MULDIV_DIV
+  const uint32_t expected = a / d;
+#elif MULDIV_KERNEL == MULDIV_DIV_SMALL
+  const uint32_t expected = small / d;
+#else
+  const uint32_t expected = (uint32_t)((int32_t)a % -(int32_t)d);
+#endif
+  return r == expected ? 0 : 1;
+}
@@ -0,0 +1,421 @@
+#!/usr/bin/env python3
+"""Benchmark runner: compile the bench suite and measure it on every core's simulator.
+
+The suite is CoreMark, Dhrystone and the integer embench-iot kernels, plus
+``coremark-mt``, CoreMark with one context per hardware thread of a barrel
+core, and the ``muldiv-*`` M-extension kernels of ``ports/muldiv``.
+``fetch_sources.sh`` clones the upstream sources; the ports under ``ports/``
+and the runtime in ``env/`` adapt them to the harness:
+
+* Every ELF is linked with ``tests/riscof/zeronyte/env/link.ld`` into
+  ``tests/bench/build/<benchmark>.elf`` (the path the DSE grids use).
+* Each benchmark brackets its measured region with ``bench_roi_begin`` and
+  ``bench_roi_end``, which accumulate ``mcycle`` and per-hart ``minstret`` into
+  the signature, so the numbers exclude setup and the harness's reset.
+* The simulators are the ones ``tests/sim/build_*_sim.sh`` build.
+
+For each core, benchmark and thread count the runner reports the ROI cycles
+and the CPI (``cycles / instructions retired by all harts``), and for
+``coremark-mt`` each thread's own CPI; ``--host-profile`` adds the simulator's
+own throughput from ``--perf-report``. The ``muldiv-*`` kernels also report
+cycles per MUL/DIV, and run only on the cores with the M extension. Results
+go to ``<out>/results.json``.
+
+``--mem-config`` runs the simulators with the harness memory timing model
+(``tests/sim/mem_timing.h``). The RTL's ``mcycle`` cannot see its stalls, so
+the ROI numbers stay zero-latency; ``timed`` is the whole run's cycle count
+with the stalls and ``mem_x`` its ratio to the simulated cycles.
+
+With ``--baseline`` (default ``tests/bench/baseline.json`` when it exists)
+every result is compared against its recorded ROI cycles and the run fails
+when one is more than ``--threshold`` slower; ``--update-baseline`` rewrites
+the baseline from this run instead.
+"""
+
+import argparse
+import json
+import logging
+import os
+import re
+import shlex
+import subprocess
+import sys
+from concurrent.futures import ThreadPoolExecutor
+from dataclasses import asdict, dataclass, field
+from typing import Dict, List, Optional
+
+logger = logging.getLogger("run_bench")
+
+REPO_ROOT = os.path.abspath(os.path.join(os.path.dirname(__file__), "..", ".."))
+BENCH_ROOT = os.path.join(REPO_ROOT, "tests", "bench")
+THIRD_PARTY = os.path.join(BENCH_ROOT, "third_party")
+LINK_SCRIPT = os.path.join(REPO_ROOT, "tests", "riscof", "zeronyte", "env", "link.ld")
+
+# Simulator, hardware thread count and M extension of each core, as built by tests/sim.
+CORES = {
+    "zeronyte": dict(sim="zeronyte_sim", threads=1, m=True),
+    "tetranyte": dict(sim="tetranyte_sim", threads=4, m=True),
+    "octonyte": dict(sim="octonyte_sim", threads=8, m=False),
+}
+
+EMBENCH_KERNELS = (
+    "aha-mont64", "crc32", "edn", "huffbench", "matmult-int", "nettle-aes", "nettle-sha256",
+    "nsichneu", "picojpeg", "qrduino", "sglib-combined", "slre", "statemate", "ud",
+)
+
+# muldiv-<kernel> -> MULDIV_KERNEL in ports/muldiv/muldiv.c.
+MULDIV_KERNELS = {
+    "mul-lat": "MULDIV_MUL_LAT", "mul-tput": "MULDIV_MUL_TPUT", "mulh-tput": "MULDIV_MULH_TPUT",
+    "div": "MULDIV_DIV", "div-small": "MULDIV_DIV_SMALL", "rem": "MULDIV_REM",
+}
+MULDIV_ITERATIONS = 64
+MULDIV_BLOCK = 16  # ops per iteration, MULDIV_BLOCK in muldiv.c
+
+# Harness summary line, e.g. "ZeroNyte: cycles=1234 tohost=0x1 timed=1500".
+_SUMMARY_RE = re.compile(r"^\w+: cycles=(\d+) tohost=0x([0-9a-fA-F]+)(?: skipped=\d+)?"
+                         r"(?: timed=(\d+))?", re.MULTILINE)
+
+MAX_HARTS = 8  # BENCH_MAX_HARTS in env/bench.h
+
+
+@dataclass
+class Benchmark:
+    name: str
+    sources: List[str]
+    includes: List[str]
+    defines: List[str] = field(default_factory=list)
+    # Number of CoreMark contexts; the run enables that many hardware threads.
+    threads: int = 1
+    # Extra compiler flags, after the common ones.
+    cflags: List[str] = field(default_factory=list)
+    # MUL/DIV instructions in the ROI of a muldiv kernel; needs the M extension.
+    ops: int = 0
+    elf: str = ""
+    error: str = ""
+
+
+@dataclass
+class BenchResult:
+    core: str
+    benchmark: str
+    threads: int
+    status: int = -1
+    total_cycles: Optional[int] = None
+    timed_cycles: Optional[int] = None  # total_cycles with --mem-config stalls
+    mem_slowdown: Optional[float] = None  # timed_cycles / total_cycles
+    roi_cycles: Optional[int] = None
+    roi_instret: Optional[int] = None
+    cpi: Optional[float] = None
+    cycles_per_op: Optional[float] = None  # muldiv kernels
+    thread_cpi: List[float] = field(default_factory=list)
+    baseline_cycles: Optional[int] = None
+    host_khz: Optional[float] = None  # simulated kHz, with --host-profile
+    detail: str = field(default="", repr=False)
+
+    @property
+    def key(self) -> str:
+        return f"{self.core}/{self.benchmark}"
+
+
+def _run(cmd: List[str], cwd: str = REPO_ROOT, log_path: str = ""):
+    logger.debug("running: %s", " ".join(shlex.quote(c) for c in cmd))
+    try:
+        proc = subprocess.run(cmd, cwd=cwd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+                              text=True)
+    except OSError as e:
+        proc = subprocess.CompletedProcess(cmd, 127, stdout=f"{cmd[0]}: {e}\n")
+    if log_path:
+        with open(log_path, "w") as log:
+            log.write(proc.stdout)
+    return proc
+
+
+def _tp(*parts: str) -> str:
+    return os.path.join(THIRD_PARTY, *parts)
+
+
+def _port(*parts: str) -> str:
+    return os.path.join(BENCH_ROOT, "ports", *parts)
+
+
+def suite(coremark_iterations: int, thread_counts: List[int]) -> List[Benchmark]:
+    coremark_sources = [_tp("coremark", f) for f in (
+        "core_list_join.c", "core_main.c", "core_matrix.c", "core_state.c", "core_util.c")]
+    coremark_sources.append(_port("coremark", "core_portme.c"))
+    coremark_includes = [_port("coremark"), _tp("coremark")]
+    coremark_defines = [f"ITERATIONS={coremark_iterations}", 'FLAGS_STR=""']
+
+    benchmarks = [
+        Benchmark("coremark", coremark_sources, coremark_includes, coremark_defines),
+        Benchmark("dhrystone",
+                  [_tp("riscv-tests", "benchmarks", "dhrystone", f)
+                   for f in ("dhrystone.c", "dhrystone_main.c")] +
+                  [_port("dhrystone", "dhrystone_port.c")],
+                  # The shim util.h must shadow benchmarks/common/util.h.
+                  [_port("dhrystone"), _tp("riscv-tests", "benchmarks", "dhrystone")]),
+    ]
+    support = _tp("embench-iot", "support")
+    for kernel in EMBENCH_KERNELS:
+        kernel_dir = _tp("embench-iot", "src", kernel)
+        sources = sorted(os.path.join(kernel_dir, f) for f in os.listdir(kernel_dir)
+                         if f.endswith(".c")) if os.path.isdir(kernel_dir) else []
+        benchmarks.append(Benchmark(
+            kernel, sources + [os.path.join(support, "main.c"), os.path.join(support, "beebsc.c"),
+                               _port("embench", "boardsupport.c")],
+            [_port("embench"), support, kernel_dir], ["CPU_MHZ=1", "WARMUP_HEAT=1"]))
+    for threads in thread_counts:
+        benchmarks.append(Benchmark(f"coremark-mt{threads}", coremark_sources, coremark_includes,
+                                    coremark_defines + [f"MULTITHREAD={threads}"],
+                                    threads=threads))
+    for kernel, define in MULDIV_KERNELS.items():
+        benchmarks.append(Benchmark(f"muldiv-{kernel}", [_port("muldiv", "muldiv.c")], [],
+                                    [f"MULDIV_KERNEL={define}",
+                                     f"MULDIV_ITERATIONS={MULDIV_ITERATIONS}"],
+                                    cflags=["-march=rv32im_zicsr"],
+                                    ops=MULDIV_ITERATIONS * MULDIV_BLOCK))
+    return benchmarks
+
+
+def compile_benchmark(bench: Benchmark, cc: str, cflags: List[str], build_dir: str):
+    bench.elf = os.path.join(build_dir, bench.name + ".elf")
+    missing = [s for s in bench.sources if not os.path.isfile(s)]
+    if missing or not bench.sources:
+        bench.error = f"missing {missing[0] if missing else 'sources'}; run fetch_sources.sh"
+        return
+    env_dir = os.path.join(BENCH_ROOT, "env")
+    cmd = [cc] + cflags + bench.cflags + [f"-I{d}" for d in [env_dir] + bench.includes]
+    cmd += [f"-D{d}" for d in bench.defines]
+    cmd += ["-T", LINK_SCRIPT, "-o", bench.elf, os.path.join(env_dir, "crt0.S"),
+            os.path.join(env_dir, "bench.c")] + bench.sources + ["-lm", "-lc", "-lgcc"]
+    log_path = os.path.join(build_dir, bench.name + ".compile.log")
+    if _run(cmd, log_path=log_path).returncode != 0:
+        bench.error = f"compile failed, see {log_path}"
+
+
+def _load_json(path: str) -> Optional[dict]:
+    try:
+        with open(path) as f:
+            return json.load(f)
+    except (OSError, ValueError):
+        return None
+
+
+def parse_signature(path: str) -> Optional[List[int]]:
+    """Returns the struct bench_result words: status, roi_cycles, roi_instret[]."""
+    try:
+        with open(path) as f:
+            words = [int(line, 16) for line in f if line.strip()]
+    except (OSError, ValueError):
+        return None
+    return words if len(words) >= 2 + MAX_HARTS else None
+
+
+def run_benchmark(core: str, sim: str, bench: Benchmark, max_cycles: int, out_dir: str,
+                  host_profile: bool = False, mem_config: str = "") -> BenchResult:
+    result = BenchResult(core=core, benchmark=bench.name, threads=bench.threads)
+    if bench.error:
+        result.detail = bench.error
+        return result
+    prefix = os.path.join(out_dir, f"{core}.{bench.name}")
+    cmd = [sim, "--elf", bench.elf, "--signature", prefix + ".sig", "--max-cycles",
+           str(max_cycles)]
+    if CORES[core]["threads"] > 1:
+        cmd += ["--thread-mask", hex((1 << bench.threads) - 1)]
+    if host_profile:
+        cmd += ["--perf-report", prefix + ".host.json"]
+    if mem_config:
+        cmd += ["--mem-config", mem_config]
+    proc = _run(cmd, log_path=prefix + ".log")
+    result.status = proc.returncode
+    match = _SUMMARY_RE.search(proc.stdout)
+    if match:
+        result.total_cycles = int(match.group(1))
+        if match.group(3):
+            result.timed_cycles = int(match.group(3))
+            if result.total_cycles:
+                result.mem_slowdown = round(result.timed_cycles / result.total_cycles, 4)
+    host = _load_json(prefix + ".host.json") if host_profile else None
+    if host:
+        result.host_khz = round(host["cycles_per_second"] / 1000, 1)
+    words = parse_signature(prefix + ".sig")
+    if proc.returncode != 0 or words is None:
+        result.detail = f"run failed (exit {proc.returncode}), see {prefix}.log"
+        return result
+    if words[0] != 0:
+        result.status = words[0]
+        result.detail = f"benchmark self-check failed with {words[0]}"
+        return result
+    result.roi_cycles = words[1]
+    instret = words[2:2 + bench.threads]
+    result.roi_instret = sum(instret)
+    if result.roi_instret:
+        result.cpi = result.roi_cycles / result.roi_instret
+    if bench.ops:
+        result.cycles_per_op = round(result.roi_cycles / bench.ops, 3)
+    if bench.threads > 1:
+        result.thread_cpi = [round(result.roi_cycles / n, 4) if n else 0.0 for n in instret]
+    return result
+
+
+def compare(results: List[BenchResult], baseline: Dict[str, dict], threshold: float) -> List[str]:
+    regressions = []
+    for r in results:
+        entry = baseline.get(r.key)
+        if entry is None or r.roi_cycles is None:
+            continue
+        r.baseline_cycles = int(entry["roi_cycles"])
+        if r.roi_cycles > r.baseline_cycles * (1.0 + threshold):
+            regressions.append(f"{r.key}: {r.roi_cycles} ROI cycles vs baseline "
+                               f"{r.baseline_cycles} (+{r.roi_cycles / r.baseline_cycles - 1:.1%})")
+    missing = sorted(r.key for r in results if r.roi_cycles is not None and r.key not in baseline)
+    if missing:
+        logger.warning("no baseline for %s", ", ".join(missing))
+    return regressions
+
+
+def _fmt(value, spec: str) -> str:
+    return "-" if value is None else format(value, spec)
+
+
+def print_table(results: List[BenchResult], out=sys.stdout):
+    headers = ["core", "benchmark", "threads", "status", "roi_cycles", "instret", "cpi",
+               "cycles/op", "baseline", "delta", "timed", "mem_x", "host_khz", "thread_cpi"]
+    rows = []
+    for r in results:
+        delta = None
+        if r.baseline_cycles and r.roi_cycles is not None:
+            delta = 100.0 * (r.roi_cycles / r.baseline_cycles - 1)
+        rows.append([r.core, r.benchmark, str(r.threads), str(r.status), _fmt(r.roi_cycles, "d"),
+                     _fmt(r.roi_instret, "d"), _fmt(r.cpi, ".3f"), _fmt(r.cycles_per_op, ".2f"),
+                     _fmt(r.baseline_cycles, "d"),
+                     _fmt(delta, "+.2f"), _fmt(r.timed_cycles, "d"), _fmt(r.mem_slowdown, ".3f"),
+                     _fmt(r.host_khz, ".1f"), " ".join(f"{c:.2f}" for c in r.thread_cpi)])
+    widths = [max(len(h), *(len(row[i]) for row in rows)) if rows else len(h)
+              for i, h in enumerate(headers)]
+    out.write("  ".join(h.ljust(w) for h, w in zip(headers, widths)) + "\n")
+    for row in rows:
+        out.write("  ".join(c.ljust(w) for c, w in zip(row, widths)) + "\n")
+
+
+def main(argv=None) -> int:
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--core", action="append", choices=sorted(CORES),
+                        help="core to measure (repeatable; default: all)")
+    parser.add_argument("--bench", action="append", default=[],
+                        help="benchmark to run (repeatable; default: the whole suite)")
+    parser.add_argument("--sim-dir", default=os.path.join(REPO_ROOT, "tests", "sim", "build"),
+                        help="directory holding <core>_sim (default: tests/sim/build)")
+    parser.add_argument("--out", default=os.path.join(BENCH_ROOT, "build"),
+                        help="ELF and results directory (default: tests/bench/build)")
+    parser.add_argument("--cc", default=os.environ.get("BENCH_CC", "riscv64-unknown-elf-gcc"),
+                        help="RISC-V compiler (default: $BENCH_CC or riscv64-unknown-elf-gcc)")
+    # Every core runs RV32I, so the default ELFs take multiply and divide from libgcc.
+    parser.add_argument("--march", default="rv32i_zicsr", help="-march (default: rv32i_zicsr)")
+    parser.add_argument("--opt", default="-O2", help="optimisation flags (default: -O2)")
+    parser.add_argument("--coremark-iterations", type=int, default=10)
+    parser.add_argument("--threads", type=int, action="append",
+                        help="coremark-mt thread count (repeatable; default: 2 4 8)")
+    parser.add_argument("--max-cycles", type=int, default=50_000_000)
+    parser.add_argument("--jobs", type=int, default=os.cpu_count() or 1,
+                        help="parallel compile and run jobs")
+    parser.add_argument("--mem-config", default="",
+                        help="harness memory timing config, e.g. tests/sim/mem_soc.cfg")
+    parser.add_argument("--host-profile", action="store_true",
+                        help="run with --perf-report and report each run's simulated kHz "
+                             "(use --jobs 1 for comparable numbers)")
+    parser.add_argument("--no-compile", action="store_true",
+                        help="run the ELFs already in --out")
+    parser.add_argument("--baseline", default=os.path.join(BENCH_ROOT, "baseline.json"),
+                        help="baseline to compare against, empty for none "
+                             "(default: tests/bench/baseline.json)")
+    parser.add_argument("--threshold", type=float, default=0.02,
+                        help="allowed ROI cycle increase over the baseline (default: 0.02)")
+    parser.add_argument("--update-baseline", action="store_true",
+                        help="write this run's ROI cycles to --baseline instead of comparing")
+    parser.add_argument("-v", "--verbose", action="store_true")
+    args = parser.parse_args(argv)
+    logging.basicConfig(level=logging.DEBUG if args.verbose else logging.INFO,
+                        format="%(levelname)s: %(message)s")
+
+    if args.update_baseline and not args.baseline:
+        logger.error("--update-baseline needs a --baseline path")
+        return 1
+    cores = args.core or list(CORES)
+    thread_counts = sorted(set(args.threads or [2, 4, 8]))
+    if any(t < 2 or t > MAX_HARTS for t in thread_counts):
+        logger.error("--threads must be between 2 and %d", MAX_HARTS)
+        return 1
+    benchmarks = suite(args.coremark_iterations, thread_counts)
+    if args.bench:
+        unknown = sorted(set(args.bench) - {b.name for b in benchmarks})
+        if unknown:
+            logger.error("unknown benchmark(s) %s", ", ".join(unknown))
+            return 1
+        benchmarks = [b for b in benchmarks if b.name in args.bench]
+    out_dir = os.path.abspath(args.out)
+    mem_config = os.path.abspath(args.mem_config) if args.mem_config else ""
+    os.makedirs(out_dir, exist_ok=True)
+
+    cflags = [f"-march={args.march}", "-mabi=ilp32", "-mcmodel=medany", "-static",
+              "-nostartfiles", "-fno-builtin-printf"] + shlex.split(args.opt)
+    if args.no_compile:
+        for b in benchmarks:
+            b.elf = os.path.join(out_dir, b.name + ".elf")
+            if not os.path.isfile(b.elf):
+                b.error = f"missing {b.elf}"
+    else:
+        with ThreadPoolExecutor(max_workers=max(1, args.jobs)) as pool:
+            list(pool.map(lambda b: compile_benchmark(b, args.cc, cflags, out_dir), benchmarks))
+    for b in benchmarks:
+        if b.error:
+            logger.error("%s: %s", b.name, b.error)
+
+    jobs = []
+    missing_sim = False
+    for core in cores:
+        sim = os.path.join(args.sim_dir, CORES[core]["sim"])
+        if not os.access(sim, os.X_OK):
+            logger.error("%s: no simulator at %s; build it with tests/sim/build_%s.sh", core, sim,
+                         CORES[core]["sim"])
+            missing_sim = True
+            continue
+        # A barrel core runs each single-context benchmark on thread 0 alone.
+        jobs.extend((core, sim, b) for b in benchmarks if b.threads <= CORES[core]["threads"]
+                    and (CORES[core]["m"] or not b.ops))
+    with ThreadPoolExecutor(max_workers=max(1, args.jobs)) as pool:
+        results = list(pool.map(
+            lambda job: run_benchmark(job[0], job[1], job[2], args.max_cycles, out_dir,
+                                      args.host_profile, mem_config), jobs))
+
+    failed = [r for r in results if r.roi_cycles is None]
+    for r in failed:
+        logger.error("%s: %s", r.key, r.detail)
+
+    regressions = []
+    if args.update_baseline:
+        baseline = {r.key: dict(roi_cycles=r.roi_cycles, cpi=round(r.cpi, 4) if r.cpi else None)
+                    for r in results if r.roi_cycles is not None}
+        with open(args.baseline, "w") as f:
+            json.dump(dict(sorted(baseline.items())), f, indent=2)
+            f.write("\n")
+        logger.info("Baseline of %d result(s) written to %s", len(baseline), args.baseline)
+    elif os.path.isfile(args.baseline):
+        with open(args.baseline) as f:
+            regressions = compare(results, json.load(f), args.threshold)
+    elif args.baseline:
+        logger.warning("no baseline at %s; run with --update-baseline to record one",
+                       args.baseline)
+
+    print_table(results)
+    with open(os.path.join(out_dir, "results.json"), "w") as f:
+        json.dump([{k: v for k, v in asdict(r).items() if k != "detail"} for r in results], f,
+                  indent=2)
+    logger.info("Results written to %s", os.path.join(out_dir, "results.json"))
+    for line in regressions:
+        logger.error("regression: %s", line)
+    ok = results and not failed and not regressions and not missing_sim
+    return 0 if ok else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,367 @@
+#!/usr/bin/env python3
+"""Design-space sweep: generate, build and benchmark core variants over a parameter grid.
+
+A grid file names a core, the design parameters to sweep and the benchmarks::
+
+    {
+      "core": "zeronyte_cache",
+      "params": {"icache.bytes": [1024, 2048, 4096], "icache.ways": [1, 2]},
+      "benchmarks": ["tests/bench/build/*.elf"],
+      "max_cycles": 2000000,
+      "mem_config": "tests/sim/mem_soc.cfg"
+    }
+
+Integer knobs take numbers and named ones (``octonyte.schedule``) their names.
+Every point of the cross product becomes a variant under ``<out>/<name>/``:
+
+1. ``GenerateHierarchicalRTL --variants`` elaborates all variants that are new
+   or whose parameters changed, in one sbt run and ``--jobs`` in parallel.
+2. The core's ``tests/sim/build_*_sim.sh`` builds each variant with
+   ``--verilog``; the content-hashed model cache skips unchanged models.
+3. Each benchmark runs on each variant with ``--perf-json`` (and
+   ``--icache-stats`` on cores with an I-cache). With ``mem_config`` (or
+   ``--mem-config``) the harness memory timing model is on too, and
+   ``timed`` is the cycle count with its stalls.
+4. With ``--area``, ``physical_design/generate_physical_design.sh`` implements
+   each variant and the OpenLane2 instance area is reported.
+
+The combined table is printed and written to ``<out>/results.json`` and
+``<out>/results.csv``.
+"""
+
+import argparse
+import csv
+import glob
+import itertools
+import json
+import logging
+import os
+import re
+import subprocess
+import sys
+from concurrent.futures import ThreadPoolExecutor
+from dataclasses import asdict, dataclass, field
+from typing import Dict, List, Optional, Union
+
+logger = logging.getLogger("dse_sweep")
+
+REPO_ROOT = os.path.abspath(os.path.join(os.path.dirname(__file__), "..", ".."))
+
+# Cores the sweep can build and run, with the design parameters the generator
+# accepts for each (see DesignParams in GenerateHierarchicalRTL.scala): None
+# for an integer knob, otherwise the names the knob takes.
+CORES = {
+    "zeronyte": dict(family="ZeroNyte", top="ZeroNyteRV32ICore",
+                     build="build_zeronyte_sim.sh", params={}),
+    "zeronyte_cache": dict(family="ZeroNyte", top="ZeroNyteRV32ICoreWithCache",
+                           build="build_zeronyte_cache_sim.sh",
+                           params={"icache.bytes": None, "icache.block": None,
+                                   "icache.ways": None,
+                                   "icache.replacement": ("lru", "random", "round-robin",
+                                                          "plru")},
+                           icache_defaults={"icache.bytes": 2048, "icache.block": 16,
+                                            "icache.ways": 1, "icache.replacement": "lru"}),
+    "tetranyte": dict(family="TetraNyte", top="TetraNyteRV32ICore",
+                      build="build_tetranyte_sim.sh", params={}),
+    "octonyte": dict(family="OctoNyte", top="OctoNyteRV32ICore",
+                     build="build_octonyte_sim.sh",
+                     params={"octonyte.schedule": ("fixed", "dynamic")}),
+}
+
+# Harness summary line, e.g. "ZeroNyte: cycles=1234 tohost=0x1 timed=1500".
+_SUMMARY_RE = re.compile(r"^\w+: cycles=(\d+) tohost=0x([0-9a-fA-F]+)(?: skipped=\d+)?"
+                         r"(?: timed=(\d+))?", re.MULTILINE)
+
+
+@dataclass
+class Variant:
+    name: str
+    params: Dict[str, Union[int, str]]
+    out_dir: str
+    verilog: str = ""
+    sim: str = ""
+    area: Optional[float] = None
+    error: str = ""
+
+
+@dataclass
+class BenchResult:
+    variant: str
+    benchmark: str
+    params: Dict[str, Union[int, str]]
+    status: int = -1
+    cycles: Optional[int] = None
+    timed_cycles: Optional[int] = None  # with the memory timing model
+    ipc: Optional[float] = None
+    icache_miss_rate: Optional[float] = None
+    area: Optional[float] = None
+    detail: str = field(default="", repr=False)
+
+
+def _run(cmd: List[str], cwd: str = REPO_ROOT, env: Optional[dict] = None, log_path: str = ""):
+    logger.debug("running: %s", " ".join(cmd))
+    try:
+        proc = subprocess.run(cmd, cwd=cwd, env=env, stdout=subprocess.PIPE,
+                              stderr=subprocess.STDOUT, text=True)
+    except OSError as e:
+        proc = subprocess.CompletedProcess(cmd, 127, stdout=f"{cmd[0]}: {e}\n")
+    if log_path:
+        with open(log_path, "w") as log:
+            log.write(proc.stdout)
+    return proc
+
+
+def expand_grid(grid: dict, out_root: str) -> List[Variant]:
+    core = CORES[grid["core"]]
+    params = grid.get("params", {})
+    unknown = sorted(set(params) - set(core["params"]))
+    if unknown:
+        raise ValueError(f"{grid['core']} has no design parameters {', '.join(unknown)}; "
+                         f"supported: {', '.join(core['params']) or 'none'}")
+    keys = sorted(params)
+    for k in keys:
+        choices = core["params"][k]
+        bad = [v for v in params[k] if str(v) not in choices] if choices else []
+        if bad:
+            raise ValueError(f"{k} takes {', '.join(choices)}, not {', '.join(map(str, bad))}")
+    variants = []
+    for values in itertools.product(*(params[k] for k in keys)):
+        point = {k: str(v) if core["params"][k] else int(v) for k, v in zip(keys, values)}
+        name = "-".join(f"{k.split('.')[-1]}{v}" if isinstance(v, int) else
+                        f"{k.split('.')[-1]}_{v}" for k, v in point.items()) or "base"
+        variants.append(Variant(name=name, params=point, out_dir=os.path.join(out_root, name)))
+    return variants
+
+
+def _params_file(variant: Variant) -> str:
+    return os.path.join(variant.out_dir, "params.json")
+
+
+def _is_current(variant: Variant) -> bool:
+    if not os.path.isfile(variant.verilog) or not os.path.isfile(_params_file(variant)):
+        return False
+    with open(_params_file(variant)) as f:
+        return json.load(f) == variant.params
+
+
+def generate(variants: List[Variant], core: dict, out_root: str, jobs: int, regen: bool):
+    for v in variants:
+        v.verilog = os.path.join(v.out_dir, "verilog_hierarchical_timed", core["top"] + ".v")
+    stale = [v for v in variants if regen or not _is_current(v)]
+    if not stale:
+        logger.info("All %d variants already generated", len(variants))
+        return
+    variants_file = os.path.join(out_root, "variants.txt")
+    with open(variants_file, "w") as f:
+        for v in stale:
+            f.write(" ".join([v.name] + [f"{k}={val}" for k, val in v.params.items()]) + "\n")
+    logger.info("Generating %d variant(s) of %s", len(stale), core["top"])
+    runner = (f"generators/runMain generators.GenerateHierarchicalRTL --core-family {core['family']}"
+              f" --top {core['top']} --variants {variants_file} --output-root {out_root}"
+              f" --jobs {jobs} --quiet")
+    proc = _run(["sbt", runner], cwd=os.path.join(REPO_ROOT, "rtl"),
+                log_path=os.path.join(out_root, "generate.log"))
+    for v in stale:
+        if os.path.isfile(v.verilog):
+            with open(_params_file(v), "w") as f:
+                json.dump(v.params, f)
+        else:
+            v.error = "generation failed"
+    if proc.returncode != 0:
+        logger.error("RTL generation failed, see %s", os.path.join(out_root, "generate.log"))
+
+
+def build(variant: Variant, core: dict, profile: str, cache_keep: int):
+    if variant.error:
+        return
+    variant.sim = os.path.join(variant.out_dir, "sim")
+    env = dict(os.environ, SIM_CACHE_KEEP=str(cache_keep))
+    cmd = ["bash", os.path.join(REPO_ROOT, "tests", "sim", core["build"]), "--profile", profile,
+           "--verilog", variant.verilog, "--output", variant.sim]
+    log_path = os.path.join(variant.out_dir, "build.log")
+    if _run(cmd, env=env, log_path=log_path).returncode != 0:
+        variant.error = f"build failed, see {log_path}"
+
+
+def _load_json(path: str) -> Optional[dict]:
+    try:
+        with open(path) as f:
+            return json.load(f)
+    except (OSError, ValueError):
+        return None
+
+
+def run_benchmark(variant: Variant, core: dict, elf: str, max_cycles: int,
+                  mem_config: str = "") -> BenchResult:
+    bench = os.path.splitext(os.path.basename(elf))[0]
+    result = BenchResult(variant=variant.name, benchmark=bench, params=variant.params,
+                         area=variant.area)
+    if variant.error:
+        result.detail = variant.error
+        return result
+    prefix = os.path.join(variant.out_dir, bench)
+    cmd = [variant.sim, "--elf", elf, "--signature", prefix + ".sig",
+           "--max-cycles", str(max_cycles), "--perf-json", prefix + ".perf.json"]
+    if "icache_defaults" in core:
+        geometry = {**core["icache_defaults"], **variant.params}
+        cmd += ["--icache-stats", prefix + ".icache.json", "--icache-geometry",
+                f"{geometry['icache.bytes']}:{geometry['icache.block']}:{geometry['icache.ways']}"
+                f":{geometry['icache.replacement']}"]
+    if mem_config:
+        cmd += ["--mem-config", mem_config]
+    proc = _run(cmd, cwd=variant.out_dir, log_path=prefix + ".log")
+    result.status = proc.returncode
+    match = _SUMMARY_RE.search(proc.stdout)
+    if match:
+        result.cycles = int(match.group(1))
+        result.timed_cycles = int(match.group(3)) if match.group(3) else None
+    perf = _load_json(prefix + ".perf.json")
+    if perf:
+        result.ipc = perf.get("ipc")
+    icache = _load_json(prefix + ".icache.json")
+    if icache:
+        result.icache_miss_rate = icache.get("miss_rate")
+    return result
+
+
+def measure_area(variant: Variant, core: dict, pd_config: str):
+    if variant.error:
+        return
+    config = pd_config or f"config.{core['top']}.json"
+    if not os.path.isfile(os.path.join(REPO_ROOT, "physical_design", config)):
+        logger.warning("%s: no physical design config %s, skipping area", variant.name, config)
+        return
+    pd_root = os.path.join(variant.out_dir, "pd")
+    cmd = ["bash", os.path.join(REPO_ROOT, "physical_design", "generate_physical_design.sh"),
+           "--module-name", core["top"], "--input-rtl", variant.verilog,
+           "--output-root", pd_root, "--config-module", config, "--quiet"]
+    log_path = os.path.join(variant.out_dir, "pd.log")
+    if _run(cmd, cwd=os.path.join(REPO_ROOT, "physical_design"), log_path=log_path).returncode != 0:
+        logger.warning("%s: physical design failed, see %s", variant.name, log_path)
+        return
+    # OpenLane2 writes runs/<tag>/final/metrics.json inside the design directory.
+    metrics = sorted(glob.glob(os.path.join(pd_root, "runs", core["top"], "runs", "*",
+                                            "final", "metrics.json")), key=os.path.getmtime)
+    data = _load_json(metrics[-1]) if metrics else None
+    if data and "design__instance__area" in data:
+        variant.area = float(data["design__instance__area"])
+    else:
+        logger.warning("%s: no design__instance__area in the OpenLane2 metrics", variant.name)
+
+
+def _fmt(value, spec: str) -> str:
+    return "-" if value is None else format(value, spec)
+
+
+def print_table(results: List[BenchResult], param_keys: List[str], out=sys.stdout):
+    headers = ["variant"] + param_keys + ["benchmark", "status", "cycles", "timed", "ipc", "miss%",
+                                          "area"]
+    rows = []
+    for r in results:
+        miss = None if r.icache_miss_rate is None else 100.0 * r.icache_miss_rate
+        rows.append([r.variant] + [str(r.params.get(k, "")) for k in param_keys] +
+                    [r.benchmark, str(r.status), _fmt(r.cycles, "d"), _fmt(r.timed_cycles, "d"),
+                     _fmt(r.ipc, ".3f"),
+                     _fmt(miss, ".3f"), _fmt(r.area, ".0f")])
+    widths = [max(len(h), *(len(row[i]) for row in rows)) if rows else len(h)
+              for i, h in enumerate(headers)]
+    out.write("  ".join(h.ljust(w) for h, w in zip(headers, widths)) + "\n")
+    for row in rows:
+        out.write("  ".join(c.ljust(w) for c, w in zip(row, widths)) + "\n")
+
+
+def write_results(results: List[BenchResult], param_keys: List[str], out_root: str):
+    with open(os.path.join(out_root, "results.json"), "w") as f:
+        json.dump([{k: v for k, v in asdict(r).items() if k != "detail"} for r in results], f,
+                  indent=2)
+    with open(os.path.join(out_root, "results.csv"), "w", newline="") as f:
+        writer = csv.writer(f)
+        writer.writerow(["variant"] + param_keys +
+                        ["benchmark", "status", "cycles", "timed_cycles", "ipc", "icache_miss_rate",
+                         "area"])
+        for r in results:
+            writer.writerow([r.variant] + [r.params.get(k, "") for k in param_keys] +
+                            [r.benchmark, r.status, r.cycles, r.timed_cycles, r.ipc,
+                             r.icache_miss_rate, r.area])
+
+
+def main(argv=None) -> int:
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("grid", help="JSON grid file")
+    parser.add_argument("--out", help="output directory (default: tests/dse/runs/<grid name>)")
+    parser.add_argument("--elf", action="append", default=[],
+                        help="benchmark ELF (repeatable; adds to the grid's list)")
+    parser.add_argument("--jobs", type=int, default=os.cpu_count() or 1,
+                        help="parallel generator, build and run jobs")
+    parser.add_argument("--profile", default="fast", help="sim build profile (default: fast)")
+    parser.add_argument("--max-cycles", type=int, help="override the grid's max_cycles")
+    parser.add_argument("--mem-config", help="override the grid's mem_config (memory timing)")
+    parser.add_argument("--regen", action="store_true", help="regenerate every variant's RTL")
+    parser.add_argument("--area", action="store_true",
+                        help="run the physical design flow for each variant")
+    parser.add_argument("--pd-config", default="",
+                        help="module config for the physical design flow "
+                             "(default: physical_design/config.<top>.json)")
+    parser.add_argument("-v", "--verbose", action="store_true")
+    args = parser.parse_args(argv)
+    logging.basicConfig(level=logging.DEBUG if args.verbose else logging.INFO,
+                        format="%(levelname)s: %(message)s")
+
+    with open(args.grid) as f:
+        grid = json.load(f)
+    if grid.get("core") not in CORES:
+        logger.error("grid core must be one of %s", ", ".join(sorted(CORES)))
+        return 1
+    core = CORES[grid["core"]]
+    out_root = os.path.abspath(args.out or os.path.join(
+        REPO_ROOT, "tests", "dse", "runs", os.path.splitext(os.path.basename(args.grid))[0]))
+    os.makedirs(out_root, exist_ok=True)
+
+    elfs = []
+    for pattern in grid.get("benchmarks", []) + args.elf:
+        matches = sorted(glob.glob(os.path.join(REPO_ROOT, pattern)))
+        if not matches:
+            logger.warning("no benchmarks match %s", pattern)
+        elfs.extend(os.path.abspath(m) for m in matches)
+    if not elfs:
+        logger.error("no benchmarks to run")
+        return 1
+    max_cycles = args.max_cycles or int(grid.get("max_cycles", 1_000_000))
+    mem_config = args.mem_config or grid.get("mem_config", "")
+    if mem_config:
+        mem_config = os.path.join(REPO_ROOT, mem_config)
+
+    try:
+        variants = expand_grid(grid, out_root)
+    except ValueError as e:
+        logger.error("%s", e)
+        return 1
+    for v in variants:
+        os.makedirs(v.out_dir, exist_ok=True)
+    param_keys = sorted(grid.get("params", {}))
+    logger.info("%d variant(s) x %d benchmark(s) in %s", len(variants), len(elfs), out_root)
+
+    generate(variants, core, out_root, args.jobs, args.regen)
+    with ThreadPoolExecutor(max_workers=max(1, args.jobs)) as pool:
+        # Keep every variant's model cached while the sweep builds them side by side.
+        list(pool.map(lambda v: build(v, core, args.profile, len(variants) + 4), variants))
+    if args.area:
+        with ThreadPoolExecutor(max_workers=max(1, args.jobs)) as pool:
+            list(pool.map(lambda v: measure_area(v, core, args.pd_config), variants))
+    for v in variants:
+        if v.error:
+            logger.error("%s: %s", v.name, v.error)
+
+    with ThreadPoolExecutor(max_workers=max(1, args.jobs)) as pool:
+        results = list(pool.map(lambda job: run_benchmark(job[0], core, job[1], max_cycles,
+                                                          mem_config),
+                                [(v, elf) for v in variants for elf in elfs]))
+
+    print_table(results, param_keys)
+    write_results(results, param_keys, out_root)
+    logger.info("Results written to %s", os.path.join(out_root, "results.{json,csv}"))
+    return 0 if all(not v.error for v in variants) else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,506 @@
+#!/usr/bin/env python3
+"""Coverage-guided random-program fuzzing of the cores against the ISS.
+
+Each worker process owns one simulator in ``--batch -`` server mode with
+``--cosim``, so every commit the core reports is checked in lock-step against
+the ISS, and runs the programs ``rvgen.py`` generates through it one after
+another:
+
+1. The program runs on ``iss_sim`` first. A program the ISS cannot finish is
+   a generator problem (``gen-error``); one retiring more than
+   ``--max-cycles / MAX_CPI`` instructions is ``skipped``, so that a
+   simulator timeout means a hang and not a long program.
+2. The simulator runs it. A co-simulation mismatch, a signature that differs
+   from the ISS's, a run that never reaches tohost or a crashed simulator is
+   a finding. The ELF, its listing, knobs, both signatures and the
+   simulator's messages go to ``<out>/failures/<core>-<seed>/``.
+3. With a model built with ``--profile cov``, the harness writes the
+   program's Verilator line and toggle coverage (``--coverage``). Points the
+   worker has not seen before are sent back to the driver.
+
+The driver keeps the union of the covered points and a corpus of the knobs
+(see ``rvgen.DEFAULT_KNOBS``) of every program that covered something new.
+New programs mostly mutate a corpus entry, preferring entries that found
+many points and have been picked few times, and otherwise draw fresh knobs;
+without coverage every program draws fresh knobs.
+
+A worker process that dies (an exception in the worker or a kill, as opposed
+to a simulator crash, which the worker handles itself) is noticed by the
+driver: the program it was running is a ``crash`` finding with just its knobs
+saved, its queued programs go to the worker's replacement, and a worker that
+dies before finishing any program is not replaced.
+
+Progress lines report programs per second. ``<out>/summary.json`` holds the
+totals and the findings; ``<out>/corpus.json`` can seed a later run with
+``--corpus``. The exit status is 1 when there were findings.
+"""
+
+import argparse
+import json
+import logging
+import multiprocessing
+import os
+import queue
+import random
+import re
+import shutil
+import subprocess
+import sys
+import time
+from dataclasses import asdict, dataclass, field
+from typing import Dict, List, Optional, Set
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import rvgen  # noqa: E402
+
+logger = logging.getLogger("fuzz")
+
+REPO_ROOT = os.path.abspath(os.path.join(os.path.dirname(__file__), "..", ".."))
+SIM_BUILD = os.path.join(REPO_ROOT, "tests", "sim", "build")
+
+# Simulator, hardware thread count and M extension of each core, as built by tests/sim.
+CORES = {
+    "zeronyte": dict(sim="zeronyte_sim", threads=1, m=True),
+    "tetranyte": dict(sim="tetranyte_sim", threads=4, m=True),
+    "octonyte": dict(sim="octonyte_sim", threads=8, m=False),
+}
+
+# Batch summary line, e.g. "ZeroNyte: cycles=1234 tohost=0x1 cosim=99 status=0 elf=/x.elf".
+_SUMMARY_RE = re.compile(r"^\w+: cycles=(\d+) tohost=0x[0-9a-fA-F]+.* status=(\d+) elf=(\S+)$")
+
+EXIT_TIMEOUT = 3  # harness.h ExitCode
+EXIT_COSIM_MISMATCH = 7
+
+EXPLORE = 0.2  # share of programs drawn with fresh knobs once there is a corpus
+MAX_CPI = 50  # simulator cycles per ISS instruction a program may need
+FINDINGS = ("mismatch", "timeout", "crash", "error")
+
+
+@dataclass
+class Job:
+    id: int
+    seed: int
+    knobs: dict
+    parent: int = -1  # corpus index the knobs were mutated from
+
+
+@dataclass
+class Outcome:
+    job: Job
+    verdict: str  # pass, mismatch, timeout, crash, error, gen-error, skipped
+    cycles: int = 0
+    new_points: List[str] = field(default_factory=list)
+    detail: str = ""
+
+
+@dataclass
+class WorkerHandle:
+    """Driver side of a worker process: its job queue and the jobs sent, oldest first."""
+    index: int
+    proc: multiprocessing.Process
+    jobs: "multiprocessing.Queue"
+    pending: List[Job] = field(default_factory=list)
+    finished: int = 0
+
+
+@dataclass
+class CorpusEntry:
+    knobs: dict
+    found: int
+    picks: int = 0
+
+
+def _read_signature(path: str) -> Optional[str]:
+    try:
+        with open(path) as f:
+            return f.read()
+    except OSError:
+        return None
+
+
+def covered_points(path: str) -> Set[str]:
+    """Keys of the points with a non-zero count in a Verilator coverage.dat."""
+    points = set()
+    try:
+        with open(path, errors="replace") as f:
+            for line in f:
+                if not line.startswith("C '"):
+                    continue
+                end = line.rfind("' ")
+                if end > 3 and line[end + 2:].strip() not in ("", "0"):
+                    points.add(line[3:end])
+    except OSError:
+        pass
+    return points
+
+
+class Worker:
+    """One simulator in server mode plus the ISS runner, in their own directory."""
+
+    def __init__(self, index: int, cfg: dict):
+        self.cfg = cfg
+        self.dir = os.path.join(cfg["out"], "workers", str(index))
+        os.makedirs(self.dir, exist_ok=True)
+        self.elf = os.path.join(self.dir, "prog.elf")
+        self.ref_sig = os.path.join(self.dir, "ref.sig")
+        self.dut_sig = os.path.join(self.dir, "dut.sig")
+        self.coverage = os.path.join(self.dir, "coverage.dat")
+        self.stderr_path = os.path.join(self.dir, "sim.err")
+        self.seen: Set[str] = set()
+        self.proc: Optional[subprocess.Popen] = None
+        self._start()
+
+    def _start(self):
+        cmd = [self.cfg["sim"], "--batch", "-", "--cosim", "--max-cycles", str(self.cfg["max_cycles"])]
+        if self.cfg["harts"] > 1:
+            cmd += ["--thread-mask", hex((1 << self.cfg["harts"]) - 1)]
+        if self.cfg["coverage"]:
+            cmd += ["--coverage", self.coverage]
+        # Append mode: the simulator's writes always land at the end, where
+        # run() finds each program's messages.
+        open(self.stderr_path, "w").close()
+        self.stderr = open(self.stderr_path, "a")
+        self.proc = subprocess.Popen(cmd, cwd=self.dir, stdin=subprocess.PIPE,
+                                     stdout=subprocess.PIPE, stderr=self.stderr, text=True,
+                                     bufsize=1)
+
+    def close(self):
+        if self.proc and self.proc.poll() is None:
+            try:
+                self.proc.stdin.close()
+            except OSError:
+                pass
+            self.proc.wait()
+        self.stderr.close()
+
+    def _sim(self):
+        """Runs prog.elf in the server; returns (status, cycles) or None if it died."""
+        try:
+            self.proc.stdin.write(f"{self.elf} {self.dut_sig}\n")
+            self.proc.stdin.flush()
+        except OSError:
+            return None
+        while True:
+            line = self.proc.stdout.readline()
+            if not line:
+                return None
+            match = _SUMMARY_RE.match(line.strip())
+            if match and match.group(3) == self.elf:
+                return int(match.group(2)), int(match.group(1))
+
+    def run(self, job: Job) -> Outcome:
+        try:
+            program = rvgen.generate(job.knobs, job.seed, self.cfg["harts"], self.cfg["m"])
+        except ValueError as e:
+            return Outcome(job, "gen-error", detail=str(e))
+        with open(self.elf, "wb") as f:
+            f.write(program.elf())
+        for path in (self.ref_sig, self.dut_sig):
+            if os.path.exists(path):
+                os.remove(path)
+
+        iss = subprocess.run([self.cfg["iss"], "--elf", self.elf, "--signature", self.ref_sig,
+                              "--harts", str(self.cfg["harts"]),
+                              "--max-instrs", str(self.cfg["max_cycles"] // MAX_CPI)],
+                             stdout=subprocess.DEVNULL, stderr=subprocess.PIPE, text=True)
+        if iss.returncode == EXIT_TIMEOUT:
+            return Outcome(job, "skipped")
+        if iss.returncode != 0:
+            return Outcome(job, "gen-error", detail=iss.stderr.strip())
+
+        err_start = os.path.getsize(self.stderr_path)
+        result = self._sim()
+        with open(self.stderr_path, errors="replace") as f:
+            f.seek(err_start)
+            messages = f.read()
+
+        if result is None:
+            self.close()
+            self._start()
+            outcome = Outcome(job, "crash", detail=messages)
+        else:
+            status, cycles = result
+            outcome = Outcome(job, "pass", cycles=cycles, detail=messages)
+            if status == EXIT_COSIM_MISMATCH:
+                outcome.verdict = "mismatch"
+            elif status == EXIT_TIMEOUT:
+                outcome.verdict = "timeout"
+            elif status != 0:
+                outcome.verdict = "error"
+            elif _read_signature(self.dut_sig) != _read_signature(self.ref_sig):
+                outcome.verdict = "mismatch"
+                outcome.detail = (messages + "signature differs from the ISS\n").lstrip()
+
+        if self.cfg["coverage"] and result is not None:
+            new = covered_points(self.coverage) - self.seen
+            self.seen |= new
+            outcome.new_points = sorted(new)
+        if outcome.verdict in FINDINGS:
+            self._save_failure(outcome, program)
+        return outcome
+
+    def _save_failure(self, outcome: Outcome, program: "rvgen.Program"):
+        dest = os.path.join(self.cfg["out"], "failures", f"{self.cfg['core']}-{outcome.job.seed}")
+        os.makedirs(dest, exist_ok=True)
+        for path in (self.elf, self.ref_sig, self.dut_sig):
+            if os.path.exists(path):
+                shutil.copy(path, dest)
+        with open(os.path.join(dest, "prog.lst"), "w") as f:
+            f.write(program.listing())
+        with open(os.path.join(dest, "knobs.json"), "w") as f:
+            json.dump(outcome.job.knobs, f, indent=2)
+        with open(os.path.join(dest, "finding.txt"), "w") as f:
+            f.write(f"verdict: {outcome.verdict}\nseed: {outcome.job.seed}\n"
+                    f"harts: {self.cfg['harts']}\ncycles: {outcome.cycles}\n\n{outcome.detail}")
+
+
+def worker_main(index: int, cfg: dict, jobs, results):
+    worker = Worker(index, cfg)
+    try:
+        while True:
+            job = jobs.get()
+            if job is None:
+                break
+            results.put((index, worker.run(job)))
+    finally:
+        worker.close()
+
+
+class Scheduler:
+    """Chooses the knobs of the next program from the corpus."""
+
+    def __init__(self, rng: random.Random, corpus: List[CorpusEntry], guided: bool):
+        self.rng = rng
+        self.corpus = corpus
+        self.guided = guided
+        self.next_id = 0
+
+    def job(self) -> Job:
+        self.next_id += 1
+        seed = self.rng.getrandbits(32)
+        if not self.guided or not self.corpus or self.rng.random() < EXPLORE:
+            return Job(self.next_id, seed, rvgen.random_knobs(self.rng))
+        energy = [e.found / (1.0 + e.picks) for e in self.corpus]
+        parent = self.rng.choices(range(len(self.corpus)), energy)[0]
+        self.corpus[parent].picks += 1
+        return Job(self.next_id, seed, rvgen.mutate_knobs(self.corpus[parent].knobs, self.rng),
+                   parent)
+
+    def credit(self, outcome: Outcome, new_points: int):
+        if new_points == 0:
+            return
+        self.corpus.append(CorpusEntry(outcome.job.knobs, new_points))
+        if outcome.job.parent >= 0:
+            self.corpus[outcome.job.parent].found += new_points
+
+
+def _sim_has_coverage(sim: str) -> bool:
+    try:
+        proc = subprocess.run([sim, "--build-info"], stdout=subprocess.PIPE,
+                              stderr=subprocess.STDOUT, text=True)
+    except OSError:
+        return False
+    return "coverage=on" in proc.stdout
+
+
+def _save_lost(cfg: dict, job: Job, detail: str):
+    """Records a program whose worker died; rvgen regenerates it from the knobs and seed."""
+    dest = os.path.join(cfg["out"], "failures", f"{cfg['core']}-{job.seed}")
+    os.makedirs(dest, exist_ok=True)
+    with open(os.path.join(dest, "knobs.json"), "w") as f:
+        json.dump(job.knobs, f, indent=2)
+    with open(os.path.join(dest, "finding.txt"), "w") as f:
+        f.write(f"verdict: crash\nseed: {job.seed}\nharts: {cfg['harts']}\n\n{detail}\n")
+
+
+def _load_corpus(path: str) -> List[CorpusEntry]:
+    with open(path) as f:
+        return [CorpusEntry(rvgen.clamp_knobs(e["knobs"]), int(e.get("found", 1)))
+                for e in json.load(f)]
+
+
+def main(argv=None) -> int:
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--core", choices=sorted(CORES), default="zeronyte")
+    parser.add_argument("--sim", help="simulator (default: tests/sim/build/<core>_sim)")
+    parser.add_argument("--iss", default=os.path.join(SIM_BUILD, "iss_sim"),
+                        help="ISS runner (default: tests/sim/build/iss_sim)")
+    parser.add_argument("-j", "--jobs", type=int, default=os.cpu_count() or 1,
+                        help="worker processes, one simulator each")
+    parser.add_argument("--programs", type=int, default=0, help="stop after N programs")
+    parser.add_argument("--time", type=float, default=0.0, help="stop after N seconds")
+    parser.add_argument("--harts", type=int, help="threads to enable (default: all of the core's)")
+    parser.add_argument("--seed", type=int, default=1)
+    parser.add_argument("--max-cycles", type=int, default=2_000_000,
+                        help="simulator cycle budget per program (default: 2000000)")
+    parser.add_argument("--no-coverage", action="store_true",
+                        help="do not collect coverage even if the model has it")
+    parser.add_argument("--corpus", help="corpus.json of an earlier run to start from")
+    parser.add_argument("--out", help="output directory (default: tests/fuzz/runs/<core>)")
+    parser.add_argument("--interval", type=float, default=5.0, help="seconds between progress lines")
+    parser.add_argument("-v", "--verbose", action="store_true")
+    args = parser.parse_args(argv)
+    logging.basicConfig(level=logging.DEBUG if args.verbose else logging.INFO,
+                        format="%(levelname)s: %(message)s")
+
+    core = CORES[args.core]
+    sim = os.path.abspath(args.sim or os.path.join(SIM_BUILD, core["sim"]))
+    for path, hint in ((sim, f"tests/sim/build_{args.core}_sim.sh"),
+                       (args.iss, "tests/sim/build_iss_sim.sh")):
+        if not os.access(path, os.X_OK):
+            logger.error("%s not found; build it with %s", path, hint)
+            return 2
+    harts = args.harts or core["threads"]
+    if not 1 <= harts <= core["threads"]:
+        logger.error("%s has %d thread(s), --harts %d", args.core, core["threads"], harts)
+        return 2
+    if args.programs <= 0 and args.time <= 0:
+        logger.error("give --programs and/or --time")
+        return 2
+
+    coverage = not args.no_coverage and _sim_has_coverage(sim)
+    if not coverage and not args.no_coverage:
+        logger.warning("%s has no coverage (build it with --profile cov); generating unguided", sim)
+    out = os.path.abspath(args.out or os.path.join(REPO_ROOT, "tests", "fuzz", "runs", args.core))
+    os.makedirs(out, exist_ok=True)
+    cfg = dict(core=args.core, sim=sim, iss=os.path.abspath(args.iss), harts=harts, m=core["m"],
+               max_cycles=args.max_cycles, coverage=coverage, out=out)
+
+    corpus = _load_corpus(args.corpus) if args.corpus else []
+    scheduler = Scheduler(random.Random(args.seed), corpus, coverage)
+    results = multiprocessing.Queue()
+
+    def spawn(index: int) -> WorkerHandle:
+        jobs = multiprocessing.Queue()
+        proc = multiprocessing.Process(target=worker_main, args=(index, cfg, jobs, results),
+                                       daemon=True)
+        proc.start()
+        return WorkerHandle(index, proc, jobs)
+
+    workers = [spawn(i) for i in range(max(1, args.jobs))]
+    logger.info("Fuzzing %s with %d worker(s), %d hart(s), coverage %s, in %s", args.core,
+                len(workers), harts, "on" if coverage else "off", out)
+
+    points: Set[str] = set()
+    counts: Dict[str, int] = {}
+    findings: List[dict] = []
+    start = time.monotonic()
+    last_report = start
+    issued = done = 0
+
+    def more() -> bool:
+        if args.programs and issued >= args.programs:
+            return False
+        return not (args.time and time.monotonic() - start >= args.time)
+
+    def send(w: WorkerHandle, job: Job):
+        w.pending.append(job)
+        w.jobs.put(job)
+
+    def issue(w: WorkerHandle):
+        nonlocal issued
+        if more():
+            send(w, scheduler.job())
+            issued += 1
+
+    def record(outcome: Outcome):
+        nonlocal done
+        done += 1
+        counts[outcome.verdict] = counts.get(outcome.verdict, 0) + 1
+        new = [p for p in outcome.new_points if p not in points]
+        points.update(new)
+        scheduler.credit(outcome, len(new))
+        if outcome.verdict in FINDINGS:
+            findings.append(dict(verdict=outcome.verdict, seed=outcome.job.seed,
+                                 detail=(outcome.detail.strip().splitlines() or [""])[0]))
+            logger.warning("%s: seed %d, see failures/%s-%d", outcome.verdict,
+                           outcome.job.seed, args.core, outcome.job.seed)
+        elif outcome.verdict == "gen-error":
+            logger.debug("generator: seed %d: %s", outcome.job.seed, outcome.detail)
+
+    def receive(timeout: float) -> bool:
+        """Takes one result, waiting up to timeout seconds (0: only if one is queued)."""
+        try:
+            index, outcome = results.get(timeout=timeout) if timeout else results.get_nowait()
+        except queue.Empty:
+            return False
+        w = workers[index]
+        job = next((j for j in w.pending if j.id == outcome.job.id), None)
+        if job is None:  # a replaced worker's result for a program already resent
+            return True
+        w.pending.remove(job)
+        w.finished += 1
+        record(outcome)
+        issue(w)
+        return True
+
+    def reap(w: WorkerHandle) -> bool:
+        """Handles a dead worker; returns False when it is not replaced."""
+        # Results it sent before dying are still in the queue.
+        while receive(0):
+            pass
+        code = w.proc.exitcode
+        if w.pending:  # the oldest is the one it was running
+            lost = w.pending.pop(0)
+            detail = f"worker {w.index} exited with code {code} before finishing this program"
+            _save_lost(cfg, lost, detail)
+            record(Outcome(lost, "crash", detail=detail))
+        queued, w.pending = w.pending, []
+        if not w.finished:
+            logger.error("worker %d exited with code %s before finishing a program; "
+                         "not replacing it", w.index, code)
+            live = [x for x in workers if x is not w and x.proc.exitcode is None]
+            for i, job in enumerate(queued if live else []):
+                send(live[i % len(live)], job)
+            return False
+        logger.warning("worker %d exited with code %s; restarting it", w.index, code)
+        workers[w.index] = replacement = spawn(w.index)
+        for job in queued:
+            send(replacement, job)
+        issue(replacement)
+        return True
+
+    # Two programs in flight per worker hide the round trip through the driver.
+    for _ in range(2):
+        for w in workers:
+            issue(w)
+    active = set(range(len(workers)))
+    try:
+        while done < issued:
+            receive(min(args.interval, 1.0))
+            for index in sorted(active):
+                if workers[index].proc.exitcode is not None and not reap(workers[index]):
+                    active.discard(index)
+            if not active:
+                logger.error("no workers left; %d program(s) not run", issued - done)
+                break
+            now = time.monotonic()
+            if now - last_report >= args.interval:
+                last_report = now
+                logger.info("%d programs, %.1f/s, %d points, corpus %d, %d finding(s)", done,
+                            done / (now - start), len(points), len(corpus), len(findings))
+    except KeyboardInterrupt:
+        logger.info("Interrupted; stopping the workers")
+    finally:
+        for w in workers:
+            w.jobs.put(None)
+        for w in workers:
+            w.proc.join(timeout=10)
+
+    elapsed = time.monotonic() - start
+    summary = dict(core=args.core, harts=harts, workers=len(workers), coverage=coverage,
+                   programs=done, seconds=round(elapsed, 3),
+                   programs_per_sec=round(done / elapsed, 2) if elapsed > 0 else None,
+                   verdicts=counts, points=len(points), corpus=len(corpus), findings=findings)
+    with open(os.path.join(out, "summary.json"), "w") as f:
+        json.dump(summary, f, indent=2)
+    with open(os.path.join(out, "corpus.json"), "w") as f:
+        json.dump([asdict(e) for e in corpus], f, indent=2)
+    logger.info("%d programs in %.1f s (%.1f/s), %d points, %d finding(s); summary in %s", done,
+                elapsed, summary["programs_per_sec"] or 0.0, len(points), len(findings),
+                os.path.join(out, "summary.json"))
+    return 1 if findings else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
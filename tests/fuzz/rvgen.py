@@ -0,0 +1,525 @@
+#!/usr/bin/env python3
+"""Constrained-random RV32IM program generator for the fuzzer.
+
+A program is drawn from a seed and a set of knobs (instruction class weights,
+dependency bias, loop and branch shape; see ``DEFAULT_KNOBS``) and assembled
+straight into an ELF the harnesses and ``iss_sim`` load, so no toolchain is
+involved. Every hart of a barrel core runs the same code on its own data:
+
+* ``x31`` points at the hart's region of the signature, found from ``mhartid``.
+  Its first ``DATA_BYTES`` hold random words that loads and stores use; the
+  registers are stored after them at the end.
+* ``x30`` counts loop iterations and ``x29`` anchors ``auipc``/``jalr`` pairs;
+  random instructions write only ``x0``-``x28``.
+* Control flow only goes forward, except the counted loops. Their bodies
+  contain no loops and their forward branches stay inside the body, so every
+  program terminates.
+* Harts other than 0 set a done flag after storing their registers. Hart 0
+  waits for all of them before it writes ``tohost``, so the signature is
+  complete when the harness stops.
+
+Stores and loads are aligned (no core traps on misalignment), and nothing
+reads a CSR other than ``mhartid``.
+
+Run it directly to write one program, e.g. to reproduce a fuzzer finding::
+
+    rvgen.py --seed 1234 --knobs knobs.json --harts 4 --elf prog.elf --listing prog.lst
+"""
+
+import argparse
+import json
+import math
+import random
+import struct
+import sys
+from typing import Dict, List, Optional
+
+MEM_BASE = 0x80000000  # kMemBase in tests/sim/harness.h, also the reset vector
+
+REGION_BYTES = 1024  # signature bytes per hart
+REGION_SHIFT = 10
+DATA_BYTES = 512  # random data at the start of each region
+REGS_OFFSET = DATA_BYTES  # x0..x31 stored here at the end
+
+MAX_HARTS = 8
+MAX_BODY = 16  # loop body items; keeps forward skips inside the B/JALR range
+MAX_SKIP = 8
+
+# Registers random instructions may write and the generator's own.
+GP_REGS = range(1, 29)
+R_JALR = 29
+R_LOOP = 30
+R_BASE = 31
+
+CLASSES = ("alu", "alu_imm", "upper", "muldiv", "load", "store", "branch", "jal", "jalr", "loop")
+
+DEFAULT_KNOBS = {
+    "length": 200,  # top-level items in the body
+    "weights": {"alu": 4.0, "alu_imm": 4.0, "upper": 1.0, "muldiv": 2.0, "load": 2.0,
+                "store": 2.0, "branch": 2.0, "jal": 0.5, "jalr": 0.5, "loop": 0.3},
+    "dep": 0.5,  # a source is one of the last few destinations (RAW)
+    "waw": 0.1,  # the destination is one of the last few destinations
+    "window": 3,  # how many recent destinations dep and waw draw from
+    "special": 0.1,  # an operand is first set to 0, 1, -1 or INT_MIN
+    "loop_iters": 8,
+    "loop_body": 8,
+    "skip": 4,  # items a forward branch or jump skips at most
+}
+
+SPECIAL_VALUES = (0, 1, 0xFFFFFFFF, 0x80000000, 0x7FFFFFFF)
+
+ALU_OPS = {"add": (0, 0x00), "sub": (0, 0x20), "sll": (1, 0x00), "slt": (2, 0x00),
+           "sltu": (3, 0x00), "xor": (4, 0x00), "srl": (5, 0x00), "sra": (5, 0x20),
+           "or": (6, 0x00), "and": (7, 0x00)}
+MULDIV_OPS = {"mul": 0, "mulh": 1, "mulhsu": 2, "mulhu": 3, "div": 4, "divu": 5, "rem": 6,
+              "remu": 7}
+ALU_IMM_OPS = {"addi": 0, "slti": 2, "sltiu": 3, "xori": 4, "ori": 6, "andi": 7}
+SHIFT_IMM_OPS = {"slli": (1, 0x00), "srli": (5, 0x00), "srai": (5, 0x20)}
+LOAD_OPS = {"lb": (0, 1), "lh": (1, 2), "lw": (2, 4), "lbu": (4, 1), "lhu": (5, 2)}
+STORE_OPS = {"sb": (0, 1), "sh": (1, 2), "sw": (2, 4)}
+BRANCH_OPS = {"beq": 0, "bne": 1, "blt": 4, "bge": 5, "bltu": 6, "bgeu": 7}
+
+CSR_MHARTID = 0xF14
+
+
+def _r(funct7: int, rs2: int, rs1: int, funct3: int, rd: int, opcode: int) -> int:
+    return (funct7 << 25) | (rs2 << 20) | (rs1 << 15) | (funct3 << 12) | (rd << 7) | opcode
+
+
+def _i(imm: int, rs1: int, funct3: int, rd: int, opcode: int) -> int:
+    if not -2048 <= imm < 2048:
+        raise ValueError(f"I-type immediate {imm} out of range")
+    return ((imm & 0xFFF) << 20) | (rs1 << 15) | (funct3 << 12) | (rd << 7) | opcode
+
+
+def _s(imm: int, rs2: int, rs1: int, funct3: int) -> int:
+    imm &= 0xFFF
+    return ((imm >> 5) << 25) | (rs2 << 20) | (rs1 << 15) | (funct3 << 12) | \
+        ((imm & 0x1F) << 7) | 0x23
+
+
+def _b(offset: int, rs2: int, rs1: int, funct3: int) -> int:
+    if not -4096 <= offset < 4096 or offset & 1:
+        raise ValueError(f"branch offset {offset} out of range")
+    imm = offset & 0x1FFF
+    return (((imm >> 12) & 1) << 31) | (((imm >> 5) & 0x3F) << 25) | (rs2 << 20) | \
+        (rs1 << 15) | (funct3 << 12) | (((imm >> 1) & 0xF) << 8) | (((imm >> 11) & 1) << 7) | 0x63
+
+
+def _u(imm20: int, rd: int, opcode: int) -> int:
+    return ((imm20 & 0xFFFFF) << 12) | (rd << 7) | opcode
+
+
+def _j(offset: int, rd: int) -> int:
+    if not -(1 << 20) <= offset < (1 << 20) or offset & 1:
+        raise ValueError(f"jump offset {offset} out of range")
+    imm = offset & 0x1FFFFF
+    return (((imm >> 20) & 1) << 31) | (((imm >> 1) & 0x3FF) << 21) | \
+        (((imm >> 11) & 1) << 20) | (((imm >> 12) & 0xFF) << 12) | (rd << 7) | 0x6F
+
+
+def _hi_lo(value: int):
+    """lui/addi split of a 32-bit value."""
+    value &= 0xFFFFFFFF
+    hi = ((value + 0x800) >> 12) & 0xFFFFF
+    lo = value - (hi << 12)
+    lo = ((lo + 0x800) & 0xFFF) - 0x800
+    return hi, lo
+
+
+class Insn:
+    """One instruction word. Branches and jumps resolve their label relative to
+    the pc at assembly, "hi"/"lo" load the label's absolute address."""
+
+    def __init__(self, text: str, word: int = 0, label: Optional[str] = None, kind: str = "",
+                 fields: tuple = ()):
+        self.text = text
+        self.word = word
+        self.label = label
+        self.kind = kind
+        self.fields = fields
+
+    def encode(self, pc: int, labels: Dict[str, int]) -> int:
+        if self.label is None:
+            return self.word
+        if self.kind in ("hi", "lo"):
+            (rd,) = self.fields
+            hi, lo = _hi_lo(labels[self.label])
+            return _u(hi, rd, 0x37) if self.kind == "hi" else _i(lo, rd, 0, rd, 0x13)
+        offset = labels[self.label] - pc
+        if self.kind == "branch":
+            rs1, rs2, funct3 = self.fields
+            return _b(offset, rs2, rs1, funct3)
+        if self.kind == "jal":
+            (rd,) = self.fields
+            return _j(offset, rd)
+        # jalr: offset from the auipc just before it.
+        (rd,) = self.fields
+        return _i(offset + 4, R_JALR, 0, rd, 0x67)
+
+
+class Label:
+    def __init__(self, name: str):
+        self.name = name
+
+
+def _li(rd: int, value: int) -> List[Insn]:
+    hi, lo = _hi_lo(value)
+    out = []
+    if hi:
+        out.append(Insn(f"lui x{rd}, 0x{hi:x}", _u(hi, rd, 0x37)))
+        if lo:
+            out.append(Insn(f"addi x{rd}, x{rd}, {lo}", _i(lo, rd, 0, rd, 0x13)))
+    else:
+        out.append(Insn(f"addi x{rd}, x0, {lo}", _i(lo, 0, 0, rd, 0x13)))
+    return out
+
+
+def _la(rd: int, label: str) -> List[Insn]:
+    return [Insn(f"lui x{rd}, %hi({label})", label=label, kind="hi", fields=(rd,)),
+            Insn(f"addi x{rd}, x{rd}, %lo({label})", label=label, kind="lo", fields=(rd,))]
+
+
+def _csrr(rd: int, csr: int, name: str) -> Insn:
+    return Insn(f"csrrs x{rd}, {name}, x0", (csr << 20) | (2 << 12) | (rd << 7) | 0x73)
+
+
+def clamp_knobs(knobs: dict) -> dict:
+    """Fills in missing knobs and clamps them to the ranges the layout allows."""
+    out = json.loads(json.dumps(DEFAULT_KNOBS))
+    for key, value in knobs.items():
+        if key == "weights":
+            out["weights"].update({k: float(v) for k, v in value.items() if k in CLASSES})
+        elif key in out:
+            out[key] = value
+    out["length"] = int(min(max(out["length"], 8), 4000))
+    for key in ("dep", "waw", "special"):
+        out[key] = float(min(max(out[key], 0.0), 1.0))
+    out["window"] = int(min(max(out["window"], 1), 8))
+    out["loop_iters"] = int(min(max(out["loop_iters"], 1), 64))
+    out["loop_body"] = int(min(max(out["loop_body"], 1), MAX_BODY))
+    out["skip"] = int(min(max(out["skip"], 1), MAX_SKIP))
+    out["weights"] = {k: max(float(v), 0.0) for k, v in out["weights"].items()}
+    return out
+
+
+def random_knobs(rng: random.Random) -> dict:
+    return clamp_knobs({
+        "length": int(math.exp(rng.uniform(math.log(32), math.log(1000)))),
+        "weights": {c: rng.expovariate(1.0) * DEFAULT_KNOBS["weights"][c] for c in CLASSES},
+        "dep": rng.random(),
+        "waw": rng.random() * 0.5,
+        "window": rng.randint(1, 6),
+        "special": rng.random() * 0.3,
+        "loop_iters": rng.randint(1, 32),
+        "loop_body": rng.randint(1, MAX_BODY),
+        "skip": rng.randint(1, MAX_SKIP),
+    })
+
+
+def mutate_knobs(knobs: dict, rng: random.Random) -> dict:
+    """A neighbour of knobs: every weight scaled by log-normal noise, the
+    probabilities nudged and the shape parameters stepped."""
+    out = json.loads(json.dumps(knobs))
+    out["weights"] = {c: w * math.exp(rng.gauss(0.0, 0.5)) for c, w in out["weights"].items()}
+    if rng.random() < 0.2:
+        out["weights"][rng.choice(CLASSES)] = 0.0  # drop a class entirely now and then
+    for key in ("dep", "waw", "special"):
+        out[key] += rng.gauss(0.0, 0.1)
+    out["length"] = int(out["length"] * math.exp(rng.gauss(0.0, 0.3)))
+    for key in ("window", "loop_iters", "loop_body", "skip"):
+        out[key] += rng.choice((-1, 0, 0, 1))
+    return clamp_knobs(out)
+
+
+class Generator:
+    def __init__(self, knobs: dict, seed: int, harts: int, has_m: bool):
+        if not 1 <= harts <= MAX_HARTS:
+            raise ValueError(f"harts must be between 1 and {MAX_HARTS}")
+        self.knobs = clamp_knobs(knobs)
+        self.rng = random.Random(seed)
+        self.harts = harts
+        weights = dict(self.knobs["weights"])
+        if not has_m:
+            weights["muldiv"] = 0.0
+        if sum(weights.values()) <= 0.0:
+            weights["alu"] = 1.0
+        self.classes = list(CLASSES)
+        self.class_weights = [weights[c] for c in CLASSES]
+        self.recent: List[int] = []
+        self.labels = 0
+
+    # Register choice biased towards the last few destinations.
+    def _src(self) -> int:
+        if self.recent and self.rng.random() < self.knobs["dep"]:
+            return self.rng.choice(self.recent)
+        return self.rng.choice(range(0, 29))
+
+    def _dst(self) -> int:
+        if self.recent and self.rng.random() < self.knobs["waw"]:
+            rd = self.rng.choice(self.recent)
+        else:
+            rd = 0 if self.rng.random() < 0.02 else self.rng.choice(GP_REGS)
+        if rd:
+            self.recent = (self.recent + [rd])[-self.knobs["window"]:]
+        return rd
+
+    def _label(self) -> str:
+        self.labels += 1
+        return f"L{self.labels}"
+
+    def _special(self, out: List[Insn]) -> int:
+        """Maybe sets a fresh register to a corner value and returns it as a source."""
+        if self.rng.random() >= self.knobs["special"]:
+            return self._src()
+        rd = self.rng.choice(GP_REGS)
+        out.extend(_li(rd, self.rng.choice(SPECIAL_VALUES)))
+        self.recent = (self.recent + [rd])[-self.knobs["window"]:]
+        return rd
+
+    def _item(self, cls: str, skip_label) -> list:
+        rng = self.rng
+        out: list = []
+        if cls == "alu":
+            name, (funct3, funct7) = rng.choice(list(ALU_OPS.items()))
+            rs1, rs2 = self._special(out), self._special(out)
+            rd = self._dst()
+            out.append(Insn(f"{name} x{rd}, x{rs1}, x{rs2}", _r(funct7, rs2, rs1, funct3, rd, 0x33)))
+        elif cls == "muldiv":
+            name, funct3 = rng.choice(list(MULDIV_OPS.items()))
+            rs1, rs2 = self._special(out), self._special(out)
+            rd = self._dst()
+            out.append(Insn(f"{name} x{rd}, x{rs1}, x{rs2}", _r(0x01, rs2, rs1, funct3, rd, 0x33)))
+        elif cls == "alu_imm":
+            rs1 = self._src()
+            if rng.random() < 0.3:
+                name, (funct3, funct7) = rng.choice(list(SHIFT_IMM_OPS.items()))
+                shamt = rng.randrange(32)
+                rd = self._dst()
+                out.append(Insn(f"{name} x{rd}, x{rs1}, {shamt}",
+                                _i((funct7 << 5) | shamt, rs1, funct3, rd, 0x13)))
+            else:
+                name, funct3 = rng.choice(list(ALU_IMM_OPS.items()))
+                imm = rng.choice((0, 1, -1, -2048, 2047)) if rng.random() < 0.2 \
+                    else rng.randint(-2048, 2047)
+                rd = self._dst()
+                out.append(Insn(f"{name} x{rd}, x{rs1}, {imm}", _i(imm, rs1, funct3, rd, 0x13)))
+        elif cls == "upper":
+            imm20 = rng.getrandbits(20)
+            rd = self._dst()
+            if rng.random() < 0.5:
+                out.append(Insn(f"lui x{rd}, 0x{imm20:x}", _u(imm20, rd, 0x37)))
+            else:
+                out.append(Insn(f"auipc x{rd}, 0x{imm20:x}", _u(imm20, rd, 0x17)))
+        elif cls == "load":
+            name, (funct3, size) = rng.choice(list(LOAD_OPS.items()))
+            offset = rng.randrange(0, DATA_BYTES, size)
+            rd = self._dst()
+            out.append(Insn(f"{name} x{rd}, {offset}(x{R_BASE})", _i(offset, R_BASE, funct3, rd, 0x03)))
+        elif cls == "store":
+            name, (funct3, size) = rng.choice(list(STORE_OPS.items()))
+            offset = rng.randrange(0, DATA_BYTES, size)
+            rs2 = self._src()
+            out.append(Insn(f"{name} x{rs2}, {offset}(x{R_BASE})", _s(offset, rs2, R_BASE, funct3)))
+        elif cls == "branch":
+            name, funct3 = rng.choice(list(BRANCH_OPS.items()))
+            rs1, rs2 = self._src(), self._src()
+            target = skip_label(rng.randint(1, self.knobs["skip"]))
+            out.append(Insn(f"{name} x{rs1}, x{rs2}, {target}", label=target, kind="branch",
+                            fields=(rs1, rs2, funct3)))
+        elif cls == "jal":
+            target = skip_label(rng.randint(1, self.knobs["skip"]))
+            rd = self._dst()
+            out.append(Insn(f"jal x{rd}, {target}", label=target, kind="jal", fields=(rd,)))
+        elif cls == "jalr":
+            target = skip_label(rng.randint(1, self.knobs["skip"]))
+            out.append(Insn(f"auipc x{R_JALR}, 0", _u(0, R_JALR, 0x17)))
+            rd = self._dst()
+            out.append(Insn(f"jalr x{rd}, x{R_JALR} -> {target}", label=target, kind="jalr",
+                            fields=(rd,)))
+        return out
+
+    def _segment(self, length: int, allow_loops: bool) -> list:
+        """Items whose forward branches land on item boundaries in this segment."""
+        boundaries = [self._label() for _ in range(length + 1)]
+        items = []
+        for index in range(length):
+            def skip_label(skip, index=index):
+                return boundaries[min(index + 1 + skip, length)]
+            cls = self.rng.choices(self.classes, self.class_weights)[0]
+            if cls == "loop" and not allow_loops:
+                cls = "alu"
+            items.append([Label(boundaries[index])])
+            if cls == "loop":
+                iters = self.rng.randint(1, self.knobs["loop_iters"])
+                start = self._label()
+                items[-1].extend(_li(R_LOOP, iters))
+                items[-1].append(Label(start))
+                items[-1].extend(self._segment(self.rng.randint(1, self.knobs["loop_body"]), False))
+                items[-1].append(Insn(f"addi x{R_LOOP}, x{R_LOOP}, -1", _i(-1, R_LOOP, 0, R_LOOP, 0x13)))
+                items[-1].append(Insn(f"bne x{R_LOOP}, x0, {start}", label=start, kind="branch",
+                                      fields=(R_LOOP, 0, 1)))
+            else:
+                items[-1].extend(self._item(cls, skip_label))
+        flat = [node for item in items for node in item]
+        flat.append(Label(boundaries[length]))
+        return flat
+
+    def program(self) -> "Program":
+        rng = self.rng
+        code: list = []
+        # x31 = this hart's region.
+        code.append(_csrr(R_BASE, CSR_MHARTID, "mhartid"))
+        code.append(Insn(f"slli x{R_BASE}, x{R_BASE}, {REGION_SHIFT}",
+                         _i(REGION_SHIFT, R_BASE, 1, R_BASE, 0x13)))
+        code.extend(_la(R_LOOP, "begin_signature"))
+        code.append(Insn(f"add x{R_BASE}, x{R_BASE}, x{R_LOOP}", _r(0, R_LOOP, R_BASE, 0, R_BASE, 0x33)))
+        for rd in GP_REGS:
+            pick = rng.random()
+            if pick < 0.4:
+                offset = 4 * rng.randrange(DATA_BYTES // 4)
+                code.append(Insn(f"lw x{rd}, {offset}(x{R_BASE})", _i(offset, R_BASE, 2, rd, 0x03)))
+            elif pick < 0.6:
+                code.extend(_li(rd, rng.choice(SPECIAL_VALUES)))
+            else:
+                code.extend(_li(rd, rng.getrandbits(32)))
+        code.extend(self._segment(self.knobs["length"], True))
+        return Program(code, self.harts, rng)
+
+
+class Program:
+    """Assembled image: code, then tohost, the done flags and the signature."""
+
+    def __init__(self, code: list, harts: int, rng: random.Random):
+        self.harts = harts
+        nodes = list(code) + self._epilogue()
+
+        labels: Dict[str, int] = {}
+        pc = MEM_BASE
+        for node in nodes:
+            if isinstance(node, Label):
+                labels[node.name] = pc
+            else:
+                pc += 4
+        self.tohost = (pc + 0xFFF) & ~0xFFF
+        self.done = self.tohost + 64
+        self.signature = self.tohost + 0x100
+        self.end_signature = self.signature + harts * REGION_BYTES
+        labels.update(tohost=self.tohost, done=self.done, begin_signature=self.signature)
+
+        self.words: List[int] = []
+        self.lines: List[str] = []
+        pc = MEM_BASE
+        for node in nodes:
+            if isinstance(node, Label):
+                self.lines.append(f"{node.name}:")
+                continue
+            word = node.encode(pc, labels)
+            self.words.append(word)
+            self.lines.append(f"  {pc:08x}: {word:08x}  {node.text}")
+            pc += 4
+        self.data = [rng.getrandbits(32) for _ in range(harts * REGION_BYTES // 4)]
+
+    def _epilogue(self) -> list:
+        out: list = [Label("epilogue")]
+        for reg in range(32):
+            offset = REGS_OFFSET + 4 * reg
+            out.append(Insn(f"sw x{reg}, {offset}(x{R_BASE})", _s(offset, reg, R_BASE, 2)))
+        out.append(_csrr(1, CSR_MHARTID, "mhartid"))
+        out.extend(_la(3, "done"))
+        out.append(Insn("addi x2, x0, 1", _i(1, 0, 0, 2, 0x13)))
+        out.append(Insn("bne x1, x0, not_hart0", label="not_hart0", kind="branch", fields=(1, 0, 1)))
+        for hart in range(1, self.harts):
+            wait = f"wait{hart}"
+            out.append(Label(wait))
+            out.append(Insn(f"lw x4, {4 * hart}(x3)", _i(4 * hart, 3, 2, 4, 0x03)))
+            out.append(Insn(f"beq x4, x0, {wait}", label=wait, kind="branch", fields=(4, 0, 0)))
+        out.extend(_la(5, "tohost"))
+        out.append(Insn("sw x2, 0(x5)", _s(0, 2, 5, 2)))
+        out.append(Label("halt"))
+        out.append(Insn("jal x0, halt", label="halt", kind="jal", fields=(0,)))
+        out.append(Label("not_hart0"))
+        out.append(Insn("slli x1, x1, 2", _i(2, 1, 1, 1, 0x13)))
+        out.append(Insn("add x3, x3, x1", _r(0, 1, 3, 0, 3, 0x33)))
+        out.append(Insn("sw x2, 0(x3)", _s(0, 2, 3, 2)))
+        out.append(Label("park"))
+        out.append(Insn("jal x0, park", label="park", kind="jal", fields=(0,)))
+        return out
+
+    def listing(self) -> str:
+        return "\n".join(self.lines + [
+            f"tohost          = 0x{self.tohost:08x}",
+            f"done flags      = 0x{self.done:08x}",
+            f"begin_signature = 0x{self.signature:08x} ({REGION_BYTES} bytes per hart,"
+            f" registers at +{REGS_OFFSET})",
+            f"end_signature   = 0x{self.end_signature:08x}"]) + "\n"
+
+    def elf(self) -> bytes:
+        """ELF32 with one RWX PT_LOAD and the symbols elf_loader.cpp looks up."""
+        image = bytearray(self.end_signature - MEM_BASE)
+        struct.pack_into(f"<{len(self.words)}I", image, 0, *self.words)
+        struct.pack_into(f"<{len(self.data)}I", image, self.signature - MEM_BASE, *self.data)
+
+        names = b"\0tohost\0fromhost\0begin_signature\0end_signature\0"
+        symbols = [("tohost", self.tohost), ("fromhost", self.tohost + 8),
+                   ("begin_signature", self.signature), ("end_signature", self.end_signature)]
+        symtab = bytearray(16)  # the null symbol
+        for name, value in symbols:
+            # STB_GLOBAL, STT_NOTYPE, SHN_ABS
+            symtab += struct.pack("<IIIBBH", names.index(name.encode() + b"\0"), value, 0, 0x10, 0,
+                                  0xFFF1)
+
+        seg_off = 0x100
+        symtab_off = seg_off + len(image)
+        strtab_off = symtab_off + len(symtab)
+        shoff = (strtab_off + len(names) + 3) & ~3
+        ehdr = struct.pack("<16sHHIIIIIHHHHHH", b"\x7fELF\x01\x01\x01" + bytes(9), 2, 0xF3, 1,
+                           MEM_BASE, 52, shoff, 0, 52, 32, 1, 40, 3, 0)
+        phdr = struct.pack("<IIIIIIII", 1, seg_off, MEM_BASE, MEM_BASE, len(image), len(image), 7, 4)
+        shdrs = bytes(40)
+        shdrs += struct.pack("<IIIIIIIIII", 0, 2, 0, 0, symtab_off, len(symtab), 2, 1, 4, 16)
+        shdrs += struct.pack("<IIIIIIIIII", 0, 3, 0, 0, strtab_off, len(names), 0, 0, 1, 0)
+
+        out = bytearray(shoff + len(shdrs))
+        out[0:52] = ehdr
+        out[52:84] = phdr
+        out[seg_off:symtab_off] = image
+        out[symtab_off:strtab_off] = symtab
+        out[strtab_off:strtab_off + len(names)] = names
+        out[shoff:] = shdrs
+        return bytes(out)
+
+
+def generate(knobs: dict, seed: int, harts: int = 1, has_m: bool = True) -> Program:
+    return Generator(knobs, seed, harts, has_m).program()
+
+
+def main(argv=None) -> int:
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--seed", type=int, required=True)
+    parser.add_argument("--knobs", help="JSON knobs file (default: DEFAULT_KNOBS)")
+    parser.add_argument("--harts", type=int, default=1)
+    parser.add_argument("--no-m", action="store_true", help="leave out MUL/DIV")
+    parser.add_argument("--elf", required=True)
+    parser.add_argument("--listing", help="also write the disassembly and layout")
+    args = parser.parse_args(argv)
+
+    knobs = DEFAULT_KNOBS
+    if args.knobs:
+        with open(args.knobs) as f:
+            knobs = json.load(f)
+    try:
+        program = generate(knobs, args.seed, args.harts, not args.no_m)
+    except ValueError as e:
+        print(f"rvgen: {e}", file=sys.stderr)
+        return 1
+    with open(args.elf, "wb") as f:
+        f.write(program.elf())
+    if args.listing:
+        with open(args.listing, "w") as f:
+            f.write(program.listing())
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
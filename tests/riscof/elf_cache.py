@@ -0,0 +1,195 @@
+"""Content-addressed cache of compiled arch-test ELFs, shared by the plugins.
+
+Every DUT plugin and the ISS reference plugin compile tests through one
+``Toolchain`` (same compiler, flags, ``link.ld`` and ``model_test.h``), so a
+test built for the same ``-march`` and macros is the same ELF whichever
+plugin asks for it. ``parallel_runner.compile_jobs`` looks each test up in
+the ``ElfCache`` before compiling it and stores what it compiles.
+
+The key is a SHA-256 over the compiler's ``--version`` line, the fixed
+flags, ``-march``, ``-mabi``, the macros, the test source, ``link.ld`` and
+every file in the include directories (the plugin env and the arch-test
+env). The ELFs carry ``-g`` line info naming the source path of whichever
+run compiled them; the loaded image does not depend on it.
+
+The cache lives in ``RISCOF_ELF_CACHE`` (default ``tests/riscof/elf_cache``);
+``RISCOF_ELF_CACHE=off`` compiles every test as before. Entries are written
+through a temporary file and renamed, so concurrent runs may share it.
+
+Fill it ahead of a run from a RISCOF test list (``riscof testlist`` writes
+``<work-dir>/test_list.yaml``; so does every ``riscof run``)::
+
+    python3 elf_cache.py prebuild --test-list work/test_list.yaml \\
+        --arch-env $RISCV_ARCH_TEST_ROOT/riscv-test-suite/env -j 32
+"""
+
+import argparse
+import hashlib
+import logging
+import os
+import shlex
+import shutil
+import subprocess
+import sys
+import tempfile
+from typing import Dict, List, Optional
+
+from parallel_runner import TestJob, compile_jobs, resolve_jobs
+
+logger = logging.getLogger()
+
+PLUGIN_ROOT = os.path.dirname(os.path.abspath(__file__))
+DEFAULT_CACHE = os.path.join(PLUGIN_ROOT, "elf_cache")
+# The test environment every plugin compiles with (RVMODEL_HALT writes tohost).
+SHARED_ENV = os.path.join(PLUGIN_ROOT, "zeronyte", "env")
+
+COMPILE_FLAGS = ("-mcmodel=medany", "-static", "-nostdlib", "-nostartfiles", "-g")
+
+
+def _digest_file(h, path: str):
+    h.update(path.rsplit(os.sep, 1)[-1].encode() + b"\0")
+    with open(path, "rb") as f:
+        h.update(hashlib.sha256(f.read()).digest())
+
+
+class Toolchain:
+    """Compile command and cache key for arch tests in one environment."""
+
+    def __init__(self, arch_env: str, env_dir: str = SHARED_ENV, xlen: str = "32",
+                 gcc: Optional[str] = None):
+        self.gcc = gcc or os.environ.get("RISCV_GCC", "riscv64-unknown-elf-gcc")
+        self.linker = os.path.join(env_dir, "link.ld")
+        self.includes = [env_dir, arch_env]
+        self.xlen = xlen
+        self.mabi = "lp64" if xlen == "64" else "ilp32"
+
+        # Everything but the test, -march and the macros, hashed once.
+        base = hashlib.sha256()
+        base.update(self._compiler_id().encode() + b"\0")
+        base.update(" ".join(COMPILE_FLAGS + ("-mabi=" + self.mabi,)).encode() + b"\0")
+        _digest_file(base, self.linker)
+        for include in self.includes:
+            for name in sorted(os.listdir(include)):
+                path = os.path.join(include, name)
+                if os.path.isfile(path):
+                    _digest_file(base, path)
+        self._base = base.digest()
+
+    def _compiler_id(self) -> str:
+        try:
+            proc = subprocess.run([self.gcc, "--version"], stdout=subprocess.PIPE,
+                                  stderr=subprocess.DEVNULL, text=True)
+            return proc.stdout.splitlines()[0] if proc.stdout else self.gcc
+        except OSError:
+            return self.gcc
+
+    def macros(self, test_macros: List[str]) -> List[str]:
+        return ["-DXLEN=" + self.xlen] + ["-D" + m for m in test_macros or []]
+
+    def command(self, test: str, march: str, test_macros: List[str], elf: str) -> str:
+        args = [self.gcc, "-march=" + march.lower(), "-mabi=" + self.mabi, *COMPILE_FLAGS,
+                "-T", self.linker]
+        for include in self.includes:
+            args += ["-I", include]
+        args += [test, "-o", elf, *self.macros(test_macros)]
+        return " ".join(shlex.quote(a) for a in args)
+
+    def key(self, test: str, march: str, test_macros: List[str]) -> str:
+        h = hashlib.sha256(self._base)
+        h.update(march.lower().encode() + b"\0")
+        h.update("\0".join(self.macros(test_macros)).encode() + b"\0")
+        _digest_file(h, test)
+        return h.hexdigest()
+
+
+class ElfCache:
+    def __init__(self, root: str):
+        self.root = root
+
+    @classmethod
+    def from_env(cls) -> Optional["ElfCache"]:
+        root = os.environ.get("RISCOF_ELF_CACHE", DEFAULT_CACHE)
+        if root.lower() in ("", "0", "off", "none"):
+            return None
+        return cls(os.path.abspath(root))
+
+    def _path(self, key: str) -> str:
+        return os.path.join(self.root, key[:2], key + ".elf")
+
+    def fetch(self, key: str, dest: str) -> bool:
+        """Places the cached ELF at dest (a hard link where possible)."""
+        src = self._path(key)
+        if not os.path.isfile(src):
+            return False
+        if os.path.lexists(dest):
+            os.remove(dest)
+        try:
+            os.link(src, dest)
+        except OSError:
+            shutil.copyfile(src, dest)
+        return True
+
+    def store(self, key: str, elf: str):
+        dest = self._path(key)
+        os.makedirs(os.path.dirname(dest), exist_ok=True)
+        fd, tmp = tempfile.mkstemp(dir=os.path.dirname(dest), suffix=".tmp")
+        os.close(fd)
+        try:
+            shutil.copyfile(elf, tmp)
+            os.replace(tmp, dest)
+        except OSError as e:
+            logger.warning("ELF cache: could not store %s: %s", elf, e)
+            if os.path.exists(tmp):
+                os.remove(tmp)
+
+
+def _load_test_list(path: str) -> Dict[str, dict]:
+    import yaml  # RISCOF depends on PyYAML
+
+    with open(path) as f:
+        return yaml.safe_load(f) or {}
+
+
+def main(argv=None) -> int:
+    parser = argparse.ArgumentParser(description="Arch-test ELF cache shared by the RISCOF plugins")
+    sub = parser.add_subparsers(dest="command", required=True)
+    prebuild = sub.add_parser("prebuild", help="compile a RISCOF test list into the cache")
+    prebuild.add_argument("--test-list", required=True, help="test_list.yaml written by RISCOF")
+    prebuild.add_argument("--arch-env", required=True, help="riscv-test-suite/env")
+    prebuild.add_argument("--env", default=SHARED_ENV, help="model env (default: zeronyte/env)")
+    prebuild.add_argument("--xlen", default="32")
+    prebuild.add_argument("-j", "--jobs", default="0", help="parallel compiles (0: every core)")
+    prebuild.add_argument("--timeout", type=float, default=300.0)
+    args = parser.parse_args(argv)
+    logging.basicConfig(level=logging.INFO, format="%(levelname)s: %(message)s")
+
+    cache = ElfCache.from_env()
+    if cache is None:
+        logger.error("RISCOF_ELF_CACHE is off; nothing to prebuild")
+        return 1
+    toolchain = Toolchain(os.path.abspath(args.arch_env), os.path.abspath(args.env), args.xlen)
+    work = tempfile.mkdtemp(prefix="elf_prebuild_")
+    try:
+        jobs = []
+        for index, (name, entry) in enumerate(sorted(_load_test_list(args.test_list).items())):
+            test_dir = os.path.join(work, str(index))
+            os.makedirs(test_dir)
+            elf = os.path.join(test_dir, "test.elf")
+            jobs.append(TestJob(name, test_dir,
+                                toolchain.command(entry["test_path"], entry["isa"],
+                                                  entry["macros"], elf),
+                                None, elf=elf,
+                                cache_key=toolchain.key(entry["test_path"], entry["isa"],
+                                                        entry["macros"])))
+        results = compile_jobs(jobs, resolve_jobs(args.jobs), args.timeout, cache, "prebuild")
+    finally:
+        shutil.rmtree(work, ignore_errors=True)
+    failed = [r.name for r in results.values() if r.status != "compiled"]
+    cached = sum(1 for r in results.values() if r.cached)
+    logger.info("prebuild: %d tests, %d already cached, %d compiled, %d failed; cache at %s",
+                len(results), cached, len(results) - cached - len(failed), len(failed), cache.root)
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,3 @@
+from .riscof_iss import iss
+
+__all__ = ["iss"]
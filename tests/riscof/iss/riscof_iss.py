@@ -0,0 +1,76 @@
+import os
+import sys
+import logging
+from typing import Dict
+
+import riscof.utils as utils
+from riscof.pluginTemplate import pluginTemplate
+
+sys.path.insert(0, os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+from elf_cache import ElfCache, Toolchain  # noqa: E402
+from parallel_runner import TestJob, resolve_jobs, run_jobs  # noqa: E402
+
+logger = logging.getLogger()
+
+
+class iss(pluginTemplate):
+    """Reference plugin running the tests/sim ISS (iss_sim) in place of Spike."""
+
+    __model__ = "iss-rv32im"
+    __version__ = "0.1"
+
+    def __init__(self, *args, **kwargs):
+        super().__init__(*args, **kwargs)
+        config: Dict = kwargs.get("config")
+        if config is None:
+            raise SystemExit("iss plugin requires configuration")
+
+        sim_name = config.get("sim", "iss_sim")
+        sim_dir = config.get("PATH", "")
+        self.ref_exe = os.path.join(sim_dir, sim_name)
+        if not os.path.isabs(self.ref_exe):
+            self.ref_exe = os.path.abspath(self.ref_exe)
+
+        self.num_jobs = str(config.get("jobs", 1))
+        self.pluginpath = os.path.abspath(config["pluginpath"])
+        self.isa_spec = os.path.abspath(config["ispec"])
+        self.platform_spec = os.path.abspath(config["pspec"])
+        # The cores share one test environment (RVMODEL_HALT writes tohost).
+        self.env_dir = os.path.abspath(
+            config.get("env", os.path.join(self.pluginpath, "..", "zeronyte", "env"))
+        )
+
+    def initialise(self, suite, work_dir, archtest_env):
+        self.work_dir = work_dir
+        self.suite_dir = suite
+        self.archtest_env = archtest_env
+
+    def build(self, isa_yaml, platform_yaml):
+        ispec = utils.load_yaml(isa_yaml)["hart0"]
+        self.xlen = "64" if 64 in ispec["supported_xlen"] else "32"
+        self.toolchain = Toolchain(self.archtest_env, self.env_dir, self.xlen)
+
+    def runTests(self, testList):
+        timeout_env = os.environ.get("RISCOF_TIMEOUT") or os.environ.get("TIMEOUT")
+        try:
+            timeout = int(timeout_env) if timeout_env else 300
+        except ValueError:
+            timeout = 300
+
+        jobs = []
+        for testname, testentry in sorted(testList.items(), key=lambda item: item[0]):
+            test_dir = testentry["work_dir"]
+            elf_path = os.path.join(test_dir, "ref.elf")
+            sig_path = os.path.join(test_dir, self.name[:-1] + ".signature")
+
+            # Same key as the DUT plugins: a DUT run already compiled this ELF.
+            compile_cmd = self.toolchain.command(
+                testentry["test_path"], testentry["isa"], testentry["macros"], elf_path)
+            cache_key = self.toolchain.key(testentry["test_path"], testentry["isa"], testentry["macros"])
+            run_cmd = f"{self.ref_exe} --elf {elf_path} --signature {sig_path}"
+            jobs.append(TestJob(testname, test_dir, compile_cmd, run_cmd,
+                                elf=elf_path, cache_key=cache_key))
+
+        summary_path = os.path.join(self.work_dir, self.name[:-1] + ".summary.json")
+        run_jobs(jobs, resolve_jobs(self.num_jobs), timeout, summary_path, "ISS",
+                 ElfCache.from_env())
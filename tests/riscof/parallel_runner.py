@@ -0,0 +1,278 @@
+"""Bounded parallel compile+run of RISCOF test entries for the Nyte plugins.
+
+RISCOF hands each plugin the full test list; instead of one make target per
+test executed in order, the plugins build a list of ``TestJob`` objects and hand
+them to ``run_jobs``, which runs them on a worker pool sized from the plugin's
+``jobs`` setting and writes one JSON summary for the whole suite.
+
+Compilation is its own stage: ``compile_jobs`` builds every ELF on the pool
+first, taking it from the shared ``elf_cache.ElfCache`` when the job has a
+cache key, and only then do the simulations start.
+
+``run_jobs_batched`` is the server-mode variant: each worker streams its share
+of the compiled ELFs into one long-lived simulator started with ``--batch -``,
+so model construction happens once per worker instead of once per test.
+"""
+
+import json
+import logging
+import os
+import re
+import signal
+import subprocess
+import time
+from concurrent.futures import ThreadPoolExecutor, as_completed
+from dataclasses import asdict, dataclass, field
+from typing import Dict, List, Optional
+
+logger = logging.getLogger()
+
+# Summary line printed by the harness per program, e.g. "OctoNyte: cycles=1234 tohost=0x1",
+# followed by " skipped=<cycles>" when --idle-window fast-forwarded a spin, " timed=<cycles>"
+# with --mem-config and " cosim=<commits>" with --cosim; batch mode appends
+# " status=<exit code> elf=<path>".
+_SUMMARY_RE = re.compile(
+    r"^\w+: cycles=(\d+) tohost=0x([0-9a-fA-F]+)(?: skipped=(\d+))?(?: timed=\d+)?(?: cosim=\d+)?"
+    r"(?: status=(\d+) elf=(\S+))?$",
+    re.MULTILINE,
+)
+
+
+@dataclass
+class TestJob:
+    name: str
+    work_dir: str
+    compile_cmd: str
+    run_cmd: Optional[str]
+    # "<elf> <signature> [<trace>]" entry for run_jobs_batched.
+    batch_line: Optional[str] = None
+    # ELF compile_cmd writes, and its elf_cache.Toolchain key ("" bypasses the cache).
+    elf: str = ""
+    cache_key: str = ""
+
+
+@dataclass
+class TestResult:
+    name: str
+    status: str
+    returncode: int = 0
+    compile_seconds: float = 0.0
+    cached: bool = False  # the ELF came from the ELF cache
+    run_seconds: float = 0.0
+    cycles: Optional[int] = None
+    tohost: Optional[int] = None
+    skipped_cycles: Optional[int] = None
+    detail: str = field(default="", repr=False)
+
+
+def resolve_jobs(value) -> int:
+    """Maps the plugin ``jobs`` setting to a worker count; ``0`` means every host core."""
+    try:
+        jobs = int(value)
+    except (TypeError, ValueError):
+        jobs = 1
+    if jobs <= 0:
+        jobs = os.cpu_count() or 1
+    return jobs
+
+
+def _run_step(cmd: str, cwd: str, timeout: float):
+    start = time.monotonic()
+    # Own process group so a timeout also takes down the simulator under the shell.
+    proc = subprocess.Popen(
+        cmd,
+        shell=True,
+        cwd=cwd,
+        stdout=subprocess.PIPE,
+        stderr=subprocess.STDOUT,
+        text=True,
+        start_new_session=True,
+    )
+    try:
+        output, _ = proc.communicate(timeout=timeout)
+        returncode = proc.returncode
+    except subprocess.TimeoutExpired:
+        os.killpg(proc.pid, signal.SIGKILL)
+        output, _ = proc.communicate()
+        returncode = None
+    return returncode, output, round(time.monotonic() - start, 3)
+
+
+def _compile(job: TestJob, timeout: float, cache) -> TestResult:
+    result = TestResult(name=job.name, status="compiled")
+    if cache is not None and job.cache_key and cache.fetch(job.cache_key, job.elf):
+        result.cached = True
+        return result
+
+    returncode, output, result.compile_seconds = _run_step(job.compile_cmd, job.work_dir, timeout)
+    if returncode != 0:
+        result.status = "compile-timeout" if returncode is None else "compile-failed"
+        result.returncode = -1 if returncode is None else returncode
+        result.detail = output
+    elif cache is not None and job.cache_key:
+        cache.store(job.cache_key, job.elf)
+    return result
+
+
+def compile_jobs(jobs: List[TestJob], workers: int, timeout: float, cache,
+                 label: str) -> Dict[str, TestResult]:
+    """Compiles (or fetches from ``cache``) every job's ELF on ``workers`` threads."""
+    start = time.monotonic()
+    with ThreadPoolExecutor(max_workers=workers) as pool:
+        results = {r.name: r for r in pool.map(lambda job: _compile(job, timeout, cache), jobs)}
+    hits = sum(1 for r in results.values() if r.cached)
+    failed = [r for r in results.values() if r.status != "compiled"]
+    logger.info("%s: %d ELFs ready in %.1fs (%d from the ELF cache, %d failed to compile)",
+                label, len(results) - len(failed), time.monotonic() - start, hits, len(failed))
+    return results
+
+
+def _execute(job: TestJob, result: TestResult, timeout: float) -> TestResult:
+    result.status = "passed"
+    returncode, output, result.run_seconds = _run_step(job.run_cmd, job.work_dir, timeout)
+    match = _SUMMARY_RE.search(output)
+    if match:
+        result.cycles = int(match.group(1))
+        result.tohost = int(match.group(2), 16)
+        result.skipped_cycles = int(match.group(3)) if match.group(3) else None
+    if returncode is None:
+        result.status = "timeout"
+        result.returncode = -1
+    elif returncode != 0:
+        result.status = "failed"
+        result.returncode = returncode
+    result.detail = output
+    return result
+
+
+def _log_result(label: str, result: TestResult):
+    wall = result.compile_seconds + result.run_seconds
+    if result.status in ("passed", "compiled"):
+        logger.info("%s test %s %s (%.2fs, cycles=%s)",
+                    label, result.name, result.status.upper(), wall, result.cycles)
+    else:
+        logger.error("%s test %s %s (rc=%d, %.2fs)",
+                     label, result.name, result.status.upper(), result.returncode, wall)
+        if result.detail:
+            logger.error("%s", result.detail.rstrip())
+
+
+def _write_summary(results: List[TestResult], workers: int, wall_seconds: float,
+                   summary_path: str, label: str):
+    results.sort(key=lambda r: r.name)
+    summary = {
+        "label": label,
+        "workers": workers,
+        "wall_seconds": round(wall_seconds, 3),
+        "compile_seconds": round(sum(r.compile_seconds for r in results), 3),
+        "elf_cache_hits": sum(1 for r in results if r.cached),
+        "total_cycles": sum(r.cycles or 0 for r in results),
+        "skipped_cycles": sum(r.skipped_cycles or 0 for r in results),
+        "failed": [r.name for r in results if r.status not in ("passed", "compiled")],
+        "tests": [
+            {k: v for k, v in asdict(r).items() if k != "detail"} for r in results
+        ],
+    }
+    with open(summary_path, "w") as fh:
+        json.dump(summary, fh, indent=2)
+    logger.info("%s: %d tests in %.1fs, %d failed; summary at %s",
+                label, len(results), summary["wall_seconds"], len(summary["failed"]), summary_path)
+
+
+def run_jobs(jobs: List[TestJob], workers: int, timeout: float, summary_path: str, label: str,
+             cache=None):
+    """Compiles, then runs every job on ``workers`` threads; returns the results.
+
+    The pool bounds the number of concurrent compilers and then simulators.
+    Jobs without a ``run_cmd`` stop at "compiled". The summary JSON lists
+    per-test status, wall time and cycle count.
+    """
+    suite_start = time.monotonic()
+    logger.info("%s: compiling and running %d tests on %d workers", label, len(jobs), workers)
+    compiled = compile_jobs(jobs, workers, timeout, cache, label)
+
+    results: List[TestResult] = [r for r in compiled.values() if r.status != "compiled"]
+    for result in results:
+        _log_result(label, result)
+    runnable = [j for j in jobs if compiled[j.name].status == "compiled"]
+    results += [compiled[j.name] for j in runnable if j.run_cmd is None]
+    with ThreadPoolExecutor(max_workers=workers) as pool:
+        futures = [pool.submit(_execute, job, compiled[job.name], timeout)
+                   for job in runnable if job.run_cmd is not None]
+        for future in as_completed(futures):
+            result = future.result()
+            results.append(result)
+            _log_result(label, result)
+
+    _write_summary(results, workers, time.monotonic() - suite_start, summary_path, label)
+    return results
+
+
+def _run_shard(sim_cmd: str, shard: List[TestJob], results: dict, timeout: float):
+    """Feeds one shard of compiled jobs through a single ``--batch -`` simulator."""
+    by_elf = {job.batch_line.split()[0]: job for job in shard}
+    stdin = "".join(job.batch_line + "\n" for job in shard)
+    start = time.monotonic()
+    proc = subprocess.Popen(
+        f"{sim_cmd} --batch -",
+        shell=True,
+        stdin=subprocess.PIPE,
+        stdout=subprocess.PIPE,
+        stderr=subprocess.STDOUT,
+        text=True,
+        start_new_session=True,
+    )
+    try:
+        output, _ = proc.communicate(stdin, timeout=timeout * len(shard))
+    except subprocess.TimeoutExpired:
+        os.killpg(proc.pid, signal.SIGKILL)
+        output, _ = proc.communicate()
+    elapsed = time.monotonic() - start
+
+    # Output before a program's summary line belongs to that program.
+    pending = []
+    for line in output.splitlines():
+        match = _SUMMARY_RE.match(line)
+        if not match or match.group(5) not in by_elf:
+            pending.append(line)
+            continue
+        result = results[by_elf.pop(match.group(5)).name]
+        result.cycles = int(match.group(1))
+        result.tohost = int(match.group(2), 16)
+        result.skipped_cycles = int(match.group(3)) if match.group(3) else None
+        result.returncode = int(match.group(4))
+        result.status = "passed" if result.returncode == 0 else "failed"
+        result.detail = "\n".join(pending)
+        pending = []
+
+    # Anything without a summary line was lost to a crash or the shard timeout.
+    for job in by_elf.values():
+        result = results[job.name]
+        result.status = "timeout" if proc.returncode in (None, -signal.SIGKILL) else "failed"
+        result.returncode = -1
+        result.detail = "\n".join(pending)
+
+    # Wall time is only known per shard; attribute it evenly.
+    for job in shard:
+        results[job.name].run_seconds = round(elapsed / len(shard), 3)
+
+
+def run_jobs_batched(jobs: List[TestJob], workers: int, timeout: float, sim_cmd: str,
+                     summary_path: str, label: str, cache=None):
+    """Like ``run_jobs`` but runs the simulations through ``workers`` batch-mode simulators."""
+    suite_start = time.monotonic()
+    logger.info("%s: compiling %d tests on %d workers (batch mode)", label, len(jobs), workers)
+    results = compile_jobs(jobs, workers, timeout, cache, label)
+
+    runnable = [j for j in jobs if results[j.name].status == "compiled" and j.batch_line]
+    shards = [runnable[i::workers] for i in range(workers) if runnable[i::workers]]
+    logger.info("%s: running %d tests through %d batch simulators", label, len(runnable), len(shards))
+    with ThreadPoolExecutor(max_workers=max(len(shards), 1)) as pool:
+        for future in [pool.submit(_run_shard, sim_cmd, shard, results, timeout) for shard in shards]:
+            future.result()
+
+    ordered = list(results.values())
+    for result in sorted(ordered, key=lambda r: r.name):
+        _log_result(label, result)
+    _write_summary(ordered, workers, time.monotonic() - suite_start, summary_path, label)
+    return ordered
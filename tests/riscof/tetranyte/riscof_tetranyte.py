@@ -1,10 +1,15 @@
 import os
+import sys
 import logging
 from typing import Dict
 
 import riscof.utils as utils
 from riscof.pluginTemplate import pluginTemplate
 
+sys.path.insert(0, os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+from parallel_runner import TestJob, resolve_jobs, run_jobs, run_jobs_batched  # noqa: E402
+from elf_cache import ElfCache, Toolchain  # noqa: E402
+
 logger = logging.getLogger()
 
 
@@ -35,78 +40,59 @@ class tetranyte(pluginTemplate):
         self.suite_dir = suite
         self.archtest_env = archtest_env
 
-        self.linker = os.path.join(self.pluginpath, "env", "link.ld")
         self.local_env = os.path.join(self.pluginpath, "env")
         self.arch_env = archtest_env
 
-        gcc = os.environ.get("RISCV_GCC", "riscv64-unknown-elf-gcc")
-        self.compile_cmd_template = (
-            f"{gcc} -march={{march}} -mabi=ilp32 "
-            "-mcmodel=medany -static -nostdlib -nostartfiles -g "
-            "-T {linker} -I {local_env} -I {arch_env} {test} -o {elf} {macros}"
-        )
-
     def build(self, isa_yaml, platform_yaml):
         ispec = utils.load_yaml(isa_yaml)["hart0"]
         self.xlen = "64" if 64 in ispec["supported_xlen"] else "32"
+        # Same compiler, flags and env for every plugin, so they share the ELF cache.
+        self.toolchain = Toolchain(self.arch_env, self.local_env, self.xlen)
 
     def runTests(self, testList):
-        # RISCOF names the generated DUT makefile as "Makefile.DUT-<model>".
-        # Pick the first matching file to avoid name mismatches.
-        makefile_path = None
-        for fname in os.listdir(self.work_dir):
-            if fname.startswith("Makefile.DUT-"):
-                makefile_path = os.path.join(self.work_dir, fname)
-                break
-        if makefile_path is None:
-            makefile_path = os.path.join(self.work_dir, "Makefile." + self.name[:-1])
-
-        make = utils.makeUtil(makefilePath=makefile_path)
-        make.makeCommand = "make -k -j" + self.num_jobs
         timeout_env = os.environ.get("RISCOF_TIMEOUT") or os.environ.get("TIMEOUT")
         try:
             timeout = int(timeout_env) if timeout_env else 300
         except ValueError:
             timeout = 300
+        # Barrel threading stretches execution; allow configurable cycle budget.
+        max_cycles_env = os.environ.get("TETRANYTE_MAX_CYCLES")
+        try:
+            max_cycles = int(max_cycles_env) if max_cycles_env else 2_000_000
+        except ValueError:
+            max_cycles = 2_000_000
 
-        for testname, testentry in testList.items():
+        jobs = []
+        for testname, testentry in sorted(testList.items(), key=lambda item: item[0]):
             test_dir = testentry["work_dir"]
             elf_path = os.path.join(test_dir, "test.elf")
             sig_path = os.path.join(test_dir, self.name[:-1] + ".signature")
-            log_path = os.path.join(test_dir, self.name[:-1] + ".log")
-
-            compile_macros = "-DXLEN=" + self.xlen
-            if testentry["macros"]:
-                compile_macros += " -D" + " -D".join(testentry["macros"])
-
-            compile_cmd = self.compile_cmd_template.format(
-                march=testentry["isa"].lower(),
-                linker=self.linker,
-                local_env=self.local_env,
-                arch_env=self.arch_env,
-                test=testentry["test_path"],
-                elf=elf_path,
-                macros=compile_macros,
-            )
+            trace_path = os.path.join(test_dir, self.name[:-1] + ".trace")
 
+            compile_cmd = self.toolchain.command(
+                testentry["test_path"], testentry["isa"], testentry["macros"], elf_path)
+            cache_key = self.toolchain.key(testentry["test_path"], testentry["isa"], testentry["macros"])
+
+            run_cmd = None
             if self.target_run:
-                # Barrel threading stretches execution; allow configurable cycle budget.
-                max_cycles_env = os.environ.get("TETRANYTE_MAX_CYCLES")
-                try:
-                    max_cycles = int(max_cycles_env) if max_cycles_env else 2_000_000
-                except ValueError:
-                    max_cycles = 2_000_000
                 run_cmd = (
                     f"{self.dut_exe} --elf {elf_path} --signature {sig_path} "
-                    f"--log {log_path} --max-cycles {max_cycles}"
+                    f"--trace {trace_path} --max-cycles {max_cycles}"
                 )
-            else:
-                run_cmd = "echo 'target run disabled'"
-
-            execute = f"@cd {test_dir}; {compile_cmd}; {run_cmd};"
-            make.add_target(execute)
-
-        make.execute_all(self.work_dir, timeout=timeout)
+            batch_line = f"{elf_path} {sig_path} {trace_path}"
+            jobs.append(TestJob(testname, test_dir, compile_cmd, run_cmd, batch_line,
+                                elf=elf_path, cache_key=cache_key))
+
+        summary_path = os.path.join(self.work_dir, self.name[:-1] + ".summary.json")
+        cache = ElfCache.from_env()
+        workers = resolve_jobs(self.num_jobs)
+        # RISCOF_SIM_BATCH=1 reuses one simulator process per worker across tests.
+        if self.target_run and os.environ.get("RISCOF_SIM_BATCH", "0") == "1":
+            sim_cmd = f"{self.dut_exe} --max-cycles {max_cycles}"
+            results = run_jobs_batched(jobs, workers, timeout, sim_cmd, summary_path, "TetraNyte",
+                                       cache)
+        else:
+            results = run_jobs(jobs, workers, timeout, summary_path, "TetraNyte", cache)
 
         if not self.target_run:
             raise SystemExit(0)
@@ -1,10 +1,15 @@
 import os
+import sys
 import logging
 from typing import Dict
 
 import riscof.utils as utils
 from riscof.pluginTemplate import pluginTemplate
 
+sys.path.insert(0, os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+from elf_cache import ElfCache, Toolchain  # noqa: E402
+from parallel_runner import TestJob, resolve_jobs, run_jobs  # noqa: E402
+
 logger = logging.getLogger()
 
 
@@ -35,61 +40,44 @@ class zeronyte(pluginTemplate):
         self.suite_dir = suite
         self.archtest_env = archtest_env
 
-        self.linker = os.path.join(self.pluginpath, "env", "link.ld")
         self.local_env = os.path.join(self.pluginpath, "env")
         self.arch_env = archtest_env
 
-        self.compile_cmd_template = (
-            "riscv64-unknown-elf-gcc -march={march} -mabi=ilp32 "
-            "-mcmodel=medany -static -nostdlib -nostartfiles -g "
-            "-T {linker} -I {local_env} -I {arch_env} {test} -o {elf} {macros}"
-        )
-
     def build(self, isa_yaml, platform_yaml):
         ispec = utils.load_yaml(isa_yaml)["hart0"]
         self.xlen = "64" if 64 in ispec["supported_xlen"] else "32"
+        self.toolchain = Toolchain(self.arch_env, self.local_env, self.xlen)
 
     def runTests(self, testList):
-        make = utils.makeUtil(makefilePath=os.path.join(self.work_dir, "Makefile." + self.name[:-1]))
-        make.makeCommand = "make -k -j" + self.num_jobs
         timeout_env = os.environ.get("RISCOF_TIMEOUT") or os.environ.get("TIMEOUT")
         try:
             timeout = int(timeout_env) if timeout_env else 300
         except ValueError:
             timeout = 300
 
-        for testname, testentry in testList.items():
+        jobs = []
+        for testname, testentry in sorted(testList.items(), key=lambda item: item[0]):
             test_dir = testentry["work_dir"]
             elf_path = os.path.join(test_dir, "test.elf")
             sig_path = os.path.join(test_dir, self.name[:-1] + ".signature")
-            log_path = os.path.join(test_dir, self.name[:-1] + ".log")
-
-            compile_macros = "-DXLEN=" + self.xlen
-            if testentry["macros"]:
-                compile_macros += " -D" + " -D".join(testentry["macros"])
-
-            compile_cmd = self.compile_cmd_template.format(
-                march=testentry["isa"].lower(),
-                linker=self.linker,
-                local_env=self.local_env,
-                arch_env=self.arch_env,
-                test=testentry["test_path"],
-                elf=elf_path,
-                macros=compile_macros,
-            )
+            trace_path = os.path.join(test_dir, self.name[:-1] + ".trace")
 
+            compile_cmd = self.toolchain.command(
+                testentry["test_path"], testentry["isa"], testentry["macros"], elf_path)
+            cache_key = self.toolchain.key(testentry["test_path"], testentry["isa"], testentry["macros"])
+
+            run_cmd = None
             if self.target_run:
                 run_cmd = (
                     f"{self.dut_exe} --elf {elf_path} --signature {sig_path} "
-                    f"--log {log_path} --max-cycles 1000000"
+                    f"--trace {trace_path} --max-cycles 1000000"
                 )
-            else:
-                run_cmd = "echo 'target run disabled'"
-
-            execute = f"@cd {test_dir}; {compile_cmd}; {run_cmd};"
-            make.add_target(execute)
+            jobs.append(TestJob(testname, test_dir, compile_cmd, run_cmd,
+                                elf=elf_path, cache_key=cache_key))
 
-        make.execute_all(self.work_dir, timeout=timeout)
+        summary_path = os.path.join(self.work_dir, self.name[:-1] + ".summary.json")
+        run_jobs(jobs, resolve_jobs(self.num_jobs), timeout, summary_path, "ZeroNyte",
+                 ElfCache.from_env())
 
         if not self.target_run:
             raise SystemExit(0)
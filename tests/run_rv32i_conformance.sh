@@ -12,18 +12,26 @@ ENV_ROOT="$RISCV_ARCH_TEST_ROOT/riscv-test-suite/env"
 print_usage() {
   cat <<EOF
 Usage: $(basename "$0") [--processor <zeronyte|zeronyte-cache|tetranyte|octonyte>]
-[--smoke-test] [--timeout <seconds>]
+[--smoke-test] [--timeout <seconds>] [--jobs <n>] [--batch] [--reference <spike|iss>]
+[--elf-cache <dir|off>]
 
 Runs RISCOF RV32I conformance for the requested processor. Defaults to ZeroNyte.
 Use --smoke-test to run a minimal ADD-only test for quicker turnaround.
 Use --timeout to override the per-invocation timeout (default: 3600s).
+Use --jobs to set how many tests compile and run concurrently (default: all host cores).
+Use --batch to run TetraNyte/OctoNyte tests through long-lived --batch simulators.
+Use --reference iss to take the golden signatures from tests/sim's ISS instead of Spike.
+Use --elf-cache to move the compiled-test cache the plugins share (default:
+tests/riscof/elf_cache), or "off" to compile every test.
 EOF
 }
 
 PROCESSOR="zeronyte"
+REFERENCE="spike"
 SMOKE_TEST=false
 TIMEOUT_SECS=3600
 TIMEOUT_SPECIFIED=false
+JOBS=$(nproc 2>/dev/null || echo 1)
 while [[ $# -gt 0 ]]; do
   case "$1" in
     --processor|-p)
@@ -34,6 +42,14 @@ while [[ $# -gt 0 ]]; do
       PROCESSOR="$2"
       shift 2
       ;;
+    --reference)
+      if [[ $# -lt 2 ]]; then
+        echo "Error: --reference requires spike or iss" >&2
+        exit 1
+      fi
+      REFERENCE="$2"
+      shift 2
+      ;;
     --help|-h)
       print_usage
       exit 0
@@ -51,6 +67,29 @@ while [[ $# -gt 0 ]]; do
       TIMEOUT_SPECIFIED=true
       shift 2
       ;;
+    --batch)
+      export RISCOF_SIM_BATCH=1
+      shift
+      ;;
+    --elf-cache)
+      if [[ $# -lt 2 ]]; then
+        echo "Error: --elf-cache requires a directory or off" >&2
+        exit 1
+      fi
+      case "$2" in
+        off|none|0) export RISCOF_ELF_CACHE=off ;;
+        *) export RISCOF_ELF_CACHE="$(realpath -m "$2")" ;;
+      esac
+      shift 2
+      ;;
+    --jobs|-j)
+      if [[ $# -lt 2 ]]; then
+        echo "Error: --jobs requires a value" >&2
+        exit 1
+      fi
+      JOBS="$2"
+      shift 2
+      ;;
     *)
       echo "Unknown argument: $1" >&2
       print_usage >&2
@@ -59,6 +98,14 @@ while [[ $# -gt 0 ]]; do
   esac
 done
 
+case "$REFERENCE" in
+  spike|iss) ;;
+  *)
+    echo "Unsupported reference: $REFERENCE (expected spike or iss)" >&2
+    exit 1
+    ;;
+esac
+
 case "$PROCESSOR" in
   zeronyte)
     DUT_NAME="zeronyte"
@@ -147,6 +194,9 @@ if [[ ! -f "$RTL_TOP" ]]; then
 fi
 
 "$SIM_BUILD_SCRIPT"
+if [[ "$REFERENCE" == "iss" ]]; then
+  "$SCRIPT_DIR/sim/build_iss_sim.sh"
+fi
 
 PLUGIN_DIR="$SCRIPT_DIR/riscof/$DUT_NAME"
 if [[ ! -d "$PLUGIN_DIR" ]]; then
@@ -209,11 +259,31 @@ if $SMOKE_TEST; then
   echo "Smoke test enabled: running ${#COPIED[@]} tests: ${COPIED[*]}"
 fi
 
+if [[ "$REFERENCE" == "iss" ]]; then
+  REF_PLUGIN="iss"
+  REF_PLUGIN_PATH="iss"
+  REF_CONFIG="[iss]
+pluginpath=iss
+ispec=$ISA_FILE
+pspec=$PLATFORM_FILE
+PATH=../sim/build
+jobs=$JOBS"
+else
+  REF_PLUGIN="spike_simple"
+  REF_PLUGIN_PATH="$PLUGIN_ROOT/spike_simple"
+  REF_CONFIG="[spike_simple]
+pluginpath=$PLUGIN_ROOT/spike_simple
+ispec=$PLUGIN_ROOT/spike_simple/spike_simple_isa.yaml
+pspec=$PLUGIN_ROOT/spike_simple/spike_simple_platform.yaml
+PATH=/opt/riscv/bin
+jobs=1"
+fi
+
 CONFIG_GENERATED="$SCRIPT_DIR/riscof/.config.rv32i.${PROCESSOR}.ini"
 cat >"$CONFIG_GENERATED" <<EOF
 [RISCOF]
-ReferencePlugin=spike_simple
-ReferencePluginPath=$PLUGIN_ROOT/spike_simple
+ReferencePlugin=$REF_PLUGIN
+ReferencePluginPath=$REF_PLUGIN_PATH
 DUTPlugin=$DUT_NAME
 DUTPluginPath=$DUT_NAME
 
@@ -223,14 +293,9 @@ ispec=$ISA_FILE
 pspec=$PLATFORM_FILE
 PATH=../sim/build
 sim=$SIM_BINARY
-jobs=1
+jobs=$JOBS
 
-[spike_simple]
-pluginpath=$PLUGIN_ROOT/spike_simple
-ispec=$PLUGIN_ROOT/spike_simple/spike_simple_isa.yaml
-pspec=$PLUGIN_ROOT/spike_simple/spike_simple_platform.yaml
-PATH=/opt/riscv/bin
-jobs=1
+$REF_CONFIG
 EOF
 
 TOOLCHAIN_DIR="$SCRIPT_DIR/toolchain"
@@ -314,7 +379,7 @@ fi
 
 if $SMOKE_TEST && [[ "$PROCESSOR" != "octonyte" ]]; then
   echo "[INFO] Smoke artifacts under $OUTPUT_DIR (signatures/logs):"
-  find "$OUTPUT_DIR" -type f \( -name "*.signature" -o -name "*.log" -o -name "*.elf" \) | sed 's|^|  |'
+  find "$OUTPUT_DIR" -type f \( -name "*.signature" -o -name "*.log" -o -name "*.trace" -o -name "*.elf" \) | sed 's|^|  |'
   echo "[INFO] Smoke tests executed:"
   find "$OUTPUT_DIR/src" -maxdepth 3 -mindepth 3 -type d | sed 's|^|  |'
 fi
@@ -333,7 +398,7 @@ if $SMOKE_TEST && [[ "$PROCESSOR" == "tetranyte" ]]; then
       SIG_PATH="$OUTPUT_DIR/src/${test_name}/dut/DUT-tetranyte-rv32i.thread${tid}.signature"
       LOG_PATH="$OUTPUT_DIR/src/${test_name}/dut/DUT-tetranyte-rv32i.thread${tid}.log"
       THREAD_MASK=$((1 << tid))
-      "$SCRIPT_DIR/sim/build/tetranyte_obj/VTetraNyteRV32ICore" \
+      "$SCRIPT_DIR/sim/build/tetranyte_sim" \
         --elf "$ELF_PATH" \
         --signature "$SIG_PATH" \
         --log "$LOG_PATH" \
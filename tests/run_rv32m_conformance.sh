@@ -11,13 +11,23 @@ ENV_ROOT="$RISCV_ARCH_TEST_ROOT/riscv-test-suite/env"
 
 print_usage() {
   cat <<EOF
-Usage: $(basename "$0") [--processor zeronyte]
-
-Runs RISCOF RV32M conformance for ZeroNyte.
+Usage: $(basename "$0") [--processor zeronyte] [--reference <spike|iss>] [--param key=value ...]
+       [--no-latency]
+
+Runs RISCOF RV32M conformance for ZeroNyte, then reports its cycles per MUL/DIV
+with tests/bench's muldiv kernels.
+Use --reference iss to take the golden signatures from tests/sim's ISS instead of Spike.
+--param regenerates the RTL with a design parameter first, e.g. muldiv.div-radix=16
+(see GenerateHierarchicalRTL --help), into its own directory under
+tests/output/rv32m/variants/ so the default RTL and simulator stay untouched.
+--no-latency skips the MUL/DIV report.
 EOF
 }
 
 PROCESSOR="zeronyte"
+REFERENCE="spike"
+PARAMS=()
+LATENCY=1
 while [[ $# -gt 0 ]]; do
   case "$1" in
     --processor|-p)
@@ -28,6 +38,26 @@ while [[ $# -gt 0 ]]; do
       PROCESSOR="$2"
       shift 2
       ;;
+    --reference)
+      if [[ $# -lt 2 ]]; then
+        echo "Error: --reference requires spike or iss" >&2
+        exit 1
+      fi
+      REFERENCE="$2"
+      shift 2
+      ;;
+    --param)
+      if [[ $# -lt 2 ]]; then
+        echo "Error: --param requires key=value" >&2
+        exit 1
+      fi
+      PARAMS+=("$2")
+      shift 2
+      ;;
+    --no-latency)
+      LATENCY=0
+      shift
+      ;;
     --help|-h)
       print_usage
       exit 0
@@ -40,6 +70,14 @@ while [[ $# -gt 0 ]]; do
   esac
 done
 
+case "$REFERENCE" in
+  spike|iss) ;;
+  *)
+    echo "Unsupported reference: $REFERENCE (expected spike or iss)" >&2
+    exit 1
+    ;;
+esac
+
 case "$PROCESSOR" in
   zeronyte)
     DUT_NAME="zeronyte"
@@ -49,6 +87,9 @@ case "$PROCESSOR" in
     PLATFORM_FILE="zeronyte/zeronyte_platform.yaml"
     RTL_TOP="$REPO_ROOT/rtl/generators/generated/verilog_hierarchical_timed/ZeroNyteRV32ICore.v"
     RTL_GEN_TASK="generators/generateZeroNyteRTL"
+    RTL_FAMILY="ZeroNyte"
+    RTL_MODULE="ZeroNyteRV32ICore"
+    BENCH_CORE="zeronyte"
     ;;
   *)
     echo "Unsupported processor: $PROCESSOR" >&2
@@ -93,8 +134,34 @@ if [[ ! -x "$SIM_BUILD_SCRIPT" ]]; then
   exit 1
 fi
 
+# Design parameters change the RTL, so the core is regenerated with them into
+# a directory of its own (as tests/dse does) and the simulator is built from
+# that Verilog; the shared generated RTL keeps the default configuration.
+SIM_DIR="$SCRIPT_DIR/sim/build"
+if [[ ${#PARAMS[@]} -gt 0 ]]; then
+  VARIANT_NAME=$(printf '%s_' "${PARAMS[@]}" | tr -c 'A-Za-z0-9._\n-' '-')
+  VARIANT_ROOT="$SCRIPT_DIR/output/rv32m/variants/$PROCESSOR/${VARIANT_NAME%_}"
+  RTL_TOP="$VARIANT_ROOT/verilog_hierarchical_timed/$RTL_MODULE.v"
+  SIM_DIR="$VARIANT_ROOT"
+  GEN_ARGS="--core-family $RTL_FAMILY --core-variant rv32i --top $RTL_MODULE"
+  GEN_ARGS+=" --output-root $VARIANT_ROOT"
+  for p in "${PARAMS[@]}"; do
+    GEN_ARGS+=" --param $p"
+  done
+  echo "Generating $RTL_MODULE with ${PARAMS[*]} into $VARIANT_ROOT ..."
+  mkdir -p "$VARIANT_ROOT"
+  pushd "$REPO_ROOT/rtl" >/dev/null
+  sbt "generators/runMain generators.GenerateHierarchicalRTL $GEN_ARGS"
+  popd >/dev/null
+  if [[ ! -f "$RTL_TOP" ]]; then
+    echo "Failed to generate RTL for $PROCESSOR with ${PARAMS[*]} at $RTL_TOP" >&2
+    exit 1
+  fi
+  "$SIM_BUILD_SCRIPT" --verilog "$RTL_TOP" --output "$SIM_DIR/$SIM_BINARY"
+fi
+
 # Ensure timed hierarchical RTL exists; generate via sbt if missing
-if [[ ! -f "$RTL_TOP" ]]; then
+if [[ ${#PARAMS[@]} -eq 0 && ! -f "$RTL_TOP" ]]; then
   echo "Timed RTL not found at $RTL_TOP. Attempting to generate via sbt $RTL_GEN_TASK ..."
   pushd "$REPO_ROOT/rtl" >/dev/null
   sbt "$RTL_GEN_TASK"
@@ -105,7 +172,12 @@ if [[ ! -f "$RTL_TOP" ]]; then
   fi
 fi
 
-"$SIM_BUILD_SCRIPT"
+if [[ ${#PARAMS[@]} -eq 0 ]]; then
+  "$SIM_BUILD_SCRIPT"
+fi
+if [[ "$REFERENCE" == "iss" ]]; then
+  "$SCRIPT_DIR/sim/build_iss_sim.sh"
+fi
 
 PLUGIN_DIR="$SCRIPT_DIR/riscof/$DUT_NAME"
 if [[ ! -d "$PLUGIN_DIR" ]]; then
@@ -116,11 +188,30 @@ fi
 OUTPUT_DIR="$SCRIPT_DIR/output/rv32m/$PROCESSOR"
 mkdir -p "$OUTPUT_DIR"
 
+if [[ "$REFERENCE" == "iss" ]]; then
+  REF_PLUGIN="iss"
+  REF_PLUGIN_PATH="iss"
+  REF_CONFIG="[iss]
+pluginpath=iss
+ispec=$ISA_FILE
+pspec=$PLATFORM_FILE
+PATH=../sim/build
+jobs=1"
+else
+  REF_PLUGIN="spike_simple"
+  REF_PLUGIN_PATH="$PLUGIN_ROOT/spike_simple"
+  REF_CONFIG="[spike_simple]
+pluginpath=$PLUGIN_ROOT/spike_simple
+ispec=$PLUGIN_ROOT/spike_simple/spike_simple_isa.yaml
+pspec=$PLUGIN_ROOT/spike_simple/spike_simple_platform.yaml
+PATH="
+fi
+
 CONFIG_GENERATED="$SCRIPT_DIR/riscof/.config.rv32m.${PROCESSOR}.ini"
 cat >"$CONFIG_GENERATED" <<EOF
 [RISCOF]
-ReferencePlugin=spike_simple
-ReferencePluginPath=$PLUGIN_ROOT/spike_simple
+ReferencePlugin=$REF_PLUGIN
+ReferencePluginPath=$REF_PLUGIN_PATH
 DUTPlugin=$DUT_NAME
 DUTPluginPath=$DUT_NAME
 
@@ -128,15 +219,11 @@ DUTPluginPath=$DUT_NAME
 pluginpath=$DUT_NAME
 ispec=$ISA_FILE
 pspec=$PLATFORM_FILE
-PATH=../sim/build
+PATH=$SIM_DIR
 sim=$SIM_BINARY
 jobs=1
 
-[spike_simple]
-pluginpath=$PLUGIN_ROOT/spike_simple
-ispec=$PLUGIN_ROOT/spike_simple/spike_simple_isa.yaml
-pspec=$PLUGIN_ROOT/spike_simple/spike_simple_platform.yaml
-PATH=
+$REF_CONFIG
 EOF
 
 pushd "$SCRIPT_DIR/riscof" >/dev/null
@@ -144,3 +231,17 @@ riscof run --config "$CONFIG_GENERATED" --suite "$SUITE_ROOT" --env "$ENV_ROOT"
 popd >/dev/null
 
 echo "RISCV RV32M conformance results for $PROCESSOR available under $OUTPUT_DIR"
+
+# Cycles per MUL/DIV of the configuration just checked. The kernels carry no
+# baseline: their cycles change with the muldiv parameters by design.
+if [[ "$LATENCY" -eq 1 ]]; then
+  LATENCY_BENCH=()
+  for k in mul-lat mul-tput mulh-tput div div-small rem; do
+    LATENCY_BENCH+=(--bench "muldiv-$k")
+  done
+  if ! python3 "$SCRIPT_DIR/bench/run_bench.py" --core "$BENCH_CORE" "${LATENCY_BENCH[@]}" \
+      --sim-dir "$SIM_DIR" --cc "${RISCV_PREFIX}gcc" --out "$OUTPUT_DIR/muldiv" \
+      --baseline ""; then
+    echo "Warning: MUL/DIV latency run failed; see $OUTPUT_DIR/muldiv" >&2
+  fi
+fi
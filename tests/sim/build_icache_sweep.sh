@@ -0,0 +1,17 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+SCRIPT_DIR=$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)
+REPO_ROOT=$(cd "$SCRIPT_DIR/../.." && pwd)
+
+cd "$REPO_ROOT"
+
+SIM_DIR="tests/sim"
+BUILD_DIR="$SIM_DIR/build"
+
+mkdir -p "$BUILD_DIR"
+
+"${CXX:-g++}" -O2 -std=c++17 -pthread -o "$BUILD_DIR/icache_sweep" \
+  "$SIM_DIR/icache_sweep.cpp" "$SIM_DIR/icache_model.cpp"
+
+echo "Built I-cache sweep at $BUILD_DIR/icache_sweep"
@@ -0,0 +1,17 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+SCRIPT_DIR=$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)
+REPO_ROOT=$(cd "$SCRIPT_DIR/../.." && pwd)
+
+cd "$REPO_ROOT"
+
+SIM_DIR="tests/sim"
+BUILD_DIR="$SIM_DIR/build"
+
+mkdir -p "$BUILD_DIR"
+
+"${CXX:-g++}" -O2 -std=c++17 -pthread -o "$BUILD_DIR/iss_sim" \
+  "$SIM_DIR/iss_sim.cpp" "$SIM_DIR/iss.cpp" "$SIM_DIR/elf_loader.cpp" "$SIM_DIR/memory.cpp"
+
+echo "Built ISS runner at $BUILD_DIR/iss_sim"
@@ -0,0 +1,110 @@
+#!/usr/bin/env bash
+# Builds soc_sim, which links the ZeroNyte, TetraNyte and OctoNyte models into
+# one binary. The first two are Verilated into linkable archives in their
+# own cache entries; the OctoNyte build then compiles the harness and links
+# everything against its Verilator runtime. Build the single-core simulators
+# first if the Verilog has not been generated yet.
+set -euo pipefail
+
+SCRIPT_DIR=$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)
+REPO_ROOT=$(cd "$SCRIPT_DIR/../.." && pwd)
+
+cd "$REPO_ROOT"
+
+SIM_DIR="tests/sim"
+BUILD_DIR="$SIM_DIR/build"
+# Every core already runs on its own host thread.
+DEFAULT_SIM_THREADS=1
+
+source "$SCRIPT_DIR/sim_build_profile.sh"
+source "$SCRIPT_DIR/sim_build_cache.sh"
+sim_build_parse_args "$@"
+if [[ -n "$SIM_VERILOG" || "$SIM_PROFILE" == pgo-* || "$SIM_SAVABLE" == "1" ]]; then
+  echo "soc_sim supports neither --verilog, the pgo profiles nor --savable" >&2
+  exit 1
+fi
+sim_build_select_profile soc_sim
+
+mkdir -p "$BUILD_DIR"
+
+VERILOG_DIR="rtl/generators/generated/verilog_hierarchical_timed"
+SIM_BINARY="${SIM_OUTPUT:-$BUILD_DIR/soc_sim}"
+ARCHIVE_TOPS=(ZeroNyteRV32ICore TetraNyteRV32ICore)
+LINK_TOP=OctoNyteRV32ICore
+
+for top in "${ARCHIVE_TOPS[@]}" "$LINK_TOP"; do
+  if [[ ! -f "$VERILOG_DIR/$top.v" ]]; then
+    echo "Expected RTL at $VERILOG_DIR/$top.v. Run the core's build_*_sim.sh to generate it." >&2
+    exit 1
+  fi
+done
+
+# Same Verilator arguments as the core's own build script.
+verilator_args() {
+  VERILATOR_ARGS=(
+    -cc "$VERILOG_DIR/$1.v"
+    --top-module "$1"
+    --timescale-override 1ns/1ns
+    "${PROFILE_VERILATOR_FLAGS[@]}"
+  )
+  if [[ "$1" != ZeroNyte* ]]; then
+    VERILATOR_ARGS+=(--Wno-UNOPTFLAT)
+  fi
+}
+
+CORE_ARCHIVES=()
+CORE_INCLUDES=""
+for top in "${ARCHIVE_TOPS[@]}"; do
+  verilator_args "$top"
+  sim_cache_select_obj_dir "soc_sim_$top" "$VERILOG_DIR/$top.v" "${VERILATOR_ARGS[@]}"
+  if [[ "$SIM_CACHE_HIT" -eq 0 ]]; then
+    verilator "${VERILATOR_ARGS[@]}" \
+      --Mdir "$OBJ_DIR" \
+      --build \
+      ${SIM_MAKEFLAGS[@]+"${SIM_MAKEFLAGS[@]}"} \
+      -CFLAGS "$PROFILE_CFLAGS"
+    sim_cache_record
+  fi
+  CORE_ARCHIVES+=("$REPO_ROOT/$OBJ_DIR/V${top}__ALL.a")
+  CORE_INCLUDES+=" -I$REPO_ROOT/$OBJ_DIR"
+done
+
+SIM_SOURCES=(
+  "$SIM_DIR/soc_sim.cpp"
+  "$SIM_DIR/cosim.cpp"
+  "$SIM_DIR/elf_loader.cpp"
+  "$SIM_DIR/host_profile.cpp"
+  "$SIM_DIR/icache_model.cpp"
+  "$SIM_DIR/iss.cpp"
+  "$SIM_DIR/mem_timing.cpp"
+  "$SIM_DIR/memory.cpp"
+  "$SIM_DIR/perf_counters.cpp"
+  "$SIM_DIR/soc.cpp"
+  "$SIM_DIR/trace.cpp"
+)
+mapfile -t HARNESS_FILES < <(sim_harness_sources)
+
+verilator_args "$LINK_TOP"
+sim_cache_select_obj_dir "soc_sim_$LINK_TOP" "$VERILOG_DIR/$LINK_TOP.v" "${VERILATOR_ARGS[@]}"
+
+# The archives are part of the binary's inputs, so a rebuilt core relinks.
+if sim_cache_binary_current "$OBJ_DIR/V$LINK_TOP" "${HARNESS_FILES[@]}" "${CORE_ARCHIVES[@]}"; then
+  echo "Simulator up to date; skipping Verilator and compile."
+else
+  verilator "${VERILATOR_ARGS[@]}" \
+    --Mdir "$OBJ_DIR" \
+    --build \
+    ${SIM_MAKEFLAGS[@]+"${SIM_MAKEFLAGS[@]}"} \
+    -CFLAGS "$PROFILE_CFLAGS$CORE_INCLUDES" \
+    -LDFLAGS "$PROFILE_LDFLAGS" \
+    --exe \
+      "${SIM_SOURCES[@]}" \
+      "${CORE_ARCHIVES[@]}"
+  sim_cache_record "${HARNESS_FILES[@]}" "${CORE_ARCHIVES[@]}"
+fi
+
+mkdir -p "$(dirname "$SIM_BINARY")"
+cp "$OBJ_DIR/V$LINK_TOP" "$SIM_BINARY"
+chmod +x "$SIM_BINARY"
+
+echo "Built simulator at $SIM_BINARY (profile: $SIM_PROFILE)"
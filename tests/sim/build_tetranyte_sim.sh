@@ -8,27 +8,32 @@ cd "$REPO_ROOT"
 
 SIM_DIR="tests/sim"
 BUILD_DIR="$SIM_DIR/build"
-OBJ_DIR="$BUILD_DIR/tetranyte_obj"
+DEFAULT_SIM_THREADS=2
+
+source "$SCRIPT_DIR/sim_build_profile.sh"
+source "$SCRIPT_DIR/sim_build_cache.sh"
+sim_build_parse_args "$@"
+sim_build_select_profile tetranyte_sim
 
 mkdir -p "$BUILD_DIR"
-rm -rf "$OBJ_DIR"
-mkdir -p "$OBJ_DIR"
 
-VERILOG_TOP="rtl/generators/generated/verilog_hierarchical_timed/TetraNyteRV32ICore.v"
+VERILOG_TOP="${SIM_VERILOG:-rtl/generators/generated/verilog_hierarchical_timed/TetraNyteRV32ICore.v}"
+SIM_BINARY="${SIM_OUTPUT:-$BUILD_DIR/tetranyte_sim}"
 RTL_SRC_DIRS=("rtl/TetraNyte/rv32i/src" "rtl/library/src")
 
 regen_rtl=0
 if [[ "${TETRANYTE_REGEN_RTL:-0}" == "1" ]]; then
   regen_rtl=1
-elif [[ ! -f "$VERILOG_TOP" ]]; then
-  regen_rtl=1
-elif [[ -n "$(find "${RTL_SRC_DIRS[@]}" -type f -name '*.scala' -newer "$VERILOG_TOP" -print -quit)" ]]; then
+elif [[ -z "$SIM_VERILOG" ]] && sim_rtl_needs_regen "$VERILOG_TOP" "${RTL_SRC_DIRS[@]}"; then
   regen_rtl=1
 fi
 
 if [[ "$regen_rtl" -eq 1 ]]; then
   echo "Regenerating TetraNyte RTL..."
   (cd "rtl" && sbt "generators/generateTetraNyteRTL")
+  if [[ -f "$VERILOG_TOP" ]]; then
+    sim_rtl_record_sources "$VERILOG_TOP" "${RTL_SRC_DIRS[@]}"
+  fi
 fi
 
 if [[ ! -f "$VERILOG_TOP" ]]; then
@@ -36,21 +41,48 @@ if [[ ! -f "$VERILOG_TOP" ]]; then
   exit 1
 fi
 
-verilator -cc "$VERILOG_TOP" \
-  --top-module TetraNyteRV32ICore \
-  --Mdir "$OBJ_DIR" \
-  --timescale-override 1ns/1ns \
-  --trace \
-  --Wno-UNOPTFLAT \
-  --build \
-  -CFLAGS "-O2 -std=c++17" \
-  -LDFLAGS "-O2" \
-  --exe \
-    "$SIM_DIR/tetranyte_sim.cpp" \
-    "$SIM_DIR/elf_loader.cpp" \
-    "$SIM_DIR/memory.cpp"
-
-cp "$OBJ_DIR/VTetraNyteRV32ICore" "$BUILD_DIR/tetranyte_sim"
-chmod +x "$BUILD_DIR/tetranyte_sim"
-
-echo "Built simulator at $BUILD_DIR/tetranyte_sim"
+VERILATOR_ARGS=(
+  -cc "$VERILOG_TOP"
+  --top-module TetraNyteRV32ICore
+  --timescale-override 1ns/1ns
+  "${PROFILE_VERILATOR_FLAGS[@]}"
+  --Wno-UNOPTFLAT
+)
+SIM_SOURCES=(
+  "$SIM_DIR/tetranyte_sim.cpp"
+  "$SIM_DIR/cosim.cpp"
+  "$SIM_DIR/elf_loader.cpp"
+  "$SIM_DIR/host_profile.cpp"
+  "$SIM_DIR/icache_model.cpp"
+  "$SIM_DIR/iss.cpp"
+  "$SIM_DIR/mem_timing.cpp"
+  "$SIM_DIR/memory.cpp"
+  "$SIM_DIR/perf_counters.cpp"
+  "$SIM_DIR/trace.cpp"
+)
+mapfile -t HARNESS_FILES < <(sim_harness_sources)
+
+sim_cache_select_obj_dir tetranyte_sim "$VERILOG_TOP" "${VERILATOR_ARGS[@]}"
+
+if sim_cache_binary_current "$OBJ_DIR/VTetraNyteRV32ICore" "${HARNESS_FILES[@]}"; then
+  echo "Simulator up to date; skipping Verilator and compile."
+else
+  # Verilator skips re-Verilating identical inputs in a reused OBJ_DIR, and
+  # make then rebuilds only the harness objects that changed.
+  verilator "${VERILATOR_ARGS[@]}" \
+    --Mdir "$OBJ_DIR" \
+    --build \
+    ${SIM_MAKEFLAGS[@]+"${SIM_MAKEFLAGS[@]}"} \
+    -CFLAGS "$PROFILE_CFLAGS" \
+    -LDFLAGS "$PROFILE_LDFLAGS" \
+    --exe \
+      "${SIM_SOURCES[@]}" \
+      ${PROFILE_INPUTS[@]+"${PROFILE_INPUTS[@]}"}
+  sim_cache_record "${HARNESS_FILES[@]}"
+fi
+
+mkdir -p "$(dirname "$SIM_BINARY")"
+cp "$OBJ_DIR/VTetraNyteRV32ICore" "$SIM_BINARY"
+chmod +x "$SIM_BINARY"
+
+echo "Built simulator at $SIM_BINARY (profile: $SIM_PROFILE)"
@@ -0,0 +1,16 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+SCRIPT_DIR=$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)
+REPO_ROOT=$(cd "$SCRIPT_DIR/../.." && pwd)
+
+cd "$REPO_ROOT"
+
+SIM_DIR="tests/sim"
+BUILD_DIR="$SIM_DIR/build"
+
+mkdir -p "$BUILD_DIR"
+
+"${CXX:-g++}" -O2 -std=c++17 -o "$BUILD_DIR/trace_decode" "$SIM_DIR/trace_decode.cpp"
+
+echo "Built trace decoder at $BUILD_DIR/trace_decode"
@@ -8,32 +8,63 @@ cd "$REPO_ROOT"
 
 SIM_DIR="tests/sim"
 BUILD_DIR="$SIM_DIR/build"
-OBJ_DIR="$BUILD_DIR/obj_dir_cache"
+DEFAULT_SIM_THREADS=1
+
+source "$SCRIPT_DIR/sim_build_profile.sh"
+source "$SCRIPT_DIR/sim_build_cache.sh"
+sim_build_parse_args "$@"
+sim_build_select_profile zeronyte_cache_sim
 
 mkdir -p "$BUILD_DIR"
-rm -rf "$OBJ_DIR"
-mkdir -p "$OBJ_DIR"
 
-VERILOG_TOP="rtl/generators/generated/verilog_hierarchical_timed/ZeroNyteRV32ICoreWithCache.v"
+VERILOG_TOP="${SIM_VERILOG:-rtl/generators/generated/verilog_hierarchical_timed/ZeroNyteRV32ICoreWithCache.v}"
+SIM_BINARY="${SIM_OUTPUT:-$BUILD_DIR/zeronyte_cache_sim}"
 if [[ ! -f "$VERILOG_TOP" ]]; then
   echo "Expected RTL at $VERILOG_TOP. Regenerate with 'sbt generateRTL' from rtl/." >&2
   exit 1
 fi
 
-verilator -cc "$VERILOG_TOP" \
-  --top-module ZeroNyteRV32ICoreWithCache \
-  --Mdir "$OBJ_DIR" \
-  --timescale-override 1ns/1ns \
-  --trace \
-  --build \
-  -CFLAGS "-O2 -std=c++17" \
-  -LDFLAGS "-O2" \
-  --exe \
-    "$SIM_DIR/zeronyte_cache_sim.cpp" \
-    "$SIM_DIR/elf_loader.cpp" \
-    "$SIM_DIR/memory.cpp"
-
-cp "$OBJ_DIR/VZeroNyteRV32ICoreWithCache" "$BUILD_DIR/zeronyte_cache_sim"
-chmod +x "$BUILD_DIR/zeronyte_cache_sim"
-
-echo "Built simulator at $BUILD_DIR/zeronyte_cache_sim"
+VERILATOR_ARGS=(
+  -cc "$VERILOG_TOP"
+  --top-module ZeroNyteRV32ICoreWithCache
+  --timescale-override 1ns/1ns
+  "${PROFILE_VERILATOR_FLAGS[@]}"
+)
+SIM_SOURCES=(
+  "$SIM_DIR/zeronyte_cache_sim.cpp"
+  "$SIM_DIR/cosim.cpp"
+  "$SIM_DIR/elf_loader.cpp"
+  "$SIM_DIR/host_profile.cpp"
+  "$SIM_DIR/icache_model.cpp"
+  "$SIM_DIR/iss.cpp"
+  "$SIM_DIR/mem_timing.cpp"
+  "$SIM_DIR/memory.cpp"
+  "$SIM_DIR/perf_counters.cpp"
+  "$SIM_DIR/trace.cpp"
+)
+mapfile -t HARNESS_FILES < <(sim_harness_sources)
+
+sim_cache_select_obj_dir zeronyte_cache_sim "$VERILOG_TOP" "${VERILATOR_ARGS[@]}"
+
+if sim_cache_binary_current "$OBJ_DIR/VZeroNyteRV32ICoreWithCache" "${HARNESS_FILES[@]}"; then
+  echo "Simulator up to date; skipping Verilator and compile."
+else
+  # Verilator skips re-Verilating identical inputs in a reused OBJ_DIR, and
+  # make then rebuilds only the harness objects that changed.
+  verilator "${VERILATOR_ARGS[@]}" \
+    --Mdir "$OBJ_DIR" \
+    --build \
+    ${SIM_MAKEFLAGS[@]+"${SIM_MAKEFLAGS[@]}"} \
+    -CFLAGS "$PROFILE_CFLAGS" \
+    -LDFLAGS "$PROFILE_LDFLAGS" \
+    --exe \
+      "${SIM_SOURCES[@]}" \
+      ${PROFILE_INPUTS[@]+"${PROFILE_INPUTS[@]}"}
+  sim_cache_record "${HARNESS_FILES[@]}"
+fi
+
+mkdir -p "$(dirname "$SIM_BINARY")"
+cp "$OBJ_DIR/VZeroNyteRV32ICoreWithCache" "$SIM_BINARY"
+chmod +x "$SIM_BINARY"
+
+echo "Built simulator at $SIM_BINARY (profile: $SIM_PROFILE)"
@@ -0,0 +1,168 @@
+#include "cosim.h"
+
+#include <sstream>
+
+#include "elf_loader.h"
+
+namespace {
+
+std::string hex(uint32_t value) {
+  std::ostringstream out;
+  out << "0x" << std::hex << value;
+  return out.str();
+}
+
+}  // namespace
+
+CoSim::CoSim(uint32_t mem_base, uint32_t mem_size, int harts, uint32_t kinds,
+             uint32_t thread_mask)
+    : memory_(mem_base, mem_size), iss_(memory_, harts), kinds_(kinds), queues_(harts) {
+  const uint32_t enabled = thread_mask & ((1u << harts) - 1);
+  if (enabled != 0 && (enabled & (enabled - 1)) == 0) {
+    store_hart_ = __builtin_ctz(enabled);
+  } else {
+    kinds_ &= ~kCommitStore;
+  }
+}
+
+void CoSim::load(const std::string& elf, uint32_t reset_pc) {
+  memory_.clear();
+  ElfSymbols symbols;
+  loadElfIntoMemory(elf, memory_, symbols);
+  iss_.reset(reset_pc);
+  for (HartQueues& queues : queues_) {
+    queues = HartQueues{};
+  }
+  mismatch_.clear();
+  checked_ = 0;
+}
+
+void CoSim::fail(int hart, const std::string& what) {
+  mismatch_ = "hart " + std::to_string(hart) + " after " + std::to_string(checked_) +
+              " matching events: " + what;
+}
+
+bool CoSim::fill(int hart, std::deque<IssStep>& queue, const char* kind) {
+  HartQueues& queues = queues_[hart];
+  for (uint64_t steps = 0; queue.empty(); ++steps) {
+    if (steps == kMaxRunAhead) {
+      fail(hart, std::string("ISS found no ") + kind + " within " + std::to_string(steps) +
+                     " instructions of pc " + hex(iss_.pc(hart)));
+      return false;
+    }
+    IssStep step;
+    if (iss_.step(hart, step) != kIssOk) {
+      fail(hart, "ISS stopped on unsupported instruction " + hex(step.instr) + " at pc " +
+                     hex(step.pc));
+      return false;
+    }
+    if ((kinds_ & kCommitRetire) != 0) {
+      queues.retires.push_back(step);
+    }
+    if (step.is_ctrl &&
+        ((kinds_ & kCommitControl) != 0 || ((kinds_ & kCommitTaken) != 0 && step.taken))) {
+      queues.controls.push_back(step);
+    }
+    if (step.is_store && (kinds_ & kCommitStore) != 0 && hart == store_hart_) {
+      queues.stores.push_back(step);
+    }
+  }
+  return true;
+}
+
+void CoSim::retire(int hart, uint32_t pc, uint32_t instr, uint32_t rd_value) {
+  HartQueues& queues = queues_[hart];
+  if (failed()) {
+    return;
+  }
+  // A store retires in the cycle its write reaches the data port.
+  if (!queues.stores.empty()) {
+    fail(hart, "store at pc " + hex(queues.stores.front().pc) + " never reached the data port");
+    return;
+  }
+  if (!fill(hart, queues.retires, "retire")) {
+    return;
+  }
+  const IssStep step = queues.retires.front();
+  queues.retires.pop_front();
+  if (pc != step.pc || instr != step.instr) {
+    fail(hart, "DUT retired " + hex(instr) + " at pc " + hex(pc) + ", ISS " + hex(step.instr) +
+                   " at pc " + hex(step.pc));
+    return;
+  }
+  if (step.writes_rd) {
+    if (step.rd_volatile) {
+      iss_.setReg(hart, step.rd, rd_value);
+    } else if (rd_value != step.rd_value) {
+      fail(hart, "pc " + hex(pc) + " instr " + hex(instr) + " wrote x" + std::to_string(step.rd) +
+                     " = " + hex(rd_value) + ", ISS " + hex(step.rd_value));
+      return;
+    }
+  }
+  ++checked_;
+}
+
+void CoSim::control(int hart, uint32_t from, bool taken, uint32_t target) {
+  HartQueues& queues = queues_[hart];
+  if (failed() || !fill(hart, queues.controls, "branch or jump")) {
+    return;
+  }
+  const IssStep step = queues.controls.front();
+  queues.controls.pop_front();
+  const bool outcome_ok = (kinds_ & kCommitControl) == 0 || taken == step.taken;
+  if (from != step.pc || !outcome_ok || (taken && target != step.next_pc)) {
+    fail(hart, "DUT " + std::string(taken ? "took " : "did not take ") + hex(from) +
+                   (taken ? " -> " + hex(target) : "") + ", ISS " +
+                   (step.taken ? "took " : "did not take ") + hex(step.pc) +
+                   (step.taken ? " -> " + hex(step.next_pc) : ""));
+    return;
+  }
+  ++checked_;
+}
+
+void CoSim::store(uint32_t addr, uint32_t data, uint32_t mask) {
+  if (failed() || (kinds_ & kCommitStore) == 0) {
+    return;
+  }
+  std::deque<IssStep>& stores = queues_[store_hart_].stores;
+  if (stores.empty()) {
+    if ((kinds_ & kCommitRetire) != 0) {
+      fail(store_hart_, "store to " + hex(addr) + " without a retiring store instruction");
+      return;
+    }
+    if (!fill(store_hart_, stores, "store")) {
+      return;
+    }
+  }
+  const IssStep step = stores.front();
+  stores.pop_front();
+
+  // Every byte the DUT writes must hold its value after the ISS store, and
+  // together they must cover the bytes the ISS stored.
+  const uint32_t word = step.store_addr & ~0x3u;
+  uint32_t covered = 0;
+  bool ok = true;
+  for (uint32_t byte = 0; byte < 4 && ok; ++byte) {
+    if (((mask >> byte) & 0x1u) == 0) {
+      continue;
+    }
+    const uint32_t at = addr + byte;
+    const uint8_t value = static_cast<uint8_t>(data >> (8 * byte));
+    const uint32_t offset = at - step.store_addr;
+    if (offset < step.store_size) {
+      ok = value == static_cast<uint8_t>(step.store_data >> (8 * offset));
+      covered |= 1u << offset;
+    } else if ((at & ~0x3u) == word) {
+      ok = value == static_cast<uint8_t>(step.store_word >> (8 * (at & 0x3u)));
+    } else {
+      ok = false;
+    }
+  }
+  if (!ok || covered != (1u << step.store_size) - 1) {
+    fail(store_hart_, "DUT stored " + hex(data) + " mask " + hex(mask) + " at " + hex(addr) +
+                          ", ISS pc " + hex(step.pc) + " stored " + hex(step.store_data) + " (" +
+                          std::to_string(step.store_size) + " bytes) at " + hex(step.store_addr));
+    return;
+  }
+  ++checked_;
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+// Lock-step co-simulation against the ISS (--cosim).
+//
+// CoSim loads the same ELF as the DUT into its own Memory and steps one ISS
+// hart per DUT thread. Port adapters report the commit events their core
+// exposes (Ports::commits); each event is matched against the next event of
+// the same kind the ISS produces for that hart, running the hart ahead as
+// far as needed, and the first difference ends the run:
+//   retire   pc, instruction and the rd value written back
+//   control  pc, outcome and target of a branch or jump (or only the taken
+//            ones, for cores that report nothing else)
+//   store    address, bytes and data; a full-word store of the merged word
+//            (ZeroNyte's SB/SH read-modify-write) must match the ISS memory
+//
+// Stores carry no thread id, so they are checked only while a single thread
+// is enabled. Counter CSR reads depend on timing: their rd value is never
+// compared, and the ISS adopts the DUT's value when it sees it.
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "iss.h"
+#include "memory.h"
+
+enum CommitKind : uint32_t {
+  kCommitRetire = 1u << 0,
+  kCommitControl = 1u << 1,
+  kCommitTaken = 1u << 2,  // taken branches and jumps only
+  kCommitStore = 1u << 3,
+};
+
+class CoSim {
+ public:
+  // kinds: the CommitKind bits the core reports; thread_mask: enabled harts.
+  CoSim(uint32_t mem_base, uint32_t mem_size, int harts, uint32_t kinds, uint32_t thread_mask);
+
+  // Loads the program and resets every hart to reset_pc; throws
+  // std::runtime_error like loadElfIntoMemory.
+  void load(const std::string& elf, uint32_t reset_pc);
+
+  // DUT events. After a mismatch failed() is set and later events are ignored.
+  void retire(int hart, uint32_t pc, uint32_t instr, uint32_t rd_value);
+  void control(int hart, uint32_t from, bool taken, uint32_t target);
+  void store(uint32_t addr, uint32_t data, uint32_t mask);
+
+  bool failed() const { return !mismatch_.empty(); }
+  const std::string& mismatch() const { return mismatch_; }
+  uint64_t checked() const { return checked_; }
+
+ private:
+  // Most ISS instructions a hart may run ahead looking for one event.
+  static constexpr uint64_t kMaxRunAhead = 1u << 20;
+
+  struct HartQueues {
+    std::deque<IssStep> retires;
+    std::deque<IssStep> controls;
+    std::deque<IssStep> stores;
+  };
+
+  // Steps the hart until queue holds an event; false once failed().
+  bool fill(int hart, std::deque<IssStep>& queue, const char* kind);
+  void fail(int hart, const std::string& what);
+
+  Memory memory_;
+  Iss iss_;
+  uint32_t kinds_;
+  int store_hart_ = -1;  // the single enabled hart, or -1
+  std::vector<HartQueues> queues_;
+  std::string mismatch_;
+  uint64_t checked_ = 0;
+};
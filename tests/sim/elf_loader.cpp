@@ -1,9 +1,13 @@
 #include "elf_loader.h"
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include <cstring>
-#include <fstream>
 #include <stdexcept>
-#include <vector>
+#include <string_view>
 
 namespace {
 
@@ -67,29 +71,64 @@ enum : uint32_t {
   SHT_SYMTAB = 2,
 };
 
-std::vector<uint8_t> readFile(const std::string& path) {
-  std::ifstream file(path, std::ios::binary);
-  if (!file.is_open()) {
-    throw std::runtime_error("failed to open ELF: " + path);
+// Read-only private mapping of the ELF image; segments are copied straight
+// out of the page cache instead of being staged in a heap buffer.
+class MappedFile {
+ public:
+  explicit MappedFile(const std::string& path) {
+    fd_ = ::open(path.c_str(), O_RDONLY);
+    if (fd_ < 0) {
+      throw std::runtime_error("failed to open ELF: " + path);
+    }
+    struct stat st {};
+    if (::fstat(fd_, &st) != 0) {
+      ::close(fd_);
+      throw std::runtime_error("failed to stat ELF: " + path);
+    }
+    size_ = static_cast<size_t>(st.st_size);
+    if (size_ > 0) {
+      void* addr = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+      if (addr == MAP_FAILED) {
+        ::close(fd_);
+        throw std::runtime_error("failed to map ELF: " + path);
+      }
+      data_ = static_cast<const uint8_t*>(addr);
+    }
   }
-  std::vector<uint8_t> buffer((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
-  return buffer;
-}
+
+  ~MappedFile() {
+    if (data_ != nullptr) {
+      ::munmap(const_cast<uint8_t*>(data_), size_);
+    }
+    ::close(fd_);
+  }
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  const uint8_t* data() const { return data_; }
+  size_t size() const { return size_; }
+
+ private:
+  int fd_ = -1;
+  const uint8_t* data_ = nullptr;
+  size_t size_ = 0;
+};
 
 template <typename T>
-T readStruct(const std::vector<uint8_t>& data, uint32_t offset) {
-  if (offset + sizeof(T) > data.size()) {
+T readStruct(const MappedFile& file, uint64_t offset) {
+  if (offset + sizeof(T) > file.size()) {
     throw std::runtime_error("ELF parse error: truncated file");
   }
   T value{};
-  std::memcpy(&value, data.data() + offset, sizeof(T));
+  std::memcpy(&value, file.data() + offset, sizeof(T));
   return value;
 }
 
 }  // namespace
 
 void loadElfIntoMemory(const std::string& path, Memory& memory, ElfSymbols& symbols) {
-  const auto image = readFile(path);
+  const MappedFile image(path);
   const Elf32_Ehdr ehdr = readStruct<Elf32_Ehdr>(image, 0);
 
   if (ehdr.e_ident[0] != kElfMagic0 || ehdr.e_ident[1] != kElfMagic1 ||
@@ -101,26 +140,23 @@ void loadElfIntoMemory(const std::string& path, Memory& memory, ElfSymbols& symb
   }
 
   for (uint16_t i = 0; i < ehdr.e_phnum; ++i) {
-    const uint32_t offset = ehdr.e_phoff + i * ehdr.e_phentsize;
+    const uint64_t offset = static_cast<uint64_t>(ehdr.e_phoff) + i * ehdr.e_phentsize;
     const Elf32_Phdr phdr = readStruct<Elf32_Phdr>(image, offset);
     if (phdr.p_type != PT_LOAD) {
       continue;
     }
-    for (uint32_t byte = 0; byte < phdr.p_filesz; ++byte) {
-      const uint32_t src_index = phdr.p_offset + byte;
-      if (src_index >= image.size()) {
-        throw std::runtime_error("ELF segment exceeds file size");
-      }
-      memory.write8(phdr.p_paddr + byte, image[src_index]);
+    if (static_cast<uint64_t>(phdr.p_offset) + phdr.p_filesz > image.size()) {
+      throw std::runtime_error("ELF segment exceeds file size");
     }
-    for (uint32_t byte = phdr.p_filesz; byte < phdr.p_memsz; ++byte) {
-      memory.write8(phdr.p_paddr + byte, 0);
+    memory.writeBlock(phdr.p_paddr, image.data() + phdr.p_offset, phdr.p_filesz);
+    if (phdr.p_memsz > phdr.p_filesz) {
+      memory.fill(phdr.p_paddr + phdr.p_filesz, 0, phdr.p_memsz - phdr.p_filesz);
     }
   }
 
   const Elf32_Shdr shdr_symtab = [&]() -> Elf32_Shdr {
     for (uint16_t i = 0; i < ehdr.e_shnum; ++i) {
-      const uint32_t off = ehdr.e_shoff + i * ehdr.e_shentsize;
+      const uint64_t off = static_cast<uint64_t>(ehdr.e_shoff) + i * ehdr.e_shentsize;
       const Elf32_Shdr shdr = readStruct<Elf32_Shdr>(image, off);
       if (shdr.sh_type == SHT_SYMTAB) {
         return shdr;
@@ -129,25 +165,27 @@ void loadElfIntoMemory(const std::string& path, Memory& memory, ElfSymbols& symb
     throw std::runtime_error("ELF missing symbol table");
   }();
 
-  const Elf32_Shdr shdr_strtab = readStruct<Elf32_Shdr>(image, ehdr.e_shoff + shdr_symtab.sh_link * ehdr.e_shentsize);
+  const Elf32_Shdr shdr_strtab = readStruct<Elf32_Shdr>(
+      image, static_cast<uint64_t>(ehdr.e_shoff) + shdr_symtab.sh_link * ehdr.e_shentsize);
   const uint32_t sym_count = shdr_symtab.sh_size / shdr_symtab.sh_entsize;
 
   for (uint32_t idx = 0; idx < sym_count; ++idx) {
-    const uint32_t sym_off = shdr_symtab.sh_offset + idx * shdr_symtab.sh_entsize;
+    const uint64_t sym_off = static_cast<uint64_t>(shdr_symtab.sh_offset) + idx * shdr_symtab.sh_entsize;
     const Elf32_Sym sym = readStruct<Elf32_Sym>(image, sym_off);
-    const uint32_t name_off = shdr_strtab.sh_offset + sym.st_name;
+    const uint64_t name_off = static_cast<uint64_t>(shdr_strtab.sh_offset) + sym.st_name;
     if (name_off >= image.size()) {
       continue;
     }
 
-    const char* name = reinterpret_cast<const char*>(image.data() + name_off);
-    if (std::strcmp(name, "tohost") == 0) {
+    const char* name_ptr = reinterpret_cast<const char*>(image.data() + name_off);
+    const std::string_view name(name_ptr, strnlen(name_ptr, image.size() - name_off));
+    if (name == "tohost") {
       symbols.tohost = sym.st_value;
-    } else if (std::strcmp(name, "fromhost") == 0) {
+    } else if (name == "fromhost") {
       symbols.fromhost = sym.st_value;
-    } else if (std::strcmp(name, "begin_signature") == 0) {
+    } else if (name == "begin_signature") {
       symbols.begin_signature = sym.st_value;
-    } else if (std::strcmp(name, "end_signature") == 0) {
+    } else if (name == "end_signature") {
       symbols.end_signature = sym.st_value;
     }
   }
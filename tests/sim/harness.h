@@ -0,0 +1,1113 @@
+#pragma once
+
+// Shared driver for the Verilator simulation harnesses.
+//
+// Each sim binary supplies a port-adapter trait describing how its top-level
+// model is wired to Memory, then instantiates runHarness<Ports>(). The trait
+// is a plain struct of static functions so the per-cycle loop is specialized
+// and inlined for each core:
+//
+//   struct Ports {
+//     using Model = VTop;
+//     static constexpr const char* kName;      // used in diagnostics
+//     static constexpr int kNumThreads;        // > 1 enables --thread-mask
+//     struct State { ... };                    // harness-side core state
+//
+//     template <typename Mem>                  // Memory, CoreMemory in soc_sim or
+//                                              // TimedMemory under --perf-report
+//     static void drive(Model&, State&, Mem&, const Options&);      // before eval
+//     static void capture(Model&, State&);                          // after eval
+//     static void endResetCycle(State&);
+//     static void endCycle(State&);
+//     static MemWrite memWrite(const Model&);
+//     static void logResetCycle(std::ostream&, const Model&, const State&);
+//     static void logCycle(std::ostream&, const Model&, const State&, uint64_t cycle,
+//                          const MemWrite&, const Options&, const ElfSymbols&);
+//     static void traceCycle(TraceWriter&, const Model&, const State&, uint64_t cycle,
+//                            const MemWrite&);
+//     static uint64_t idleSample(const Model&, const State&);     // see idle_detector.h
+//     static bool fetchesPc(const Model&, const State&, uint32_t pc);  // --wave-start pc:
+//     static constexpr bool kObservesRetire;   // false if countCycle cannot see writeback
+//     static constexpr bool kHasFetchBuffer;   // true if countCycle fills the fetch_* counters
+//     static void countCycle(PerfCounters&, const Model&, const State&, const MemWrite&);
+//     static void memAccesses(CycleAccesses&, const Model&, const State&,  // see mem_timing.h
+//                             const MemWrite&);
+//     static constexpr uint32_t kCommitKinds;  // CommitKind bits commits() reports
+//     static void commits(CoSim&, const Model&, const State&,      // see cosim.h
+//                         const MemWrite&);
+//     static constexpr bool kHasICache;        // true enables --icache-stats; then also:
+//     static constexpr ICacheGeometry kICache; //   geometry of the RTL cache
+//     static ICacheEvent icacheEvent(const Model&);
+//   };
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "cosim.h"
+#include "elf_loader.h"
+#include "host_profile.h"
+#include "icache_model.h"
+#include "idle_detector.h"
+#include "mem_timing.h"
+#include "memory.h"
+#include "perf_counters.h"
+#include "trace.h"
+#include "verilated.h"
+
+// Build profile baked in by sim_build_profile.sh.
+#ifndef SIM_BUILD_PROFILE
+#define SIM_BUILD_PROFILE unknown
+#endif
+#ifndef SIM_BUILD_THREADS
+#define SIM_BUILD_THREADS 1
+#endif
+#ifndef SIM_BUILD_TRACE
+#define SIM_BUILD_TRACE 0
+#endif
+#ifndef SIM_BUILD_SAVABLE
+#define SIM_BUILD_SAVABLE 0
+#endif
+#ifndef SIM_BUILD_COVERAGE
+#define SIM_BUILD_COVERAGE 0
+#endif
+#if SIM_BUILD_TRACE
+#include "verilated_fst_c.h"
+#endif
+#if SIM_BUILD_SAVABLE
+#include "verilated_save.h"
+#endif
+#if SIM_BUILD_COVERAGE
+#include "verilated_cov.h"
+#endif
+#define HARNESS_STRINGIFY_IMPL(x) #x
+#define HARNESS_STRINGIFY(x) HARNESS_STRINGIFY_IMPL(x)
+
+namespace harness {
+
+constexpr const char* kBuildProfile = HARNESS_STRINGIFY(SIM_BUILD_PROFILE);
+constexpr int kBuildThreads = SIM_BUILD_THREADS;
+constexpr bool kBuildTrace = SIM_BUILD_TRACE != 0;
+constexpr bool kBuildSavable = SIM_BUILD_SAVABLE != 0;
+constexpr bool kBuildCoverage = SIM_BUILD_COVERAGE != 0;
+
+constexpr uint32_t kMemBase = 0x80000000u;
+constexpr uint32_t kMemSize = 16 * 1024 * 1024;
+constexpr int kResetCycles = 5;
+constexpr uint32_t kNopInstr = 0x00000013;
+
+constexpr char kCheckpointMagic[8] = {'K', 'N', 'Y', 'C', 'K', 'P', 'T', '\0'};
+constexpr uint32_t kCheckpointVersion = 1;
+
+struct Options {
+  std::string elf;
+  std::string signature;
+  std::string batch;  // list of "<elf> <signature> [<trace>]" lines, "-" for stdin
+  std::string log;
+  std::string trace;
+  bool trace_async = false;
+  uint64_t max_cycles = 1'000'000;
+  uint64_t idle_window = 0;  // cycles per steady-state detection window; 0 disables
+  bool idle_stop = false;    // end the run on a spin instead of skipping to max_cycles
+  std::string save_checkpoint;  // written once save_checkpoint_cycle cycles have run
+  uint64_t save_checkpoint_cycle = 0;
+  std::string restore_checkpoint;  // replaces ELF load and reset
+  std::string perf_json;
+  uint64_t perf_interval = 0;  // cycles between counter snapshots; 0 records only the total
+  std::string perf_report;  // host profile JSON; "-" only prints the summary
+  std::string icache_stats;
+  ICacheGeometry icache_geometry;  // overrides Ports::kICache when cache_bytes != 0
+  std::string mem_config;  // region timing; adds timed= to the summary line
+  std::string mem_stats;  // per-region breakdown, needs mem_config
+  bool cosim = false;  // check every commit against the ISS
+  std::string wave;  // FST of the cycles in the trigger window
+  uint64_t wave_start_cycle = 0;
+  bool wave_start_on_pc = false;  // trigger on the first fetch of wave_start_pc instead
+  uint32_t wave_start_pc = 0;
+  uint64_t wave_len = 10'000;
+  std::string coverage;  // Verilator coverage of each program, rewritten after every run
+  uint32_t thread_mask = 0x1;  // bit per thread; default only thread 0 enabled
+  bool trace_pc = false;
+  bool build_info = false;
+};
+
+// Data-side store observed on the DUT ports after the rising edge.
+struct MemWrite {
+  bool valid = false;
+  uint32_t addr = 0;
+  uint32_t data = 0;
+  uint32_t mask = 0;
+};
+
+// Optional per-cycle work, selected once per run. The log and trace bits
+// pick the specialization of the cycle loop; the other features share one
+// more specialization per combination of those, which tests them at run
+// time, so the cycle loop exists in eight copies however many features
+// there are.
+enum Feature : uint32_t {
+  kFeatureLog = 1u << 0,
+  kFeatureTrace = 1u << 1,
+  kFeatureIdle = 1u << 2,
+  kFeaturePerf = 1u << 3,
+  kFeatureICache = 1u << 4,
+  kFeatureMemTiming = 1u << 5,
+  kFeatureCosim = 1u << 6,
+  kFeatureHostProfile = 1u << 7,
+  kFeatureWave = 1u << 8,  // only in models built with tracing
+  kSpecializedFeatures = kFeatureLog | kFeatureTrace,
+};
+
+enum ExitCode : int {
+  kExitPass = 0,
+  kExitSetupError = 1,
+  kExitMemoryError = 2,
+  kExitTimeout = 3,
+  kExitSignatureError = 4,
+  kExitTestFailed = 5,
+  kExitIdle = 6,  // --idle-action stop: spinning without reaching tohost
+  kExitCosimMismatch = 7,  // --cosim: the DUT and the ISS disagree
+};
+
+template <typename Ports>
+Options parseArgs(int argc, char** argv) {
+  constexpr bool kThreaded = Ports::kNumThreads > 1;
+  Options opts;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg(argv[i]);
+    if (!arg.empty() && arg[0] == '+') {
+      continue;  // +verilator+... plusargs are consumed by Verilated::commandArgs
+    }
+    if (arg == "--build-info") {
+      opts.build_info = true;
+    } else if (arg == "--elf" && i + 1 < argc) {
+      opts.elf = argv[++i];
+    } else if (arg == "--signature" && i + 1 < argc) {
+      opts.signature = argv[++i];
+    } else if (arg == "--batch" && i + 1 < argc) {
+      opts.batch = argv[++i];
+    } else if (arg == "--log" && i + 1 < argc) {
+      opts.log = argv[++i];
+    } else if (arg == "--trace" && i + 1 < argc) {
+      opts.trace = argv[++i];
+    } else if (arg == "--trace-async") {
+      opts.trace_async = true;
+    } else if (arg == "--max-cycles" && i + 1 < argc) {
+      opts.max_cycles = std::stoull(argv[++i]);
+    } else if (arg == "--idle-window" && i + 1 < argc) {
+      opts.idle_window = std::stoull(argv[++i]);
+    } else if (arg == "--idle-action" && i + 1 < argc) {
+      const std::string action(argv[++i]);
+      if (action != "skip" && action != "stop") {
+        throw std::invalid_argument("--idle-action must be skip or stop, got " + action);
+      }
+      opts.idle_stop = action == "stop";
+    } else if (arg == "--save-checkpoint" && i + 2 < argc) {
+      opts.save_checkpoint_cycle = std::stoull(argv[++i]);
+      opts.save_checkpoint = argv[++i];
+    } else if (arg == "--restore-checkpoint" && i + 1 < argc) {
+      opts.restore_checkpoint = argv[++i];
+    } else if (arg == "--perf-json" && i + 1 < argc) {
+      opts.perf_json = argv[++i];
+    } else if (arg == "--perf-interval" && i + 1 < argc) {
+      opts.perf_interval = std::stoull(argv[++i]);
+    } else if (arg == "--perf-report" && i + 1 < argc) {
+      opts.perf_report = argv[++i];
+    } else if (Ports::kHasICache && arg == "--icache-stats" && i + 1 < argc) {
+      opts.icache_stats = argv[++i];
+    } else if (Ports::kHasICache && arg == "--icache-geometry" && i + 1 < argc) {
+      opts.icache_geometry = parseICacheGeometry(argv[++i]);
+    } else if (arg == "--mem-config" && i + 1 < argc) {
+      opts.mem_config = argv[++i];
+    } else if (arg == "--mem-stats" && i + 1 < argc) {
+      opts.mem_stats = argv[++i];
+    } else if (arg == "--cosim") {
+      opts.cosim = true;
+    } else if (arg == "--wave" && i + 1 < argc) {
+      opts.wave = argv[++i];
+    } else if (arg == "--wave-start" && i + 1 < argc) {
+      const std::string start(argv[++i]);
+      opts.wave_start_on_pc = start.compare(0, 3, "pc:") == 0;
+      if (opts.wave_start_on_pc) {
+        opts.wave_start_pc = static_cast<uint32_t>(std::stoul(start.substr(3), nullptr, 0));
+      } else {
+        opts.wave_start_cycle = std::stoull(start);
+      }
+    } else if (arg == "--wave-len" && i + 1 < argc) {
+      opts.wave_len = std::stoull(argv[++i]);
+    } else if (arg == "--coverage" && i + 1 < argc) {
+      opts.coverage = argv[++i];
+    } else if (kThreaded && arg == "--thread-mask" && i + 1 < argc) {
+      opts.thread_mask = static_cast<uint32_t>(std::stoul(argv[++i], nullptr, 0));
+    } else if (kThreaded && (arg == "--trace-pc" || arg == "--trace-stage")) {
+      opts.trace_pc = true;
+    } else {
+      throw std::invalid_argument("unknown or incomplete argument: " + arg);
+    }
+  }
+  const bool checkpoints = !opts.save_checkpoint.empty() || !opts.restore_checkpoint.empty();
+  if (checkpoints && !kBuildSavable) {
+    throw std::invalid_argument("checkpoints need a model built with --savable");
+  }
+  if (checkpoints && !opts.batch.empty()) {
+    throw std::invalid_argument("checkpoints are not supported with --batch");
+  }
+  if (!opts.perf_json.empty() && !opts.batch.empty()) {
+    throw std::invalid_argument("--perf-json is not supported with --batch");
+  }
+  if (!opts.perf_report.empty() && !opts.batch.empty()) {
+    throw std::invalid_argument("--perf-report is not supported with --batch");
+  }
+  if (!opts.icache_stats.empty() && !opts.batch.empty()) {
+    throw std::invalid_argument("--icache-stats is not supported with --batch");
+  }
+  if (!opts.mem_stats.empty() && opts.mem_config.empty()) {
+    throw std::invalid_argument("--mem-stats needs --mem-config");
+  }
+  if (!opts.mem_stats.empty() && !opts.batch.empty()) {
+    throw std::invalid_argument("--mem-stats is not supported with --batch");
+  }
+  if (!opts.wave.empty() && !kBuildTrace) {
+    throw std::invalid_argument("--wave needs a model built with tracing (the debug profile)");
+  }
+  if (!opts.wave.empty() && !opts.batch.empty()) {
+    throw std::invalid_argument("--wave is not supported with --batch");
+  }
+  if (opts.wave_len == 0) {
+    throw std::invalid_argument("--wave-len must be at least 1");
+  }
+  if (!opts.coverage.empty() && !kBuildCoverage) {
+    throw std::invalid_argument("--coverage needs a model built with coverage (the cov profile)");
+  }
+  if (opts.cosim && !opts.restore_checkpoint.empty()) {
+    throw std::invalid_argument("--cosim needs the ELF: not supported with --restore-checkpoint");
+  }
+  const bool have_program = !opts.elf.empty() || !opts.restore_checkpoint.empty();
+  if (!opts.build_info && opts.batch.empty() && (!have_program || opts.signature.empty())) {
+    throw std::invalid_argument(
+        "--elf (or --restore-checkpoint) and --signature (or --batch) are required");
+  }
+  return opts;
+}
+
+template <typename Ports>
+class Harness {
+ public:
+  using Model = typename Ports::Model;
+  using State = typename Ports::State;
+  static_assert(Ports::kNumThreads <= kPerfMaxThreads, "perf counters track at most 8 threads");
+
+  explicit Harness(const Options& options) : options_(options), memory_(kMemBase, kMemSize) {
+    if (!options_.log.empty()) {
+      log_.open(options_.log);
+    }
+    if (!options_.mem_config.empty()) {
+      mem_regions_ = loadMemConfig(options_.mem_config);
+    }
+    if (options_.cosim) {
+      cosim_ = std::make_unique<CoSim>(kMemBase, kMemSize, Ports::kNumThreads,
+                                       Ports::kCommitKinds, options_.thread_mask);
+    }
+  }
+
+  // Starts a new program on the same model: clears memory and harness state,
+  // then loads the ELF. State not covered by the DUT reset (e.g. register
+  // file contents) carries over from the previous program.
+  void load(const std::string& elf) {
+    memory_.clear();
+    symbols_ = ElfSymbols{};
+    state_ = State{};
+    tohost_value_ = 0;
+    cycles_ = 0;
+    skipped_cycles_ = 0;
+    loadElfIntoMemory(elf, memory_, symbols_);
+    if (cosim_) {
+      cosim_->load(elf, kMemBase);
+    }
+  }
+
+  // Restores a checkpoint in place of load() and reset(); run() then carries
+  // on from the saved cycle.
+  void restoreCheckpoint(const std::string& path) {
+#if SIM_BUILD_SAVABLE
+    VerilatedRestore is;
+    is.open(path.c_str());
+    if (!is.isOpen()) {
+      throw std::runtime_error("cannot open checkpoint " + path);
+    }
+    char magic[sizeof(kCheckpointMagic)];
+    uint32_t version = 0;
+    std::string core;
+    is.read(magic, sizeof(magic));
+    is >> version >> core;
+    if (std::string(magic, sizeof(magic)) != std::string(kCheckpointMagic, sizeof(magic)) ||
+        version != kCheckpointVersion || core != Ports::kName) {
+      throw std::runtime_error(path + " is not a " + Ports::kName + " checkpoint");
+    }
+
+    memory_.clear();
+    skipped_cycles_ = 0;
+    is >> cycles_ >> tohost_value_;
+    is.read(&symbols_, sizeof(symbols_));
+    is.read(&state_, sizeof(state_));
+
+    uint64_t pages = 0;
+    is >> pages;
+    std::unique_ptr<uint8_t[]> page(new uint8_t[Memory::kPageSize]);
+    for (uint64_t i = 0; i < pages; ++i) {
+      uint32_t addr = 0;
+      is >> addr;
+      is.read(page.get(), Memory::kPageSize);
+      memory_.writeBlock(addr, page.get(), Memory::kPageSize);
+    }
+    uint64_t bytes = 0;
+    is >> bytes;
+    for (uint64_t i = 0; i < bytes; ++i) {
+      uint32_t addr = 0;
+      uint8_t value = 0;
+      is >> addr >> value;
+      memory_.write8(addr, value);
+    }
+
+    is >> dut_;
+    is.close();
+#else
+    throw std::runtime_error("cannot restore " + path + ": model not built with --savable");
+#endif
+  }
+
+  // Routes the binary trace of subsequent runs to path; empty disables it.
+  void setTrace(const std::string& path) {
+    trace_.reset();
+    if (!path.empty()) {
+      trace_ = std::make_unique<TraceWriter>(path, Ports::kName, Ports::kNumThreads,
+                                             options_.trace_async);
+    }
+  }
+
+  void reset() {
+    dut_.reset = 1;
+    for (int cycle = 0; cycle < kResetCycles; ++cycle) {
+      halfCycle(0);
+      if (log_.is_open()) {
+        Ports::logResetCycle(log_, dut_, state_);
+      }
+      halfCycle(1);
+      Ports::endResetCycle(state_);
+    }
+    dut_.reset = 0;
+  }
+
+  // Runs until tohost is written or max_cycles expires. Returns kExitPass on
+  // reaching tohost; the tohost value itself is available via tohostValue().
+  // With --idle-window, a detected spin either skips the remaining cycles
+  // (same result as running them, kExitTimeout) or stops with kExitIdle. The
+  // skip waits while a --wave window is open or still due, so that its cycles
+  // are simulated and dumped.
+  // Cycles are counted from reset, including any restored from a checkpoint.
+  int run() {
+    uint32_t features = 0;
+    if (log_.is_open()) {
+      features |= kFeatureLog;
+    }
+    if (trace_) {
+      features |= kFeatureTrace;
+    }
+    if (options_.idle_window != 0) {
+      features |= kFeatureIdle;
+      idle_.reset(options_.idle_window);
+    }
+    if (!options_.perf_json.empty()) {
+      features |= kFeaturePerf;
+      perf_ = PerfCounters{};
+      perf_intervals_.clear();
+      perf_start_cycle_ = cycles_;
+      if (options_.perf_interval != 0) {
+        perf_stream_.open(options_.perf_json + ".intervals", std::ios::trunc);
+        if (!perf_stream_.is_open()) {
+          std::cerr << "Perf report failed: cannot open " << options_.perf_json << ".intervals"
+                    << std::endl;
+          return kExitSetupError;
+        }
+      }
+    }
+    if constexpr (Ports::kHasICache) {
+      if (!options_.icache_stats.empty()) {
+        features |= kFeatureICache;
+        // A sweep variant elaborated with another ICacheSimpleConfig passes
+        // its geometry with --icache-geometry.
+        const ICacheGeometry& geometry =
+            options_.icache_geometry.cache_bytes != 0 ? options_.icache_geometry : Ports::kICache;
+        icache_ = std::make_unique<ICacheProfile>(geometry);
+      }
+    }
+    if (!options_.mem_config.empty()) {
+      features |= kFeatureMemTiming;
+      mem_timing_ = std::make_unique<MemTiming>(mem_regions_, Ports::kNumThreads);
+    }
+    if (cosim_) {
+      features |= kFeatureCosim;
+    }
+    if (!options_.wave.empty()) {
+      features |= kFeatureWave;
+      wave_state_ = kWaveArmed;
+      wave_pc_seen_ = false;
+    }
+    if (!options_.perf_report.empty()) {
+      features |= kFeatureHostProfile;
+      host_profile_.start(cycles_);
+    }
+    int status = kSegmentDone;
+    bool saved = false;
+    const uint64_t save_at = options_.save_checkpoint_cycle;
+    if (!options_.save_checkpoint.empty() && save_at >= cycles_ && save_at < options_.max_cycles) {
+      status = dispatch(features, save_at);
+      if (status == kSegmentDone) {
+        saved = saveCheckpoint(options_.save_checkpoint);
+        if (!saved) {
+          status = kExitSetupError;
+        }
+      }
+    }
+    if (status == kSegmentDone) {
+      status = dispatch(features, options_.max_cycles);
+    }
+    if (!options_.perf_report.empty()) {
+      host_profile_.stop(cycles_ - skipped_cycles_);
+    }
+    if (!options_.save_checkpoint.empty() && !saved && status != kExitSetupError) {
+      std::cerr << "Checkpoint not written: run ended at cycle " << cycles_ << " before cycle "
+                << save_at << std::endl;
+    }
+    if (trace_ && !flushTrace()) {
+      status = status == kExitPass ? kExitSetupError : status;
+    }
+    if (wave_state_ == kWaveOn) {
+      closeWave();
+    } else if (wave_state_ == kWaveArmed) {
+      std::cerr << "Waves not written: run ended at cycle " << cycles_ << " before the trigger"
+                << std::endl;
+    }
+    if (mem_timing_ && mem_timing_->badThreadAccesses() != 0) {
+      std::cerr << "Memory timing: " << mem_timing_->badThreadAccesses()
+                << " access(es) named no thread of the core and were not timed" << std::endl;
+    }
+    if (!options_.perf_json.empty() && !writePerf()) {
+      status = status == kExitPass ? kExitSetupError : status;
+    }
+    if (!options_.perf_report.empty() && !writeHostProfile()) {
+      status = status == kExitPass ? kExitSetupError : status;
+    }
+    if (icache_ && !writeICacheStats()) {
+      status = status == kExitPass ? kExitSetupError : status;
+    }
+    if (!options_.mem_stats.empty() && !writeMemStats()) {
+      status = status == kExitPass ? kExitSetupError : status;
+    }
+    return status;
+  }
+
+  void dumpSignature(const std::string& path) const {
+    memory_.dumpSignature(symbols_.begin_signature, symbols_.end_signature, path);
+  }
+
+  uint32_t tohostValue() const { return tohost_value_; }
+  uint64_t cycles() const { return cycles_; }
+  // Cycles not simulated because the core was found spinning.
+  uint64_t skippedCycles() const { return skipped_cycles_; }
+  // With --mem-config, cycles() plus the stalls of the memory timing model
+  // (cycles restored from a checkpoint count as unstalled); 0 without it.
+  uint64_t timedCycles() const { return mem_timing_ ? cycles_ + mem_timing_->stallCycles() : 0; }
+  // With --coverage, writes the counts gathered since the last call
+  // (Verilator's coverage.dat format) and zeroes them, so that in batch mode
+  // the file holds the points of the program that just ran.
+  void writeCoverage() {
+#if SIM_BUILD_COVERAGE
+    if (!options_.coverage.empty()) {
+      VerilatedCovContext* coverage = Verilated::threadContextp()->coveragep();
+      coverage->write(options_.coverage.c_str());
+      coverage->zero();
+    }
+#endif
+  }
+
+  // Commit events --cosim has matched against the ISS.
+  uint64_t cosimChecked() const { return cosim_ ? cosim_->checked() : 0; }
+
+ private:
+  inline void halfCycle(uint8_t clock) {
+    dut_.clock = clock;
+    Ports::drive(dut_, state_, memory_, options_);
+    dut_.eval();
+    Ports::capture(dut_, state_);
+  }
+
+  // halfCycle with drive, its memory reads, eval and capture each charged to
+  // the host profile; mark is the tick count the first of them starts at.
+  void timedHalfCycle(uint8_t clock, uint64_t& mark) {
+    dut_.clock = clock;
+    TimedMemory<Memory> memory(memory_);
+    Ports::drive(dut_, state_, memory, options_);
+    const uint64_t driven = hostTicks();
+    host_profile_.add(kHostDrive, driven - mark - memory.ticks());
+    host_profile_.add(kHostMemory, memory.ticks());
+    mark = driven;
+    dut_.eval();
+    lap(kHostEval, mark);
+    Ports::capture(dut_, state_);
+    lap(kHostCapture, mark);
+  }
+
+  // Charges the time since mark to section and restarts it.
+  inline void lap(HostSection section, uint64_t& mark) {
+    const uint64_t now = hostTicks();
+    host_profile_.add(section, now - mark);
+    mark = now;
+  }
+
+  int dispatch(uint32_t features, uint64_t limit) {
+    features_ = features;
+    if ((features & ~kSpecializedFeatures) != 0) {
+      return dispatchSpecialized<true>(features & kSpecializedFeatures, limit);
+    }
+    return dispatchSpecialized<false>(features, limit);
+  }
+
+  template <bool kRare, uint32_t kFeatures = 0>
+  int dispatchSpecialized(uint32_t specialized, uint64_t limit) {
+    if constexpr (kFeatures == kSpecializedFeatures) {
+      return runCycles<kFeatures, kRare>(limit);
+    } else {
+      return specialized == kFeatures
+                 ? runCycles<kFeatures, kRare>(limit)
+                 : dispatchSpecialized<kRare, kFeatures + 1>(specialized, limit);
+    }
+  }
+
+  // True if feature is on for this run; constant false in the
+  // specializations that run none of the unspecialized features.
+  template <bool kRare>
+  inline bool enabled(Feature feature) const {
+    return kRare && (features_ & feature) != 0;
+  }
+
+  // Simulates from cycles_ up to limit. Stopping short of max_cycles returns
+  // kSegmentDone so run() can checkpoint and carry on. kFeatures holds the
+  // specialized features; with kRare false none of the others is enabled.
+  template <uint32_t kFeatures, bool kRare>
+  int runCycles(uint64_t limit) {
+    const bool profile = enabled<kRare>(kFeatureHostProfile);
+    const bool wave = kBuildTrace && enabled<kRare>(kFeatureWave);
+    for (uint64_t cycle = cycles_; cycle < limit; ++cycle) {
+      const bool timed = profile && HostProfile::sampled(cycle);
+      uint64_t mark = timed ? hostTicks() : 0;
+      const uint64_t cycle_start = mark;
+      // Charges the time since the last lap to section on timed cycles.
+      auto lapIfTimed = [&](HostSection section) {
+        if constexpr (kRare) {
+          if (timed) {
+            lap(section, mark);
+          }
+        }
+      };
+      auto step = [&](uint8_t clock) {
+        if constexpr (kRare) {
+          if (timed) {
+            timedHalfCycle(clock, mark);
+            return;
+          }
+        }
+        halfCycle(clock);
+      };
+
+      if (wave) {
+        waveBeginCycle(cycle);
+        lapIfTimed(kHostWave);
+        step(0);
+        waveDump(2 * cycle);
+        lapIfTimed(kHostWave);
+        step(1);
+        waveDump(2 * cycle + 1);
+        lapIfTimed(kHostWave);
+      } else {
+        step(0);
+        step(1);
+      }
+      Ports::endCycle(state_);
+
+      const MemWrite write = Ports::memWrite(dut_);
+      lapIfTimed(kHostCapture);
+      bool completed = false;
+      if (write.valid) {
+        try {
+          memory_.writeMasked(write.addr, write.data, write.mask);
+        } catch (const std::exception& e) {
+          std::cerr << "Memory write failed at 0x" << std::hex << write.addr << ": " << e.what()
+                    << std::dec << std::endl;
+          return kExitMemoryError;
+        }
+        if (write.addr == symbols_.tohost && write.data != 0) {
+          tohost_value_ = write.data;
+          completed = true;
+        }
+        lapIfTimed(kHostMemory);
+      }
+
+      if constexpr ((kFeatures & kFeatureLog) != 0) {
+        Ports::logCycle(log_, dut_, state_, cycle, write, options_, symbols_);
+        lapIfTimed(kHostLog);
+      }
+      if constexpr ((kFeatures & kFeatureTrace) != 0) {
+        Ports::traceCycle(*trace_, dut_, state_, cycle, write);
+        lapIfTimed(kHostTrace);
+      }
+      if (enabled<kRare>(kFeaturePerf)) {
+        ++perf_.cycles;
+        Ports::countCycle(perf_, dut_, state_, write);
+        if (options_.perf_interval != 0 && perf_.cycles % options_.perf_interval == 0) {
+          recordPerfInterval();
+        }
+        lapIfTimed(kHostStats);
+      }
+      if constexpr (Ports::kHasICache) {
+        if (enabled<kRare>(kFeatureICache)) {
+          icache_->observe(Ports::icacheEvent(dut_));
+          lapIfTimed(kHostStats);
+        }
+      }
+      if (enabled<kRare>(kFeatureMemTiming)) {
+        CycleAccesses accesses;
+        Ports::memAccesses(accesses, dut_, state_, write);
+        mem_timing_->observe(accesses);
+        lapIfTimed(kHostStats);
+      }
+      if (wave) {
+        waveEndCycle();
+        lapIfTimed(kHostWave);
+      }
+      if (enabled<kRare>(kFeatureCosim)) {
+        Ports::commits(*cosim_, dut_, state_, write);
+        if (cosim_->failed()) {
+          std::cerr << "Co-simulation mismatch at cycle " << cycle << ", " << cosim_->mismatch()
+                    << std::endl;
+          cycles_ = cycle + 1;
+          return kExitCosimMismatch;
+        }
+        lapIfTimed(kHostCosim);
+      }
+
+      if (completed) {
+        cycles_ = cycle + 1;
+        return kExitPass;
+      }
+      if (enabled<kRare>(kFeatureIdle)) {
+        if (idle_.sample(Ports::idleSample(dut_, state_), write.valid) &&
+            (options_.idle_stop || !wavePending(cycle + 1))) {
+          return endIdle(cycle + 1);
+        }
+      }
+      if constexpr (kRare) {
+        if (timed) {
+          host_profile_.addCycle(hostTicks() - cycle_start);
+        }
+      }
+    }
+    cycles_ = limit;
+    return limit == options_.max_cycles ? kExitTimeout : kSegmentDone;
+  }
+
+  // --wave: the window opens at the start cycle, or on the cycle after the
+  // first fetch of the start PC, and closes wave_len cycles later. The model
+  // is attached to the FST writer only inside the window, and the writer
+  // compresses on Verilator's trace threads.
+  void waveBeginCycle(uint64_t cycle) {
+    const bool triggered =
+        options_.wave_start_on_pc ? wave_pc_seen_ : cycle >= options_.wave_start_cycle;
+    if (wave_state_ == kWaveArmed && triggered) {
+      openWave(cycle);
+    }
+  }
+
+  void waveEndCycle() {
+    if (wave_state_ == kWaveOn) {
+      if (++wave_cycles_ == options_.wave_len) {
+        closeWave();
+      }
+    } else if (wave_state_ == kWaveArmed && options_.wave_start_on_pc &&
+               Ports::fetchesPc(dut_, state_, options_.wave_start_pc)) {
+      wave_pc_seen_ = true;
+    }
+  }
+
+  void waveDump(uint64_t time) {
+#if SIM_BUILD_TRACE
+    if (wave_state_ == kWaveOn) {
+      wave_->dump(time);
+    }
+#else
+    (void)time;
+#endif
+  }
+
+  void openWave(uint64_t cycle) {
+    wave_state_ = kWaveOn;
+    wave_first_cycle_ = cycle;
+    wave_cycles_ = 0;
+#if SIM_BUILD_TRACE
+    wave_ = std::make_unique<VerilatedFstC>();
+    dut_.trace(wave_.get(), 99);
+    wave_->open(options_.wave.c_str());
+#endif
+  }
+
+  void closeWave() {
+    wave_state_ = kWaveDone;
+#if SIM_BUILD_TRACE
+    wave_->close();
+    wave_.reset();
+#endif
+    std::cerr << "Waves written: " << wave_cycles_ << " cycles from cycle " << wave_first_cycle_
+              << " to " << options_.wave << std::endl;
+  }
+
+  // True while the --wave window is open or will open at a cycle from next
+  // on. A spinning core that has not fetched the start PC never will, so a
+  // PC trigger does not hold back the idle skip.
+  bool wavePending(uint64_t next) const {
+    return wave_state_ == kWaveOn ||
+           (wave_state_ == kWaveArmed && !options_.wave_start_on_pc &&
+            std::max(options_.wave_start_cycle, next) < options_.max_cycles);
+  }
+
+  // Nothing the core reads can change while it stores nothing, so the rest
+  // of the run would repeat the same loop until max_cycles.
+  int endIdle(uint64_t executed) {
+    skipped_cycles_ = options_.max_cycles - executed;
+    if (options_.idle_stop) {
+      cycles_ = executed;
+      return kExitIdle;
+    }
+    cycles_ = options_.max_cycles;
+    return kExitTimeout;
+  }
+
+  PerfReport perfReport() const {
+    PerfReport report;
+    report.core = Ports::kName;
+    report.num_threads = Ports::kNumThreads;
+    report.thread_mask = Ports::kNumThreads > 1 ? options_.thread_mask : 0x1;
+    report.observes_retire = Ports::kObservesRetire;
+    report.has_fetch_buffer = Ports::kHasFetchBuffer;
+    report.start_cycle = perf_start_cycle_;
+    return report;
+  }
+
+  // Appends the interval that ends now to <perf-json>.intervals. A failed
+  // write leaves the stream failed, and writePerf reports it at exit.
+  void recordPerfInterval() {
+    const PerfCounters previous = perf_intervals_.empty() ? PerfCounters{} : perf_intervals_.back();
+    perf_intervals_.push_back(perf_);
+    writePerfInterval(perf_stream_, perfReport(), previous, perf_);
+    perf_stream_ << '\n' << std::flush;
+  }
+
+  bool writePerf() {
+    bool ok = true;
+    if (perf_stream_.is_open()) {
+      perf_stream_.close();
+      if (!perf_stream_) {
+        std::cerr << "Perf report failed: could not write " << options_.perf_json << ".intervals"
+                  << std::endl;
+        ok = false;
+      }
+    }
+    try {
+      writePerfJson(options_.perf_json, perfReport(), perf_, perf_intervals_);
+    } catch (const std::exception& e) {
+      std::cerr << "Perf report failed: " << e.what() << std::endl;
+      return false;
+    }
+    return ok;
+  }
+
+  // Prints the host profile on stderr and writes its JSON.
+  bool writeHostProfile() {
+    host_profile_.print(std::cerr, Ports::kName);
+    if (options_.perf_report == "-") {
+      return true;
+    }
+    try {
+      host_profile_.writeJson(options_.perf_report, Ports::kName);
+    } catch (const std::exception& e) {
+      std::cerr << "Host profile failed: " << e.what() << std::endl;
+      return false;
+    }
+    return true;
+  }
+
+  bool writeICacheStats() {
+    try {
+      icache_->writeJson(options_.icache_stats, Ports::kName);
+    } catch (const std::exception& e) {
+      std::cerr << "I-cache stats failed: " << e.what() << std::endl;
+      return false;
+    }
+    return true;
+  }
+
+  bool flushTrace() {
+    try {
+      trace_->flush();
+    } catch (const std::exception& e) {
+      std::cerr << "Trace failed: " << e.what() << std::endl;
+      return false;
+    }
+    return true;
+  }
+
+  bool writeMemStats() {
+    try {
+      mem_timing_->writeJson(options_.mem_stats, Ports::kName);
+    } catch (const std::exception& e) {
+      std::cerr << "Memory stats failed: " << e.what() << std::endl;
+      return false;
+    }
+    return true;
+  }
+
+  // A checkpoint holds the harness state, every allocated memory page and the
+  // Verilated model, all written at a cycle boundary. The harness fields are
+  // stored as raw bytes, so a checkpoint only restores into the binary (and
+  // model) that wrote it.
+  static_assert(std::is_trivially_copyable<State>::value, "checkpoints copy State bytes");
+  static_assert(std::is_trivially_copyable<ElfSymbols>::value, "checkpoints copy ElfSymbols bytes");
+
+  bool saveCheckpoint(const std::string& path) {
+#if SIM_BUILD_SAVABLE
+    VerilatedSave os;
+    os.open(path.c_str());
+    if (!os.isOpen()) {
+      std::cerr << "Checkpoint save failed: cannot open " << path << std::endl;
+      return false;
+    }
+    os.write(kCheckpointMagic, sizeof(kCheckpointMagic));
+    // VerilatedSerialize's operators take non-const lvalue references.
+    uint32_t version = kCheckpointVersion;
+    std::string core = Ports::kName;
+    os << version << core;
+    os << cycles_ << tohost_value_;
+    os.write(&symbols_, sizeof(symbols_));
+    os.write(&state_, sizeof(state_));
+
+    uint64_t pages = 0;
+    uint64_t bytes = 0;
+    memory_.forEachAllocated([&](uint32_t, const uint8_t*) { ++pages; },
+                             [&](uint32_t, uint8_t) { ++bytes; });
+    os << pages;
+    memory_.forEachAllocated(
+        [&](uint32_t addr, const uint8_t* data) {
+          os << addr;
+          os.write(data, Memory::kPageSize);
+        },
+        [](uint32_t, uint8_t) {});
+    os << bytes;
+    memory_.forEachAllocated([](uint32_t, const uint8_t*) {},
+                             [&](uint32_t addr, uint8_t value) { os << addr << value; });
+
+    os << dut_;
+    os.close();
+    std::cerr << "Checkpoint written at cycle " << cycles_ << ": " << path << std::endl;
+    return true;
+#else
+    (void)path;
+    return false;
+#endif
+  }
+
+ private:
+  // run() status for a segment that stopped at its limit before max_cycles.
+  static constexpr int kSegmentDone = -1;
+
+  enum WaveState : uint8_t { kWaveIdle, kWaveArmed, kWaveOn, kWaveDone };
+
+  Options options_;
+  Memory memory_;
+  ElfSymbols symbols_;
+  Model dut_;
+  State state_;
+  std::ofstream log_;
+  std::unique_ptr<TraceWriter> trace_;
+  uint32_t features_ = 0;  // Feature bits of the current run
+  IdleDetector idle_;
+  PerfCounters perf_;
+  std::vector<PerfCounters> perf_intervals_;
+  std::ofstream perf_stream_;  // <perf-json>.intervals
+  uint64_t perf_start_cycle_ = 0;
+  HostProfile host_profile_;
+  std::unique_ptr<ICacheProfile> icache_;
+  std::vector<MemRegion> mem_regions_;
+  std::unique_ptr<MemTiming> mem_timing_;
+  std::unique_ptr<CoSim> cosim_;
+#if SIM_BUILD_TRACE
+  std::unique_ptr<VerilatedFstC> wave_;
+#endif
+  WaveState wave_state_ = kWaveIdle;
+  bool wave_pc_seen_ = false;
+  uint64_t wave_first_cycle_ = 0;
+  uint64_t wave_cycles_ = 0;
+  uint32_t tohost_value_ = 0;
+  uint64_t cycles_ = 0;
+  uint64_t skipped_cycles_ = 0;
+};
+
+// Loads, resets and runs one program, then writes its signature. Prints the
+// per-program summary line on stdout; the RISCOF runners parse it.
+template <typename Ports>
+int runProgram(Harness<Ports>& sim, const std::string& elf, const std::string& signature,
+               const std::string& trace, bool batch, const std::string& checkpoint = "") {
+  int status = kExitPass;
+  try {
+    sim.setTrace(trace);
+    if (checkpoint.empty()) {
+      sim.load(elf);
+    } else {
+      sim.restoreCheckpoint(checkpoint);
+    }
+  } catch (const std::exception& e) {
+    std::cerr << (checkpoint.empty() ? "ELF load failed: " : "Checkpoint restore failed: ")
+              << e.what() << std::endl;
+    status = kExitSetupError;
+  }
+
+  if (status == kExitPass) {
+    if (checkpoint.empty()) {
+      sim.reset();
+    }
+    status = sim.run();
+    sim.writeCoverage();
+  }
+  if (sim.skippedCycles() != 0) {
+    std::cerr << "Steady-state loop without stores detected; skipped " << sim.skippedCycles()
+              << " cycles" << std::endl;
+  }
+  if (status == kExitTimeout) {
+    std::cerr << "Simulation terminated: max cycles reached" << std::endl;
+  } else if (status == kExitIdle) {
+    std::cerr << "Simulation terminated: core idle before tohost" << std::endl;
+  } else if (status == kExitPass) {
+    if (sim.tohostValue() != 1) {
+      std::cerr << "Test reported failure, tohost=0x" << std::hex << sim.tohostValue() << std::dec
+                << std::endl;
+    }
+    try {
+      sim.dumpSignature(signature);
+      status = sim.tohostValue() == 1 ? kExitPass : kExitTestFailed;
+    } catch (const std::exception& e) {
+      std::cerr << "Signature dump failed: " << e.what() << std::endl;
+      status = kExitSignatureError;
+    }
+  }
+
+  std::cout << Ports::kName << ": cycles=" << sim.cycles() << " tohost=0x" << std::hex
+            << sim.tohostValue() << std::dec;
+  if (sim.skippedCycles() != 0) {
+    std::cout << " skipped=" << sim.skippedCycles();
+  }
+  if (sim.timedCycles() != 0) {
+    std::cout << " timed=" << sim.timedCycles();
+  }
+  if (sim.cosimChecked() != 0) {
+    std::cout << " cosim=" << sim.cosimChecked();
+  }
+  if (batch) {
+    std::cout << " status=" << status << " elf=" << elf;
+  }
+  std::cout << std::endl;
+  return status;
+}
+
+// Server mode: one model and one Memory serve every program in the list.
+// Lines are processed as they arrive, so a driver can stream work over stdin.
+template <typename Ports>
+int runBatch(Harness<Ports>& sim, const Options& options) {
+  std::ifstream list_file;
+  if (options.batch != "-") {
+    list_file.open(options.batch);
+    if (!list_file.is_open()) {
+      std::cerr << "Failed to open batch list: " << options.batch << std::endl;
+      return kExitSetupError;
+    }
+  }
+  std::istream& list = options.batch == "-" ? std::cin : list_file;
+
+  int overall = kExitPass;
+  std::string line;
+  while (std::getline(list, line)) {
+    std::istringstream fields(line);
+    std::string elf;
+    std::string signature;
+    std::string trace;
+    fields >> elf >> signature >> trace;
+    if (elf.empty() || elf[0] == '#') {
+      continue;
+    }
+    if (signature.empty()) {
+      std::cerr << "Batch entry missing signature path: " << line << std::endl;
+      if (overall == kExitPass) {
+        overall = kExitSetupError;
+      }
+      continue;
+    }
+    const int status = runProgram(sim, elf, signature, trace, true);
+    if (overall == kExitPass) {
+      overall = status;
+    }
+  }
+  return overall;
+}
+
+template <typename Ports>
+int runHarness(int argc, char** argv) {
+  Verilated::commandArgs(argc, argv);
+
+  Options options;
+  try {
+    options = parseArgs<Ports>(argc, argv);
+  } catch (const std::exception& e) {
+    std::cerr << "Argument error: " << e.what() << std::endl;
+    return kExitSetupError;
+  }
+  if (!options.wave.empty()) {
+    Verilated::traceEverOn(true);  // before the model is constructed
+  }
+
+  if (options.build_info) {
+    std::cout << Ports::kName << " sim: profile=" << kBuildProfile << " threads=" << kBuildThreads
+              << " trace=" << (kBuildTrace ? "on" : "off")
+              << " savable=" << (kBuildSavable ? "on" : "off")
+              << " coverage=" << (kBuildCoverage ? "on" : "off") << std::endl;
+    return kExitPass;
+  }
+
+  std::unique_ptr<Harness<Ports>> sim;
+  try {
+    sim = std::make_unique<Harness<Ports>>(options);
+  } catch (const std::exception& e) {
+    std::cerr << "Harness setup failed: " << e.what() << std::endl;
+    return kExitSetupError;
+  }
+
+  if (!options.batch.empty()) {
+    return runBatch(*sim, options);
+  }
+  return runProgram(*sim, options.elf, options.signature, options.trace, false,
+                    options.restore_checkpoint);
+}
+
+}  // namespace harness
@@ -0,0 +1,97 @@
+#include "host_profile.h"
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+constexpr const char* kSectionNames[kHostSections] = {
+    "drive", "memory", "eval", "capture", "log", "trace", "stats", "cosim", "wave",
+};
+
+}  // namespace
+
+void HostProfile::start(uint64_t cycle) {
+  *this = HostProfile{};
+  first_cycle_ = cycle;
+  start_time_ = std::chrono::steady_clock::now();
+  start_ticks_ = hostTicks();
+}
+
+void HostProfile::stop(uint64_t cycle) {
+  stop_ticks_ = hostTicks();
+  stop_time_ = std::chrono::steady_clock::now();
+  cycles_ = cycle - first_cycle_;
+}
+
+double HostProfile::seconds() const {
+  return std::chrono::duration<double>(stop_time_ - start_time_).count();
+}
+
+double HostProfile::nsPerTick() const {
+  const uint64_t ticks = stop_ticks_ - start_ticks_;
+  return ticks == 0 ? 0.0 : seconds() * 1e9 / static_cast<double>(ticks);
+}
+
+uint64_t HostProfile::loopTicks() const {
+  uint64_t accounted = 0;
+  for (uint64_t ticks : ticks_) {
+    accounted += ticks;
+  }
+  return sampled_ticks_ > accounted ? sampled_ticks_ - accounted : 0;
+}
+
+double HostProfile::nsPerCycle(uint64_t ticks) const {
+  return sampled_cycles_ == 0 ? 0.0 : ticks * nsPerTick() / sampled_cycles_;
+}
+
+void HostProfile::print(std::ostream& out, const char* core) const {
+  const double secs = seconds();
+  std::ostringstream text;
+  text << std::fixed << std::setprecision(1);
+  text << core << " host: cycles=" << cycles_ << " seconds=" << std::setprecision(3) << secs
+       << " khz=" << (secs > 0 ? cycles_ / secs / 1000 : 0.0) << " timed=" << sampled_cycles_
+       << " (1/" << kHostSampleStride << ")\n"
+       << std::setprecision(1);
+  auto row = [&](const char* name, uint64_t ticks) {
+    const double share = sampled_ticks_ == 0 ? 0.0 : 100.0 * ticks / sampled_ticks_;
+    text << "  " << std::left << std::setw(8) << name << std::right << std::setw(6) << share
+         << "%" << std::setw(9) << nsPerCycle(ticks) << " ns/cycle\n";
+  };
+  for (int s = 0; s < kHostSections; ++s) {
+    if (ticks_[s] != 0) {
+      row(kSectionNames[s], ticks_[s]);
+    }
+  }
+  row("loop", loopTicks());
+  out << text.str() << std::flush;
+}
+
+void HostProfile::writeJson(const std::string& path, const char* core) const {
+  const double secs = seconds();
+  std::ostringstream out;
+  out << "{\n";
+  out << "  \"core\": \"" << core << "\",\n";
+  out << "  \"cycles\": " << cycles_ << ",\n";
+  out << "  \"host_seconds\": " << secs << ",\n";
+  out << "  \"cycles_per_second\": " << (secs > 0 ? cycles_ / secs : 0.0) << ",\n";
+  out << "  \"sample_stride\": " << kHostSampleStride << ",\n";
+  out << "  \"timed_cycles\": " << sampled_cycles_ << ",\n";
+  out << "  \"ns_per_cycle\": " << nsPerCycle(sampled_ticks_) << ",\n";
+  out << "  \"section_ns_per_cycle\": {\n";
+  for (int s = 0; s < kHostSections; ++s) {
+    out << "    \"" << kSectionNames[s] << "\": " << nsPerCycle(ticks_[s]) << ",\n";
+  }
+  out << "    \"loop\": " << nsPerCycle(loopTicks()) << "\n  }\n}\n";
+
+  std::ofstream file(path);
+  if (!file.is_open()) {
+    throw std::runtime_error("failed to open " + path);
+  }
+  file << out.str();
+  if (!file) {
+    throw std::runtime_error("failed to write " + path);
+  }
+}
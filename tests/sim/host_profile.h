@@ -0,0 +1,114 @@
+#pragma once
+
+// Host-side profile of the harness cycle loop (--perf-report).
+//
+// Reading the timestamp counter around every section of every cycle would
+// cost as much as the smaller sections themselves, so only one cycle in
+// kHostSampleStride is timed; the fractions are those of the timed cycles,
+// and the wall clock over the whole run gives the throughput and converts
+// ticks to nanoseconds. Each counter read adds its own cost (tens of ns in
+// a VM) to the timed cycles, so the small sections read high next to eval.
+//
+// Sections:
+//   drive    Ports::drive, less its memory reads (port marshalling)
+//   memory   Memory::read32 from drive, and the cycle's store
+//   eval     the Verilated model
+//   capture  Ports::capture, endCycle and memWrite
+//   log, trace, stats (perf counters, I-cache, memory timing), cosim, wave
+//   loop     the rest of the cycle: loop control, idle detection, sampling
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+enum HostSection : int {
+  kHostDrive,
+  kHostMemory,
+  kHostEval,
+  kHostCapture,
+  kHostLog,
+  kHostTrace,
+  kHostStats,
+  kHostCosim,
+  kHostWave,
+  kHostSections,
+};
+
+constexpr uint64_t kHostSampleStride = 64;  // power of two
+
+// Timestamp counter where the ISA has a user-readable one, otherwise the
+// steady clock in nanoseconds.
+inline uint64_t hostTicks() {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#elif defined(__aarch64__)
+  uint64_t ticks;
+  __asm__ volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+  return ticks;
+#else
+  return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                   std::chrono::steady_clock::now().time_since_epoch())
+                                   .count());
+#endif
+}
+
+class HostProfile {
+ public:
+  void start(uint64_t cycle);
+  void stop(uint64_t cycle);
+
+  static bool sampled(uint64_t cycle) { return (cycle & (kHostSampleStride - 1)) == 0; }
+  void add(HostSection section, uint64_t ticks) { ticks_[section] += ticks; }
+  void addCycle(uint64_t ticks) {
+    ++sampled_cycles_;
+    sampled_ticks_ += ticks;
+  }
+
+  // One line of throughput, then one per section with its share of the
+  // timed cycles and nanoseconds per simulated cycle.
+  void print(std::ostream& out, const char* core) const;
+  // Throws std::runtime_error if the file cannot be written.
+  void writeJson(const std::string& path, const char* core) const;
+
+ private:
+  double seconds() const;
+  double nsPerTick() const;
+  double nsPerCycle(uint64_t ticks) const;  // per timed cycle
+  uint64_t loopTicks() const;
+
+  uint64_t ticks_[kHostSections] = {};
+  uint64_t sampled_cycles_ = 0;
+  uint64_t sampled_ticks_ = 0;
+  uint64_t first_cycle_ = 0;
+  uint64_t cycles_ = 0;
+  uint64_t start_ticks_ = 0;
+  uint64_t stop_ticks_ = 0;
+  std::chrono::steady_clock::time_point start_time_;
+  std::chrono::steady_clock::time_point stop_time_;
+};
+
+// Memory view handed to Ports::drive on timed cycles; charges its reads to
+// the memory section.
+template <typename Mem>
+class TimedMemory {
+ public:
+  explicit TimedMemory(const Mem& memory) : memory_(memory) {}
+
+  uint32_t read32(uint32_t addr) {
+    const uint64_t start = hostTicks();
+    const uint32_t value = memory_.read32(addr);
+    ticks_ += hostTicks() - start;
+    return value;
+  }
+
+  uint64_t ticks() const { return ticks_; }
+
+ private:
+  const Mem& memory_;
+  uint64_t ticks_ = 0;
+};
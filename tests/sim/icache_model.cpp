@@ -0,0 +1,273 @@
+#include "icache_model.h"
+
+#include <fstream>
+#include <ostream>
+#include <stdexcept>
+
+namespace {
+
+bool isPowerOfTwo(uint32_t value) { return value != 0 && (value & (value - 1)) == 0; }
+
+uint32_t parseSize(const std::string& text) {
+  if (text.empty()) {
+    throw std::invalid_argument("empty cache size");
+  }
+  size_t used = 0;
+  uint64_t value = std::stoull(text, &used, 0);
+  const std::string suffix = text.substr(used);
+  if (suffix == "k" || suffix == "K") {
+    value *= 1024;
+  } else if (!suffix.empty()) {
+    throw std::invalid_argument("bad cache size: " + text);
+  }
+  if (value > UINT32_MAX) {
+    throw std::invalid_argument("cache size out of range: " + text);
+  }
+  return static_cast<uint32_t>(value);
+}
+
+void writeCounts(std::ostream& out, const std::vector<uint64_t>& counts) {
+  out << '[';
+  for (size_t i = 0; i < counts.size(); ++i) {
+    out << (i == 0 ? "" : ", ") << counts[i];
+  }
+  out << ']';
+}
+
+}  // namespace
+
+const char* replacementName(ICacheReplacement policy) {
+  switch (policy) {
+    case kReplaceRandom:
+      return "random";
+    case kReplaceRoundRobin:
+      return "round-robin";
+    case kReplacePlru:
+      return "plru";
+    case kReplaceLru:
+      break;
+  }
+  return "lru";
+}
+
+ICacheReplacement parseReplacement(const std::string& text) {
+  for (ICacheReplacement policy : {kReplaceLru, kReplaceRandom, kReplaceRoundRobin, kReplacePlru}) {
+    if (text == replacementName(policy)) {
+      return policy;
+    }
+  }
+  throw std::invalid_argument("unknown replacement policy " + text +
+                              " (expected lru, random, round-robin or plru)");
+}
+
+void ICacheGeometry::validate() const {
+  if (block_bytes < 4 || !isPowerOfTwo(block_bytes)) {
+    throw std::invalid_argument("block size must be a power of two >= 4: " + name());
+  }
+  if (ways == 0 || cache_bytes == 0 || cache_bytes % (block_bytes * ways) != 0) {
+    throw std::invalid_argument("cache size must be a multiple of block*ways: " + name());
+  }
+  if (!isPowerOfTwo(sets())) {
+    throw std::invalid_argument("set count must be a power of two: " + name());
+  }
+  if ((replacement == kReplaceRandom || replacement == kReplacePlru) && !isPowerOfTwo(ways)) {
+    throw std::invalid_argument("random and plru need a power-of-two way count: " + name());
+  }
+}
+
+std::string ICacheGeometry::name() const {
+  std::string text = std::to_string(cache_bytes) + ":" + std::to_string(block_bytes) + ":" +
+                     std::to_string(ways);
+  return replacement == kReplaceLru ? text : text + ":" + replacementName(replacement);
+}
+
+ICacheGeometry parseICacheGeometry(const std::string& text) {
+  const size_t first = text.find(':');
+  const size_t second = first == std::string::npos ? first : text.find(':', first + 1);
+  if (second == std::string::npos) {
+    throw std::invalid_argument("cache geometry must be <bytes>:<block>:<ways>[:<policy>], got " +
+                                text);
+  }
+  const size_t third = text.find(':', second + 1);
+  ICacheGeometry geometry;
+  geometry.cache_bytes = parseSize(text.substr(0, first));
+  geometry.block_bytes = parseSize(text.substr(first + 1, second - first - 1));
+  geometry.ways = parseSize(text.substr(second + 1, third - second - 1));
+  if (third != std::string::npos) {
+    geometry.replacement = parseReplacement(text.substr(third + 1));
+  }
+  geometry.validate();
+  return geometry;
+}
+
+ICacheModel::ICacheModel(const ICacheGeometry& geometry) : geometry_(geometry) {
+  geometry_.validate();
+  sets_ = geometry_.sets();
+  while ((1u << offset_bits_) < geometry_.block_bytes) {
+    ++offset_bits_;
+  }
+  ways_.resize(static_cast<size_t>(sets_) * geometry_.ways);
+  policy_.assign(sets_, 0);
+  stats_.set_misses.assign(sets_, 0);
+  stats_.set_conflicts.assign(sets_, 0);
+}
+
+bool ICacheModel::lookupFullyAssociative(uint32_t block) {
+  auto it = resident_.find(block);
+  if (it != resident_.end()) {
+    lru_.splice(lru_.begin(), lru_, it->second);
+    return true;
+  }
+  if (resident_.size() == geometry_.blocks()) {
+    resident_.erase(lru_.back());
+    lru_.pop_back();
+  }
+  lru_.push_front(block);
+  resident_.emplace(block, lru_.begin());
+  return false;
+}
+
+// Tree PLRU node n has children 2n+1 and 2n+2; its bit points toward the
+// half to evict, as in ICacheSimple.
+uint32_t ICacheModel::policyVictim(uint32_t set) {
+  uint32_t& state = policy_[set];
+  switch (geometry_.replacement) {
+    case kReplaceRandom: {
+      const uint32_t way = lfsr_ & (geometry_.ways - 1);
+      const uint16_t bit = ((lfsr_ >> 0) ^ (lfsr_ >> 2) ^ (lfsr_ >> 3) ^ (lfsr_ >> 5)) & 1u;
+      lfsr_ = static_cast<uint16_t>((lfsr_ >> 1) | (bit << 15));
+      return way;
+    }
+    case kReplaceRoundRobin: {
+      const uint32_t way = state;
+      state = state + 1 == geometry_.ways ? 0 : state + 1;
+      return way;
+    }
+    case kReplacePlru: {
+      uint32_t node = 0;
+      uint32_t way = 0;
+      for (uint32_t span = geometry_.ways; span > 1; span >>= 1) {
+        const uint32_t right = (state >> node) & 1u;
+        way = (way << 1) | right;
+        node = 2 * node + 1 + right;
+      }
+      return way;
+    }
+    case kReplaceLru:
+      break;
+  }
+  // Oldest way; the first one wins a tie.
+  const Way* ways = &ways_[static_cast<size_t>(set) * geometry_.ways];
+  uint32_t oldest = 0;
+  for (uint32_t w = 1; w < geometry_.ways; ++w) {
+    if (ways[w].last_use < ways[oldest].last_use) {
+      oldest = w;
+    }
+  }
+  return oldest;
+}
+
+void ICacheModel::touch(uint32_t set, uint32_t way) {
+  ways_[static_cast<size_t>(set) * geometry_.ways + way].last_use = now_;
+  if (geometry_.replacement != kReplacePlru) {
+    return;
+  }
+  uint32_t& state = policy_[set];
+  uint32_t node = 0;
+  uint32_t levels = 0;
+  while ((1u << levels) < geometry_.ways) {
+    ++levels;
+  }
+  for (uint32_t level = 0; level < levels; ++level) {
+    const uint32_t right = (way >> (levels - 1 - level)) & 1u;
+    state = right ? state & ~(1u << node) : state | (1u << node);
+    node = 2 * node + 1 + right;
+  }
+}
+
+ICacheOutcome ICacheModel::access(uint32_t addr) {
+  const uint32_t block = addr >> offset_bits_;
+  const uint32_t set = block & (sets_ - 1);
+  Way* ways = &ways_[static_cast<size_t>(set) * geometry_.ways];
+  ++now_;
+  ++stats_.accesses;
+  const bool fa_hit = lookupFullyAssociative(block);
+
+  // Same choice as ICacheSimple: first invalid way, else the policy's.
+  int invalid = -1;
+  for (uint32_t w = 0; w < geometry_.ways; ++w) {
+    const Way& way = ways[w];
+    if (way.valid && way.block == block) {
+      touch(set, w);
+      ++stats_.hits;
+      return kICacheHit;
+    }
+    if (!way.valid && invalid < 0) {
+      invalid = static_cast<int>(w);
+    }
+  }
+  // The RTL advances its round-robin pointer and LFSR on every fill.
+  const uint32_t policy_way = policyVictim(set);
+  const uint32_t victim = invalid >= 0 ? static_cast<uint32_t>(invalid) : policy_way;
+  ways[victim].valid = true;
+  ways[victim].block = block;
+  touch(set, victim);
+
+  ++stats_.set_misses[set];
+  if (seen_.insert(block).second) {
+    ++stats_.compulsory;
+    return kICacheCompulsory;
+  }
+  if (!fa_hit) {
+    ++stats_.capacity;
+    return kICacheCapacity;
+  }
+  ++stats_.conflict;
+  ++stats_.set_conflicts[set];
+  return kICacheConflict;
+}
+
+ICacheProfile::ICacheProfile(const ICacheGeometry& geometry)
+    : model_(geometry),
+      set_misses_(geometry.sets(), 0),
+      set_conflicts_(geometry.sets(), 0) {}
+
+void ICacheProfile::writeJson(const std::string& path, const std::string& core) const {
+  const ICacheModelStats& model = model_.stats();
+  const uint64_t misses = accesses_ - hits_;
+  std::ofstream out(path);
+  if (!out.is_open()) {
+    throw std::runtime_error("failed to open icache stats: " + path);
+  }
+  out << "{\n";
+  out << "  \"core\": \"" << core << "\",\n";
+  out << "  \"geometry\": \"" << model_.geometry().name() << "\",\n";
+  out << "  \"sets\": " << model_.geometry().sets() << ",\n";
+  out << "  \"cycles\": " << cycles_ << ",\n";
+  out << "  \"accesses\": " << accesses_ << ",\n";
+  out << "  \"hits\": " << hits_ << ",\n";
+  out << "  \"misses\": " << misses << ",\n";
+  out << "  \"miss_rate\": ";
+  if (accesses_ == 0) {
+    out << "null";
+  } else {
+    out << static_cast<double>(misses) / static_cast<double>(accesses_);
+  }
+  out << ",\n";
+  out << "  \"refill_cycles\": " << refill_cycles_ << ",\n";
+  out << "  \"unallocated_misses\": " << unallocated_ << ",\n";
+  out << "  \"compulsory_misses\": " << compulsory_ << ",\n";
+  out << "  \"capacity_misses\": " << capacity_ << ",\n";
+  out << "  \"conflict_misses\": " << conflict_ << ",\n";
+  out << "  \"set_misses\": ";
+  writeCounts(out, set_misses_);
+  out << ",\n  \"set_conflict_misses\": ";
+  writeCounts(out, set_conflicts_);
+  out << ",\n  \"model\": {\"hits\": " << model.hits << ", \"misses\": " << model.misses()
+      << ", \"compulsory\": " << model.compulsory << ", \"capacity\": " << model.capacity
+      << ", \"conflict\": " << model.conflict << "}\n";
+  out << "}\n";
+  if (!out) {
+    throw std::runtime_error("failed to write icache stats: " + path);
+  }
+}
@@ -0,0 +1,173 @@
+#pragma once
+
+// Functional instruction-cache model for the simulation harnesses.
+//
+// ICacheModel mirrors ICacheSimple's organisation (sets x ways of blocks,
+// invalid-first then the configured replacement policy, allocate on miss) and
+// classifies every miss with the usual three Cs:
+//   compulsory  first reference to the block
+//   capacity    would also miss in a fully associative LRU cache of equal size
+//   conflict    would have hit in that fully associative cache
+//
+// The harness uses it to attribute the RTL cache's misses (--icache-stats);
+// icache_sweep replays recorded fetch streams through many geometries.
+
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// Same policies as ICacheReplacement. Random uses the model's own LFSR, so
+// its misses match the RTL statistically rather than access for access.
+enum ICacheReplacement : uint8_t {
+  kReplaceLru = 0,
+  kReplaceRandom = 1,
+  kReplaceRoundRobin = 2,
+  kReplacePlru = 3,
+};
+
+const char* replacementName(ICacheReplacement policy);
+// Parses lru, random, round-robin or plru; throws std::invalid_argument.
+ICacheReplacement parseReplacement(const std::string& text);
+
+struct ICacheGeometry {
+  uint32_t cache_bytes = 0;
+  uint32_t block_bytes = 0;
+  uint32_t ways = 0;
+  ICacheReplacement replacement = kReplaceLru;
+
+  uint32_t sets() const { return cache_bytes / (block_bytes * ways); }
+  uint32_t blocks() const { return cache_bytes / block_bytes; }
+  // Same legality rules as ICacheSimpleConfig; throws std::invalid_argument.
+  void validate() const;
+  std::string name() const;  // "<bytes>:<block>:<ways>[:<policy>]", policy omitted for lru
+};
+
+// Parses "<bytes>:<block>:<ways>[:<policy>]"; sizes accept a k suffix
+// (e.g. "4k:16:2" or "4k:16:4:plru").
+ICacheGeometry parseICacheGeometry(const std::string& text);
+
+enum ICacheOutcome : uint8_t {
+  kICacheHit = 0,
+  kICacheCompulsory = 1,
+  kICacheCapacity = 2,
+  kICacheConflict = 3,
+};
+
+struct ICacheModelStats {
+  uint64_t accesses = 0;
+  uint64_t hits = 0;
+  uint64_t compulsory = 0;
+  uint64_t capacity = 0;
+  uint64_t conflict = 0;
+  std::vector<uint64_t> set_misses;
+  std::vector<uint64_t> set_conflicts;
+
+  uint64_t misses() const { return compulsory + capacity + conflict; }
+};
+
+class ICacheModel {
+ public:
+  explicit ICacheModel(const ICacheGeometry& geometry);
+
+  // Looks up the block holding addr, allocating it on a miss.
+  ICacheOutcome access(uint32_t addr);
+
+  uint32_t setOf(uint32_t addr) const { return (addr >> offset_bits_) & (sets_ - 1); }
+  const ICacheGeometry& geometry() const { return geometry_; }
+  const ICacheModelStats& stats() const { return stats_; }
+
+ private:
+  struct Way {
+    bool valid = false;
+    uint32_t block = 0;
+    uint64_t last_use = 0;
+  };
+
+  bool lookupFullyAssociative(uint32_t block);
+  uint32_t policyVictim(uint32_t set);
+  void touch(uint32_t set, uint32_t way);
+
+  ICacheGeometry geometry_;
+  uint32_t sets_ = 1;
+  uint32_t offset_bits_ = 0;
+  uint64_t now_ = 0;
+  std::vector<Way> ways_;  // sets_ x geometry_.ways
+  std::vector<uint32_t> policy_;  // per set: round-robin pointer or PLRU tree bits
+  uint16_t lfsr_ = 1;
+
+  // Fully associative LRU shadow with as many blocks as the real cache.
+  std::list<uint32_t> lru_;
+  std::unordered_map<uint32_t, std::list<uint32_t>::iterator> resident_;
+  std::unordered_set<uint32_t> seen_;
+
+  ICacheModelStats stats_;
+};
+
+// One cycle of RTL cache activity, as reported by a port adapter.
+struct ICacheEvent {
+  bool access = false;  // a lookup was made this cycle
+  bool hit = false;
+  bool refill = false;  // the cache was busy filling a line
+  uint32_t addr = 0;
+};
+
+// Counts the RTL cache's hits, misses and refill cycles and attributes each
+// miss using a model of the same geometry fed the same lookups. A miss the
+// model hits on means the RTL answered an earlier miss without keeping the
+// line (ICacheSimple's bypass for single-cycle memory).
+class ICacheProfile {
+ public:
+  explicit ICacheProfile(const ICacheGeometry& geometry);
+
+  inline void observe(const ICacheEvent& event);
+
+  // Throws std::runtime_error if the file cannot be written.
+  void writeJson(const std::string& path, const std::string& core) const;
+
+ private:
+  ICacheModel model_;
+  uint64_t cycles_ = 0;
+  uint64_t refill_cycles_ = 0;
+  uint64_t accesses_ = 0;
+  uint64_t hits_ = 0;
+  uint64_t unallocated_ = 0;
+  uint64_t compulsory_ = 0;
+  uint64_t capacity_ = 0;
+  uint64_t conflict_ = 0;
+  std::vector<uint64_t> set_misses_;
+  std::vector<uint64_t> set_conflicts_;
+};
+
+inline void ICacheProfile::observe(const ICacheEvent& event) {
+  ++cycles_;
+  refill_cycles_ += event.refill ? 1 : 0;
+  if (!event.access) {
+    return;
+  }
+  ++accesses_;
+  const ICacheOutcome outcome = model_.access(event.addr);
+  if (event.hit) {
+    ++hits_;
+    return;
+  }
+  const uint32_t set = model_.setOf(event.addr);
+  ++set_misses_[set];
+  switch (outcome) {
+    case kICacheHit:
+      ++unallocated_;
+      break;
+    case kICacheCompulsory:
+      ++compulsory_;
+      break;
+    case kICacheCapacity:
+      ++capacity_;
+      break;
+    case kICacheConflict:
+      ++conflict_;
+      ++set_conflicts_[set];
+      break;
+  }
+}
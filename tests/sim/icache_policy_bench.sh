@@ -0,0 +1,59 @@
+#!/usr/bin/env bash
+# Miss rates of the I-cache replacement policies at 1/2/4/8 ways on real
+# workloads: records each ELF's fetch stream with the ZeroNyte harness, then
+# replays the streams through icache_sweep.
+#
+#   tests/sim/icache_policy_bench.sh [--sizes 1k,2k,4k] [--json out.json] <elf>...
+#
+# Builds the sweep tool if needed; expects tests/sim/build/zeronyte_sim
+# (build_zeronyte_sim.sh) unless SIM points at another harness binary.
+set -euo pipefail
+
+SCRIPT_DIR=$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)
+REPO_ROOT=$(cd "$SCRIPT_DIR/../.." && pwd)
+
+cd "$REPO_ROOT"
+
+BUILD_DIR="tests/sim/build"
+SIM="${SIM:-$BUILD_DIR/zeronyte_sim}"
+SWEEP="$BUILD_DIR/icache_sweep"
+MAX_CYCLES="${MAX_CYCLES:-2000000}"
+SIZES="1k,2k,4k"
+JSON=""
+ELFS=()
+
+while [[ $# -gt 0 ]]; do
+  case "$1" in
+    --sizes) SIZES="$2"; shift 2 ;;
+    --json) JSON="$2"; shift 2 ;;
+    -*) echo "Unknown option: $1" >&2; exit 1 ;;
+    *) ELFS+=("$1"); shift ;;
+  esac
+done
+
+if [[ ${#ELFS[@]} -eq 0 ]]; then
+  echo "Usage: $0 [--sizes list] [--json file] <elf>..." >&2
+  exit 1
+fi
+if [[ ! -x "$SIM" ]]; then
+  echo "Expected a harness at $SIM; build it with tests/sim/build_zeronyte_sim.sh." >&2
+  exit 1
+fi
+if [[ ! -x "$SWEEP" || "$SWEEP" -ot tests/sim/icache_model.cpp || "$SWEEP" -ot tests/sim/icache_sweep.cpp ]]; then
+  tests/sim/build_icache_sweep.sh
+fi
+
+WORK_DIR=$(mktemp -d)
+trap 'rm -rf "$WORK_DIR"' EXIT
+
+STREAMS=()
+for elf in "${ELFS[@]}"; do
+  name=$(basename "$elf" .elf)
+  # A run that times out still leaves a usable fetch stream.
+  "$SIM" --elf "$elf" --signature "$WORK_DIR/$name.sig" --trace "$WORK_DIR/$name.trace" \
+    --max-cycles "$MAX_CYCLES" > /dev/null || true
+  STREAMS+=("$WORK_DIR/$name.trace")
+done
+
+"$SWEEP" --sizes "$SIZES" --ways 1,2,4,8 --policies lru,plru,round-robin,random \
+  ${JSON:+--json "$JSON"} "${STREAMS[@]}"
@@ -0,0 +1,260 @@
+// Replays recorded fetch streams through the functional I-cache model for a
+// range of cache geometries, without regenerating or re-Verilating the RTL.
+//
+//   icache_sweep [options] <stream>...
+//
+//   --config <bytes>:<block>:<ways>[:<policy>]   add one geometry (repeatable)
+//   --sizes <list>                    cross product of comma-separated
+//   --blocks <list>                     cache sizes, block sizes, ways and
+//   --ways <list>                       replacement policies (defaults:
+//   --policies <list>                   1k,2k,4k,8k / 16 / 1,2,4 / lru)
+//   --jobs <n>                        geometries simulated in parallel
+//   --json <file>                     also write the results as JSON
+//
+// A stream is either a harness trace (--trace), whose per-cycle fetch records
+// give one lookup per cycle, or a text file of hex fetch addresses, one per
+// line. Multithreaded traces contribute only the slots that fetched. Refill
+// cycles are estimated from ICacheSimple's FSM: one request cycle plus one
+// cycle per word of the block.
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "icache_model.h"
+#include "trace.h"
+
+namespace {
+
+struct SweepResult {
+  ICacheGeometry geometry;
+  ICacheModelStats stats;
+};
+
+std::vector<std::string> splitList(const std::string& text) {
+  std::vector<std::string> items;
+  std::istringstream in(text);
+  std::string item;
+  while (std::getline(in, item, ',')) {
+    if (!item.empty()) {
+      items.push_back(item);
+    }
+  }
+  return items;
+}
+
+void loadTrace(std::FILE* in, const std::string& path, std::vector<uint32_t>& addrs) {
+  TraceHeader header{};
+  if (std::fread(&header, sizeof(header), 1, in) != 1 || header.version != kTraceVersion) {
+    throw std::runtime_error("unsupported trace: " + path);
+  }
+  const bool threaded = header.num_threads > 1;
+  std::vector<TraceRecord> block(TraceWriter::kChunkRecords);
+  size_t count = 0;
+  while ((count = std::fread(block.data(), sizeof(TraceRecord), block.size(), in)) > 0) {
+    for (size_t i = 0; i < count; ++i) {
+      const TraceRecord& r = block[i];
+      if (r.kind == kTraceCycle && (!threaded || (r.flags & kTraceFetchEnabled) != 0)) {
+        addrs.push_back(r.pc);
+      }
+    }
+  }
+}
+
+void loadStream(const std::string& path, std::vector<uint32_t>& addrs) {
+  std::FILE* in = std::fopen(path.c_str(), "rb");
+  if (in == nullptr) {
+    throw std::runtime_error("failed to open " + path);
+  }
+  char magic[sizeof(kTraceMagic)] = {};
+  const bool is_trace = std::fread(magic, sizeof(magic), 1, in) == 1 &&
+                        std::memcmp(magic, kTraceMagic, sizeof(magic)) == 0;
+  if (is_trace) {
+    std::rewind(in);
+    loadTrace(in, path, addrs);
+    std::fclose(in);
+    return;
+  }
+  std::fclose(in);
+
+  std::ifstream text(path);
+  std::string line;
+  while (std::getline(text, line)) {
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    addrs.push_back(static_cast<uint32_t>(std::stoul(line, nullptr, 16)));
+  }
+}
+
+uint64_t refillCycles(const SweepResult& result) {
+  return result.stats.misses() * (1 + result.geometry.block_bytes / 4);
+}
+
+double missRate(const SweepResult& result) {
+  const uint64_t accesses = result.stats.accesses;
+  return accesses == 0 ? 0.0 : static_cast<double>(result.stats.misses()) / accesses;
+}
+
+void printTable(std::ostream& out, const std::vector<SweepResult>& results) {
+  out << std::left << std::setw(24) << "config" << std::right << std::setw(7) << "sets"
+      << std::setw(12) << "accesses" << std::setw(10) << "misses" << std::setw(10) << "miss%"
+      << std::setw(12) << "compulsory" << std::setw(10) << "capacity" << std::setw(10)
+      << "conflict" << std::setw(15) << "refill_cycles" << '\n';
+  for (const SweepResult& r : results) {
+    out << std::left << std::setw(24) << r.geometry.name() << std::right << std::setw(7)
+        << r.geometry.sets() << std::setw(12) << r.stats.accesses << std::setw(10)
+        << r.stats.misses() << std::setw(10) << std::fixed << std::setprecision(3)
+        << 100.0 * missRate(r) << std::setw(12) << r.stats.compulsory << std::setw(10)
+        << r.stats.capacity << std::setw(10) << r.stats.conflict << std::setw(15)
+        << refillCycles(r) << '\n';
+  }
+}
+
+void writeJson(const std::string& path, const std::vector<SweepResult>& results) {
+  std::ofstream out(path);
+  if (!out.is_open()) {
+    throw std::runtime_error("failed to open " + path);
+  }
+  out << "{\n  \"results\": [";
+  for (size_t i = 0; i < results.size(); ++i) {
+    const SweepResult& r = results[i];
+    out << (i == 0 ? "\n" : ",\n");
+    out << "    {\"config\": \"" << r.geometry.name() << "\""
+        << ", \"cache_bytes\": " << r.geometry.cache_bytes
+        << ", \"block_bytes\": " << r.geometry.block_bytes
+        << ", \"ways\": " << r.geometry.ways
+        << ", \"replacement\": \"" << replacementName(r.geometry.replacement) << "\""
+        << ", \"sets\": " << r.geometry.sets()
+        << ", \"accesses\": " << r.stats.accesses
+        << ", \"misses\": " << r.stats.misses()
+        << ", \"miss_rate\": " << missRate(r)
+        << ", \"compulsory\": " << r.stats.compulsory
+        << ", \"capacity\": " << r.stats.capacity
+        << ", \"conflict\": " << r.stats.conflict
+        << ", \"refill_cycles\": " << refillCycles(r) << "}";
+  }
+  out << (results.empty() ? "]\n" : "\n  ]\n") << "}\n";
+}
+
+int usage(const char* argv0) {
+  std::cerr << "Usage: " << argv0
+            << " [--config B:L:W]... [--sizes list] [--blocks list] [--ways list]"
+               " [--policies list] [--jobs n] [--json file] <stream>..."
+            << std::endl;
+  return 1;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::vector<ICacheGeometry> geometries;
+  std::vector<std::string> sizes;
+  std::vector<std::string> blocks;
+  std::vector<std::string> ways;
+  std::vector<std::string> policies;
+  std::vector<std::string> streams;
+  std::string json;
+  unsigned jobs = std::max(1u, std::thread::hardware_concurrency());
+
+  try {
+    for (int i = 1; i < argc; ++i) {
+      const std::string arg(argv[i]);
+      if (arg == "--config" && i + 1 < argc) {
+        geometries.push_back(parseICacheGeometry(argv[++i]));
+      } else if (arg == "--sizes" && i + 1 < argc) {
+        sizes = splitList(argv[++i]);
+      } else if (arg == "--blocks" && i + 1 < argc) {
+        blocks = splitList(argv[++i]);
+      } else if (arg == "--ways" && i + 1 < argc) {
+        ways = splitList(argv[++i]);
+      } else if (arg == "--policies" && i + 1 < argc) {
+        policies = splitList(argv[++i]);
+      } else if (arg == "--jobs" && i + 1 < argc) {
+        jobs = std::max(1, std::stoi(argv[++i]));
+      } else if (arg == "--json" && i + 1 < argc) {
+        json = argv[++i];
+      } else if (!arg.empty() && arg[0] == '-') {
+        return usage(argv[0]);
+      } else {
+        streams.push_back(arg);
+      }
+    }
+    if (streams.empty()) {
+      return usage(argv[0]);
+    }
+
+    const bool grid = !sizes.empty() || !blocks.empty() || !ways.empty() || !policies.empty();
+    if (grid || geometries.empty()) {
+      for (const std::string& size : sizes.empty() ? splitList("1k,2k,4k,8k") : sizes) {
+        for (const std::string& block : blocks.empty() ? splitList("16") : blocks) {
+          for (const std::string& way : ways.empty() ? splitList("1,2,4") : ways) {
+            for (const std::string& policy : policies.empty() ? splitList("lru") : policies) {
+              try {
+                geometries.push_back(
+                    parseICacheGeometry(size + ":" + block + ":" + way + ":" + policy));
+              } catch (const std::invalid_argument& e) {
+                std::cerr << "skipping " << e.what() << std::endl;
+              }
+            }
+          }
+        }
+      }
+    }
+  } catch (const std::exception& e) {
+    std::cerr << "Argument error: " << e.what() << std::endl;
+    return 1;
+  }
+
+  std::vector<uint32_t> addrs;
+  try {
+    for (const std::string& stream : streams) {
+      loadStream(stream, addrs);
+    }
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+
+  // Each geometry replays the whole stream on its own model.
+  std::vector<SweepResult> results(geometries.size());
+  std::atomic<size_t> next{0};
+  auto worker = [&]() {
+    for (size_t i = next++; i < geometries.size(); i = next++) {
+      ICacheModel model(geometries[i]);
+      for (uint32_t addr : addrs) {
+        model.access(addr);
+      }
+      results[i] = {geometries[i], model.stats()};
+    }
+  };
+  std::vector<std::thread> threads;
+  for (unsigned t = 1; t < std::min<size_t>(jobs, geometries.size()); ++t) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  printTable(std::cout, results);
+  if (!json.empty()) {
+    try {
+      writeJson(json, results);
+    } catch (const std::exception& e) {
+      std::cerr << e.what() << std::endl;
+      return 1;
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+// Steady-state loop detection for the simulation harnesses.
+//
+// Each cycle the port adapter condenses what it can observe of the core
+// (fetch PCs, operands, results) into one 64-bit sample. Samples are
+// collected as a set per window of cycles; a core that stores nothing and
+// produces the same sample set for several consecutive windows is spinning
+// in a loop it cannot leave, since nothing it reads can change. Loops whose
+// operands change (countdowns, pointer walks) yield differing sets and are
+// left alone. The window should be longer than the loop being detected.
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_set>
+
+// Folds v into the running sample h.
+inline uint64_t idleMix(uint64_t h, uint64_t v) {
+  h ^= v + 0x9E3779B97F4A7C15ull + (h << 6) + (h >> 2);
+  return h;
+}
+
+class IdleDetector {
+ public:
+  // Windows with more distinct samples than this are not a tight loop.
+  static constexpr size_t kMaxDistinct = 4096;
+  // Identical windows required, after the first, before declaring a spin.
+  static constexpr int kRepeats = 2;
+
+  void reset(uint64_t window) {
+    window_ = window;
+    filled_ = 0;
+    repeats_ = 0;
+    busy_ = false;
+    have_previous_ = false;
+    current_.clear();
+    previous_.clear();
+  }
+
+  // Records one cycle; returns true once the core is judged to be spinning.
+  inline bool sample(uint64_t key, bool stored) {
+    if (stored) {
+      busy_ = true;
+    } else if (!busy_ && current_.insert(key).second && current_.size() > kMaxDistinct) {
+      busy_ = true;
+    }
+    if (++filled_ < window_) {
+      return false;
+    }
+    return closeWindow();
+  }
+
+ private:
+  bool closeWindow() {
+    if (busy_) {
+      repeats_ = 0;
+      have_previous_ = false;
+    } else {
+      repeats_ = (have_previous_ && current_ == previous_) ? repeats_ + 1 : 0;
+      previous_.swap(current_);
+      have_previous_ = true;
+    }
+    current_.clear();
+    busy_ = false;
+    filled_ = 0;
+    return repeats_ >= kRepeats;
+  }
+
+  uint64_t window_ = 0;
+  uint64_t filled_ = 0;
+  int repeats_ = 0;
+  bool busy_ = false;
+  bool have_previous_ = false;
+  std::unordered_set<uint64_t> current_;
+  std::unordered_set<uint64_t> previous_;
+};
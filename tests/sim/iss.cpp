@@ -0,0 +1,639 @@
+#include "iss.h"
+
+#include <algorithm>
+
+namespace {
+
+// PerfCounterCSRs addresses.
+constexpr int kCsrMcycle = 0xB00;
+constexpr int kCsrMinstret = 0xB02;
+constexpr int kCsrMhpmcounter3 = 0xB03;
+constexpr int kCsrHigh = 0x80;  // mcycleh = mcycle + kCsrHigh, and so on
+constexpr int kCsrCycle = 0xC00;
+constexpr int kCsrTime = 0xC01;
+constexpr int kCsrInstret = 0xC02;
+constexpr int kCsrHpmcounter3 = 0xC03;
+constexpr int kCsrMcountinhibit = 0x320;
+constexpr int kCsrMhpmevent3 = 0x323;
+constexpr int kCsrMhartid = 0xF14;
+
+// mcountinhibit: CY (0), IR (2) and HPM3..5 (3..5); TM is read-only zero.
+constexpr uint32_t kInhibitCycle = 1u << 0;
+constexpr uint32_t kInhibitInstret = 1u << 2;
+constexpr uint32_t kInhibitMask = 0x3Du;
+constexpr int kHpmTaken = 1;  // mhpmcounter4: taken branch or jump
+constexpr uint32_t kInhibitTaken = 1u << (3 + kHpmTaken);
+
+inline uint32_t signExtend(uint32_t value, int bits) {
+  const uint32_t sign = 1u << (bits - 1);
+  return (value ^ sign) - sign;
+}
+
+inline uint32_t immI(uint32_t instr) { return signExtend(instr >> 20, 12); }
+inline uint32_t immS(uint32_t instr) {
+  return signExtend(((instr >> 25) << 5) | ((instr >> 7) & 0x1Fu), 12);
+}
+inline uint32_t immB(uint32_t instr) {
+  return signExtend(((instr >> 31) << 12) | (((instr >> 7) & 0x1u) << 11) |
+                        (((instr >> 25) & 0x3Fu) << 5) | (((instr >> 8) & 0xFu) << 1),
+                    13);
+}
+inline uint32_t immJ(uint32_t instr) {
+  return signExtend(((instr >> 31) << 20) | (instr & 0xFF000u) | (((instr >> 20) & 0x1u) << 11) |
+                        (((instr >> 21) & 0x3FFu) << 1),
+                    21);
+}
+
+inline uint32_t half(uint64_t value, bool high) {
+  return static_cast<uint32_t>(high ? value >> 32 : value);
+}
+
+inline uint64_t setHalf(uint64_t value, bool high, uint32_t part) {
+  return high ? (value & 0xFFFFFFFFull) | (static_cast<uint64_t>(part) << 32)
+              : (value & ~0xFFFFFFFFull) | part;
+}
+
+uint32_t mulDiv(uint32_t funct3, uint32_t a, uint32_t b) {
+  const int32_t sa = static_cast<int32_t>(a);
+  const int32_t sb = static_cast<int32_t>(b);
+  switch (funct3) {
+    case 0:  // MUL
+      return a * b;
+    case 1:  // MULH
+      return static_cast<uint32_t>((static_cast<int64_t>(sa) * sb) >> 32);
+    case 2:  // MULHSU
+      return static_cast<uint32_t>((static_cast<int64_t>(sa) * static_cast<int64_t>(b)) >> 32);
+    case 3:  // MULHU
+      return static_cast<uint32_t>((static_cast<uint64_t>(a) * b) >> 32);
+    case 4:  // DIV
+      if (b == 0) {
+        return 0xFFFFFFFFu;
+      }
+      if (a == 0x80000000u && b == 0xFFFFFFFFu) {
+        return a;
+      }
+      return static_cast<uint32_t>(sa / sb);
+    case 5:  // DIVU
+      return b == 0 ? 0xFFFFFFFFu : a / b;
+    case 6:  // REM
+      if (b == 0) {
+        return a;
+      }
+      if (a == 0x80000000u && b == 0xFFFFFFFFu) {
+        return 0;
+      }
+      return static_cast<uint32_t>(sa % sb);
+    default:  // REMU
+      return b == 0 ? a : a % b;
+  }
+}
+
+
+// Decoded-op handlers, in dispatch-table order.
+#define ISS_OPS(X)                                                        \
+  X(Illegal) X(Lui) X(Auipc) X(Jal) X(Jalr)                               \
+  X(Beq) X(Bne) X(Blt) X(Bge) X(Bltu) X(Bgeu)                             \
+  X(Lb) X(Lh) X(Lw) X(Lbu) X(Lhu) X(Sb) X(Sh) X(Sw)                       \
+  X(Addi) X(Slti) X(Sltiu) X(Xori) X(Ori) X(Andi) X(Slli) X(Srli) X(Srai) \
+  X(Add) X(Sub) X(Sll) X(Slt) X(Sltu) X(Xor) X(Srl) X(Sra) X(Or) X(And)   \
+  X(Mul) X(Mulh) X(Mulhsu) X(Mulhu) X(Div) X(Divu) X(Rem) X(Remu)         \
+  X(Fence) X(Csr)
+
+enum IssOp : uint8_t {
+#define ISS_OP_ENUM(name) kOp##name,
+  ISS_OPS(ISS_OP_ENUM)
+#undef ISS_OP_ENUM
+};
+
+constexpr IssOp kBranchOps[8] = {kOpBeq, kOpBne, kOpIllegal, kOpIllegal,
+                                 kOpBlt, kOpBge, kOpBltu,    kOpBgeu};
+constexpr IssOp kLoadOps[8] = {kOpLb,  kOpLh,  kOpLw,      kOpIllegal,
+                               kOpLbu, kOpLhu, kOpIllegal, kOpIllegal};
+constexpr IssOp kImmOps[8] = {kOpAddi, kOpSlli, kOpSlti, kOpSltiu,
+                              kOpXori, kOpSrli, kOpOri,  kOpAndi};
+constexpr IssOp kRegOps[8] = {kOpAdd, kOpSll, kOpSlt, kOpSltu, kOpXor, kOpSrl, kOpOr, kOpAnd};
+
+}  // namespace
+
+struct Iss::DecodedOp {
+  uint8_t op = kOpIllegal;
+  uint8_t rd = 0;
+  uint8_t rs1 = 0;
+  uint8_t rs2 = 0;
+  uint32_t imm = 0;  // immediate, or shift amount
+  uint32_t instr = 0;
+};
+
+struct Iss::DecodedPage {
+  std::array<DecodedOp, Memory::kPageSize / 4> ops;
+};
+
+Iss::DecodedOp Iss::decode(uint32_t instr) {
+  DecodedOp d;
+  d.rd = static_cast<uint8_t>((instr >> 7) & 0x1Fu);
+  d.rs1 = static_cast<uint8_t>((instr >> 15) & 0x1Fu);
+  d.rs2 = static_cast<uint8_t>((instr >> 20) & 0x1Fu);
+  d.instr = instr;
+  const uint32_t funct3 = (instr >> 12) & 0x7u;
+  const uint32_t funct7 = instr >> 25;
+  IssOp op = kOpIllegal;
+  switch (instr & 0x7Fu) {
+    case 0x37:
+      op = kOpLui;
+      d.imm = instr & 0xFFFFF000u;
+      break;
+    case 0x17:
+      op = kOpAuipc;
+      d.imm = instr & 0xFFFFF000u;
+      break;
+    case 0x6F:
+      op = kOpJal;
+      d.imm = immJ(instr);
+      break;
+    case 0x67:
+      op = funct3 == 0 ? kOpJalr : kOpIllegal;
+      d.imm = immI(instr);
+      break;
+    case 0x63:
+      op = kBranchOps[funct3];
+      d.imm = immB(instr);
+      break;
+    case 0x03:
+      op = kLoadOps[funct3];
+      d.imm = immI(instr);
+      break;
+    case 0x23:
+      op = funct3 == 0 ? kOpSb : funct3 == 1 ? kOpSh : funct3 == 2 ? kOpSw : kOpIllegal;
+      d.imm = immS(instr);
+      break;
+    case 0x13:
+      op = kImmOps[funct3];
+      d.imm = immI(instr);
+      if (funct3 == 1 || funct3 == 5) {
+        d.imm = d.rs2;  // shamt
+        if (funct3 == 5 && funct7 == 0x20) {
+          op = kOpSrai;
+        } else if (funct7 != 0) {
+          op = kOpIllegal;
+        }
+      }
+      break;
+    case 0x33:
+      if (funct7 == 0x01) {
+        op = static_cast<IssOp>(kOpMul + funct3);
+      } else if (funct7 == 0x00) {
+        op = kRegOps[funct3];
+      } else if (funct7 == 0x20 && funct3 == 0) {
+        op = kOpSub;
+      } else if (funct7 == 0x20 && funct3 == 5) {
+        op = kOpSra;
+      }
+      break;
+    case 0x0F:  // FENCE, FENCE.I
+      op = funct3 <= 1 ? kOpFence : kOpIllegal;
+      break;
+    case 0x73:  // Zicsr; ECALL, EBREAK, MRET and WFI are illegal here
+      op = funct3 != 0 && funct3 != 4 ? kOpCsr : kOpIllegal;
+      break;
+    default:
+      break;
+  }
+  d.op = op;
+  return d;
+}
+
+Iss::Iss(Memory& memory, int harts)
+    : memory_(memory), harts_(harts), code_pages_(kNumPages / 64) {}
+
+Iss::~Iss() = default;
+
+void Iss::reset(uint32_t pc) {
+  for (Hart& hart : harts_) {
+    hart = Hart{};
+    hart.pc = pc;
+  }
+  flushDecoded();
+}
+
+void Iss::flushDecoded() {
+  pages_.clear();
+  std::fill(code_pages_.begin(), code_pages_.end(), 0);
+}
+
+void Iss::setWatch(uint32_t addr) { watch_ = addr == 0 ? kNoWatch : addr & ~0x3u; }
+
+void Iss::setReg(int hart, int index, uint32_t value) {
+  if (index != 0) {
+    harts_[hart].x[index] = value;
+  }
+}
+
+const Iss::DecodedOp* Iss::decodedPage(uint32_t pc) {
+  const uint32_t page = pc >> Memory::kPageBits;
+  std::unique_ptr<DecodedPage>& slot = pages_[page];
+  if (!slot) {
+    slot = std::make_unique<DecodedPage>();
+    const uint32_t base = page << Memory::kPageBits;
+    for (uint32_t i = 0; i < slot->ops.size(); ++i) {
+      slot->ops[i] = decode(memory_.read32(base + 4 * i));
+    }
+    code_pages_[page >> 6] |= 1ull << (page & 63);
+  }
+  return slot->ops.data();
+}
+
+bool Iss::invalidate(uint32_t addr, uint32_t size) {
+  bool dropped = false;
+  const uint32_t first = addr >> Memory::kPageBits;
+  const uint32_t last = (addr + size - 1) >> Memory::kPageBits;
+  for (uint32_t page = first;; page = (page + 1) & (kNumPages - 1)) {
+    if (isCodePage(page)) {
+      pages_.erase(page);
+      code_pages_[page >> 6] &= ~(1ull << (page & 63));
+      dropped = true;
+    }
+    if (page == last) {
+      break;
+    }
+  }
+  return dropped;
+}
+
+inline uint32_t Iss::load(uint32_t addr, uint32_t size) const {
+  if (size == 4) {
+    return memory_.read32(addr);
+  }
+  uint32_t value = memory_.read8(addr);
+  if (size == 2) {
+    value |= static_cast<uint32_t>(memory_.read8(addr + 1)) << 8;
+  }
+  return value;
+}
+
+inline bool Iss::store(uint32_t addr, uint32_t size, uint32_t data) {
+  if (size == 4) {
+    memory_.write32(addr, data);
+  } else {
+    for (uint32_t byte = 0; byte < size; ++byte) {
+      memory_.write8(addr + byte, static_cast<uint8_t>(data >> (8 * byte)));
+    }
+  }
+  const uint32_t page = addr >> Memory::kPageBits;
+  const uint32_t last = (addr + size - 1) >> Memory::kPageBits;
+  return (isCodePage(page) || (last != page && isCodePage(last))) && invalidate(addr, size);
+}
+
+uint32_t Iss::accessCsr(Hart& hart, int index, uint32_t instr, uint32_t operand,
+                        bool& volatile_read, const uint64_t*& written) {
+  const int addr = static_cast<int>(instr >> 20);
+  const bool high = (addr & kCsrHigh) != 0;
+  const int low = addr & ~kCsrHigh;
+  uint64_t* counter = nullptr;
+  bool writable = false;
+  if (low == kCsrMcycle || low == kCsrCycle || low == kCsrTime) {
+    counter = &hart.cycle;
+    writable = low == kCsrMcycle;
+  } else if (low == kCsrMinstret || low == kCsrInstret) {
+    counter = &hart.instret;
+    writable = low == kCsrMinstret;
+  } else if (low >= kCsrMhpmcounter3 && low < kCsrMhpmcounter3 + kNumHpm) {
+    counter = &hart.hpm[low - kCsrMhpmcounter3];
+    writable = true;
+  } else if (low >= kCsrHpmcounter3 && low < kCsrHpmcounter3 + kNumHpm) {
+    counter = &hart.hpm[low - kCsrHpmcounter3];
+  }
+
+  uint32_t old = 0;
+  if (counter != nullptr) {
+    old = half(*counter, high);
+    volatile_read = true;
+  } else if (addr == kCsrMcountinhibit) {
+    old = hart.inhibit;
+  } else if (addr >= kCsrMhpmevent3 && addr < kCsrMhpmevent3 + kNumHpm) {
+    old = static_cast<uint32_t>(addr - kCsrMhpmevent3 + 1);
+  } else if (addr == kCsrMhartid) {
+    old = static_cast<uint32_t>(index);
+  }
+
+  const uint32_t cmd = (instr >> 12) & 0x3u;
+  const bool writes = cmd == 1 || ((instr >> 15) & 0x1Fu) != 0;
+  if (writes) {
+    const uint32_t value = cmd == 1 ? operand : cmd == 2 ? old | operand : old & ~operand;
+    if (counter != nullptr && writable) {
+      *counter = setHalf(*counter, high, value);
+      written = counter;
+    } else if (addr == kCsrMcountinhibit) {
+      hart.inhibit = value & kInhibitMask;
+    }
+  }
+  return old;
+}
+
+// One executor serves step() (kRecord, budget 1) and run(). Handlers end in
+// ISS_NEXT, which falls through to the next op of the decoded page, or in
+// ISS_JUMP, which re-fetches through the page lookup only when the target
+// leaves the current page. GCC and Clang dispatch through a table of label
+// addresses; other compilers use a switch.
+template <bool kRecord>
+IssStatus Iss::execute(int index, uint64_t budget, IssStep* out, uint64_t& executed) {
+  Hart& hart = harts_[index];
+  uint32_t* const x = hart.x.data();
+  uint32_t pc = hart.pc;
+  uint64_t done = 0;
+  uint64_t counted = 0;  // instructions of `done` already added to the counters
+  uint64_t taken_inc = (hart.inhibit & kInhibitTaken) == 0 ? 1 : 0;
+  IssStatus status = kIssOk;
+  const DecodedOp* page_ops = nullptr;
+  const DecodedOp* page_end = nullptr;
+  uint32_t page_base = 0;
+  const DecodedOp* op = nullptr;
+
+  const auto count = [&]() {
+    const uint64_t n = done - counted;
+    hart.cycle += (hart.inhibit & kInhibitCycle) == 0 ? n : 0;
+    hart.instret += (hart.inhibit & kInhibitInstret) == 0 ? n : 0;
+    counted = done;
+  };
+
+#if defined(__GNUC__)
+  static const void* const kLabels[] = {
+#define ISS_OP_LABEL(name) &&op_##name,
+      ISS_OPS(ISS_OP_LABEL)
+#undef ISS_OP_LABEL
+  };
+#define ISS_DISPATCH() goto* kLabels[op->op]
+#else
+#define ISS_OP_CASE(name) \
+  case kOp##name:         \
+    goto op_##name;
+#define ISS_DISPATCH()       \
+  switch (op->op) {          \
+    ISS_OPS(ISS_OP_CASE)     \
+    default:                 \
+      goto op_Illegal;       \
+  }
+#endif
+
+#define ISS_NEXT()                          \
+  do {                                      \
+    pc += 4;                                \
+    ++done;                                 \
+    if (kRecord || done == budget) {        \
+      goto finish;                          \
+    }                                       \
+    if (++op == page_end) {                 \
+      goto fetch;                           \
+    }                                       \
+    ISS_DISPATCH();                         \
+  } while (0)
+#define ISS_JUMP(target)                    \
+  do {                                      \
+    pc = (target);                          \
+    ++done;                                 \
+    if (kRecord || done == budget) {        \
+      goto finish;                          \
+    }                                       \
+    goto fetch;                             \
+  } while (0)
+#define ISS_WRITE(value)                    \
+  do {                                      \
+    x[op->rd] = (value);                    \
+    x[0] = 0;                               \
+    if constexpr (kRecord) {                \
+      out->writes_rd = op->rd != 0;         \
+      out->rd = op->rd;                     \
+      out->rd_value = x[op->rd];            \
+    }                                       \
+  } while (0)
+#define ISS_BRANCH(cond)                    \
+  do {                                      \
+    const bool taken = (cond);              \
+    if constexpr (kRecord) {                \
+      out->is_ctrl = true;                  \
+      out->taken = taken;                   \
+    }                                       \
+    if (taken) {                            \
+      hart.hpm[kHpmTaken] += taken_inc;     \
+      ISS_JUMP(pc + op->imm);               \
+    }                                       \
+    ISS_NEXT();                             \
+  } while (0)
+#define ISS_LOAD(size, extend)                                  \
+  do {                                                          \
+    const uint32_t value = load(x[op->rs1] + op->imm, (size));  \
+    ISS_WRITE(extend);                                          \
+    ISS_NEXT();                                                 \
+  } while (0)
+// A store that dropped a decoded page (op included) or hit the watched word
+// leaves through the page lookup.
+#define ISS_STORE(size)                                                    \
+  do {                                                                     \
+    const uint32_t addr = x[op->rs1] + op->imm;                            \
+    const uint32_t data = (size) == 4 ? x[op->rs2]                         \
+                                      : x[op->rs2] & ((1u << (8 * (size))) - 1); \
+    const bool dropped = store(addr, (size), data);                        \
+    if constexpr (kRecord) {                                               \
+      out->is_store = true;                                                \
+      out->store_size = (size);                                            \
+      out->store_addr = addr;                                              \
+      out->store_data = data;                                              \
+      out->store_word = memory_.read32(addr & ~0x3u);                      \
+    }                                                                      \
+    if (dropped || (addr & ~0x3u) == watch_) {                             \
+      page_ops = nullptr;                                                  \
+      if ((addr & ~0x3u) == watch_) {                                      \
+        status = kIssWatch;                                                \
+        budget = done + 1;                                                 \
+      }                                                                    \
+      ISS_JUMP(pc + 4);                                                    \
+    }                                                                      \
+    ISS_NEXT();                                                            \
+  } while (0)
+#define ISS_ALU(expr)   \
+  do {                  \
+    const uint32_t a = x[op->rs1]; \
+    const uint32_t b = x[op->rs2]; \
+    const uint32_t imm = op->imm;  \
+    (void)b;                       \
+    (void)imm;                     \
+    ISS_WRITE(expr);               \
+    ISS_NEXT();                    \
+  } while (0)
+
+  if (budget == 0) {
+    goto finish;
+  }
+
+fetch:
+  if ((pc & 0x3u) != 0) {
+    if constexpr (kRecord) {
+      out->pc = pc;
+      out->instr = memory_.read32(pc);
+    }
+    status = kIssIllegal;
+    goto finish;
+  }
+  if (page_ops == nullptr || ((pc - page_base) >> Memory::kPageBits) != 0) {
+    page_ops = decodedPage(pc);
+    page_end = page_ops + Memory::kPageSize / 4;
+    page_base = pc & ~Memory::kPageMask;
+  }
+  op = page_ops + ((pc - page_base) >> 2);
+  if constexpr (kRecord) {
+    out->pc = pc;
+    out->instr = op->instr;
+  }
+  ISS_DISPATCH();
+
+op_Illegal:
+  status = kIssIllegal;
+  goto finish;
+op_Lui:
+  ISS_WRITE(op->imm);
+  ISS_NEXT();
+op_Auipc:
+  ISS_WRITE(pc + op->imm);
+  ISS_NEXT();
+op_Jal: {
+  const uint32_t target = pc + op->imm;
+  ISS_WRITE(pc + 4);
+  if constexpr (kRecord) {
+    out->is_ctrl = out->taken = true;
+  }
+  hart.hpm[kHpmTaken] += taken_inc;
+  ISS_JUMP(target);
+}
+op_Jalr: {
+  const uint32_t target = (x[op->rs1] + op->imm) & ~1u;
+  ISS_WRITE(pc + 4);
+  if constexpr (kRecord) {
+    out->is_ctrl = out->taken = true;
+  }
+  hart.hpm[kHpmTaken] += taken_inc;
+  ISS_JUMP(target);
+}
+op_Beq:
+  ISS_BRANCH(x[op->rs1] == x[op->rs2]);
+op_Bne:
+  ISS_BRANCH(x[op->rs1] != x[op->rs2]);
+op_Blt:
+  ISS_BRANCH(static_cast<int32_t>(x[op->rs1]) < static_cast<int32_t>(x[op->rs2]));
+op_Bge:
+  ISS_BRANCH(static_cast<int32_t>(x[op->rs1]) >= static_cast<int32_t>(x[op->rs2]));
+op_Bltu:
+  ISS_BRANCH(x[op->rs1] < x[op->rs2]);
+op_Bgeu:
+  ISS_BRANCH(x[op->rs1] >= x[op->rs2]);
+op_Lb:
+  ISS_LOAD(1, signExtend(value, 8));
+op_Lh:
+  ISS_LOAD(2, signExtend(value, 16));
+op_Lw:
+  ISS_LOAD(4, value);
+op_Lbu:
+  ISS_LOAD(1, value);
+op_Lhu:
+  ISS_LOAD(2, value);
+op_Sb:
+  ISS_STORE(1);
+op_Sh:
+  ISS_STORE(2);
+op_Sw:
+  ISS_STORE(4);
+op_Addi:
+  ISS_ALU(a + imm);
+op_Slti:
+  ISS_ALU(static_cast<int32_t>(a) < static_cast<int32_t>(imm) ? 1u : 0u);
+op_Sltiu:
+  ISS_ALU(a < imm ? 1u : 0u);
+op_Xori:
+  ISS_ALU(a ^ imm);
+op_Ori:
+  ISS_ALU(a | imm);
+op_Andi:
+  ISS_ALU(a & imm);
+op_Slli:
+  ISS_ALU(a << imm);
+op_Srli:
+  ISS_ALU(a >> imm);
+op_Srai:
+  ISS_ALU(static_cast<uint32_t>(static_cast<int32_t>(a) >> imm));
+op_Add:
+  ISS_ALU(a + b);
+op_Sub:
+  ISS_ALU(a - b);
+op_Sll:
+  ISS_ALU(a << (b & 0x1Fu));
+op_Slt:
+  ISS_ALU(static_cast<int32_t>(a) < static_cast<int32_t>(b) ? 1u : 0u);
+op_Sltu:
+  ISS_ALU(a < b ? 1u : 0u);
+op_Xor:
+  ISS_ALU(a ^ b);
+op_Srl:
+  ISS_ALU(a >> (b & 0x1Fu));
+op_Sra:
+  ISS_ALU(static_cast<uint32_t>(static_cast<int32_t>(a) >> (b & 0x1Fu)));
+op_Or:
+  ISS_ALU(a | b);
+op_And:
+  ISS_ALU(a & b);
+op_Mul:
+op_Mulh:
+op_Mulhsu:
+op_Mulhu:
+op_Div:
+op_Divu:
+op_Rem:
+op_Remu:
+  ISS_ALU(mulDiv(op->op - kOpMul, a, b));
+op_Fence:
+  ISS_NEXT();
+op_Csr: {
+  // Counters read this instruction's CSR as of the previous one, and a
+  // write replaces the written counter's own increment, as in the RTL.
+  count();
+  const uint32_t operand = (op->instr & 0x4000u) != 0 ? op->rs1 : x[op->rs1];
+  bool volatile_read = false;
+  const uint64_t* written = nullptr;
+  const uint32_t value = accessCsr(hart, index, op->instr, operand, volatile_read, written);
+  ISS_WRITE(value);
+  if constexpr (kRecord) {
+    out->rd_volatile = volatile_read && op->rd != 0;
+  }
+  hart.cycle += (hart.inhibit & kInhibitCycle) == 0 && written != &hart.cycle ? 1 : 0;
+  hart.instret += (hart.inhibit & kInhibitInstret) == 0 && written != &hart.instret ? 1 : 0;
+  counted = done + 1;
+  taken_inc = (hart.inhibit & kInhibitTaken) == 0 ? 1 : 0;
+  ISS_NEXT();
+}
+
+finish:
+  count();
+  hart.pc = pc;
+  if constexpr (kRecord) {
+    out->next_pc = pc;
+  }
+  executed = done;
+  return status;
+
+#undef ISS_DISPATCH
+#undef ISS_NEXT
+#undef ISS_JUMP
+#undef ISS_WRITE
+#undef ISS_BRANCH
+#undef ISS_LOAD
+#undef ISS_STORE
+#undef ISS_ALU
+}
+
+IssStatus Iss::step(int hart, IssStep& out) {
+  out = IssStep{};
+  uint64_t executed = 0;
+  const IssStatus status = execute<true>(hart, 1, &out, executed);
+  return status == kIssIllegal ? kIssIllegal : kIssOk;
+}
+
+IssStatus Iss::run(int hart, uint64_t max_instrs, uint64_t& executed) {
+  return execute<false>(hart, max_instrs, nullptr, executed);
+}
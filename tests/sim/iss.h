@@ -0,0 +1,122 @@
+#pragma once
+
+// Instruction-set simulator used as the co-simulation reference (cosim.h)
+// and on its own by iss_sim.
+//
+// RV32IM plus the Zicsr counters of PerfCounterCSRs, with one architectural
+// state per hart over a shared Memory. Like the cores it takes no traps:
+// FENCE and FENCE.I retire as no-ops, unimplemented CSRs read as zero, and
+// ECALL, EBREAK, MRET, a misaligned PC or any other encoding outside
+// RV32IM/Zicsr stops the hart with kIssIllegal. Misaligned loads and stores
+// access their bytes one at a time. Each instruction counts one mcycle and
+// one minstret; mhpmcounter4 counts taken branches and jumps.
+//
+// Instructions are decoded a page at a time into a decoded-op cache, and a
+// store into a decoded page drops it. run() executes straight from that
+// cache with threaded dispatch: sequential instructions and branches that
+// stay in the page chain to the next op without a lookup. step() goes
+// through the same executor one instruction at a time and reports what the
+// instruction did. Memory written behind the ISS's back (anything but its
+// own stores or a reset()) needs flushDecoded().
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "memory.h"
+
+enum IssStatus : uint8_t {
+  kIssOk = 0,
+  kIssIllegal = 1,  // the instruction at pc was not executed
+  kIssWatch = 2,    // run() stopped after a store to the watched word
+};
+
+// What one retired instruction did, in the terms the DUT ports expose.
+struct IssStep {
+  uint32_t pc = 0;
+  uint32_t instr = 0;
+  uint32_t next_pc = 0;
+  bool writes_rd = false;     // rd != x0 was written with rd_value
+  bool rd_volatile = false;   // rd_value came from a timing-dependent counter
+  uint8_t rd = 0;
+  uint32_t rd_value = 0;
+  bool is_ctrl = false;       // branch, JAL or JALR
+  bool taken = false;         // always set for JAL and JALR
+  bool is_store = false;
+  uint8_t store_size = 0;     // 1, 2 or 4 bytes at store_addr
+  uint32_t store_addr = 0;
+  uint32_t store_data = 0;    // low store_size bytes
+  uint32_t store_word = 0;    // aligned word holding store_addr, after the store
+};
+
+class Iss {
+ public:
+  Iss(Memory& memory, int harts);
+  ~Iss();
+
+  // Starts every hart at pc with zeroed registers and counters, and drops
+  // the decoded-op cache.
+  void reset(uint32_t pc);
+  void flushDecoded();
+
+  // Executes the next instruction of a hart; on kIssIllegal out.pc and
+  // out.instr name the instruction and the hart does not advance.
+  IssStatus step(int hart, IssStep& out);
+
+  // Executes up to max_instrs instructions of a hart without reporting them.
+  // Stops early on kIssIllegal (pc left at the instruction) or, with a
+  // watch set, right after any store to the watched word (kIssWatch).
+  IssStatus run(int hart, uint64_t max_instrs, uint64_t& executed);
+  void setWatch(uint32_t addr);  // aligned word; 0 disables
+  void clearWatch() { setWatch(0); }
+
+  int harts() const { return static_cast<int>(harts_.size()); }
+  uint32_t pc(int hart) const { return harts_[hart].pc; }
+  uint32_t reg(int hart, int index) const { return harts_[hart].x[index]; }
+  // Overrides a register, e.g. to adopt a counter value read by the DUT.
+  void setReg(int hart, int index, uint32_t value);
+  uint64_t instret(int hart) const { return harts_[hart].instret; }
+
+ private:
+  struct DecodedOp;
+  struct DecodedPage;
+
+  static constexpr int kNumHpm = 3;  // mhpmcounter3..5
+  static constexpr uint32_t kNumPages = 1u << (32 - Memory::kPageBits);
+
+  struct Hart {
+    std::array<uint32_t, 32> x{};
+    uint32_t pc = 0;
+    uint64_t cycle = 0;
+    uint64_t instret = 0;
+    std::array<uint64_t, kNumHpm> hpm{};
+    uint32_t inhibit = 0;
+  };
+
+  template <bool kRecord>
+  IssStatus execute(int hart, uint64_t budget, IssStep* out, uint64_t& executed);
+
+  static DecodedOp decode(uint32_t instr);
+  // Decoded ops of the page holding pc, decoding it on first use.
+  const DecodedOp* decodedPage(uint32_t pc);
+  bool isCodePage(uint32_t page) const { return (code_pages_[page >> 6] >> (page & 63)) & 1; }
+  // Drops the decoded pages [addr, addr + size) touches; true if there were any.
+  bool invalidate(uint32_t addr, uint32_t size);
+
+  uint32_t load(uint32_t addr, uint32_t size) const;
+  // Returns true if the store dropped a decoded page.
+  bool store(uint32_t addr, uint32_t size, uint32_t data);
+  // Zicsr read-modify-write; sets volatile_read for the counter CSRs and
+  // written to the counter a write replaced.
+  uint32_t accessCsr(Hart& hart, int index, uint32_t instr, uint32_t operand,
+                     bool& volatile_read, const uint64_t*& written);
+
+  Memory& memory_;
+  std::vector<Hart> harts_;
+  std::unordered_map<uint32_t, std::unique_ptr<DecodedPage>> pages_;
+  std::vector<uint64_t> code_pages_;  // bit per page with decoded ops
+  uint32_t watch_ = kNoWatch;
+  static constexpr uint32_t kNoWatch = 1;  // never equal to an aligned word
+};
@@ -0,0 +1,135 @@
+// Standalone ISS runner: executes an ELF on the co-simulation ISS and writes
+// its signature, for golden signatures without Spike or a Verilated model.
+//
+//   iss_sim --elf <elf> --signature <path> [--max-instrs N] [--harts N]
+//
+// Harts start together at the reset vector and step round-robin, one
+// instruction each, until one of them writes a non-zero value to tohost.
+// Prints the same summary line and uses the same exit codes as the
+// Verilator harnesses; 7 means the ISS met an instruction it does not
+// implement.
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include "elf_loader.h"
+#include "iss.h"
+#include "memory.h"
+
+namespace {
+
+// Same memory window and reset vector as harness.h.
+constexpr uint32_t kMemBase = 0x80000000u;
+constexpr uint32_t kMemSize = 16 * 1024 * 1024;
+
+enum ExitCode : int {
+  kExitPass = 0,
+  kExitSetupError = 1,
+  kExitTimeout = 3,
+  kExitSignatureError = 4,
+  kExitTestFailed = 5,
+  kExitUnsupported = 7,
+};
+
+struct Options {
+  std::string elf;
+  std::string signature;
+  uint64_t max_instrs = 100'000'000;
+  int harts = 1;
+};
+
+Options parseArgs(int argc, char** argv) {
+  Options opts;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg(argv[i]);
+    if (arg == "--elf" && i + 1 < argc) {
+      opts.elf = argv[++i];
+    } else if (arg == "--signature" && i + 1 < argc) {
+      opts.signature = argv[++i];
+    } else if (arg == "--max-instrs" && i + 1 < argc) {
+      opts.max_instrs = std::stoull(argv[++i]);
+    } else if (arg == "--harts" && i + 1 < argc) {
+      opts.harts = std::stoi(argv[++i]);
+    } else {
+      throw std::invalid_argument("unknown or incomplete argument: " + arg);
+    }
+  }
+  if (opts.elf.empty() || opts.signature.empty()) {
+    throw std::invalid_argument("--elf and --signature are required");
+  }
+  if (opts.harts < 1 || opts.harts > 8) {
+    throw std::invalid_argument("--harts must be between 1 and 8");
+  }
+  return opts;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  try {
+    options = parseArgs(argc, argv);
+  } catch (const std::exception& e) {
+    std::cerr << "Argument error: " << e.what() << std::endl;
+    return kExitSetupError;
+  }
+
+  Memory memory(kMemBase, kMemSize);
+  ElfSymbols symbols;
+  try {
+    loadElfIntoMemory(options.elf, memory, symbols);
+  } catch (const std::exception& e) {
+    std::cerr << "ELF load failed: " << e.what() << std::endl;
+    return kExitSetupError;
+  }
+
+  // A lone hart runs in one batch from the decoded-op cache; several harts
+  // interleave one instruction at a time like the barrel cores.
+  Iss iss(memory, options.harts);
+  iss.reset(kMemBase);
+  iss.setWatch(symbols.tohost);
+  const uint64_t quantum = options.harts == 1 ? options.max_instrs : 1;
+  int status = kExitTimeout;
+  uint32_t tohost = 0;
+  uint64_t retired = 0;
+  while (status == kExitTimeout && retired < options.max_instrs) {
+    for (int hart = 0; hart < options.harts && status == kExitTimeout; ++hart) {
+      uint64_t executed = 0;
+      const IssStatus result =
+          iss.run(hart, std::min(quantum, options.max_instrs - retired), executed);
+      retired += executed;
+      if (result == kIssIllegal) {
+        std::cerr << "ISS stopped: hart " << hart << " unsupported instruction 0x" << std::hex
+                  << memory.read32(iss.pc(hart)) << " at pc 0x" << iss.pc(hart) << std::dec
+                  << std::endl;
+        status = kExitUnsupported;
+      } else if (result == kIssWatch && memory.read32(symbols.tohost) != 0) {
+        tohost = memory.read32(symbols.tohost);
+        status = kExitPass;
+      }
+    }
+  }
+
+  if (status == kExitTimeout) {
+    std::cerr << "Simulation terminated: max instructions reached" << std::endl;
+  } else if (status == kExitPass) {
+    if (tohost != 1) {
+      std::cerr << "Test reported failure, tohost=0x" << std::hex << tohost << std::dec
+                << std::endl;
+    }
+    try {
+      memory.dumpSignature(symbols.begin_signature, symbols.end_signature, options.signature);
+      status = tohost == 1 ? kExitPass : kExitTestFailed;
+    } catch (const std::exception& e) {
+      std::cerr << "Signature dump failed: " << e.what() << std::endl;
+      status = kExitSignatureError;
+    }
+  }
+
+  std::cout << "ISS: instret=" << retired << " tohost=0x" << std::hex << tohost << std::dec
+            << std::endl;
+  return status;
+}
@@ -0,0 +1,237 @@
+#include "mem_timing.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+uint32_t parseValue(const std::string& text, const std::string& what) {
+  size_t used = 0;
+  uint64_t value = 0;
+  try {
+    value = std::stoull(text, &used, 0);
+  } catch (const std::exception&) {
+    used = 0;
+  }
+  if (text.empty() || used != text.size() || value > UINT32_MAX) {
+    throw std::invalid_argument("bad " + what + ": " + text);
+  }
+  return static_cast<uint32_t>(value);
+}
+
+MemRegion parseRegion(std::istringstream& fields) {
+  MemRegion region;
+  std::string base;
+  std::string size;
+  if (!(fields >> region.name >> base >> size)) {
+    throw std::invalid_argument("region needs <name> <base> <size>");
+  }
+  region.base = parseValue(base, "region base");
+  region.size = parseValue(size, "region size");
+  std::string option;
+  while (fields >> option) {
+    const size_t eq = option.find('=');
+    const std::string key = option.substr(0, eq);
+    const std::string value = eq == std::string::npos ? "" : option.substr(eq + 1);
+    if (key == "latency") {
+      region.latency = parseValue(value, key);
+    } else if (key == "bytes_per_cycle") {
+      region.bytes_per_cycle = parseValue(value, key);
+    } else if (key == "banks") {
+      region.banks = parseValue(value, key);
+    } else if (key == "bank_bytes") {
+      region.bank_bytes = parseValue(value, key);
+    } else if (key == "bank_busy") {
+      region.bank_busy = parseValue(value, key);
+    } else {
+      throw std::invalid_argument("unknown region option: " + option);
+    }
+  }
+  if (region.size == 0 || region.banks == 0 || region.bank_bytes == 0) {
+    throw std::invalid_argument("region " + region.name + " needs non-zero size, banks and bank_bytes");
+  }
+  if (static_cast<uint64_t>(region.base) + region.size > (1ull << 32)) {
+    throw std::invalid_argument("region " + region.name + " extends past 4 GiB");
+  }
+  return region;
+}
+
+}  // namespace
+
+std::vector<MemRegion> loadMemConfig(const std::string& path) {
+  std::ifstream file(path);
+  if (!file.is_open()) {
+    throw std::runtime_error("cannot open memory config " + path);
+  }
+  std::vector<MemRegion> regions;
+  std::string line;
+  int number = 0;
+  while (std::getline(file, line)) {
+    ++number;
+    line = line.substr(0, line.find('#'));
+    std::istringstream fields(line);
+    std::string keyword;
+    if (!(fields >> keyword)) {
+      continue;
+    }
+    try {
+      if (keyword != "region") {
+        throw std::invalid_argument("expected 'region', got " + keyword);
+      }
+      regions.push_back(parseRegion(fields));
+    } catch (const std::invalid_argument& e) {
+      throw std::invalid_argument(path + ":" + std::to_string(number) + ": " + e.what());
+    }
+  }
+
+  std::vector<const MemRegion*> sorted;
+  for (const MemRegion& region : regions) {
+    sorted.push_back(&region);
+  }
+  std::sort(sorted.begin(), sorted.end(),
+            [](const MemRegion* a, const MemRegion* b) { return a->base < b->base; });
+  for (size_t i = 1; i < sorted.size(); ++i) {
+    if (static_cast<uint64_t>(sorted[i - 1]->base) + sorted[i - 1]->size > sorted[i]->base) {
+      throw std::invalid_argument(path + ": regions " + sorted[i - 1]->name + " and " +
+                                  sorted[i]->name + " overlap");
+    }
+  }
+  return regions;
+}
+
+MemTiming::MemTiming(std::vector<MemRegion> regions, int num_threads)
+    : thread_stalls_(num_threads, 0) {
+  for (MemRegion& config : regions) {
+    Region region;
+    region.bank_free.assign(config.banks, 0);
+    region.config = std::move(config);
+    regions_.push_back(std::move(region));
+  }
+}
+
+MemTiming::Region* MemTiming::find(uint32_t addr) {
+  for (Region& region : regions_) {
+    if (addr - region.config.base < region.config.size) {
+      return &region;
+    }
+  }
+  return nullptr;
+}
+
+uint64_t MemTiming::observe(const CycleAccesses& accesses) {
+  // Each thread has a timed clock: the simulated cycle pushed back by its own
+  // earlier stalls. A thread's accesses of one cycle issue together, so it
+  // waits for the slowest of them.
+  std::array<uint64_t, CycleAccesses::kMax> waits{};
+  std::array<Region*, CycleAccesses::kMax> blocking{};
+  for (int i = 0; i < accesses.count; ++i) {
+    const MemAccess& access = accesses.list[i];
+    if (access.thread >= thread_stalls_.size()) {
+      ++bad_thread_accesses_;
+      continue;
+    }
+    Region* region = find(access.addr);
+    if (region == nullptr) {
+      continue;
+    }
+    const MemRegion& config = region->config;
+    region->fetches += access.kind == kMemFetch ? 1 : 0;
+    region->loads += access.kind == kMemLoad ? 1 : 0;
+    region->stores += access.kind == kMemStore ? 1 : 0;
+    region->bytes += access.bytes;
+
+    const uint64_t now = cycles_ + thread_stalls_[access.thread];
+    uint64_t start = now;
+    uint64_t transfer = 1;
+    if (config.bytes_per_cycle != 0) {
+      transfer = (access.bytes + config.bytes_per_cycle - 1) / config.bytes_per_cycle;
+      transfer = std::max<uint64_t>(transfer, 1);
+      if (region->bus_free > start) {
+        region->bus_wait_cycles += region->bus_free - start;
+        start = region->bus_free;
+      }
+      region->bus_free = start + transfer;
+    }
+    if (config.bank_busy != 0) {
+      uint64_t& bank_free = region->bank_free[(access.addr / config.bank_bytes) % config.banks];
+      if (bank_free > start) {
+        ++region->bank_conflicts;
+        start = bank_free;
+      }
+      bank_free = start + config.bank_busy;
+    }
+    if (access.kind == kMemStore) {
+      continue;
+    }
+    // The core's own cycle covers the first transfer cycle.
+    waits[i] = start - now + config.latency + transfer - 1;
+    blocking[i] = region;
+  }
+
+  uint64_t stalls = stalls_;
+  for (int i = 0; i < accesses.count; ++i) {
+    if (blocking[i] == nullptr) {
+      continue;
+    }
+    // Charge each thread once, for its slowest access (the first on a tie).
+    const uint8_t thread = accesses.list[i].thread;
+    bool slowest = true;
+    for (int j = 0; j < accesses.count && slowest; ++j) {
+      slowest = j == i || blocking[j] == nullptr || accesses.list[j].thread != thread ||
+                waits[j] < waits[i] || (waits[j] == waits[i] && j > i);
+    }
+    if (slowest) {
+      blocking[i]->stall_cycles += waits[i];
+      thread_stalls_[thread] += waits[i];
+      stalls = std::max(stalls, thread_stalls_[thread]);
+    }
+  }
+  ++cycles_;
+  const uint64_t added = stalls - stalls_;
+  stalls_ = stalls;
+  return added;
+}
+
+void MemTiming::writeJson(const std::string& path, const std::string& core) const {
+  std::ofstream out(path);
+  if (!out.is_open()) {
+    throw std::runtime_error("failed to open memory stats: " + path);
+  }
+  out << "{\n";
+  out << "  \"core\": \"" << core << "\",\n";
+  out << "  \"cycles\": " << cycles_ << ",\n";
+  out << "  \"stall_cycles\": " << stalls_ << ",\n";
+  out << "  \"timed_cycles\": " << cycles_ + stalls_ << ",\n";
+  out << "  \"bad_thread_accesses\": " << bad_thread_accesses_ << ",\n";
+  out << "  \"slowdown\": ";
+  if (cycles_ == 0) {
+    out << "null";
+  } else {
+    out << static_cast<double>(cycles_ + stalls_) / static_cast<double>(cycles_);
+  }
+  if (thread_stalls_.size() > 1) {
+    out << ",\n  \"thread_stall_cycles\": [";
+    for (size_t t = 0; t < thread_stalls_.size(); ++t) {
+      out << (t == 0 ? "" : ", ") << thread_stalls_[t];
+    }
+    out << "]";
+  }
+  out << ",\n  \"regions\": [";
+  for (size_t i = 0; i < regions_.size(); ++i) {
+    const Region& r = regions_[i];
+    out << (i == 0 ? "\n" : ",\n");
+    out << "    {\"name\": \"" << r.config.name << "\", \"base\": " << r.config.base
+        << ", \"size\": " << r.config.size << ", \"fetches\": " << r.fetches
+        << ", \"loads\": " << r.loads << ", \"stores\": " << r.stores
+        << ", \"bytes\": " << r.bytes << ", \"stall_cycles\": " << r.stall_cycles
+        << ", \"bus_wait_cycles\": " << r.bus_wait_cycles
+        << ", \"bank_conflicts\": " << r.bank_conflicts << "}";
+  }
+  out << (regions_.empty() ? "]\n" : "\n  ]\n");
+  out << "}\n";
+  if (!out) {
+    throw std::runtime_error("failed to write memory stats: " + path);
+  }
+}
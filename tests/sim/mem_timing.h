@@ -0,0 +1,118 @@
+#pragma once
+
+// Memory timing model for the simulation harnesses (--mem-config).
+//
+// The cores read Memory combinationally, so the DUT always sees zero-latency
+// memory. MemTiming replays each cycle's fetches, loads and stores (reported
+// by Ports::memAccesses) against per-region latency, bandwidth and bank
+// limits, and accumulates the stall cycles a core blocking on every fetch and
+// load would have spent. The summary line reports the simulated cycles plus
+// those stalls as timed=; --mem-stats breaks them down per region.
+//
+// Each access names its hardware thread. A thread stalls only itself: on
+// the barrel cores the other threads keep their slots, so the core is late
+// by the stalls of its most-stalled thread. The bus and banks are shared.
+// This does not round a stall up to the thread's next slot, and it assumes
+// the slots a stalled thread cannot use are not given to another thread.
+//
+// The config file holds one region per line; '#' starts a comment:
+//
+//   region <name> <base> <size> [latency=N] [bytes_per_cycle=N]
+//          [banks=N] [bank_bytes=N] [bank_busy=N]
+//
+//   latency          cycles from issue to data beyond the core's own cycle
+//   bytes_per_cycle  bus width; an access occupies the bus for
+//                    ceil(bytes / bytes_per_cycle) cycles (0 = unlimited)
+//   banks            interleaved banks (default 1)
+//   bank_bytes       bytes per bank before the next bank starts (default 4)
+//   bank_busy        cycles a bank stays busy after each access
+//
+// Accesses outside every region are free. Stores are posted: they occupy
+// the bus and bank but never stall the core.
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+enum MemAccessKind : uint8_t {
+  kMemFetch = 0,
+  kMemLoad = 1,
+  kMemStore = 2,
+};
+
+struct MemAccess {
+  MemAccessKind kind = kMemFetch;
+  uint8_t thread = 0;
+  uint32_t addr = 0;
+  uint32_t bytes = 0;
+};
+
+// The accesses a core makes in one cycle.
+struct CycleAccesses {
+  static constexpr int kMax = 4;
+  std::array<MemAccess, kMax> list{};
+  int count = 0;
+
+  void add(MemAccessKind kind, uint32_t addr, uint32_t bytes, uint32_t thread = 0) {
+    if (count < kMax) {
+      list[count++] = {kind, static_cast<uint8_t>(thread), addr, bytes};
+    }
+  }
+};
+
+struct MemRegion {
+  std::string name;
+  uint32_t base = 0;
+  uint32_t size = 0;
+  uint32_t latency = 0;
+  uint32_t bytes_per_cycle = 0;
+  uint32_t banks = 1;
+  uint32_t bank_bytes = 4;
+  uint32_t bank_busy = 0;
+};
+
+// Parses a region config; throws std::invalid_argument on a malformed or
+// overlapping region and std::runtime_error if the file cannot be read.
+std::vector<MemRegion> loadMemConfig(const std::string& path);
+
+class MemTiming {
+ public:
+  // Accesses name threads below num_threads; one naming another thread (a bad
+  // or X-derived DUT field) is not timed and counts in badThreadAccesses().
+  explicit MemTiming(std::vector<MemRegion> regions, int num_threads = 1);
+
+  // Accounts one simulated cycle; returns the stall cycles it added to the
+  // core.
+  uint64_t observe(const CycleAccesses& accesses);
+
+  uint64_t cycles() const { return cycles_; }
+  // The core's stalls: those of its most-stalled thread.
+  uint64_t stallCycles() const { return stalls_; }
+  uint64_t badThreadAccesses() const { return bad_thread_accesses_; }
+
+  // Throws std::runtime_error if the file cannot be written.
+  void writeJson(const std::string& path, const std::string& core) const;
+
+ private:
+  struct Region {
+    MemRegion config;
+    uint64_t bus_free = 0;            // first timed cycle the bus is idle
+    std::vector<uint64_t> bank_free;  // same, per bank
+    uint64_t fetches = 0;
+    uint64_t loads = 0;
+    uint64_t stores = 0;
+    uint64_t bytes = 0;
+    uint64_t stall_cycles = 0;     // thread stalls this region's accesses set
+    uint64_t bus_wait_cycles = 0;  // access cycles spent waiting for the bus
+    uint64_t bank_conflicts = 0;   // accesses that found their bank busy
+  };
+
+  Region* find(uint32_t addr);
+
+  std::vector<Region> regions_;
+  std::vector<uint64_t> thread_stalls_;
+  uint64_t cycles_ = 0;
+  uint64_t stalls_ = 0;
+  uint64_t bad_thread_accesses_ = 0;
+};
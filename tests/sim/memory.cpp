@@ -1,21 +1,36 @@
 #include "memory.h"
 
+#include <algorithm>
+#include <cstring>
 #include <fstream>
 #include <iomanip>
 #include <stdexcept>
 
 Memory::Memory(uint32_t base_addr, uint32_t size_bytes)
-    : base_(base_addr), size_(size_bytes) {}
+    : base_(base_addr),
+      size_(size_bytes),
+      pages_((static_cast<uint64_t>(size_bytes) + kPageMask) >> kPageBits) {}
+
+uint8_t* Memory::allocatePage(uint32_t index) {
+  pages_[index] = Page(new uint8_t[kPageSize]());
+  return pages_[index].get();
+}
 
 uint8_t Memory::read8(uint32_t addr) const {
-  auto it = data_.find(addr);
-  if (it == data_.end()) {
+  if (const uint8_t* page = pageFor(addr)) {
+    return page[(addr - base_) & kPageMask];
+  }
+  if (addr - base_ < size_) {
+    return 0;
+  }
+  auto it = overflow_.find(addr);
+  if (it == overflow_.end()) {
     return 0;
   }
   return it->second;
 }
 
-uint32_t Memory::read32(uint32_t addr) const {
+uint32_t Memory::read32Slow(uint32_t addr) const {
   uint32_t value = 0;
   for (int i = 0; i < 4; ++i) {
     value |= static_cast<uint32_t>(read8(addr + i)) << (8 * i);
@@ -24,15 +39,61 @@ uint32_t Memory::read32(uint32_t addr) const {
 }
 
 void Memory::write8(uint32_t addr, uint8_t data) {
-  data_[addr] = data;
+  const uint32_t offset = addr - base_;
+  if (offset < size_) {
+    pageForWrite(addr)[offset & kPageMask] = data;
+    return;
+  }
+  overflow_[addr] = data;
 }
 
-void Memory::write32(uint32_t addr, uint32_t data) {
+void Memory::write32Slow(uint32_t addr, uint32_t data) {
   for (int i = 0; i < 4; ++i) {
     write8(addr + i, static_cast<uint8_t>((data >> (8 * i)) & 0xFFu));
   }
 }
 
+void Memory::writeBlock(uint32_t addr, const uint8_t* data, size_t len) {
+  while (len > 0) {
+    const uint32_t offset = addr - base_;
+    if (offset >= size_) {
+      write8(addr++, *data++);
+      --len;
+      continue;
+    }
+    const size_t chunk = std::min<size_t>({len, kPageSize - (offset & kPageMask), size_ - offset});
+    std::memcpy(pageForWrite(addr) + (offset & kPageMask), data, chunk);
+    addr += static_cast<uint32_t>(chunk);
+    data += chunk;
+    len -= chunk;
+  }
+}
+
+void Memory::fill(uint32_t addr, uint8_t value, size_t len) {
+  while (len > 0) {
+    const uint32_t offset = addr - base_;
+    if (offset >= size_) {
+      write8(addr++, value);
+      --len;
+      continue;
+    }
+    const size_t chunk = std::min<size_t>({len, kPageSize - (offset & kPageMask), size_ - offset});
+    // Fresh pages are already zeroed, so zero fills never allocate.
+    if (value != 0 || pages_[offset >> kPageBits] != nullptr) {
+      std::memset(pageForWrite(addr) + (offset & kPageMask), value, chunk);
+    }
+    addr += static_cast<uint32_t>(chunk);
+    len -= chunk;
+  }
+}
+
+void Memory::clear() {
+  for (auto& page : pages_) {
+    page.reset();
+  }
+  overflow_.clear();
+}
+
 void Memory::dumpSignature(uint32_t begin, uint32_t end, const std::string& path) const {
   if (end <= begin) {
     throw std::runtime_error("invalid signature bounds");
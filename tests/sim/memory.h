@@ -1,23 +1,129 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
+// Sparse byte-addressable memory for the simulation harnesses.
+//
+// The [base, base + size) window is backed by 4 KiB pages allocated on first
+// write and indexed through a flat page table, so aligned word accesses are a
+// single table lookup. Bytes outside the window fall back to a sparse map.
+// Unwritten locations read as zero.
 class Memory {
  public:
+  static constexpr uint32_t kPageBits = 12;
+  static constexpr uint32_t kPageSize = 1u << kPageBits;
+  static constexpr uint32_t kPageMask = kPageSize - 1;
+
   Memory(uint32_t base_addr, uint32_t size_bytes);
 
   uint8_t read8(uint32_t addr) const;
-  uint32_t read32(uint32_t addr) const;
+  inline uint32_t read32(uint32_t addr) const;
 
   void write8(uint32_t addr, uint8_t data);
-  void write32(uint32_t addr, uint32_t data);
+  inline void write32(uint32_t addr, uint32_t data);
+  // Byte-enable store; bit i of mask writes byte i of data.
+  inline void writeMasked(uint32_t addr, uint32_t data, uint32_t mask);
+
+  // Bulk helpers used by the ELF loader; both walk whole pages at a time.
+  void writeBlock(uint32_t addr, const uint8_t* data, size_t len);
+  void fill(uint32_t addr, uint8_t value, size_t len);
+
+  // Drops every page so the next program starts from all-zero memory.
+  void clear();
+
+  // Visits each allocated page as (base address, kPageSize bytes) and each
+  // byte held outside the window as (address, value); used for checkpoints.
+  template <typename PageFn, typename ByteFn>
+  void forEachAllocated(PageFn&& page_fn, ByteFn&& byte_fn) const;
 
   void dumpSignature(uint32_t begin, uint32_t end, const std::string& path) const;
 
  private:
+  using Page = std::unique_ptr<uint8_t[]>;
+
+  inline const uint8_t* pageFor(uint32_t addr) const;
+  inline uint8_t* pageForWrite(uint32_t addr);
+  uint8_t* allocatePage(uint32_t index);
+
+  uint32_t read32Slow(uint32_t addr) const;
+  void write32Slow(uint32_t addr, uint32_t data);
+
   uint32_t base_;
   uint32_t size_;
-  std::unordered_map<uint32_t, uint8_t> data_;
+  std::vector<Page> pages_;
+  std::unordered_map<uint32_t, uint8_t> overflow_;
 };
+
+inline const uint8_t* Memory::pageFor(uint32_t addr) const {
+  const uint32_t offset = addr - base_;
+  if (offset >= size_) {
+    return nullptr;
+  }
+  return pages_[offset >> kPageBits].get();
+}
+
+inline uint8_t* Memory::pageForWrite(uint32_t addr) {
+  const uint32_t index = (addr - base_) >> kPageBits;
+  uint8_t* page = pages_[index].get();
+  return page != nullptr ? page : allocatePage(index);
+}
+
+inline uint32_t Memory::read32(uint32_t addr) const {
+  if ((addr & 0x3u) == 0) {
+    const uint32_t offset = addr - base_;
+    if (offset < size_) {
+      const uint8_t* page = pages_[offset >> kPageBits].get();
+      if (page == nullptr) {
+        return 0;
+      }
+      const uint8_t* p = page + (offset & kPageMask);
+      return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+             (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+    }
+  }
+  return read32Slow(addr);
+}
+
+inline void Memory::write32(uint32_t addr, uint32_t data) {
+  if ((addr & 0x3u) == 0) {
+    const uint32_t offset = addr - base_;
+    if (offset < size_) {
+      uint8_t* p = pageForWrite(addr) + (offset & kPageMask);
+      p[0] = static_cast<uint8_t>(data);
+      p[1] = static_cast<uint8_t>(data >> 8);
+      p[2] = static_cast<uint8_t>(data >> 16);
+      p[3] = static_cast<uint8_t>(data >> 24);
+      return;
+    }
+  }
+  write32Slow(addr, data);
+}
+
+inline void Memory::writeMasked(uint32_t addr, uint32_t data, uint32_t mask) {
+  if ((mask & 0xFu) == 0xFu) {
+    write32(addr, data);
+    return;
+  }
+  for (int byte = 0; byte < 4; ++byte) {
+    if ((mask >> byte) & 0x1u) {
+      write8(addr + byte, static_cast<uint8_t>((data >> (8 * byte)) & 0xFFu));
+    }
+  }
+}
+
+template <typename PageFn, typename ByteFn>
+void Memory::forEachAllocated(PageFn&& page_fn, ByteFn&& byte_fn) const {
+  for (size_t index = 0; index < pages_.size(); ++index) {
+    if (pages_[index]) {
+      page_fn(base_ + static_cast<uint32_t>(index << kPageBits), pages_[index].get());
+    }
+  }
+  for (const auto& entry : overflow_) {
+    byte_fn(entry.first, entry.second);
+  }
+}
@@ -0,0 +1,263 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <ostream>
+
+#include "VOctoNyteRV32ICore.h"
+#include "harness.h"
+
+// Port adapter for the eight-thread OctoNyte barrel core: the core names the
+// thread owning each fetch slot (io_fetchThread, registered, so valid before
+// eval) and the harness feeds it from its model of the thread PCs.
+struct OctoNytePorts {
+  using Model = VOctoNyteRV32ICore;
+  static constexpr const char* kName = "OctoNyte";
+  static constexpr int kNumThreads = 8;
+  static constexpr uint32_t kFetchWidth = 4;  // io_instrMem lanes
+
+  struct State {
+    State() { thread_pcs.fill(harness::kMemBase); }
+    std::array<uint32_t, kNumThreads> thread_pcs{};
+    uint32_t stageFetchThread = 0;
+    bool stageFetchValid = false;
+    uint32_t scheduledFetchThread = 0;
+    bool scheduledFetchValid = false;  // the scheduler gave the slot to a thread
+    bool scheduledFetchEnabled = false;
+    uint32_t scheduledFetchAddr = harness::kMemBase;
+    uint32_t scheduledInstr = harness::kNopInstr;
+  };
+
+  template <typename Mem>
+  static void drive(Model& dut, State& state, Mem& memory, const harness::Options& options) {
+    dut.io_threadEnable_0 = (options.thread_mask >> 0) & 0x1;
+    dut.io_threadEnable_1 = (options.thread_mask >> 1) & 0x1;
+    dut.io_threadEnable_2 = (options.thread_mask >> 2) & 0x1;
+    dut.io_threadEnable_3 = (options.thread_mask >> 3) & 0x1;
+    dut.io_threadEnable_4 = (options.thread_mask >> 4) & 0x1;
+    dut.io_threadEnable_5 = (options.thread_mask >> 5) & 0x1;
+    dut.io_threadEnable_6 = (options.thread_mask >> 6) & 0x1;
+    dut.io_threadEnable_7 = (options.thread_mask >> 7) & 0x1;
+
+    state.stageFetchThread = dut.io_debugStageThreads_0 & 0x7;
+    state.stageFetchValid = dut.io_debugStageValids_0;
+
+    state.scheduledFetchThread = dut.io_fetchThread & 0x7;
+    state.scheduledFetchValid = dut.io_fetchValid;
+    state.scheduledFetchEnabled =
+        dut.io_fetchValid && ((options.thread_mask >> state.scheduledFetchThread) & 0x1) != 0;
+    state.scheduledFetchAddr = state.thread_pcs[state.scheduledFetchThread];
+    state.scheduledInstr =
+        state.scheduledFetchEnabled ? memory.read32(state.scheduledFetchAddr) : harness::kNopInstr;
+
+    // The packet holds the thread's next kFetchWidth sequential words; the
+    // core keeps the ones after slot 0 in its fetch buffer.
+    dut.io_instrMem[0U] = state.scheduledInstr;
+    for (uint32_t lane = 1; lane < kFetchWidth; ++lane) {
+      dut.io_instrMem[lane] = state.scheduledFetchEnabled
+                                  ? memory.read32(state.scheduledFetchAddr + 4 * lane)
+                                  : harness::kNopInstr;
+    }
+
+    dut.io_dataMemResp = memory.read32(dut.io_memAddr);
+  }
+
+  static void capture(Model& dut, State& state) {
+    state.thread_pcs[0] = dut.io_debugPC_0;
+    state.thread_pcs[1] = dut.io_debugPC_1;
+    state.thread_pcs[2] = dut.io_debugPC_2;
+    state.thread_pcs[3] = dut.io_debugPC_3;
+    state.thread_pcs[4] = dut.io_debugPC_4;
+    state.thread_pcs[5] = dut.io_debugPC_5;
+    state.thread_pcs[6] = dut.io_debugPC_6;
+    state.thread_pcs[7] = dut.io_debugPC_7;
+  }
+
+  static void endResetCycle(State&) {}
+
+  static void endCycle(State&) {}
+
+  static harness::MemWrite memWrite(const Model& dut) {
+    return {dut.io_memMask != 0, dut.io_memAddr, dut.io_memWrite, dut.io_memMask};
+  }
+
+  static void logResetCycle(std::ostream&, const Model&, const State&) {}
+
+  static void logCycle(std::ostream& log, const Model& dut, const State& state, uint64_t cycle,
+                       const harness::MemWrite& write, const harness::Options&, const ElfSymbols&) {
+    log << std::hex
+        << "cycle=0x" << cycle
+        << " schedThread=0x" << state.scheduledFetchThread
+        << " schedEn=" << static_cast<unsigned>(state.scheduledFetchEnabled)
+        << " schedAddr=0x" << state.scheduledFetchAddr
+        << " schedInstr=0x" << state.scheduledInstr
+        << " stageThread=0x" << state.stageFetchThread
+        << " stageValid=" << state.stageFetchValid
+        << " pc0=0x" << state.thread_pcs[0]
+        << " pc1=0x" << state.thread_pcs[1]
+        << " pc2=0x" << state.thread_pcs[2]
+        << " pc3=0x" << state.thread_pcs[3]
+        << " pc4=0x" << state.thread_pcs[4]
+        << " pc5=0x" << state.thread_pcs[5]
+        << " pc6=0x" << state.thread_pcs[6]
+        << " pc7=0x" << state.thread_pcs[7]
+        << " memAddr=0x" << write.addr
+        << " memMask=0x" << write.mask
+        << std::dec << '\n';
+
+    if (dut.io_debugExecValid &&
+        (dut.io_debugExecIsBranch || dut.io_debugExecIsJal || dut.io_debugExecIsJalr)) {
+      log << std::hex << "exec1: thread=0x" << static_cast<unsigned>(dut.io_debugExecThread)
+          << " pc=0x" << dut.io_debugExecPC
+          << " instr=0x" << dut.io_debugExecInstr
+          << " rs1=0x" << dut.io_debugExecRs1
+          << " rs2=0x" << dut.io_debugExecRs2
+          << " op=0x" << static_cast<unsigned>(dut.io_debugExecBranchOp)
+          << " taken=" << static_cast<unsigned>(dut.io_debugExecCtrlTaken)
+          << " target=0x" << dut.io_debugExecCtrlTarget
+          << " branch=" << static_cast<unsigned>(dut.io_debugExecIsBranch)
+          << " jal=" << static_cast<unsigned>(dut.io_debugExecIsJal)
+          << " jalr=" << static_cast<unsigned>(dut.io_debugExecIsJalr)
+          << std::dec << '\n';
+    }
+
+    if (dut.io_debugCtrlValid &&
+        (dut.io_debugCtrlIsBranch || dut.io_debugCtrlIsJal || dut.io_debugCtrlIsJalr)) {
+      log << std::hex << "wb: thread=0x" << static_cast<unsigned>(dut.io_debugCtrlThread)
+          << " from=0x" << dut.io_debugCtrlFromPC
+          << " instr=0x" << dut.io_debugCtrlInstr
+          << " taken=" << static_cast<unsigned>(dut.io_debugCtrlTaken)
+          << " target=0x" << dut.io_debugCtrlTarget
+          << " branch=" << static_cast<unsigned>(dut.io_debugCtrlIsBranch)
+          << " jal=" << static_cast<unsigned>(dut.io_debugCtrlIsJal)
+          << " jalr=" << static_cast<unsigned>(dut.io_debugCtrlIsJalr)
+          << std::dec << '\n';
+    }
+  }
+
+  static void traceCycle(TraceWriter& trace, const Model& dut, const State& state, uint64_t cycle,
+                         const harness::MemWrite& write) {
+    TraceRecord record{};
+    record.kind = kTraceCycle;
+    record.thread = static_cast<uint8_t>(state.scheduledFetchThread);
+    record.pc = state.scheduledFetchAddr;
+    record.instr = state.scheduledInstr;
+    record.flags = state.scheduledFetchEnabled ? kTraceFetchEnabled : 0;
+    record.addr = write.addr;
+    record.data = write.data;
+    record.mask = static_cast<uint8_t>(write.mask);
+    trace.append(cycle, record);
+
+    if (dut.io_debugExecValid &&
+        (dut.io_debugExecIsBranch || dut.io_debugExecIsJal || dut.io_debugExecIsJalr)) {
+      TraceRecord exec{};
+      exec.kind = kTraceExec;
+      exec.thread = static_cast<uint8_t>(dut.io_debugExecThread);
+      exec.pc = dut.io_debugExecPC;
+      exec.instr = dut.io_debugExecInstr;
+      exec.addr = dut.io_debugExecRs1;
+      exec.data = dut.io_debugExecRs2;
+      exec.aux = dut.io_debugExecBranchOp;
+      exec.target = dut.io_debugExecCtrlTarget;
+      exec.flags = traceCtrlFlags(dut.io_debugExecCtrlTaken, dut.io_debugExecIsBranch,
+                                  dut.io_debugExecIsJal, dut.io_debugExecIsJalr);
+      trace.append(cycle, exec);
+    }
+
+    if (dut.io_debugCtrlValid &&
+        (dut.io_debugCtrlIsBranch || dut.io_debugCtrlIsJal || dut.io_debugCtrlIsJalr)) {
+      TraceRecord wb{};
+      wb.kind = kTraceWriteback;
+      wb.thread = static_cast<uint8_t>(dut.io_debugCtrlThread);
+      wb.pc = dut.io_debugCtrlFromPC;
+      wb.instr = dut.io_debugCtrlInstr;
+      wb.target = dut.io_debugCtrlTarget;
+      wb.flags = traceCtrlFlags(dut.io_debugCtrlTaken, dut.io_debugCtrlIsBranch,
+                                dut.io_debugCtrlIsJal, dut.io_debugCtrlIsJalr);
+      trace.append(cycle, wb);
+    }
+  }
+
+  // Fetch slot plus the execute-stage operands, which carry the values any
+  // loop-exit branch depends on.
+  static uint64_t idleSample(const Model& dut, const State& state) {
+    uint64_t h = idleMix(state.scheduledFetchThread, state.scheduledFetchAddr);
+    h = idleMix(h, state.scheduledInstr);
+    h = idleMix(h, dut.io_debugExecPC);
+    h = idleMix(h, dut.io_debugExecRs1);
+    h = idleMix(h, dut.io_debugExecRs2);
+    return idleMix(h, dut.io_memAddr);
+  }
+
+  static bool fetchesPc(const Model&, const State& state, uint32_t pc) {
+    return state.scheduledFetchEnabled && state.scheduledFetchAddr == pc;
+  }
+
+  // Stage 0 shows the fetch that survived this cycle (a redirect clears it)
+  // and stage 7 is writeback.
+  static constexpr bool kObservesRetire = true;
+  static constexpr bool kHasFetchBuffer = true;
+
+  static void countCycle(PerfCounters& perf, const Model& dut, const State& state,
+                         const harness::MemWrite& write) {
+    // io_fetchThread is stale when the scheduler handed the slot to nobody.
+    if (!state.scheduledFetchValid) {
+      ++perf.unowned_slots;
+    } else {
+      ThreadPerf& slot = perf.threads[state.scheduledFetchThread];
+      ++slot.slots;
+      if (!state.scheduledFetchEnabled) {
+        ++slot.disabled;
+      }
+    }
+    if (dut.io_debugStageValids_0) {
+      ++perf.threads[dut.io_debugStageThreads_0 & 0x7].issued;
+    }
+    if (dut.io_debugStageValids_7) {
+      ++perf.threads[dut.io_debugStageThreads_7 & 0x7].retired;
+    }
+    if (dut.io_debugCtrlValid && dut.io_debugCtrlTaken) {
+      ++perf.threads[dut.io_debugCtrlThread & 0x7].redirects;
+    }
+    perf.fetch_reads += dut.io_fetchReq ? 1 : 0;
+    perf.fetch_buffer_hits += dut.io_fetchBufferHit ? 1 : 0;
+    if (write.valid) {
+      ++perf.stores;
+    } else if (dut.io_memValid) {
+      ++perf.loads;
+    }
+  }
+
+  // A packet read fetches all kFetchWidth lanes; buffer hits stay in the core.
+  // Loads and stores issue in EX1 from the register-read stage's instruction.
+  static void memAccesses(CycleAccesses& accesses, const Model& dut, const State& state,
+                          const harness::MemWrite& write) {
+    if (state.scheduledFetchEnabled && dut.io_fetchReq) {
+      accesses.add(kMemFetch, state.scheduledFetchAddr, 4 * kFetchWidth,
+                   state.scheduledFetchThread);
+    }
+    const uint32_t mem_thread = dut.io_debugStageThreads_3 & 0x7;
+    if (write.valid) {
+      accesses.add(kMemStore, write.addr, 4, mem_thread);
+    } else if (dut.io_memValid) {
+      accesses.add(kMemLoad, dut.io_memAddr, 4, mem_thread);
+    }
+  }
+
+  // Writeback reports every branch and jump with its outcome.
+  static constexpr uint32_t kCommitKinds = kCommitControl | kCommitStore;
+
+  static void commits(CoSim& cosim, const Model& dut, const State&,
+                      const harness::MemWrite& write) {
+    if (dut.io_debugCtrlValid &&
+        (dut.io_debugCtrlIsBranch || dut.io_debugCtrlIsJal || dut.io_debugCtrlIsJalr)) {
+      cosim.control(dut.io_debugCtrlThread & 0x7, dut.io_debugCtrlFromPC, dut.io_debugCtrlTaken,
+                    dut.io_debugCtrlTarget);
+    }
+    if (write.valid) {
+      cosim.store(write.addr, write.data, write.mask);
+    }
+  }
+
+  static constexpr bool kHasICache = false;
+};
@@ -0,0 +1,148 @@
+#include "perf_counters.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+uint64_t totalRetired(const PerfCounters& counters, int num_threads) {
+  uint64_t retired = 0;
+  for (int t = 0; t < num_threads; ++t) {
+    retired += counters.threads[t].retired;
+  }
+  return retired;
+}
+
+void writeRatio(std::ostream& out, uint64_t num, uint64_t den) {
+  if (den == 0) {
+    out << "null";
+  } else {
+    out << static_cast<double>(num) / static_cast<double>(den);
+  }
+}
+
+void writeRetired(std::ostream& out, const PerfReport& report, uint64_t retired) {
+  if (report.observes_retire) {
+    out << retired;
+  } else {
+    out << "null";
+  }
+}
+
+void writeIpc(std::ostream& out, const PerfReport& report, uint64_t retired, uint64_t cycles) {
+  if (report.observes_retire) {
+    writeRatio(out, retired, cycles);
+  } else {
+    out << "null";
+  }
+}
+
+}  // namespace
+
+void writePerfJson(const std::string& path, const PerfReport& report, const PerfCounters& total,
+                   const std::vector<PerfCounters>& intervals) {
+  std::ostringstream out;
+  const int threads = report.num_threads;
+  uint64_t slots = total.unowned_slots;
+  uint64_t disabled = 0;
+  uint64_t issued = 0;
+  for (int t = 0; t < threads; ++t) {
+    slots += total.threads[t].slots;
+    disabled += total.threads[t].disabled;
+    issued += total.threads[t].issued;
+  }
+  const uint64_t retired = totalRetired(total, threads);
+
+  out << "{\n";
+  out << "  \"core\": \"" << report.core << "\",\n";
+  out << "  \"thread_mask\": " << report.thread_mask << ",\n";
+  out << "  \"start_cycle\": " << report.start_cycle << ",\n";
+  out << "  \"cycles\": " << total.cycles << ",\n";
+  out << "  \"slots\": " << slots << ",\n";
+  out << "  \"unowned_slots\": " << total.unowned_slots << ",\n";
+  out << "  \"issued\": " << issued << ",\n";
+  out << "  \"retired\": ";
+  writeRetired(out, report, retired);
+  out << ",\n  \"ipc\": ";
+  writeIpc(out, report, retired, total.cycles);
+  out << ",\n  \"empty_slot_share\": ";
+  writeRatio(out, slots - issued, slots);
+  out << ",\n  \"disabled_slot_share\": ";
+  writeRatio(out, disabled, slots);
+  out << ",\n  \"loads\": " << total.loads << ",\n";
+  out << "  \"stores\": " << total.stores << ",\n";
+  if (report.has_fetch_buffer) {
+    out << "  \"fetch_reads\": " << total.fetch_reads << ",\n";
+    out << "  \"fetch_buffer_hits\": " << total.fetch_buffer_hits << ",\n";
+    out << "  \"fetch_buffer_reuse\": ";
+    writeRatio(out, total.fetch_buffer_hits, total.fetch_reads + total.fetch_buffer_hits);
+    out << ",\n";
+  }
+
+  out << "  \"threads\": [";
+  for (int t = 0; t < threads; ++t) {
+    const ThreadPerf& p = total.threads[t];
+    out << (t == 0 ? "\n" : ",\n");
+    out << "    {\"thread\": " << t
+        << ", \"enabled\": " << (((report.thread_mask >> t) & 0x1) ? "true" : "false")
+        << ", \"slots\": " << p.slots
+        << ", \"disabled\": " << p.disabled
+        << ", \"issued\": " << p.issued
+        << ", \"retired\": ";
+    writeRetired(out, report, p.retired);
+    // Issued but never retired: killed by a redirect or still in flight.
+    out << ", \"squashed\": ";
+    if (report.observes_retire && p.issued >= p.retired) {
+      out << p.issued - p.retired;
+    } else {
+      out << "null";
+    }
+    out << ", \"redirects\": " << p.redirects << ", \"ipc\": ";
+    writeIpc(out, report, p.retired, total.cycles);
+    out << "}";
+  }
+  out << "\n  ],\n";
+
+  out << "  \"intervals\": [";
+  PerfCounters previous{};
+  for (size_t i = 0; i < intervals.size(); ++i) {
+    out << (i == 0 ? "\n    " : ",\n    ");
+    writePerfInterval(out, report, previous, intervals[i]);
+    previous = intervals[i];
+  }
+  out << (intervals.empty() ? "]\n" : "\n  ]\n");
+  out << "}\n";
+
+  // Written through a temporary so a reader never sees a partial file.
+  const std::string tmp = path + ".tmp";
+  {
+    std::ofstream file(tmp);
+    if (!file.is_open()) {
+      throw std::runtime_error("failed to open perf report: " + path);
+    }
+    file << out.str();
+    file.close();
+    if (!file) {
+      std::remove(tmp.c_str());
+      throw std::runtime_error("failed to write perf report: " + path);
+    }
+  }
+  if (std::rename(tmp.c_str(), path.c_str()) != 0) {
+    throw std::runtime_error("failed to write perf report: " + path);
+  }
+}
+
+void writePerfInterval(std::ostream& out, const PerfReport& report, const PerfCounters& previous,
+                       const PerfCounters& snap) {
+  const int threads = report.num_threads;
+  const uint64_t cycles = snap.cycles - previous.cycles;
+  const uint64_t delta = totalRetired(snap, threads) - totalRetired(previous, threads);
+  out << "{\"cycle\": " << report.start_cycle + snap.cycles << ", \"cycles\": " << cycles
+      << ", \"retired\": ";
+  writeRetired(out, report, delta);
+  out << ", \"ipc\": ";
+  writeIpc(out, report, delta, cycles);
+  out << "}";
+}
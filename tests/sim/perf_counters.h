@@ -0,0 +1,66 @@
+#pragma once
+
+// Performance counters for the simulation harnesses.
+//
+// Port adapters classify every cycle's fetch slot and retirement from the
+// debug ports (Ports::countCycle); the harness snapshots the counters every
+// --perf-interval cycles and writes them as JSON with --perf-json at exit.
+// Each snapshot is also appended to <perf-json>.intervals, one JSON line per
+// interval, as it is taken, so a long run can be watched while it goes.
+//
+// Per thread:
+//   slots      fetch slots the barrel scheduler gave the thread
+//   disabled   slots left empty because the thread is masked off
+//   issued     slots that fetched an instruction which survived the cycle
+//   retired    instructions that reached writeback (if the core exposes it)
+//   redirects  taken branches and jumps
+//
+// Fetch slots the scheduler gave to no thread (OctoNyte's dynamic schedule
+// with no thread ready) are counted once, as unowned_slots, and not charged
+// to any thread. Cores with a fetch buffer also count, over all threads, the
+// fetches that read instruction memory and those the buffer served.
+
+#include <array>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+constexpr int kPerfMaxThreads = 8;
+
+struct ThreadPerf {
+  uint64_t slots = 0;
+  uint64_t disabled = 0;
+  uint64_t issued = 0;
+  uint64_t retired = 0;
+  uint64_t redirects = 0;
+};
+
+struct PerfCounters {
+  uint64_t cycles = 0;
+  uint64_t unowned_slots = 0;
+  uint64_t loads = 0;
+  uint64_t stores = 0;
+  uint64_t fetch_reads = 0;
+  uint64_t fetch_buffer_hits = 0;
+  std::array<ThreadPerf, kPerfMaxThreads> threads{};
+};
+
+struct PerfReport {
+  std::string core;
+  int num_threads = 1;
+  uint32_t thread_mask = 0x1;
+  bool observes_retire = true;    // false: retired/ipc are reported as null
+  bool has_fetch_buffer = false;  // true: report fetch_reads/fetch_buffer_hits
+  uint64_t start_cycle = 0;       // cycle the counters started at (after a restore)
+};
+
+// Writes the final counters and the per-interval snapshots; throws
+// std::runtime_error if the file cannot be written.
+void writePerfJson(const std::string& path, const PerfReport& report, const PerfCounters& total,
+                   const std::vector<PerfCounters>& intervals);
+
+// Writes the interval between snapshots previous and snap as one JSON object
+// without a newline (the form of the "intervals" entries of writePerfJson).
+void writePerfInterval(std::ostream& out, const PerfReport& report, const PerfCounters& previous,
+                       const PerfCounters& snap);
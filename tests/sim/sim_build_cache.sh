@@ -0,0 +1,132 @@
+# Content-hashed build cache for the build_*_sim.sh scripts.
+#
+# Source after sim_build_profile.sh. Verilated models live under
+# $BUILD_DIR/cache/<sim>/<key>, where the key hashes the generated Verilog,
+# the Verilator version and every Verilator/compiler flag. An unchanged model
+# is never re-Verilated: Verilator skips identical inputs and make only
+# recompiles and relinks the harness sources that changed. A second stamp
+# covering the harness sources lets a fully up-to-date build return at once.
+#
+#   SIM_CACHE_KEEP   models kept per simulator (default 4)
+#   SIM_CCACHE       set to 0 to not route C++ compiles through ccache
+#   SIM_NO_CACHE     set to 1 to force a from-scratch build
+
+sim_sha256() {
+  if command -v sha256sum >/dev/null 2>&1; then
+    sha256sum | cut -d' ' -f1
+  else
+    shasum -a 256 | cut -d' ' -f1
+  fi
+}
+
+# Hashes the names and contents of the given files, in sorted order.
+sim_hash_files() {
+  local f
+  for f in $(printf '%s\n' "$@" | LC_ALL=C sort); do
+    printf '%s\n' "$f"
+    sim_sha256 <"$f"
+  done | sim_sha256
+}
+
+# Hashes every .scala file under the given directories and the generators,
+# plus rtl/build.sbt.
+sim_hash_rtl_sources() {
+  local files
+  mapfile -t files < <(find "$@" rtl/generators -type f -name '*.scala' 2>/dev/null)
+  sim_hash_files "${files[@]}" "rtl/build.sbt"
+}
+
+# Returns success if the Verilog must be regenerated. The Verilog carries a
+# .srchash stamp of the Scala sources that produced it, so touching a file
+# without changing it (checkouts, rebases) no longer triggers regeneration.
+# The stamp does not cover design parameters: the default output root only
+# ever holds default-parameter Verilog, as GenerateHierarchicalRTL refuses
+# --param there.
+sim_rtl_needs_regen() {
+  local verilog_top="$1"
+  shift
+  local stamp="$verilog_top.srchash"
+  [[ -f "$verilog_top" ]] || return 0
+  if [[ ! -f "$stamp" ]]; then
+    # No stamp yet: fall back to timestamps once, then record the hash.
+    if [[ -n "$(find "$@" -type f -name '*.scala' -newer "$verilog_top" -print -quit)" ]]; then
+      return 0
+    fi
+    sim_hash_rtl_sources "$@" >"$stamp"
+    return 1
+  fi
+  [[ "$(cat "$stamp")" != "$(sim_hash_rtl_sources "$@")" ]]
+}
+
+sim_rtl_record_sources() {
+  local verilog_top="$1"
+  shift
+  sim_hash_rtl_sources "$@" >"$verilog_top.srchash"
+}
+
+# Picks OBJ_DIR for the model described by the Verilog file and the remaining
+# arguments (flags), and sets SIM_CACHE_HIT when that model was built before.
+sim_cache_select_obj_dir() {
+  local sim_name="$1"
+  local verilog_top="$2"
+  shift 2
+  local key
+  key=$({
+    sim_sha256 <"$verilog_top"
+    verilator --version
+    printf '%s\n' "$@" "$PROFILE_CFLAGS" "$PROFILE_LDFLAGS"
+    if [[ ${#PROFILE_INPUTS[@]} -gt 0 ]]; then
+      cat "${PROFILE_INPUTS[@]}"
+    fi
+  } | sim_sha256)
+  SIM_MODEL_KEY="${key:0:16}"
+
+  SIM_CACHE_ROOT="$BUILD_DIR/cache/$sim_name"
+  OBJ_DIR="$SIM_CACHE_ROOT/$SIM_MODEL_KEY"
+  case "$SIM_PROFILE" in
+    pgo-*)
+      # GCC names profile data after object paths, so the generate and use
+      # builds must share one directory.
+      OBJ_DIR="$SIM_CACHE_ROOT/pgo"
+      ;;
+  esac
+  SIM_CACHE_HIT=0
+  if [[ "${SIM_NO_CACHE:-0}" == "1" ]]; then
+    rm -rf "$OBJ_DIR"
+  elif [[ -f "$OBJ_DIR/.model_complete" && "$(cat "$OBJ_DIR/.model_complete")" == "$SIM_MODEL_KEY" ]]; then
+    SIM_CACHE_HIT=1
+  fi
+  mkdir -p "$OBJ_DIR"
+  touch "$OBJ_DIR"
+
+  SIM_MAKEFLAGS=()
+  if [[ "${SIM_CCACHE:-1}" != "0" ]] && command -v ccache >/dev/null 2>&1; then
+    SIM_MAKEFLAGS=(-MAKEFLAGS "OBJCACHE=ccache")
+  fi
+  echo "Model cache: $OBJ_DIR ($([[ $SIM_CACHE_HIT -eq 1 ]] && echo hit || echo miss))"
+}
+
+# Succeeds if the binary in OBJ_DIR was linked from exactly these harness sources.
+sim_cache_binary_current() {
+  local binary="$1"
+  shift
+  [[ "$SIM_CACHE_HIT" -eq 1 && -x "$binary" && -f "$OBJ_DIR/.harness_hash" ]] || return 1
+  [[ "$(cat "$OBJ_DIR/.harness_hash")" == "$(sim_hash_files "$@")" ]]
+}
+
+# Marks the model complete, records the harness hash and prunes old models.
+sim_cache_record() {
+  echo "$SIM_MODEL_KEY" >"$OBJ_DIR/.model_complete"
+  sim_hash_files "$@" >"$OBJ_DIR/.harness_hash"
+  local keep="${SIM_CACHE_KEEP:-4}"
+  local stale
+  mapfile -t stale < <(ls -1dt "$SIM_CACHE_ROOT"/*/ 2>/dev/null | grep -v '/pgo/$' | tail -n +"$((keep + 1))")
+  if [[ ${#stale[@]} -gt 0 ]]; then
+    rm -rf "${stale[@]}"
+  fi
+}
+
+# Harness sources every simulator links against, for the harness hash.
+sim_harness_sources() {
+  printf '%s\n' "$SIM_DIR"/*.h "$SIM_DIR"/*.cpp
+}
@@ -0,0 +1,166 @@
+# Shared Verilator/C++ build profiles for the build_*_sim.sh scripts.
+#
+# Source after setting SIM_DIR and BUILD_DIR, then call
+# `sim_build_parse_args "$@"` and `sim_build_select_profile`. The profile comes
+# from --profile <name> or SIM_PROFILE:
+#
+#   debug    FST tracing (for --wave) on Verilator's trace threads, -O2 (default)
+#   fast     no tracing, --threads N, --x-assign fast, -O3 -march=native
+#   prof     fast + Verilator --prof-exec and --prof-cfuncs with gprof's -pg,
+#            to see which parts of the model the sim spends its time in
+#   pgo-gen  fast + Verilator --prof-pgo and -fprofile-generate; run the
+#            resulting sim on a representative workload to collect profiles
+#   pgo-use  fast + the collected profile.vlt and -fprofile-use
+#   cov      fast + Verilator line and toggle coverage, for --coverage (the
+#            fuzzer in tests/fuzz steers on it)
+#
+# --threads <n> / SIM_THREADS sets the Verilator model thread count for the
+# non-debug profiles (default: DEFAULT_SIM_THREADS from the calling script).
+# PGO data lives in SIM_PGO_DIR (default: $BUILD_DIR/pgo/<sim name>).
+#
+# --savable / SIM_SAVABLE=1 adds Verilator's --savable so the harness can
+# write and restore checkpoints; such models are evaluated on one thread.
+#
+# --verilog <file> / SIM_VERILOG builds from another elaboration of the same
+# top (e.g. a design-space sweep variant) instead of the generated default,
+# and --output <path> / SIM_OUTPUT puts the binary somewhere other than
+# $BUILD_DIR. Models from different Verilog never share a cache entry.
+
+SIM_PROFILE="${SIM_PROFILE:-debug}"
+SIM_SAVABLE="${SIM_SAVABLE:-0}"
+SIM_VERILOG="${SIM_VERILOG:-}"
+SIM_OUTPUT="${SIM_OUTPUT:-}"
+
+sim_build_parse_args() {
+  while [[ $# -gt 0 ]]; do
+    case "$1" in
+      --profile)
+        if [[ $# -lt 2 ]]; then
+          echo "Error: --profile requires a value" >&2
+          exit 1
+        fi
+        SIM_PROFILE="$2"
+        shift 2
+        ;;
+      --threads)
+        if [[ $# -lt 2 ]]; then
+          echo "Error: --threads requires a value" >&2
+          exit 1
+        fi
+        SIM_THREADS="$2"
+        shift 2
+        ;;
+      --savable)
+        SIM_SAVABLE=1
+        shift
+        ;;
+      --verilog|--output)
+        if [[ $# -lt 2 ]]; then
+          echo "Error: $1 requires a value" >&2
+          exit 1
+        fi
+        if [[ "$1" == "--verilog" ]]; then
+          SIM_VERILOG="$2"
+        else
+          SIM_OUTPUT="$2"
+        fi
+        shift 2
+        ;;
+      *)
+        echo "Unknown argument: $1" >&2
+        echo "Usage: $(basename "$0") [--profile debug|fast|prof|pgo-gen|pgo-use|cov] [--threads <n>] [--savable]" \
+          "[--verilog <file>] [--output <path>]" >&2
+        exit 1
+        ;;
+    esac
+  done
+}
+
+# Sets PROFILE_VERILATOR_FLAGS, PROFILE_INPUTS, PROFILE_CFLAGS and
+# PROFILE_LDFLAGS for the given sim name (used to locate PGO data).
+sim_build_select_profile() {
+  local sim_name="$1"
+  local threads="${SIM_THREADS:-${DEFAULT_SIM_THREADS:-1}}"
+  local pgo_dir="${SIM_PGO_DIR:-$REPO_ROOT/$BUILD_DIR/pgo/$sim_name}"
+  local trace_enabled=0
+  local coverage_enabled=0
+
+  if [[ "$SIM_SAVABLE" == "1" ]]; then
+    threads=1
+  fi
+
+  PROFILE_VERILATOR_FLAGS=()
+  PROFILE_INPUTS=()
+
+  case "$SIM_PROFILE" in
+    debug)
+      threads=1
+      trace_enabled=1
+      PROFILE_VERILATOR_FLAGS=(--trace-fst --trace-threads 2)
+      PROFILE_CFLAGS="-O2"
+      PROFILE_LDFLAGS="-O2"
+      ;;
+    fast|prof|pgo-gen|pgo-use|cov)
+      PROFILE_VERILATOR_FLAGS=(
+        --threads "$threads"
+        --x-assign fast
+        -O3
+        --output-split 20000
+        --output-split-cfuncs 5000
+      )
+      PROFILE_CFLAGS="-O3 -march=native"
+      PROFILE_LDFLAGS="-O3"
+      ;;
+    *)
+      echo "Unknown build profile: $SIM_PROFILE (expected debug, fast, prof, pgo-gen, pgo-use or cov)" >&2
+      exit 1
+      ;;
+  esac
+
+  case "$SIM_PROFILE" in
+    prof)
+      PROFILE_VERILATOR_FLAGS+=(--prof-exec --prof-cfuncs)
+      PROFILE_CFLAGS+=" -pg"
+      PROFILE_LDFLAGS+=" -pg"
+      echo "Profiling: run the sim with '+verilator+prof+exec+file+profile_exec.dat' and view it with"
+      echo "           verilator_gantt; the run also writes gmon.out for"
+      echo "           'gprof <sim> gmon.out | verilator_profcfunc'."
+      ;;
+    pgo-gen)
+      mkdir -p "$pgo_dir"
+      PROFILE_VERILATOR_FLAGS+=(--prof-pgo)
+      PROFILE_CFLAGS+=" -fprofile-generate=$pgo_dir"
+      PROFILE_LDFLAGS+=" -fprofile-generate=$pgo_dir"
+      echo "PGO: run the sim with '+verilator+prof+vlt+file+$pgo_dir/profile.vlt' on a representative"
+      echo "     workload, then rebuild with --profile pgo-use."
+      ;;
+    pgo-use)
+      if [[ ! -d "$pgo_dir" ]]; then
+        echo "No PGO data under $pgo_dir; build with --profile pgo-gen and run a workload first." >&2
+        exit 1
+      fi
+      if [[ -f "$pgo_dir/profile.vlt" ]]; then
+        PROFILE_INPUTS+=("$pgo_dir/profile.vlt")
+      fi
+      PROFILE_CFLAGS+=" -fprofile-use=$pgo_dir -fprofile-partial-training -Wno-missing-profile"
+      PROFILE_LDFLAGS+=" -fprofile-use=$pgo_dir"
+      ;;
+    cov)
+      coverage_enabled=1
+      PROFILE_VERILATOR_FLAGS+=(--coverage-line --coverage-toggle)
+      ;;
+  esac
+
+  if [[ "$SIM_SAVABLE" == "1" ]]; then
+    PROFILE_VERILATOR_FLAGS+=(--savable)
+  fi
+
+  PROFILE_CFLAGS+=" -std=c++17"
+  PROFILE_CFLAGS+=" -DSIM_BUILD_PROFILE=$SIM_PROFILE -DSIM_BUILD_THREADS=$threads"
+  PROFILE_CFLAGS+=" -DSIM_BUILD_TRACE=$trace_enabled -DSIM_BUILD_SAVABLE=$SIM_SAVABLE"
+  PROFILE_CFLAGS+=" -DSIM_BUILD_COVERAGE=$coverage_enabled"
+  PROFILE_LDFLAGS+=" -pthread"
+
+  echo "Build profile: $SIM_PROFILE (threads=$threads, trace=$trace_enabled, savable=$SIM_SAVABLE," \
+    "coverage=$coverage_enabled)"
+}
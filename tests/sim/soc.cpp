@@ -0,0 +1,102 @@
+#include "soc.h"
+
+#include <stdexcept>
+
+bool CoreMemory::writeMasked(uint32_t addr, uint32_t data, uint32_t mask) {
+  if (isPrivate(addr) && isPrivate(addr + 3)) {
+    memory_.writeMasked(addr + offset_, data, mask);
+    return true;
+  }
+  for (uint32_t byte = 0; byte < 4; ++byte) {
+    if (((mask >> byte) & 0x1u) == 0) {
+      continue;
+    }
+    const uint32_t at = addr + byte;
+    const uint8_t value = static_cast<uint8_t>(data >> (8 * byte));
+    if (isPrivate(at)) {
+      memory_.write8(at + offset_, value);
+    } else if (isShared(at)) {
+      PendingWord& word = pending_[at & ~0x3u];
+      const uint32_t shift = 8 * (at & 0x3u);
+      word.data = (word.data & ~(0xFFu << shift)) | (static_cast<uint32_t>(value) << shift);
+      word.mask |= 1u << (at & 0x3u);
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+uint32_t CoreMemory::readShared(uint32_t word) const {
+  uint32_t value = memory_.read32(word);
+  if (!pending_.empty()) {
+    auto it = pending_.find(word);
+    if (it != pending_.end()) {
+      for (uint32_t byte = 0; byte < 4; ++byte) {
+        if ((it->second.mask >> byte) & 0x1u) {
+          const uint32_t lane = 0xFFu << (8 * byte);
+          value = (value & ~lane) | (it->second.data & lane);
+        }
+      }
+    }
+  }
+  return value;
+}
+
+uint8_t CoreMemory::read8(uint32_t addr) const {
+  if (isPrivate(addr)) {
+    return memory_.read8(addr + offset_);
+  }
+  if (!isShared(addr)) {
+    return 0;
+  }
+  return static_cast<uint8_t>(readShared(addr & ~0x3u) >> (8 * (addr & 0x3u)));
+}
+
+void CoreMemory::load(const std::string& elf, ElfSymbols& symbols) {
+  // Load as a single-core harness would, then move the image into place.
+  Memory image(harness::kMemBase, harness::kMemSize);
+  loadElfIntoMemory(elf, image, symbols);
+  bool outside = false;
+  image.forEachAllocated(
+      [&](uint32_t addr, const uint8_t* data) {
+        memory_.writeBlock(addr + offset_, data, Memory::kPageSize);
+      },
+      [&](uint32_t addr, uint8_t value) {
+        if (isShared(addr)) {
+          memory_.write8(addr, value);
+        } else {
+          outside = true;
+        }
+      });
+  if (outside) {
+    throw std::runtime_error(elf + " has data outside the private window and the shared region");
+  }
+}
+
+void CoreMemory::dumpSignature(uint32_t begin, uint32_t end, const std::string& path) const {
+  if (end > begin && (!isPrivate(begin) || !isPrivate(end - 1))) {
+    throw std::runtime_error("signature outside the private window");
+  }
+  memory_.dumpSignature(begin + offset_, end + offset_, path);
+}
+
+void CoreMemory::commit() {
+  for (const auto& entry : pending_) {
+    memory_.writeMasked(entry.first, entry.second.data, entry.second.mask);
+  }
+  pending_.clear();
+}
+
+void SocBarrier::arriveAndWait() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  const uint64_t generation = generation_;
+  if (++waiting_ == threads_) {
+    completion_();
+    waiting_ = 0;
+    ++generation_;
+    released_.notify_all();
+    return;
+  }
+  released_.wait(lock, [&] { return generation_ != generation; });
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+// Shared memory and synchronisation for the multi-core SoC harness (soc_sim).
+//
+// Every core sees the same address map:
+//   [kMemBase, kMemBase + kMemSize)              private window, holding the
+//                                                 core's own program, so the
+//                                                 usual tests run unchanged
+//   [kSocSharedBase, kSocSharedBase + kSocSharedSize)  shared by all cores
+// Anything else reads as zero, and a store there stops the core. Core i's
+// window is backed at kMemBase + i * kMemSize of one Memory, and the shared
+// region sits directly above the last window.
+//
+// Cores run a quantum of cycles each on its own host thread and then meet
+// at a SocBarrier. A store to the private window lands at once. A store to
+// the shared region is buffered in the core's CoreMemory, where the core's
+// own loads see it. The buffers commit at the barrier, in core order, while
+// every thread waits. So each page is only ever written by one thread at a
+// time, the plain Memory needs no locking, and shared-memory results do not
+// depend on host scheduling. Other cores see a shared store from the next
+// quantum on, so the quantum bounds both the skew between cores and the
+// latency of cross-core communication.
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "elf_loader.h"
+#include "harness.h"
+#include "memory.h"
+
+constexpr int kSocMaxCores = 16;
+constexpr uint32_t kSocSharedBase = harness::kMemBase + kSocMaxCores * harness::kMemSize;
+constexpr uint32_t kSocSharedSize = 16 * 1024 * 1024;
+
+// Size of the Memory at kMemBase that backs the whole map.
+constexpr uint32_t kSocMemSize = kSocSharedBase + kSocSharedSize - harness::kMemBase;
+
+// One core's view of the SoC memory; the port adapters see it in place of
+// Memory.
+class CoreMemory {
+ public:
+  CoreMemory(Memory& memory, int core)
+      : memory_(memory), offset_(static_cast<uint32_t>(core) * harness::kMemSize) {}
+
+  inline uint32_t read32(uint32_t addr) const;
+  // Applies a store; false if it is outside the private window and the
+  // shared region.
+  bool writeMasked(uint32_t addr, uint32_t data, uint32_t mask);
+
+  // Loads an ELF linked for the private window (and optionally the shared
+  // region); throws std::runtime_error like loadElfIntoMemory.
+  void load(const std::string& elf, ElfSymbols& symbols);
+  void dumpSignature(uint32_t begin, uint32_t end, const std::string& path) const;
+
+  // Writes the buffered shared stores to memory; only while no core runs.
+  void commit();
+
+ private:
+  struct PendingWord {
+    uint32_t data = 0;
+    uint32_t mask = 0;
+  };
+
+  static bool isPrivate(uint32_t addr) { return addr - harness::kMemBase < harness::kMemSize; }
+  static bool isShared(uint32_t addr) { return addr - kSocSharedBase < kSocSharedSize; }
+
+  uint32_t readShared(uint32_t word) const;
+  uint8_t read8(uint32_t addr) const;
+
+  Memory& memory_;
+  uint32_t offset_;
+  std::unordered_map<uint32_t, PendingWord> pending_;  // by aligned word address
+};
+
+inline uint32_t CoreMemory::read32(uint32_t addr) const {
+  if ((addr & 0x3u) != 0) {
+    uint32_t value = 0;
+    for (uint32_t byte = 0; byte < 4; ++byte) {
+      value |= static_cast<uint32_t>(read8(addr + byte)) << (8 * byte);
+    }
+    return value;
+  }
+  if (isPrivate(addr)) {
+    return memory_.read32(addr + offset_);
+  }
+  return isShared(addr) ? readShared(addr) : 0;
+}
+
+// Reusable barrier for a fixed set of threads. The last thread to arrive
+// runs the completion step before releasing the others.
+class SocBarrier {
+ public:
+  SocBarrier(int threads, std::function<void()> completion)
+      : threads_(threads), completion_(std::move(completion)) {}
+
+  void arriveAndWait();
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable released_;
+  const int threads_;
+  int waiting_ = 0;
+  uint64_t generation_ = 0;
+  std::function<void()> completion_;
+};
@@ -0,0 +1,320 @@
+// Multi-core SoC harness: several Verilated cores, each on its own host
+// thread, over one shared memory (soc.h has the address map and how the
+// cores synchronise).
+//
+//   soc_sim --core <type>:<elf>:<signature>[:<thread-mask>] [--core ...]
+//           [--quantum K] [--max-cycles N]
+//
+// <type> is zeronyte, tetranyte or octonyte, and each --core adds one core.
+// A core is done once it writes a non-zero value to its tohost and stops
+// being clocked; the run ends when every core is done or max-cycles
+// expires, checked every K cycles (default 1000). Prints one summary line
+// per core and a SoC line with the host throughput, and returns the exit
+// code of the first core that did not pass.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "VOctoNyteRV32ICore.h"
+#include "VTetraNyteRV32ICore.h"
+#include "VZeroNyteRV32ICore.h"
+#include "harness.h"
+#include "octonyte_ports.h"
+#include "soc.h"
+#include "tetranyte_ports.h"
+#include "zeronyte_ports.h"
+
+namespace {
+
+using harness::kExitMemoryError;
+using harness::kExitPass;
+using harness::kExitSetupError;
+using harness::kExitSignatureError;
+using harness::kExitTestFailed;
+using harness::kExitTimeout;
+
+struct CoreSpec {
+  std::string type;
+  std::string elf;
+  std::string signature;
+  uint32_t thread_mask = 0x1;
+};
+
+struct SocOptions {
+  std::vector<CoreSpec> cores;
+  uint64_t quantum = 1000;
+  uint64_t max_cycles = 1'000'000;
+};
+
+CoreSpec parseCoreSpec(const std::string& spec) {
+  std::vector<std::string> fields;
+  std::istringstream in(spec);
+  for (std::string field; std::getline(in, field, ':');) {
+    fields.push_back(field);
+  }
+  if (fields.size() < 3 || fields.size() > 4 || fields[1].empty() || fields[2].empty()) {
+    throw std::invalid_argument("--core expects <type>:<elf>:<signature>[:<thread-mask>], got " +
+                                spec);
+  }
+  CoreSpec core;
+  core.type = fields[0];
+  core.elf = fields[1];
+  core.signature = fields[2];
+  if (fields.size() == 4) {
+    core.thread_mask = static_cast<uint32_t>(std::stoul(fields[3], nullptr, 0));
+  }
+  return core;
+}
+
+SocOptions parseArgs(int argc, char** argv) {
+  SocOptions opts;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg(argv[i]);
+    if (!arg.empty() && arg[0] == '+') {
+      continue;  // +verilator+... plusargs go to every core's context
+    }
+    if (arg == "--core" && i + 1 < argc) {
+      opts.cores.push_back(parseCoreSpec(argv[++i]));
+    } else if (arg == "--quantum" && i + 1 < argc) {
+      opts.quantum = std::stoull(argv[++i]);
+    } else if (arg == "--max-cycles" && i + 1 < argc) {
+      opts.max_cycles = std::stoull(argv[++i]);
+    } else {
+      throw std::invalid_argument("unknown or incomplete argument: " + arg);
+    }
+  }
+  if (opts.cores.empty() || static_cast<int>(opts.cores.size()) > kSocMaxCores) {
+    throw std::invalid_argument("between 1 and " + std::to_string(kSocMaxCores) +
+                                " --core options are required");
+  }
+  if (opts.quantum == 0) {
+    throw std::invalid_argument("--quantum must be at least 1");
+  }
+  return opts;
+}
+
+// One core and its harness-side state, driven a quantum at a time.
+class SocCore {
+ public:
+  SocCore(Memory& memory, int index) : memory_(memory, index) {}
+  virtual ~SocCore() = default;
+
+  virtual const char* name() const = 0;
+  virtual void reset() = 0;
+  // Simulates up to cycle limit, or until the core is done.
+  virtual void run(uint64_t limit) = 0;
+
+  void load(const std::string& elf) { memory_.load(elf, symbols_); }
+  void commit() { memory_.commit(); }
+  void dumpSignature(const std::string& path) const {
+    memory_.dumpSignature(symbols_.begin_signature, symbols_.end_signature, path);
+  }
+
+  bool done() const { return status_ != kExitTimeout; }
+  // kExitTimeout while running, then kExitPass or kExitMemoryError.
+  int status() const { return status_; }
+  uint32_t tohostValue() const { return tohost_value_; }
+  uint64_t cycles() const { return cycles_; }
+  uint32_t faultAddr() const { return fault_addr_; }
+
+ protected:
+  CoreMemory memory_;
+  ElfSymbols symbols_;
+  int status_ = kExitTimeout;
+  uint32_t tohost_value_ = 0;
+  uint32_t fault_addr_ = 0;
+  uint64_t cycles_ = 0;
+};
+
+// The cycle loop of Harness::runCycles without the optional features, over
+// the core's view of the SoC memory and its own Verilated context.
+template <typename Ports>
+class SocCoreModel : public SocCore {
+ public:
+  SocCoreModel(Memory& memory, int index, uint32_t thread_mask, int argc, char** argv)
+      : SocCore(memory, index), context_(std::make_unique<VerilatedContext>()),
+        dut_(context_.get()) {
+    context_->commandArgs(argc, argv);
+    options_.thread_mask = thread_mask;
+  }
+
+  const char* name() const override { return Ports::kName; }
+
+  void reset() override {
+    dut_.reset = 1;
+    for (int cycle = 0; cycle < harness::kResetCycles; ++cycle) {
+      halfCycle(0);
+      halfCycle(1);
+      Ports::endResetCycle(state_);
+    }
+    dut_.reset = 0;
+  }
+
+  void run(uint64_t limit) override {
+    for (; cycles_ < limit && status_ == kExitTimeout; ++cycles_) {
+      halfCycle(0);
+      halfCycle(1);
+      Ports::endCycle(state_);
+
+      const harness::MemWrite write = Ports::memWrite(dut_);
+      if (!write.valid) {
+        continue;
+      }
+      if (!memory_.writeMasked(write.addr, write.data, write.mask)) {
+        fault_addr_ = write.addr;
+        status_ = kExitMemoryError;
+      } else if (write.addr == symbols_.tohost && write.data != 0) {
+        tohost_value_ = write.data;
+        status_ = kExitPass;
+      }
+    }
+  }
+
+ private:
+  using Model = typename Ports::Model;
+
+  inline void halfCycle(uint8_t clock) {
+    dut_.clock = clock;
+    Ports::drive(dut_, state_, memory_, options_);
+    dut_.eval();
+    Ports::capture(dut_, state_);
+  }
+
+  std::unique_ptr<VerilatedContext> context_;
+  Model dut_;
+  typename Ports::State state_;
+  harness::Options options_;
+};
+
+std::unique_ptr<SocCore> makeCore(const CoreSpec& spec, Memory& memory, int index, int argc,
+                                  char** argv) {
+  if (spec.type == "zeronyte") {
+    if (spec.thread_mask != 0x1) {
+      throw std::invalid_argument("zeronyte takes no thread mask");
+    }
+    return std::make_unique<SocCoreModel<ZeroNytePorts<VZeroNyteRV32ICore>>>(memory, index, 0x1,
+                                                                            argc, argv);
+  }
+  if (spec.type == "tetranyte") {
+    return std::make_unique<SocCoreModel<TetraNytePorts>>(memory, index, spec.thread_mask, argc,
+                                                          argv);
+  }
+  if (spec.type == "octonyte") {
+    return std::make_unique<SocCoreModel<OctoNytePorts>>(memory, index, spec.thread_mask, argc,
+                                                         argv);
+  }
+  throw std::invalid_argument("unknown core type " + spec.type +
+                              " (expected zeronyte, tetranyte or octonyte)");
+}
+
+// Writes the signature and prints the summary line of a finished core;
+// returns its exit code.
+int reportCore(int index, SocCore& core, const CoreSpec& spec) {
+  int status = core.status();
+  if (status == kExitTimeout) {
+    std::cerr << "core" << index << ": max cycles reached" << std::endl;
+  } else if (status == kExitMemoryError) {
+    std::cerr << "core" << index << ": store to unmapped address 0x" << std::hex
+              << core.faultAddr() << std::dec << std::endl;
+  } else {
+    if (core.tohostValue() != 1) {
+      std::cerr << "core" << index << ": test reported failure, tohost=0x" << std::hex
+                << core.tohostValue() << std::dec << std::endl;
+    }
+    try {
+      core.dumpSignature(spec.signature);
+      status = core.tohostValue() == 1 ? kExitPass : kExitTestFailed;
+    } catch (const std::exception& e) {
+      std::cerr << "core" << index << ": signature dump failed: " << e.what() << std::endl;
+      status = kExitSignatureError;
+    }
+  }
+  std::cout << "core" << index << " " << core.name() << ": cycles=" << core.cycles()
+            << " tohost=0x" << std::hex << core.tohostValue() << std::dec << " status=" << status
+            << " elf=" << spec.elf << std::endl;
+  return status;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  SocOptions options;
+  try {
+    options = parseArgs(argc, argv);
+  } catch (const std::exception& e) {
+    std::cerr << "Argument error: " << e.what() << std::endl;
+    return kExitSetupError;
+  }
+
+  Memory memory(harness::kMemBase, kSocMemSize);
+  std::vector<std::unique_ptr<SocCore>> cores;
+  const int num_cores = static_cast<int>(options.cores.size());
+  for (int i = 0; i < num_cores; ++i) {
+    const CoreSpec& spec = options.cores[i];
+    try {
+      cores.push_back(makeCore(spec, memory, i, argc, argv));
+      cores.back()->load(spec.elf);
+    } catch (const std::exception& e) {
+      std::cerr << "core" << i << " setup failed: " << e.what() << std::endl;
+      return kExitSetupError;
+    }
+    cores.back()->reset();
+  }
+
+  // The barrier's completion step runs while every core thread waits, so it
+  // alone touches limit and stop between quanta.
+  uint64_t limit = std::min(options.quantum, options.max_cycles);
+  bool stop = false;
+  SocBarrier barrier(num_cores, [&] {
+    for (auto& core : cores) {
+      core->commit();
+    }
+    const bool all_done =
+        std::all_of(cores.begin(), cores.end(), [](const auto& core) { return core->done(); });
+    if (all_done || limit == options.max_cycles) {
+      stop = true;
+    } else {
+      limit = std::min(limit + options.quantum, options.max_cycles);
+    }
+  });
+
+  const auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (auto& core : cores) {
+    threads.emplace_back([&, core = core.get()] {
+      while (!stop) {
+        core->run(limit);
+        barrier.arriveAndWait();
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  const double seconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  int overall = kExitPass;
+  uint64_t total_cycles = 0;
+  uint64_t soc_cycles = 0;
+  for (int i = 0; i < num_cores; ++i) {
+    const int status = reportCore(i, *cores[i], options.cores[i]);
+    if (overall == kExitPass) {
+      overall = status;
+    }
+    total_cycles += cores[i]->cycles();
+    soc_cycles = std::max(soc_cycles, cores[i]->cycles());
+  }
+  std::cout << "SoC: cores=" << num_cores << " quantum=" << options.quantum
+            << " cycles=" << soc_cycles << " host_seconds=" << seconds
+            << " core_khz=" << (seconds > 0 ? total_cycles / seconds / 1000 : 0) << std::endl;
+  return overall;
+}
@@ -0,0 +1,211 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <ostream>
+
+#include "VTetraNyteRV32ICore.h"
+#include "harness.h"
+
+// Port adapter for the four-thread TetraNyte barrel core.
+struct TetraNytePorts {
+  using Model = VTetraNyteRV32ICore;
+  static constexpr const char* kName = "TetraNyte";
+  static constexpr int kNumThreads = 4;
+
+  struct State {
+    State() { thread_pcs.fill(harness::kMemBase); }
+    std::array<uint32_t, kNumThreads> thread_pcs{};
+    bool fetch_enabled = false;
+    uint32_t fetch_thread = 0;
+    uint32_t fetch_addr = harness::kMemBase;
+    uint32_t fetch_instr = harness::kNopInstr;
+  };
+
+  template <typename Mem>
+  static void drive(Model& dut, State& state, Mem& memory, const harness::Options& options) {
+    // Apply thread mask to the DUT (bit i enables thread i)
+    dut.io_threadEnable_0 = (options.thread_mask >> 0) & 0x1;
+    dut.io_threadEnable_1 = (options.thread_mask >> 1) & 0x1;
+    dut.io_threadEnable_2 = (options.thread_mask >> 2) & 0x1;
+    dut.io_threadEnable_3 = (options.thread_mask >> 3) & 0x1;
+
+    // Barrel fetch: feed each thread from its own PC if enabled; otherwise feed NOP.
+    const uint32_t ft = dut.io_fetchThread & 0x3;
+    state.fetch_enabled = ((options.thread_mask >> ft) & 0x1) != 0;
+    state.fetch_thread = ft;
+    state.fetch_addr = state.thread_pcs[ft];
+    if (state.fetch_enabled) {
+      state.fetch_instr = memory.read32(state.fetch_addr);
+    } else {
+      state.fetch_instr = harness::kNopInstr;
+    }
+    dut.io_instrMem = state.fetch_instr;
+    dut.io_dataMemResp = memory.read32(dut.io_memAddr);
+  }
+
+  static void capture(Model& dut, State& state) {
+    state.thread_pcs[0] = dut.io_if_pc_0;
+    state.thread_pcs[1] = dut.io_if_pc_1;
+    state.thread_pcs[2] = dut.io_if_pc_2;
+    state.thread_pcs[3] = dut.io_if_pc_3;
+  }
+
+  static void endResetCycle(State&) {}
+  static void endCycle(State&) {}
+
+  static harness::MemWrite memWrite(const Model& dut) {
+    return {dut.io_memMask != 0, dut.io_memAddr, dut.io_memWrite, dut.io_memMask};
+  }
+
+  static void logCtrl(std::ostream& log, const Model& dut) {
+    log << std::hex << "ctrl: taken=1 "
+        << "thread=" << static_cast<unsigned>(dut.io_ctrlThread)
+        << " from=0x" << dut.io_ctrlFromPC
+        << " target=0x" << dut.io_ctrlTarget
+        << " branch=" << static_cast<unsigned>(dut.io_ctrlIsBranch)
+        << " jal=" << static_cast<unsigned>(dut.io_ctrlIsJal)
+        << " jalr=" << static_cast<unsigned>(dut.io_ctrlIsJalr)
+        << std::dec << '\n';
+  }
+
+  static void logResetCycle(std::ostream& log, const Model& dut, const State&) {
+    if (dut.io_ctrlTaken) {
+      logCtrl(log, dut);
+    }
+  }
+
+  static void logCycle(std::ostream& log, const Model& dut, const State& state, uint64_t cycle,
+                       const harness::MemWrite& write, const harness::Options& options,
+                       const ElfSymbols& symbols) {
+    log << std::hex << "pcs post-eval: "
+        << "pc0=0x" << dut.io_if_pc_0 << " "
+        << "pc1=0x" << dut.io_if_pc_1 << " "
+        << "pc2=0x" << dut.io_if_pc_2 << " "
+        << "pc3=0x" << dut.io_if_pc_3
+        << " en=[" << static_cast<unsigned>(dut.io_threadEnable_0)
+        << static_cast<unsigned>(dut.io_threadEnable_1)
+        << static_cast<unsigned>(dut.io_threadEnable_2)
+        << static_cast<unsigned>(dut.io_threadEnable_3) << "]"
+        << std::dec << '\n';
+
+    if (dut.io_ctrlTaken) {
+      logCtrl(log, dut);
+    }
+
+    log << std::hex
+        << "cycle=0x" << cycle
+        << " memAddr=0x" << write.addr
+        << " mask=0x" << write.mask
+        << " tohost=0x" << symbols.tohost;
+    if (options.trace_pc) {
+      log << " pc0=0x" << state.thread_pcs[0]
+          << " pc1=0x" << state.thread_pcs[1]
+          << " pc2=0x" << state.thread_pcs[2]
+          << " pc3=0x" << state.thread_pcs[3]
+          << " instr0=0x" << dut.io_if_instr_0
+          << " instr1=0x" << dut.io_if_instr_1
+          << " instr2=0x" << dut.io_if_instr_2
+          << " instr3=0x" << dut.io_if_instr_3
+          << " ft=" << static_cast<unsigned>(dut.io_fetchThread);
+    }
+    log << std::dec << '\n';
+  }
+
+  static void traceCycle(TraceWriter& trace, const Model& dut, const State& state, uint64_t cycle,
+                         const harness::MemWrite& write) {
+    if (dut.io_ctrlTaken) {
+      TraceRecord ctrl{};
+      ctrl.kind = kTraceCtrl;
+      ctrl.thread = static_cast<uint8_t>(dut.io_ctrlThread);
+      ctrl.pc = dut.io_ctrlFromPC;
+      ctrl.target = dut.io_ctrlTarget;
+      ctrl.flags = traceCtrlFlags(true, dut.io_ctrlIsBranch, dut.io_ctrlIsJal, dut.io_ctrlIsJalr);
+      trace.append(cycle, ctrl);
+    }
+
+    const uint32_t ft = dut.io_fetchThread & 0x3;
+    TraceRecord record{};
+    record.kind = kTraceCycle;
+    record.thread = static_cast<uint8_t>(ft);
+    record.pc = state.thread_pcs[ft];
+    record.instr = state.fetch_instr;
+    record.flags = state.fetch_enabled ? kTraceFetchEnabled : 0;
+    record.addr = write.addr;
+    record.data = write.data;
+    record.mask = static_cast<uint8_t>(write.mask);
+    trace.append(cycle, record);
+  }
+
+  // Fetch slot plus every thread's PC and ALU result, so loops that count
+  // or walk a register never look steady.
+  static uint64_t idleSample(const Model& dut, const State& state) {
+    uint64_t h = idleMix(dut.io_fetchThread, state.fetch_instr);
+    for (uint32_t pc : state.thread_pcs) {
+      h = idleMix(h, pc);
+    }
+    h = idleMix(h, dut.io_ex_aluResult_0);
+    h = idleMix(h, dut.io_ex_aluResult_1);
+    h = idleMix(h, dut.io_ex_aluResult_2);
+    h = idleMix(h, dut.io_ex_aluResult_3);
+    return idleMix(h, dut.io_memAddr);
+  }
+
+  static bool fetchesPc(const Model&, const State& state, uint32_t pc) {
+    return state.fetch_enabled && state.fetch_addr == pc;
+  }
+
+  // No per-stage valid is exported, so only fetch slots, redirects and data
+  // accesses are counted; flush bubbles show up as issued slots.
+  static constexpr bool kObservesRetire = false;
+  static constexpr bool kHasFetchBuffer = false;
+
+  static void countCycle(PerfCounters& perf, const Model& dut, const State& state,
+                         const harness::MemWrite& write) {
+    ThreadPerf& slot = perf.threads[dut.io_fetchThread & 0x3];
+    ++slot.slots;
+    if (state.fetch_enabled) {
+      ++slot.issued;
+    } else {
+      ++slot.disabled;
+    }
+    if (dut.io_ctrlTaken) {
+      ++perf.threads[dut.io_ctrlThread & 0x3].redirects;
+    }
+    if (write.valid) {
+      ++perf.stores;
+    } else if (dut.io_memValid) {
+      ++perf.loads;
+    }
+  }
+
+  // The fixed round-robin puts the MEM stage two threads past the one the
+  // last edge fetched for (IF/ID, ID/EX, EX/MEM lag it by one each).
+  static void memAccesses(CycleAccesses& accesses, const Model& dut, const State& state,
+                          const harness::MemWrite& write) {
+    if (state.fetch_enabled) {
+      accesses.add(kMemFetch, state.fetch_addr, 4, state.fetch_thread);
+    }
+    const uint32_t mem_thread = (state.fetch_thread + 2) & 0x3;
+    if (write.valid) {
+      accesses.add(kMemStore, write.addr, 4, mem_thread);
+    } else if (dut.io_memValid) {
+      accesses.add(kMemLoad, dut.io_memAddr, 4, mem_thread);
+    }
+  }
+
+  // Only taken transfers are exported, with their thread.
+  static constexpr uint32_t kCommitKinds = kCommitTaken | kCommitStore;
+
+  static void commits(CoSim& cosim, const Model& dut, const State&,
+                      const harness::MemWrite& write) {
+    if (dut.io_ctrlTaken) {
+      cosim.control(dut.io_ctrlThread & 0x3, dut.io_ctrlFromPC, true, dut.io_ctrlTarget);
+    }
+    if (write.valid) {
+      cosim.store(write.addr, write.data, write.mask);
+    }
+  }
+
+  static constexpr bool kHasICache = false;
+};
@@ -0,0 +1,105 @@
+#include "trace.h"
+
+#include <cstring>
+#include <stdexcept>
+
+TraceWriter::TraceWriter(const std::string& path, const char* core, uint32_t num_threads, bool async)
+    : path_(path),
+      ring_((async ? kNumChunks : 1) * kChunkRecords),
+      chunk_counts_(async ? kNumChunks : 1),
+      async_(async) {
+  file_ = std::fopen(path.c_str(), "wb");
+  if (file_ == nullptr) {
+    throw std::runtime_error("failed to open trace file: " + path);
+  }
+  TraceHeader header{};
+  std::memcpy(header.magic, kTraceMagic, sizeof(header.magic));
+  header.version = kTraceVersion;
+  header.num_threads = num_threads;
+  std::strncpy(header.core, core, sizeof(header.core) - 1);
+  if (std::fwrite(&header, sizeof(header), 1, file_) != 1) {
+    std::fclose(file_);
+    throw std::runtime_error("failed to write trace file: " + path);
+  }
+
+  if (async_) {
+    writer_ = std::thread(&TraceWriter::writerLoop, this);
+  }
+}
+
+TraceWriter::~TraceWriter() {
+  drain();
+  if (async_) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    ready_.notify_one();
+    writer_.join();
+  }
+  std::fclose(file_);
+}
+
+void TraceWriter::flush() {
+  drain();
+  if (failed_) {
+    throw std::runtime_error("failed to write trace file: " + path_);
+  }
+}
+
+void TraceWriter::drain() {
+  if (pos_ > 0) {
+    submitChunk();
+  }
+  if (async_) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    drained_.wait(lock, [this] { return pending_ == 0; });
+  }
+  if (std::fflush(file_) != 0) {
+    failed_ = true;
+  }
+}
+
+void TraceWriter::submitChunk() {
+  if (!async_) {
+    if (!writeChunk(0, pos_)) {
+      failed_ = true;
+    }
+    pos_ = 0;
+    return;
+  }
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    chunk_counts_[head_] = pos_;
+    ++pending_;
+    head_ = (head_ + 1) % kNumChunks;
+    ready_.notify_one();
+    // The next chunk is only reusable once the writer has drained it.
+    drained_.wait(lock, [this] { return pending_ < kNumChunks; });
+  }
+  pos_ = 0;
+}
+
+bool TraceWriter::writeChunk(size_t chunk, size_t count) {
+  return std::fwrite(ring_.data() + chunk * kChunkRecords, sizeof(TraceRecord), count, file_) ==
+         count;
+}
+
+void TraceWriter::writerLoop() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  for (;;) {
+    ready_.wait(lock, [this] { return pending_ > 0 || stop_; });
+    if (pending_ == 0) {
+      return;
+    }
+    const size_t chunk = tail_;
+    const size_t count = chunk_counts_[chunk];
+    lock.unlock();
+    const bool written = writeChunk(chunk, count);
+    lock.lock();
+    failed_ = failed_ || !written;
+    tail_ = (tail_ + 1) % kNumChunks;
+    --pending_;
+    drained_.notify_all();
+  }
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+// Compact binary execution trace for the simulation harnesses.
+//
+// A trace file is a TraceHeader followed by fixed 32-byte TraceRecords.
+// Records carry the cycle delta from the previous record, so idle cycles cost
+// nothing and several records may share a cycle. trace_decode turns a trace
+// back into the text log format.
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+constexpr char kTraceMagic[8] = {'K', 'N', 'Y', 'T', 'R', 'A', 'C', 'E'};
+constexpr uint32_t kTraceVersion = 1;
+
+struct TraceHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t num_threads;
+  char core[16];
+};
+
+enum TraceKind : uint8_t {
+  kTraceCycle = 0,      // fetch slot: pc/instr of the fetched thread, data-side store
+  kTraceExec = 1,       // control-flow op in execute: addr=rs1, data=rs2, aux=branch op
+  kTraceWriteback = 2,  // control-flow op resolved at writeback
+  kTraceCtrl = 3,       // taken redirect reported on the ctrl port
+};
+
+enum TraceFlags : uint8_t {
+  kTraceTaken = 1u << 0,
+  kTraceBranch = 1u << 1,
+  kTraceJal = 1u << 2,
+  kTraceJalr = 1u << 3,
+  kTraceFetchEnabled = 1u << 4,
+};
+
+struct TraceRecord {
+  uint32_t cycle_delta;
+  uint32_t pc;
+  uint32_t instr;
+  uint32_t addr;
+  uint32_t data;
+  uint32_t target;
+  uint32_t aux;
+  uint8_t kind;
+  uint8_t thread;
+  uint8_t mask;
+  uint8_t flags;
+};
+static_assert(sizeof(TraceRecord) == 32, "trace records must stay 32 bytes");
+
+inline uint8_t traceCtrlFlags(bool taken, bool branch, bool jal, bool jalr) {
+  return static_cast<uint8_t>((taken ? kTraceTaken : 0) | (branch ? kTraceBranch : 0) |
+                              (jal ? kTraceJal : 0) | (jalr ? kTraceJalr : 0));
+}
+
+// Buffers records in a ring of fixed-size chunks. Full chunks are written
+// either inline or, when asynchronous, by a background thread so the
+// simulation only blocks if every chunk is still waiting to be written.
+// The constructor throws std::runtime_error if the file cannot be opened or
+// its header written; a failed chunk write is reported by the next flush().
+class TraceWriter {
+ public:
+  static constexpr size_t kChunkRecords = 1u << 16;  // 2 MiB per chunk
+  static constexpr size_t kNumChunks = 8;
+
+  TraceWriter(const std::string& path, const char* core, uint32_t num_threads, bool async);
+  ~TraceWriter();
+
+  TraceWriter(const TraceWriter&) = delete;
+  TraceWriter& operator=(const TraceWriter&) = delete;
+
+  inline void append(uint64_t cycle, const TraceRecord& record);
+
+  // Writes out everything buffered so far and waits for the file to catch up;
+  // throws std::runtime_error if any write to the file has failed.
+  void flush();
+
+ private:
+  void drain();
+  void submitChunk();
+  bool writeChunk(size_t chunk, size_t count);
+  void writerLoop();
+
+  std::string path_;
+  std::FILE* file_ = nullptr;
+  std::vector<TraceRecord> ring_;
+  std::vector<size_t> chunk_counts_;
+  size_t head_ = 0;  // chunk currently being filled
+  size_t tail_ = 0;  // oldest chunk not yet written
+  size_t pending_ = 0;
+  size_t pos_ = 0;
+  uint64_t last_cycle_ = 0;
+
+  bool async_;
+  bool stop_ = false;
+  bool failed_ = false;  // a write came up short; guarded by mutex_ when async
+  std::mutex mutex_;
+  std::condition_variable ready_;
+  std::condition_variable drained_;
+  std::thread writer_;
+};
+
+inline void TraceWriter::append(uint64_t cycle, const TraceRecord& record) {
+  TraceRecord& slot = ring_[head_ * kChunkRecords + pos_];
+  slot = record;
+  slot.cycle_delta = static_cast<uint32_t>(cycle - last_cycle_);
+  last_cycle_ = cycle;
+  if (++pos_ == kChunkRecords) {
+    submitChunk();
+  }
+}
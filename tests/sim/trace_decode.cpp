@@ -0,0 +1,133 @@
+// Converts a binary harness trace (--trace) back into the text log format.
+//
+//   trace_decode <trace> [<output>]
+//
+// Control-flow lines (exec1:/wb:/ctrl:) match the harness --log output; the
+// per-cycle line carries the fetch slot and data-side store recorded in the
+// trace.
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "trace.h"
+
+namespace {
+
+void printCtrlFields(std::ostream& out, const TraceRecord& r) {
+  out << " branch=" << ((r.flags & kTraceBranch) ? 1 : 0)
+      << " jal=" << ((r.flags & kTraceJal) ? 1 : 0)
+      << " jalr=" << ((r.flags & kTraceJalr) ? 1 : 0);
+}
+
+void printRecord(std::ostream& out, const TraceHeader& header, uint64_t cycle, const TraceRecord& r) {
+  const unsigned taken = (r.flags & kTraceTaken) ? 1 : 0;
+  out << std::hex;
+  switch (r.kind) {
+    case kTraceCycle:
+      if (header.num_threads <= 1) {
+        out << "cycle=0x" << cycle
+            << " pc=0x" << r.pc
+            << " instr=0x" << r.instr
+            << " result=0x" << r.aux;
+      } else {
+        out << "cycle=0x" << cycle
+            << " thread=0x" << static_cast<unsigned>(r.thread)
+            << " fetchEn=" << ((r.flags & kTraceFetchEnabled) ? 1 : 0)
+            << " pc=0x" << r.pc
+            << " instr=0x" << r.instr
+            << " memAddr=0x" << r.addr
+            << " memMask=0x" << static_cast<unsigned>(r.mask);
+        if (r.mask != 0) {
+          out << " memData=0x" << r.data;
+        }
+      }
+      break;
+    case kTraceExec:
+      out << "exec1: thread=0x" << static_cast<unsigned>(r.thread)
+          << " pc=0x" << r.pc
+          << " instr=0x" << r.instr
+          << " rs1=0x" << r.addr
+          << " rs2=0x" << r.data
+          << " op=0x" << r.aux
+          << " taken=" << taken
+          << " target=0x" << r.target;
+      printCtrlFields(out, r);
+      break;
+    case kTraceWriteback:
+      out << "wb: thread=0x" << static_cast<unsigned>(r.thread)
+          << " from=0x" << r.pc
+          << " instr=0x" << r.instr
+          << " taken=" << taken
+          << " target=0x" << r.target;
+      printCtrlFields(out, r);
+      break;
+    case kTraceCtrl:
+      out << "ctrl: taken=1 "
+          << "thread=" << static_cast<unsigned>(r.thread)
+          << " from=0x" << r.pc
+          << " target=0x" << r.target;
+      printCtrlFields(out, r);
+      break;
+    default:
+      out << "unknown record kind=0x" << static_cast<unsigned>(r.kind);
+      break;
+  }
+  out << std::dec << '\n';
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc < 2 || argc > 3) {
+    std::cerr << "Usage: " << argv[0] << " <trace> [<output>]" << std::endl;
+    return 1;
+  }
+
+  std::FILE* in = std::fopen(argv[1], "rb");
+  if (in == nullptr) {
+    std::cerr << "failed to open trace: " << argv[1] << std::endl;
+    return 1;
+  }
+
+  TraceHeader header{};
+  if (std::fread(&header, sizeof(header), 1, in) != 1 ||
+      std::memcmp(header.magic, kTraceMagic, sizeof(header.magic)) != 0) {
+    std::cerr << "not a harness trace: " << argv[1] << std::endl;
+    std::fclose(in);
+    return 1;
+  }
+  if (header.version != kTraceVersion) {
+    std::cerr << "unsupported trace version " << header.version << std::endl;
+    std::fclose(in);
+    return 1;
+  }
+
+  std::ofstream file_out;
+  if (argc == 3) {
+    file_out.open(argv[2]);
+    if (!file_out.is_open()) {
+      std::cerr << "failed to open output: " << argv[2] << std::endl;
+      std::fclose(in);
+      return 1;
+    }
+  }
+  std::ostream& out = argc == 3 ? file_out : std::cout;
+
+  std::vector<TraceRecord> block(TraceWriter::kChunkRecords);
+  uint64_t cycle = 0;
+  size_t count = 0;
+  while ((count = std::fread(block.data(), sizeof(TraceRecord), block.size(), in)) > 0) {
+    for (size_t i = 0; i < count; ++i) {
+      cycle += block[i].cycle_delta;
+      printRecord(out, header, cycle, block[i]);
+    }
+  }
+
+  std::fclose(in);
+  return 0;
+}
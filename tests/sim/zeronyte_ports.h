@@ -0,0 +1,142 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+
+#include "harness.h"
+
+// Port adapter for the single-threaded ZeroNyte tops (with or without the
+// instruction cache); both expose the same imem/dmem interface, and the
+// cached top adds its ICacheSimple lookups for --icache-stats.
+template <typename ModelT, bool kWithICache = false>
+struct ZeroNytePorts {
+  using Model = ModelT;
+  static constexpr const char* kName = "ZeroNyte";
+  static constexpr int kNumThreads = 1;
+
+  // The retiring instruction as it settled before the rising edge; after
+  // the edge pc_out already shows the next PC and result reads the updated
+  // registers.
+  struct State {
+    uint32_t pc = 0;
+    uint32_t instr = 0;
+    uint32_t result = 0;
+  };
+
+  template <typename Mem>
+  static void drive(Model& dut, State&, Mem& memory, const harness::Options&) {
+    dut.io_imem_rdata = memory.read32(dut.io_imem_addr);
+    dut.io_dmem_rdata = memory.read32(dut.io_dmem_addr);
+  }
+
+  static void capture(Model& dut, State& state) {
+    if (dut.clock == 0) {
+      state.pc = dut.io_pc_out;
+      state.instr = dut.io_instr_out;
+      state.result = dut.io_result;
+    }
+  }
+  static void endResetCycle(State&) {}
+  static void endCycle(State&) {}
+
+  static harness::MemWrite memWrite(const Model& dut) {
+    return {dut.io_dmem_wen != 0, dut.io_dmem_addr, dut.io_dmem_wdata, 0xFu};
+  }
+
+  static void logResetCycle(std::ostream&, const Model&, const State&) {}
+
+  static void logCycle(std::ostream& log, const Model& dut, const State&, uint64_t cycle,
+                       const harness::MemWrite&, const harness::Options&, const ElfSymbols&) {
+    log << std::hex
+        << "cycle=0x" << cycle
+        << " pc=0x" << dut.io_pc_out
+        << " instr=0x" << dut.io_instr_out
+        << " result=0x" << dut.io_result
+        << std::dec << '\n';
+  }
+
+  static void traceCycle(TraceWriter& trace, const Model& dut, const State&, uint64_t cycle,
+                         const harness::MemWrite& write) {
+    TraceRecord record{};
+    record.kind = kTraceCycle;
+    record.pc = dut.io_pc_out;
+    record.instr = dut.io_instr_out;
+    record.aux = dut.io_result;
+    if (write.valid) {
+      record.addr = write.addr;
+      record.data = write.data;
+      record.mask = static_cast<uint8_t>(write.mask);
+    }
+    trace.append(cycle, record);
+  }
+
+  static uint64_t idleSample(const Model& dut, const State&) {
+    uint64_t h = idleMix(dut.io_pc_out, dut.io_instr_out);
+    return idleMix(h, dut.io_result);
+  }
+
+  static bool fetchesPc(const Model&, const State& state, uint32_t pc) { return state.pc == pc; }
+
+  // Single-cycle core: every cycle issues and retires one instruction.
+  static constexpr bool kObservesRetire = true;
+  static constexpr bool kHasFetchBuffer = false;
+
+  static void countCycle(PerfCounters& perf, const Model&, const State&,
+                         const harness::MemWrite& write) {
+    ThreadPerf& thread = perf.threads[0];
+    ++thread.slots;
+    ++thread.issued;
+    ++thread.retired;
+    perf.stores += write.valid ? 1 : 0;
+  }
+
+  // Fetches go to memory on every cycle the cache does not hit; loads are
+  // recognised from the retiring instruction's opcode.
+  static void memAccesses(CycleAccesses& accesses, const Model& dut, const State&,
+                          const harness::MemWrite& write) {
+    bool fetch = true;
+    if constexpr (kWithICache) {
+      fetch = dut.io_icache_hit == 0;
+    }
+    if (fetch) {
+      accesses.add(kMemFetch, dut.io_imem_addr, 4);
+    }
+    if (write.valid) {
+      accesses.add(kMemStore, write.addr, 4);
+    } else if ((dut.io_instr_out & 0x7Fu) == 0x03u) {
+      accesses.add(kMemLoad, dut.io_dmem_addr, 4);
+    }
+  }
+
+  // A divide holds its PC until the cycle it writes back, and the cached top
+  // shows instruction 0 while it refills; neither retires anything.
+  static constexpr uint32_t kCommitKinds = kCommitRetire | kCommitStore;
+
+  static void commits(CoSim& cosim, const Model& dut, const State& state,
+                      const harness::MemWrite& write) {
+    const bool divide = (state.instr & 0xFE00007Fu) == 0x02000033u && (state.instr & 0x4000u) != 0;
+    if (state.instr == 0 || (divide && dut.io_pc_out == state.pc)) {
+      return;
+    }
+    cosim.retire(0, state.pc, state.instr, state.result);
+    if (write.valid) {
+      cosim.store(write.addr, write.data, write.mask);
+    }
+  }
+
+  // Must match the default ICacheSimpleConfig in ZeroNyteRV32ICoreWithCache;
+  // sweep variants built with other geometries pass --icache-geometry.
+  static constexpr bool kHasICache = kWithICache;
+  static constexpr ICacheGeometry kICache{2 * 1024, 16, 1};
+
+  static ICacheEvent icacheEvent(const Model& dut) {
+    ICacheEvent event;
+    if constexpr (kWithICache) {
+      event.access = dut.io_icache_hit || dut.io_icache_miss;
+      event.hit = dut.io_icache_hit != 0;
+      event.refill = dut.io_icache_stall != 0;
+      event.addr = dut.io_pc_out;
+    }
+    return event;
+  }
+};